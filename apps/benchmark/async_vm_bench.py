@@ -0,0 +1,135 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Throughput and tail latency of concurrent requests served by the async relax VM.
+
+Every request runs a small MLP on its own input. Requests arrive from a number of
+client threads, each waiting for its previous request before sending the next one,
+and are served in two ways:
+
+- sync: every client calls the VM under a lock, the way a single VM instance is shared.
+- async: every client submits to ``relax.vm.AsyncVirtualMachine`` and waits on the future.
+
+The async executor is run with increasing numbers of workers, dividing the cores
+evenly among them.
+"""
+import argparse
+import threading
+import time
+
+import numpy as np
+
+import tvm
+from tvm import relax
+
+
+def build_model(batch, hidden, num_layers, target):
+    """Build an MLP with random weights."""
+    rng = np.random.default_rng(0)
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", relax.TensorStructInfo([batch, hidden], "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            y = x
+            for _ in range(num_layers):
+                weight = rng.standard_normal((hidden, hidden)).astype("float32") / hidden
+                y = bb.emit(relax.op.nn.relu(relax.op.matmul(y, relax.const(weight))))
+            gv = bb.emit_output(y)
+        bb.emit_func_output(gv)
+    ex = relax.build(bb.get(), target)
+    return relax.VirtualMachine(ex, tvm.cpu())
+
+
+def serve(invoke, inputs, num_clients, requests_per_client):
+    """Run the clients and return the throughput and the request latencies in ms."""
+    latencies = [[] for _ in range(num_clients)]
+
+    def client(index):
+        for i in range(requests_per_client):
+            x = inputs[(index + i) % len(inputs)]
+            start = time.perf_counter()
+            invoke(x)
+            latencies[index].append((time.perf_counter() - start) * 1e3)
+
+    threads = [threading.Thread(target=client, args=(i,)) for i in range(num_clients)]
+    start = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.perf_counter() - start
+    latencies = np.concatenate([np.array(lat) for lat in latencies])
+    return num_clients * requests_per_client / elapsed, latencies
+
+
+def report(name, throughput, latencies):
+    print(
+        "%-12s %-10.1f %-10.2f %-10.2f %-10.2f"
+        % (
+            name,
+            throughput,
+            np.percentile(latencies, 50),
+            np.percentile(latencies, 99),
+            np.percentile(latencies, 99.9),
+        )
+    )
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--batch", type=int, default=8)
+    parser.add_argument("--hidden", type=int, default=512)
+    parser.add_argument("--num-layers", type=int, default=4)
+    parser.add_argument("--num-clients", type=int, default=16)
+    parser.add_argument("--requests-per-client", type=int, default=64)
+    parser.add_argument("--max-workers", type=int, default=8)
+    parser.add_argument("--target", type=str, default="llvm")
+    args = parser.parse_args()
+
+    vm = build_model(args.batch, args.hidden, args.num_layers, args.target)
+    rng = np.random.default_rng(1)
+    inputs = [
+        tvm.nd.array(rng.standard_normal((args.batch, args.hidden)).astype("float32"))
+        for _ in range(args.num_clients)
+    ]
+    main = vm["main"]
+    lock = threading.Lock()
+
+    def invoke_sync(x):
+        with lock:
+            main(x)
+
+    # warm up
+    for x in inputs:
+        main(x)
+
+    print(
+        "%-12s %-10s %-10s %-10s %-10s"
+        % ("mode", "req/s", "p50 (ms)", "p99 (ms)", "p99.9 (ms)")
+    )
+    report("sync", *serve(invoke_sync, inputs, args.num_clients, args.requests_per_client))
+    num_workers = 1
+    while num_workers <= args.max_workers:
+        executor = relax.vm.AsyncVirtualMachine(vm, num_workers=num_workers)
+        result = serve(
+            lambda x, ex=executor: ex.submit("main", x).result(),
+            inputs,
+            args.num_clients,
+            args.requests_per_client,
+        )
+        report("async x%d" % num_workers, *result)
+        executor.shutdown()
+        num_workers *= 2
@@ -0,0 +1,76 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Flash attention against the materialized matmul-softmax-matmul attention on CPU.
+
+The naive kernel allocates a (batch, heads, seq_len, seq_len) float32 score matrix and is
+skipped once that matrix exceeds --naive-limit-mb; the flash kernel streams keys and values
+in blocks and keeps its working set in a few kilobytes per thread.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te, topi
+
+
+def build(te_func, target, shape, causal_mask):
+    """Build the attention kernel produced by `te_func` for a self-attention workload."""
+    q = te.placeholder(shape, name="q")
+    k = te.placeholder(shape, name="k")
+    v = te.placeholder(shape, name="v")
+    out = te_func(q, k, v, causal_mask=causal_mask)
+    return tvm.build(te.create_prim_func([q, k, v, out]), target=target)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -mcpu=native")
+    parser.add_argument("--batch", type=int, default=1)
+    parser.add_argument("--num-heads", type=int, default=8)
+    parser.add_argument("--head-dim", type=int, default=64)
+    parser.add_argument("--min-seq-len", type=int, default=128)
+    parser.add_argument("--max-seq-len", type=int, default=32768)
+    parser.add_argument("--causal", action="store_true")
+    parser.add_argument("--naive-limit-mb", type=int, default=2048)
+    parser.add_argument("--number", type=int, default=3)
+    args = parser.parse_args()
+
+    dev = tvm.cpu()
+    causal_mask = "TopLeft" if args.causal else None
+    header = ("seq_len", "naive ms", "flash ms", "speedup", "score MB")
+    print("%-10s %-14s %-14s %-10s %-12s" % header)
+    seq_len = args.min_seq_len
+    while seq_len <= args.max_seq_len:
+        shape = (args.batch, seq_len, args.num_heads, args.head_dim)
+        inputs = [tvm.nd.array(np.random.uniform(-1, 1, shape).astype("float32"), dev)] * 3
+        out = tvm.nd.empty(shape, "float32", dev)
+        score_mb = args.batch * args.num_heads * seq_len * seq_len * 4 / 2**20
+
+        costs = {}
+        for name, te_func in [("naive", topi.nn.attention), ("flash", topi.nn.flash_attention)]:
+            if name == "naive" and score_mb > args.naive_limit_mb:
+                continue
+            func = build(te_func, args.target, shape, causal_mask)
+            timer = func.time_evaluator(func.entry_name, dev, number=args.number, repeat=1)
+            costs[name] = timer(*inputs, out).mean * 1e3
+
+        naive = "%.3f" % costs["naive"] if "naive" in costs else "skipped"
+        speedup = "%.2f" % (costs["naive"] / costs["flash"]) if "naive" in costs else "-"
+        row = (seq_len, naive, costs["flash"], speedup, score_mb)
+        print("%-10d %-14s %-14.3f %-10s %-12.1f" % row)
+        seq_len *= 2
@@ -0,0 +1,128 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Throughput of the continuous-batching scheduler under a synthetic load.
+
+The model embeds the tokens, applies one dense layer and picks the next token with
+an argmax over the vocabulary, so the cost of a step grows with the number of tokens
+in the batch. Prompt and output lengths are drawn at random. Three policies are
+compared on the same requests:
+
+- sequential: one request at a time.
+- static: requests are grouped in batches and a batch runs until all its requests finish.
+- continuous: finished requests leave and queued ones join at every step.
+"""
+import argparse
+import time
+
+import numpy as np
+
+import tvm
+from tvm import relax
+
+
+def build_model(vocab_size, hidden_size, target):
+    """Build the prefill and decode functions of the synthetic model."""
+    rng = np.random.default_rng(0)
+    embed = relax.const(rng.standard_normal((vocab_size, hidden_size)).astype("float32"))
+    weight = relax.const(rng.standard_normal((hidden_size, hidden_size)).astype("float32"))
+    head = relax.const(rng.standard_normal((hidden_size, vocab_size)).astype("float32"))
+
+    def next_token(bb, ids):
+        x = bb.emit(relax.op.take(embed, ids, axis=0))
+        x = bb.emit(relax.op.matmul(x, weight))
+        logits = bb.emit(relax.op.matmul(x, head))
+        return bb.emit(relax.op.astype(relax.op.argmax(logits, axis=-1), "int32"))
+
+    n, m, b = tvm.tir.Var("n", "int64"), tvm.tir.Var("m", "int64"), tvm.tir.Var("b", "int64")
+    bb = relax.BlockBuilder()
+    input_ids = relax.Var("input_ids", relax.TensorStructInfo([n], "int32"))
+    indptr = relax.Var("indptr", relax.TensorStructInfo([m], "int32"))
+    slots = relax.Var("slots", relax.TensorStructInfo([b], "int32"))
+    with bb.function("prefill", [input_ids, indptr, slots]):
+        with bb.dataflow():
+            # the last prompt token of each sequence predicts the next one.
+            last = bb.emit(relax.op.strided_slice(indptr, axes=[0], begin=[1], end=[m]))
+            last = bb.emit(relax.op.subtract(last, relax.const(1, "int32")))
+            last_ids = bb.emit(relax.op.take(input_ids, last, axis=0))
+            gv = bb.emit_output(next_token(bb, last_ids))
+        bb.emit_func_output(gv)
+
+    input_ids = relax.Var("input_ids", relax.TensorStructInfo([b], "int32"))
+    slots = relax.Var("slots", relax.TensorStructInfo([b], "int32"))
+    with bb.function("decode", [input_ids, slots]):
+        with bb.dataflow():
+            gv = bb.emit_output(next_token(bb, input_ids))
+        bb.emit_func_output(gv)
+
+    ex = relax.build(bb.get(), target)
+    return relax.VirtualMachine(ex, tvm.cpu())
+
+
+def make_requests(num_requests, vocab_size, max_prompt_len, max_new_tokens):
+    rng = np.random.default_rng(1)
+    requests = []
+    for _ in range(num_requests):
+        prompt_len = int(rng.integers(1, max_prompt_len + 1))
+        requests.append(
+            (
+                rng.integers(0, vocab_size, prompt_len).tolist(),
+                int(rng.integers(1, max_new_tokens + 1)),
+            )
+        )
+    return requests
+
+
+def run(vm, requests, batch_size, max_num_tokens, group):
+    """Serve the requests, submitting `group` of them at a time, and return tokens/s."""
+    sched = relax.vm.BatchScheduler(
+        vm, max_batch_size=batch_size, max_num_tokens=max(max_num_tokens, batch_size)
+    )
+    start = time.perf_counter()
+    num_tokens = 0
+    for begin in range(0, len(requests), group):
+        for request_id in range(begin, min(begin + group, len(requests))):
+            prompt, max_new_tokens = requests[request_id]
+            sched.add_request(request_id, prompt, max_new_tokens)
+        num_tokens += sum(len(out) for out in sched.run().values())
+    return num_tokens / (time.perf_counter() - start)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--num-requests", type=int, default=256)
+    parser.add_argument("--batch-size", type=int, default=32)
+    parser.add_argument("--max-prompt-len", type=int, default=128)
+    parser.add_argument("--max-new-tokens", type=int, default=128)
+    parser.add_argument("--vocab-size", type=int, default=4096)
+    parser.add_argument("--hidden-size", type=int, default=512)
+    parser.add_argument("--target", type=str, default="llvm")
+    args = parser.parse_args()
+
+    vm = build_model(args.vocab_size, args.hidden_size, args.target)
+    requests = make_requests(
+        args.num_requests, args.vocab_size, args.max_prompt_len, args.max_new_tokens
+    )
+    max_num_tokens = args.batch_size * args.max_prompt_len
+    policies = [
+        ("sequential", 1, len(requests)),
+        ("static", args.batch_size, args.batch_size),
+        ("continuous", args.batch_size, len(requests)),
+    ]
+    print("%-12s %-12s" % ("policy", "tokens/s"))
+    for name, batch_size, group in policies:
+        throughput = run(vm, requests, batch_size, max_num_tokens, group)
+        print("%-12s %-12.1f" % (name, throughput))
@@ -0,0 +1,145 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark of NUMA placement and huge pages for CPU device memory.
+
+Runs a GEMM and a conv2d with the worker threads pinned to one NUMA node while the
+tensors are placed on each node in turn, e.g. on a dual-socket server:
+
+.. code-block:: bash
+
+    python3 cpu_numa_bench.py --thread-node 0 --huge-page transparent
+
+Each configuration runs in its own process since the placement policy is read
+from TVM_CPU_NUMA_BIND / TVM_CPU_HUGE_PAGE once per process.
+"""
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+WORKER = """
+import json, sys
+import numpy as np
+import tvm
+from tvm import te, topi
+
+node, size, repeat = int(sys.argv[1]), int(sys.argv[2]), int(sys.argv[3])
+dev = tvm.cpu(node)
+target = tvm.target.Target("llvm -mcpu=native")
+results = {}
+
+# GEMM
+A = te.placeholder((size, size), name="A")
+B = te.placeholder((size, size), name="B")
+k = te.reduce_axis((0, size), name="k")
+C = te.compute((size, size), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name="C")
+s = te.create_schedule(C.op)
+i, j = s[C].op.axis
+io, jo, ii, ji = s[C].tile(i, j, 32, 32)
+ko, ki = s[C].split(k, 4)
+s[C].reorder(io, jo, ko, ii, ki, ji)
+s[C].vectorize(ji)
+s[C].parallel(io)
+f = tvm.build(s, [A, B, C], target)
+args = [tvm.nd.array(np.random.rand(size, size).astype("float32"), dev) for _ in range(2)]
+args.append(tvm.nd.empty((size, size), "float32", dev))
+t = f.time_evaluator(f.entry_name, dev, number=1, repeat=repeat)(*args).mean
+results["gemm_gflops"] = 2.0 * size**3 / t / 1e9
+
+# conv2d, dominated by the bandwidth of the input and output feature maps
+data = te.placeholder((1, 64, 224, 224), name="data")
+kernel = te.placeholder((64, 64, 3, 3), name="kernel")
+with target:
+    out = topi.nn.conv2d_nchw(data, kernel, 1, 1, 1)
+    s = topi.x86.schedule_conv2d_nchw([out])
+f = tvm.build(s, [data, kernel, out], target)
+args = [
+    tvm.nd.array(np.random.rand(*[int(x) for x in t.shape]).astype("float32"), dev)
+    for t in (data, kernel)
+]
+args.append(tvm.nd.empty([int(x) for x in out.shape], "float32", dev))
+t = f.time_evaluator(f.entry_name, dev, number=1, repeat=repeat)(*args).mean
+nbytes = sum(a.numpy().nbytes for a in args)
+results["conv2d_gbps"] = nbytes / t / 1e9
+print(json.dumps(results))
+"""
+
+
+def node_cpus(node):
+    """Get the cpu ids of a NUMA node"""
+    cpus = []
+    with open("/sys/devices/system/node/node%d/cpulist" % node) as f:
+        for part in f.read().strip().split(","):
+            lo, _, hi = part.partition("-")
+            cpus.extend(range(int(lo), int(hi or lo) + 1))
+    return cpus
+
+
+def num_nodes():
+    """Get the number of online NUMA nodes"""
+    with open("/sys/devices/system/node/online") as f:
+        return int(f.read().strip().replace(",", "-").split("-")[-1]) + 1
+
+
+def run(thread_node, data_node, huge_page):
+    """Run the workloads in a subprocess with the given placement"""
+    cpus = node_cpus(thread_node)
+    env = dict(os.environ)
+    env.update(
+        {
+            "TVM_CPU_NUMA_BIND": "1",
+            "TVM_CPU_HUGE_PAGE": huge_page,
+            # Keep the workers within the process affinity mask set below.
+            "TVM_BIND_THREADS": "0",
+            "TVM_NUM_THREADS": str(len(cpus)),
+        }
+    )
+    proc = subprocess.run(
+        [sys.executable, "-c", WORKER, str(data_node), str(args.size), str(args.repeat)],
+        env=env,
+        stdout=subprocess.PIPE,
+        check=True,
+        preexec_fn=lambda: os.sched_setaffinity(0, cpus),
+    )
+    return json.loads(proc.stdout.decode().strip().splitlines()[-1])
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--thread-node", type=int, default=0)
+    parser.add_argument(
+        "--huge-page", type=str, default="none", choices=["none", "transparent", "explicit"]
+    )
+    parser.add_argument("--size", type=int, default=2048, help="GEMM size")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    header = ("threads", "data", "huge page", "GEMM GFLOPS", "conv2d GB/s")
+    print("%-12s %-12s %-12s %-14s %-14s" % header)
+    for data_node in range(num_nodes()):
+        res = run(args.thread_node, data_node, args.huge_page)
+        print(
+            "%-12s %-12s %-12s %-14.2f %-14.2f"
+            % (
+                "node%d" % args.thread_node,
+                "node%d" % data_node,
+                args.huge_page,
+                res["gemm_gflops"],
+                res["conv2d_gbps"],
+            )
+        )
@@ -0,0 +1,40 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark of concurrent packed function lookups.
+
+Generated host code resolves packed calls through ``TVMBackendGetFuncFromEnv``, which
+ends up in ``ModuleNode::GetFuncFromEnv`` and ``Registry::Get``. This script measures
+both from a growing number of threads.
+"""
+import argparse
+import multiprocessing
+
+import tvm
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--max-threads", type=int, default=multiprocessing.cpu_count())
+    parser.add_argument("--num-lookups", type=int, default=1000000)
+    args = parser.parse_args()
+
+    f = tvm.get_global_func("testing.benchmark_func_lookup")
+    print("%-10s %-24s %-24s" % ("threads", "Registry::Get ns/op", "GetFuncFromEnv ns/op"))
+    num_threads = 1
+    while num_threads <= args.max_threads:
+        registry_ns, env_ns = f(num_threads, args.num_lookups)
+        print("%-10d %-24.2f %-24.2f" % (num_threads, registry_ns.value, env_ns.value))
+        num_threads *= 2
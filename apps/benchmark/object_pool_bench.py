@@ -0,0 +1,71 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark of compile-time workloads dominated by IR node allocation.
+
+Measures a relay build of an ImageNet network and MetaSchedule candidate generation
+on CPU. Run it against a build with ``USE_POOLED_OBJ_ALLOC`` ON and one with it OFF
+to compare the pooled object allocator with plain new/delete.
+"""
+import argparse
+import time
+
+import tvm
+from tvm import meta_schedule as ms
+from tvm import relay
+from tvm.meta_schedule.testing import te_workload
+from tvm.te import create_prim_func
+
+from util import get_network
+
+
+def bench_relay_build(network, target):
+    net, params, _, _ = get_network(network, batch_size=1)
+    start = time.time()
+    with tvm.transform.PassContext(opt_level=3):
+        relay.build(net, target=target, params=params)
+    return time.time() - start
+
+
+def bench_candidate_generation(target, num_trials):
+    mod = create_prim_func(te_workload.conv2d_nhwc(1, 56, 56, 64, 64, 3, 1, 1))
+    context = ms.TuneContext(
+        mod=mod,
+        target=target,
+        space_generator="post-order-apply",
+        search_strategy="evolutionary",
+        num_threads="physical",
+    )
+    start = time.time()
+    context.pre_tuning(max_trials=num_trials, num_trials_per_iter=num_trials)
+    candidates = context.search_strategy.generate_measure_candidates()
+    context.post_tuning()
+    return time.time() - start, len(candidates or [])
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--network", type=str, default="resnet-50")
+    parser.add_argument("--target", type=str, default="llvm -num-cores 8")
+    parser.add_argument("--num-trials", type=int, default=512)
+    args = parser.parse_args()
+
+    target = tvm.target.Target(args.target)
+    pooled = tvm.support.libinfo().get("USE_POOLED_OBJ_ALLOC", "NOT-FOUND")
+    print("USE_POOLED_OBJ_ALLOC: %s" % pooled)
+    print("relay.build %-20s %.2f s" % (args.network, bench_relay_build(args.network, target)))
+    cost, num_candidates = bench_candidate_generation(target, args.num_trials)
+    print("MetaSchedule generated %d candidates in %.2f s" % (num_candidates, cost))
@@ -0,0 +1,150 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Requantize epilogues on int8 ResNet and BERT style networks.
+
+Builds chains of qnn.conv2d, qnn.dense and qnn.batch_matmul, each followed by a
+per-tensor qnn.requantize back to int8, and reports the run time for every
+requantize rounding mode. "UPWARD" fuses into the producer as a single
+fixed-point multiply, while "TONEAREST" is canonicalized into a chain of int64
+multiply, add, shift and clip operators.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+
+
+def requantize(data, scale, rounding):
+    return relay.qnn.op.requantize(
+        data,
+        input_scale=relay.const(scale),
+        input_zero_point=relay.const(0),
+        output_scale=relay.const(0.05),
+        output_zero_point=relay.const(0),
+        rounding=rounding,
+        compute_dtype="int64",
+        out_dtype="int8",
+    )
+
+
+def int8_const(shape):
+    return relay.const(np.random.randint(-127, 128, size=shape).astype("int8"))
+
+
+def resnet(rounding, batch_size):
+    """3x3 convolutions with the channels and resolutions of the four ResNet-18 stages."""
+    data = relay.var("data", shape=(batch_size, 64, 56, 56), dtype="int8")
+    out = data
+    channels = 64
+    for stage, out_channels in enumerate([64, 128, 256, 512]):
+        for layer in range(2):
+            out = relay.qnn.op.conv2d(
+                out,
+                int8_const((out_channels, channels, 3, 3)),
+                input_zero_point=relay.const(0),
+                kernel_zero_point=relay.const(0),
+                input_scale=relay.const(0.05),
+                kernel_scale=relay.const(0.01),
+                kernel_size=(3, 3),
+                channels=out_channels,
+                strides=(2, 2) if stage > 0 and layer == 0 else (1, 1),
+                padding=(1, 1),
+            )
+            out = requantize(out, 0.0005, rounding)
+            channels = out_channels
+    return relay.Function([data], out)
+
+
+def bert(rounding, batch_size, seq_len=128, hidden=768, heads=12):
+    """The int8 matmuls of one BERT-base encoder layer."""
+    data = relay.var("data", shape=(batch_size * seq_len, hidden), dtype="int8")
+
+    def dense(x, units, in_units):
+        out = relay.qnn.op.dense(
+            x,
+            int8_const((units, in_units)),
+            input_zero_point=relay.const(0),
+            kernel_zero_point=relay.const(0),
+            input_scale=relay.const(0.05),
+            kernel_scale=relay.const(0.01),
+            units=units,
+        )
+        return requantize(out, 0.0005, rounding)
+
+    def batch_matmul(x, y):
+        out = relay.qnn.op.batch_matmul(
+            x,
+            y,
+            x_zero_point=relay.const(0),
+            y_zero_point=relay.const(0),
+            x_scale=relay.const(0.05),
+            y_scale=relay.const(0.05),
+        )
+        return requantize(out, 0.0025, rounding)
+
+    def split_heads(x):
+        x = relay.reshape(x, (batch_size, seq_len, heads, hidden // heads))
+        x = relay.transpose(x, (0, 2, 1, 3))
+        return relay.reshape(x, (batch_size * heads, seq_len, hidden // heads))
+
+    query = split_heads(dense(data, hidden, hidden))
+    key = split_heads(dense(data, hidden, hidden))
+    value = split_heads(dense(data, hidden, hidden))
+    scores = batch_matmul(query, key)
+    context = batch_matmul(scores, relay.transpose(value, (0, 2, 1)))
+    context = relay.reshape(context, (batch_size, heads, seq_len, hidden // heads))
+    context = relay.transpose(context, (0, 2, 1, 3))
+    context = relay.reshape(context, (batch_size * seq_len, hidden))
+    out = dense(context, hidden, hidden)
+    out = dense(out, 4 * hidden, hidden)
+    out = dense(out, hidden, 4 * hidden)
+    return relay.Function([data], out)
+
+
+def measure(func, target, number):
+    """Build the network and return the mean run time in ms."""
+    mod = tvm.IRModule.from_expr(func)
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target=target)
+    dev = tvm.cpu()
+    module = graph_executor.GraphModule(lib["default"](dev))
+    shape = [int(dim) for dim in func.params[0].checked_type.shape]
+    module.set_input("data", np.random.randint(-127, 128, size=shape).astype("int8"))
+    return module.module.time_evaluator("run", dev, number=number)().mean * 1e3
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -mcpu=native")
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--number", type=int, default=10)
+    args = parser.parse_args()
+
+    print("%-10s %-12s %-12s %-10s" % ("network", "rounding", "ms", "speedup"))
+    for name, network in [("resnet", resnet), ("bert", bert)]:
+        baseline = None
+        for rounding in ["TONEAREST", "UPWARD"]:
+            func = relay.transform.InferType()(
+                tvm.IRModule.from_expr(network(rounding, args.batch_size))
+            )["main"]
+            cost = measure(func, args.target, args.number)
+            baseline = baseline or cost
+            speedup = "%.2fx" % (baseline / cost)
+            print("%-10s %-12s %-12.3f %-10s" % (name, rounding, cost, speedup))
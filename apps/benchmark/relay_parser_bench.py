@@ -0,0 +1,92 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Parsing large printed Relay modules.
+
+Prints a deep MLP whose weights are bound as constants, so most of the text is
+the metadata section, together with a weight-free variant with a long body.
+Each module is parsed in a fresh process, reporting the parse time and the
+peak resident memory of that process.
+"""
+import argparse
+import multiprocessing
+import os
+import resource
+import tempfile
+import time
+
+import numpy as np
+
+import tvm
+from tvm import relay
+
+
+def mlp(layers, hidden, bind_weights):
+    data = relay.var("data", shape=(1, hidden))
+    out = data
+    params = []
+    for i in range(layers):
+        if bind_weights:
+            weight = relay.const(np.random.rand(hidden, hidden).astype("float32"))
+        else:
+            weight = relay.var("weight%d" % i, shape=(hidden, hidden))
+            params.append(weight)
+        out = relay.nn.relu(relay.nn.dense(out, weight))
+    return tvm.IRModule.from_expr(relay.Function([data] + params, out))
+
+
+def parse(path, queue):
+    with open(path) as f:
+        text = f.read()
+    start = time.time()
+    tvm.relay.parse(text)
+    elapsed = time.time() - start
+    queue.put((elapsed, resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024))
+
+
+def measure(text):
+    """Parse the text in a new process and return the run time in s and peak RSS in MB."""
+    with tempfile.NamedTemporaryFile("w", suffix=".relay", delete=False) as f:
+        f.write(text)
+    try:
+        ctx = multiprocessing.get_context("spawn")
+        queue = ctx.Queue()
+        proc = ctx.Process(target=parse, args=(f.name, queue))
+        proc.start()
+        result = queue.get()
+        proc.join()
+        return result
+    finally:
+        os.remove(f.name)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--layers", type=int, default=64)
+    parser.add_argument("--hidden", type=int, default=1024)
+    parser.add_argument("--body-layers", type=int, default=20000)
+    args = parser.parse_args()
+
+    workloads = [
+        ("metadata", mlp(args.layers, args.hidden, bind_weights=True)),
+        ("body", mlp(args.body_layers, 16, bind_weights=False)),
+    ]
+    print("%-10s %-10s %-10s %-12s" % ("module", "text MB", "parse s", "peak RSS MB"))
+    for name, mod in workloads:
+        text = mod.astext(show_meta_data=True)
+        elapsed, peak_rss = measure(text)
+        size = len(text) / (1 << 20)
+        print("%-10s %-10.1f %-10.2f %-12.1f" % (name, size, elapsed, peak_rss))
@@ -0,0 +1,97 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Scaling of a tensor-parallel MLP over local worker processes.
+
+The first weight is sharded by columns and the second by rows, so each worker
+computes a slice of the hidden layer and one allreduce sums the partial outputs.
+Each worker is pinned to its own group of CPUs, e.g. one socket per worker.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relax
+from tvm.ir import Range
+from tvm.relax.distributed import DeviceMesh, DTensorStructInfo, Placement, ShardedExecutor
+from tvm.script import tir as T
+from tvm.script.ir_builder.relax.distributed import call_tir as dist_call_tir
+
+
+@T.prim_func
+def matmul(var_A: T.handle, var_B: T.handle, var_C: T.handle):
+    m, k, n = T.int64(), T.int64(), T.int64()
+    A = T.match_buffer(var_A, (m, k), "float32")
+    B = T.match_buffer(var_B, (k, n), "float32")
+    C = T.match_buffer(var_C, (m, n), "float32")
+    for i in T.parallel(m):
+        for r, j in T.grid(k, n):
+            with T.block("matmul"):
+                vi, vr, vj = T.axis.remap("SRS", [i, r, j])
+                with T.init():
+                    C[vi, vj] = T.float32(0)
+                C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+
+def build_mlp(num_workers, batch, hidden):
+    """The MLP over distributed tensors on a mesh of `num_workers` devices."""
+    mesh = DeviceMesh((num_workers,), Range(0, num_workers))
+
+    def dtensor(shape, placement):
+        return DTensorStructInfo(
+            relax.TensorStructInfo(shape, "float32"), mesh, Placement.from_text(placement)
+        )
+
+    bb = relax.BlockBuilder()
+    gv = bb.add_func(matmul, "matmul")
+    x = relax.Var("x", dtensor((batch, hidden), "R"))
+    w1 = relax.Var("w1", dtensor((hidden, 4 * hidden), "S[1]"))
+    w2 = relax.Var("w2", dtensor((4 * hidden, hidden), "S[0]"))
+    with bb.function("mlp", [x, w1, w2]):
+        h = bb.emit(dist_call_tir(gv, (x, w1), dtensor((batch, 4 * hidden), "S[1]")))
+        partial = bb.emit(dist_call_tir(gv, (h, w2), dtensor((batch, hidden), "R")))
+        out = bb.emit(relax.op.distributed.allreduce(partial))
+        bb.emit_func_output(out)
+    mod = bb.get()
+    mod.update_global_info("mesh", [mesh])
+    return mod
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--max-workers", type=int, default=2)
+    parser.add_argument("--batch", type=int, default=64)
+    parser.add_argument("--hidden", type=int, default=1024)
+    parser.add_argument("--number", type=int, default=10)
+    args = parser.parse_args()
+
+    x = np.random.rand(args.batch, args.hidden).astype("float32")
+    w1 = np.random.rand(args.hidden, 4 * args.hidden).astype("float32")
+    w2 = np.random.rand(4 * args.hidden, args.hidden).astype("float32")
+    capacity = x.nbytes
+
+    print("%-10s %-12s %-10s" % ("workers", "ms/call", "speedup"))
+    base = None
+    num_workers = 1
+    while num_workers <= args.max_workers:
+        mod = build_mlp(num_workers, args.batch, args.hidden)
+        with ShardedExecutor(mod, "llvm", capacity_bytes=capacity) as executor:
+            np.testing.assert_allclose(executor["mlp"](x, w1, w2), x @ w1 @ w2, rtol=1e-3)
+            cost = executor.time_evaluator("mlp", x, w1, w2, number=args.number)
+        base = base or cost
+        print("%-10d %-12.3f %-10.2f" % (num_workers, cost * 1e3, base / cost))
+        num_workers *= 2
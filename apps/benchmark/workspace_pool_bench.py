@@ -0,0 +1,81 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Workspace allocation in parallel CPU kernels.
+
+Builds row-wise kernels whose per-row intermediate is allocated through
+TVMBackendAllocWorkspace inside a parallel loop, runs them with growing row
+sizes, and reports the run time along with the workspace pool statistics:
+the share of allocations served from the thread caches and the shared pool,
+and the peak number of bytes obtained from the device.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te
+
+
+def build(rows, cols, target):
+    """exp(A) normalized by its row sum, with the exp of each row in a workspace."""
+    data = te.placeholder((rows, cols), name="data")
+    exp = te.compute((rows, cols), lambda i, j: te.exp(data[i, j]), name="exp")
+    k = te.reduce_axis((0, cols), name="k")
+    total = te.compute((rows,), lambda i: te.sum(exp[i, k], axis=k), name="total")
+    out = te.compute((rows, cols), lambda i, j: exp[i, j] / total[i], name="out")
+    sch = te.create_schedule(out.op)
+    sch[out].parallel(out.op.axis[0])
+    sch[exp].compute_at(sch[out], out.op.axis[0])
+    sch[total].compute_at(sch[out], out.op.axis[0])
+    return tvm.build(sch, [data, out], target=target)
+
+
+def pool_stats():
+    stats = tvm.get_global_func("runtime.WorkspacePoolStats")(tvm.cpu())
+    return [int(x) for x in stats]
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm -mcpu=native")
+    parser.add_argument("--rows", type=int, default=4096)
+    parser.add_argument("--cols", type=int, nargs="+", default=[512, 4096, 65536])
+    parser.add_argument("--number", type=int, default=20)
+    args = parser.parse_args()
+
+    dev = tvm.cpu()
+    header = ("cols", "ms", "allocs", "thread", "shared", "peak MB")
+    print("%-8s %-10s %-12s %-10s %-10s %-12s" % header)
+    for cols in args.cols:
+        func = build(args.rows, cols, args.target)
+        data = tvm.nd.array(np.random.uniform(size=(args.rows, cols)).astype("float32"), dev)
+        out = tvm.nd.empty((args.rows, cols), "float32", dev)
+        before = pool_stats()
+        cost = func.time_evaluator(func.entry_name, dev, number=args.number)(data, out).mean
+        after = pool_stats()
+        allocs, thread_hits, shared_hits = [a - b for a, b in zip(after[:3], before[:3])]
+        print(
+            "%-8d %-10.3f %-12d %-10s %-10s %-12.1f"
+            % (
+                cols,
+                cost * 1e3,
+                allocs,
+                "%.1f%%" % (100.0 * thread_hits / max(allocs, 1)),
+                "%.1f%%" % (100.0 * shared_hits / max(allocs, 1)),
+                after[4] / 2**20,
+            )
+        )
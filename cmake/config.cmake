@@ -320,6 +320,10 @@ set(USE_PT_TVMDSOOP OFF)
 # Whether to use STL's std::unordered_map or TVM's POD compatible Map
 set(USE_FALLBACK_STL_MAP OFF)
 
+# Whether to allocate small IR nodes (e.g. PrimExpr) from thread-local object pools
+# instead of new/delete, which speeds up lowering and tuning
+set(USE_POOLED_OBJ_ALLOC OFF)
+
 # Whether to enable Hexagon support
 set(USE_HEXAGON OFF)
 set(USE_HEXAGON_SDK /path/to/sdk)
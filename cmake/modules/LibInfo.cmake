@@ -95,6 +95,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_OPENCL_GTEST="${USE_OPENCL_GTEST}"
     TVM_INFO_USE_OPENMP="${USE_OPENMP}"
     TVM_INFO_USE_PAPI="${USE_PAPI}"
+    TVM_INFO_USE_POOLED_OBJ_ALLOC="${USE_POOLED_OBJ_ALLOC}"
     TVM_INFO_USE_PROFILER="${USE_PROFILER}"
     TVM_INFO_USE_PT_TVMDSOOP="${USE_PT_TVMDSOOP}"
     TVM_INFO_USE_RANDOM="${USE_RANDOM}"
@@ -104,6 +104,8 @@ class PrimExprNode : public BaseExprNode {
 
   static constexpr const char* _type_key = "PrimExpr";
   static constexpr const uint32_t _type_child_slots = 38;
+  // PrimExpr nodes are created and dropped in bulk during lowering and tuning.
+  static constexpr bool _type_pooled_alloc = true;
   TVM_DECLARE_BASE_OBJECT_INFO(PrimExprNode, BaseExprNode);
 };
 
@@ -225,6 +225,19 @@ class ScheduleRule : public runtime::ObjectRef {
       String structure, Integer vector_length_in_bits, Optional<Integer> max_innermost_factor,
       Optional<Map<String, ObjectRef>> reuse_read, Optional<Map<String, ObjectRef>> reuse_write);
 
+  /*!
+   * \brief Extension of MultiLevelTiling for CPUs that packs every read operand into a contiguous
+   * buffer under the outermost reduction tile. Each design space is generated with and without a
+   * software pipeline that runs the packing one iteration ahead of the computation.
+   * \param structure The tiling structure. 'SSRSRS' is recommended.
+   * \param max_innermost_factor The maximum size of the innermost factor. NullOpt means no limit
+   * \param reuse_write Data reuse configuration for writing. NullOpt means no reuse.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule MultiLevelTilingWithPacking(
+      String structure, Optional<Integer> max_innermost_factor,
+      Optional<Map<String, ObjectRef>> reuse_write);
+
   /*!
    * \brief Create a rule: add-rfactor to some blocks if needed
    * \param max_jobs_per_core The maximum number of jobs to be launched per CPU core. It sets the
@@ -264,6 +277,13 @@ class ScheduleRule : public runtime::ObjectRef {
                                                          int max_vectorize_extent,         //
                                                          Array<Integer> unroll_max_steps,  //
                                                          bool unroll_explicit);
+  /*!
+   * \brief Sample a software prefetch distance and mark it on the root block. The distance is
+   * used by the InjectSoftwarePrefetch pass for the strided reads of innermost loops
+   * \param prefetch_distances The candidate distances in loop iterations, 0 disables prefetching
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule AddSoftwarePrefetch(Array<Integer> prefetch_distances);
   /*!
    * \brief Auto bind loops around the block to BlockIdx and ThreadIdx
    * \param max_threadblocks The maximum number of threadblock on GPU
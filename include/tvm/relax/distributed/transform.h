@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/distributed/transform.h
+ * \brief Relax distributed specific transformation passes.
+ */
+#ifndef TVM_RELAX_DISTRIBUTED_TRANSFORM_H_
+#define TVM_RELAX_DISTRIBUTED_TRANSFORM_H_
+
+#include <tvm/relax/distributed/struct_info.h>
+#include <tvm/relax/transform.h>
+
+namespace tvm {
+namespace relax {
+namespace distributed {
+namespace transform {
+
+using Pass = tvm::transform::Pass;
+
+/*!
+ * \brief Lower the functions over distributed tensors to the program run by each worker.
+ *
+ * Distributed tensors become the local shard held by a worker, call_tir calls
+ * operate on the local shards, and redistribute/allreduce become calls to the
+ * vm.builtin.ccl collectives. Only one-dimensional device meshes are supported.
+ *
+ * Callees with static buffer shapes are cloned with the shapes of the local shards, dividing
+ * the loops over the sharded axes among the workers. The sharded axes of such callees must be
+ * indexed directly by an iterator over the whole axis.
+ *
+ * The lowered functions carry the "num_workers", "dist_param_axes" and
+ * "dist_ret_axes" attributes, the latter two giving the sharded axis of each
+ * parameter and of each returned tensor, or -1 if replicated.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass LowerDistIR();
+
+}  // namespace transform
+}  // namespace distributed
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_DISTRIBUTED_TRANSFORM_H_
@@ -104,6 +104,43 @@ TVM_DLL Pass CallTIRRewrite();
  */
 TVM_DLL Pass RewriteDataflowReshape();
 
+/*!
+ * \brief Rewrite permute_dims, strided_slice and split whose results are
+ * only consumed by call_tir into VM builtin calls that create strided views
+ * of their input at runtime, instead of copying the data.
+ *
+ * A view is only created when every consumer kernel binds the buffer of
+ * the argument with strides and elem_offset that the view satisfies, which
+ * kernels opt into by declaring symbolic buffer strides and elem_offset.
+ * Kernels produced by LegalizeOps declare compact buffers, so in practice
+ * only hand-written call_tir kernels with symbolic strides benefit.
+ *
+ * The view layout is derived from the input assuming it is compact, so an
+ * input which is itself a view, or the result of a packed function that may
+ * return one, is left unchanged.
+ *
+ * \return The Pass.
+ * \note The pass has to run before LegalizeOps and operator fusion, as it
+ * matches the high-level operators and the kernels that consume them.
+ */
+TVM_DLL Pass UseStridedViews();
+
+/*!
+ * \brief Hoist the global intermediate buffers of the PrimFuncs called through call_tir into
+ * a workspace argument, which every calling function allocates once and shares between the
+ * kernels it calls.
+ *
+ * The workspace is sized by the largest need over all kernels. It is appended to the call_tir
+ * inputs and marked with tir::attr::kWorkspaceParam in the PrimFunc, where StorageRewrite
+ * places the allocations into it instead of calling TVMBackendAllocWorkspace. A workspace is
+ * allocated on the runtime device of the inputs of the kernels using it, or on the device
+ * CallTIRRewrite allocates the outputs on if that of the inputs is unknown.
+ *
+ * \return The Pass.
+ * \note The pass has to run before CallTIRRewrite.
+ */
+TVM_DLL Pass AllocateWorkspace();
+
 /*!
  * \brief The static memory planning pass on BindingBlock level.
  * The pass will reuse allocated memory to its best effort, in order to
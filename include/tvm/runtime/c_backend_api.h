@@ -166,6 +166,30 @@ TVM_DLL int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv);
  */
 TVM_DLL int TVMBackendRunOnce(void** handle, int (*f)(void*), void* cdata, int nbytes);
 
+/*!
+ * \brief Record one entry of an instrumented loop.
+ *
+ *  Called by code built with the tir.instrument_loop_counts option before
+ *  each execution of a loop.  Counts are kept per calling thread and merged
+ *  when the profile is dumped.
+ *
+ * \param func_name The name of the PrimFunc that contains the loop.
+ * \param loop_id The index of the loop within the function.
+ * \param trip_count The number of iterations the loop is about to run.
+ * \return 0 when no error is thrown, -1 when failure happens
+ */
+TVM_DLL int TVMBackendProfileLoop(const char* func_name, int32_t loop_id, int64_t trip_count);
+
+/*!
+ * \brief Record one evaluation of an instrumented branch.
+ *
+ * \param func_name The name of the PrimFunc that contains the branch.
+ * \param branch_id The index of the branch within the function.
+ * \param taken Whether the condition evaluated to true.
+ * \return 0 when no error is thrown, -1 when failure happens
+ */
+TVM_DLL int TVMBackendProfileBranch(const char* func_name, int32_t branch_id, int32_t taken);
+
 #ifdef __cplusplus
 }  // TVM_EXTERN_C
 #endif
@@ -25,10 +25,15 @@
 
 #include <tvm/runtime/object.h>
 
+#include <cstddef>
 #include <cstdlib>
 #include <type_traits>
 #include <utility>
 
+#ifndef TVM_POOLED_OBJ_ALLOC
+#define TVM_POOLED_OBJ_ALLOC 0
+#endif
+
 namespace tvm {
 namespace runtime {
 /*!
@@ -47,8 +52,10 @@ inline ObjectPtr<T> make_object(Args&&... args);
 //
 // Possible future allocator optimizations:
 // - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
-// - Thread-local object pools: one pool per size and alignment requirement.
 // - Can specialize by type of object to give the specific allocator to each object.
+//
+// Objects that set _type_pooled_alloc are allocated from thread-local
+// size-class pools (PooledObjAllocator) when built with TVM_POOLED_OBJ_ALLOC.
 
 /*!
  * \brief Base class of object allocators that implements make.
@@ -191,9 +198,76 @@ class SimpleObjAllocator : public ObjAllocatorBase<SimpleObjAllocator> {
   };
 };
 
+namespace detail {
+/*! \brief Granularity of the size classes of the object pool, also the alignment of the blocks. */
+constexpr size_t kObjPoolGranularity = 16;
+/*! \brief Largest object size served by the object pool. */
+constexpr size_t kObjPoolMaxBytes = 512;
+/*!
+ * \brief Allocate a block from the object pool.
+ * \param size_class The size class, the block has size_class * kObjPoolGranularity bytes.
+ * \return The allocated block.
+ */
+TVM_DLL void* ObjPoolAlloc(size_t size_class);
+/*!
+ * \brief Return a block to the object pool, can be called from any thread.
+ * \param ptr The block allocated by ObjPoolAlloc.
+ * \param size_class The size class it was allocated with.
+ */
+TVM_DLL void ObjPoolFree(void* ptr, size_t size_class);
+}  // namespace detail
+
+// Allocator that serves objects from thread-local size-class pools.
+class PooledObjAllocator : public ObjAllocatorBase<PooledObjAllocator> {
+ public:
+  template <typename T>
+  class Handler {
+   public:
+    static constexpr size_t kSizeClass =
+        (sizeof(T) + detail::kObjPoolGranularity - 1) / detail::kObjPoolGranularity;
+    static_assert(sizeof(T) <= detail::kObjPoolMaxBytes &&
+                      alignof(T) <= detail::kObjPoolGranularity,
+                  "object does not fit in the object pool");
+
+    template <typename... Args>
+    static T* New(PooledObjAllocator*, Args&&... args) {
+      void* data = detail::ObjPoolAlloc(kSizeClass);
+      new (data) T(std::forward<Args>(args)...);
+      return reinterpret_cast<T*>(data);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      detail::ObjPoolFree(tptr, kSizeClass);
+    }
+  };
+};
+
+/*!
+ * \brief Select the allocator used by make_object for T.
+ *
+ *  The deleter is recorded in each object, so objects of the same type
+ *  created by different allocators can coexist.
+ */
+template <typename T>
+struct ObjAllocatorSelector {
+#if TVM_POOLED_OBJ_ALLOC
+  static constexpr bool kPooled = T::_type_pooled_alloc && sizeof(T) <= detail::kObjPoolMaxBytes &&
+                                  alignof(T) <= detail::kObjPoolGranularity;
+#else
+  static constexpr bool kPooled = false;
+#endif
+  using Type = typename std::conditional<kPooled, PooledObjAllocator, SimpleObjAllocator>::type;
+};
+
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
-  return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
+  using Allocator = typename ObjAllocatorSelector<T>::Type;
+  return Allocator().template make_object<T>(std::forward<Args>(args)...);
 }
 
 template <typename ArrayType, typename ElemType, typename... Args>
@@ -32,6 +32,7 @@
 #include <tvm/runtime/memory.h>
 #include <tvm/runtime/object.h>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -191,7 +192,7 @@ class TVM_DLL ModuleNode : public Object {
   const PackedFunc* GetFuncFromEnv(const std::string& name);
 
   /*! \brief Clear all imports of the module. */
-  void ClearImports() { imports_.clear(); }
+  void ClearImports();
 
   /*! \return The module it imports from */
   const std::vector<Module>& imports() const { return imports_; }
@@ -237,8 +238,45 @@ class TVM_DLL ModuleNode : public Object {
   std::vector<Module> imports_;
 
  private:
-  /*! \brief Cache used by GetImport */
-  std::unordered_map<std::string, std::shared_ptr<PackedFunc>> import_cache_;
+  /*!
+   * \brief A lookup result of GetFuncFromEnv, a null func records a function that is not
+   *  provided by the imports. Entries are only freed together with the module.
+   */
+  struct ImportCacheEntry {
+    std::string name;
+    std::shared_ptr<PackedFunc> func;
+  };
+  /*!
+   * \brief Open addressing hash table of the cached entries. Slots are only ever filled, under
+   *  mutex_, so GetFuncFromEnv can probe the table without locking.
+   */
+  struct ImportCacheTable {
+    explicit ImportCacheTable(size_t capacity);
+    /*! \brief The number of slots, a power of two. */
+    size_t capacity;
+    /*! \brief The number of filled slots, guarded by mutex_. */
+    size_t size{0};
+    std::unique_ptr<std::atomic<const ImportCacheEntry*>[]> slots;
+  };
+  /*!
+   * \brief Add an entry to the current table, growing it when it is half full.
+   *  Must be called with mutex_ held.
+   */
+  void InsertImportCache(const ImportCacheEntry* entry);
+  /*!
+   * \brief Replace the current table with a new one of the given capacity holding its entries,
+   *  without the recorded misses unless keep_misses is set. Must be called with mutex_ held.
+   */
+  void RebuildImportCache(size_t capacity, bool keep_misses);
+  /*! \brief Storage of all entries ever cached, so that returned pointers stay valid. */
+  std::vector<std::unique_ptr<ImportCacheEntry>> import_cache_entries_;
+  /*! \brief The current table, read without locking by GetFuncFromEnv */
+  std::atomic<ImportCacheTable*> import_cache_{nullptr};
+  /*!
+   * \brief All tables, as concurrent readers may still probe a replaced one they are released
+   *  together with the module. Tables double in size, so this stays linear in the entries.
+   */
+  std::vector<std::unique_ptr<ImportCacheTable>> import_cache_tables_;
   std::mutex mutex_;
 };
 
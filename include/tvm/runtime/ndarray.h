@@ -128,9 +128,20 @@ class NDArray : public ObjectRef {
    * \brief Create a NDArray that shares the data memory with the current one.
    * \param shape The shape of the new array.
    * \param dtype The data type of the new array.
-   * \note The memory size of new array must be smaller than the current one.
+   * \param relative_byte_offset The byte offset of the view relative to the current one.
+   * \note The memory size of new array plus the offset must not exceed the current one.
    */
-  TVM_DLL NDArray CreateView(ShapeTuple shape, DLDataType dtype);
+  TVM_DLL NDArray CreateView(ShapeTuple shape, DLDataType dtype, uint64_t relative_byte_offset = 0);
+  /*!
+   * \brief Create a strided NDArray that shares the data memory with the current one.
+   * \param shape The shape of the new array.
+   * \param strides The strides of the new array, in number of elements.
+   * \param relative_byte_offset The byte offset of the view relative to the current one.
+   * \note The current array may itself be strided. Every element addressed by the view
+   *  must lie in the memory range spanned by the current array.
+   */
+  TVM_DLL NDArray CreateStridedView(ShapeTuple shape, ShapeTuple strides,
+                                    uint64_t relative_byte_offset = 0);
   /*!
    * \brief Create a reference view of NDArray that
    *  represents as DLManagedTensor.
@@ -277,6 +288,11 @@ class NDArray::ContainerBase {
    *  can be used used for shape data.
    */
   ShapeTuple shape_;
+  /*!
+   * \brief The strides container of strided views,
+   *  backs dl_tensor.strides when it is not nullptr.
+   */
+  ShapeTuple strides_;
 };
 
 /*!
@@ -112,6 +112,13 @@ struct TypeIndex {
  *       exceeds the _type_child_slots. A fallback mechanism to check global type table will be
  * used. Recommendation: set to false for optimal runtime speed if we know exact number of children.
  *
+ * The following field is optional.
+ *
+ * - _type_pooled_alloc:
+ *       Whether make_object allocates the object from the thread-local object pools
+ *       when TVM is built with TVM_POOLED_OBJ_ALLOC. Inherited by sub-classes.
+ *       Recommendation: set for small objects that are created and destroyed in bulk.
+ *
  * Two macros are used to declare helper functions in the object:
  * - Use TVM_DECLARE_BASE_OBJECT_INFO for object classes that can be sub-classed.
  * - Use TVM_DECLARE_FINAL_OBJECT_INFO for object classes that cannot be sub-classed.
@@ -232,6 +239,8 @@ class TVM_DLL Object {
   static constexpr bool _type_has_method_visit_attrs = true;
   static constexpr bool _type_has_method_sequal_reduce = false;
   static constexpr bool _type_has_method_shash_reduce = false;
+  // allocation strategy
+  static constexpr bool _type_pooled_alloc = false;
   // NOTE: the following field is not type index of Object
   // but was intended to be used by sub-classes as default value.
   // The type index of Object is TypeIndex::kRoot
@@ -149,6 +149,15 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param instrument The instrument function.
    */
   virtual void SetInstrument(PackedFunc instrument) = 0;
+  /*!
+   * \brief Create a new VM that shares the executable, devices, allocators and
+   *  constants of this VM, but has its own execution state.
+   *
+   * The two VMs can then invoke functions concurrently from different threads.
+   * \return The forked VM.
+   * \note The VM has to be initialized first.
+   */
+  virtual ObjectPtr<VirtualMachine> Fork() = 0;
   /*!
    * \brief Create a specific instance of VM.
    * \return Created VM
@@ -180,6 +189,18 @@ class VirtualMachine : public runtime::ModuleNode {
   std::vector<Device> devices;
 };
 
+/*!
+ * \brief Convert a function argument to the given device.
+ *
+ * DLTensor arguments are always copied into a new NDArray, NDArrays (also nested
+ * in arrays) are copied if they reside on another device.
+ * \param input The argument.
+ * \param dev The target device.
+ * \param alloc The allocator used for the copies.
+ * \return The converted argument.
+ */
+TVMRetValue ConvertArgToDevice(TVMArgValue input, Device dev, Allocator* alloc);
+
 }  // namespace relax_vm
 }  // namespace runtime
 }  // namespace tvm
@@ -706,6 +706,57 @@ TVM_DLL const Op& vectorlow();
  */
 TVM_DLL const Op& vectorcombine();
 
+/*!
+ * \brief Load a vector, reading only the lanes enabled by a mask.
+ *
+ *  VecType masked_load(Handle address_of(BufferLoad *op), BoolVec mask, VecType passthru) {
+ *    for (i = 0; i < lanes; ++i) {
+ *      ret[i] = mask[i] ? op->buffer[op->indices[0], ..., last_index[i]] : passthru[i];
+ *    }
+ *  }
+ *
+ *  The last index of the load is either a unit-stride ramp, or a vector
+ *  with one index per lane for a gather.  Disabled lanes never access
+ *  memory, so their indices may be out of bounds.
+ */
+TVM_DLL const Op& masked_load();
+
+/*!
+ * \brief Store a vector, writing only the lanes enabled by a mask.
+ *
+ *  void masked_store(Handle address_of(BufferLoad *op), VecType value, BoolVec mask) {
+ *    for (i = 0; i < lanes; ++i) {
+ *      if (mask[i]) op->buffer[op->indices[0], ..., last_index[i]] = value[i];
+ *    }
+ *  }
+ *
+ *  As for masked_load, the last index is either a unit-stride ramp or one
+ *  index per lane for a scatter.
+ */
+TVM_DLL const Op& masked_store();
+
+/*!
+ * \brief Reduce the lanes of a vector to a scalar sum.
+ *
+ *  Type vector_reduce_sum(VecType value) {
+ *    return value[0] + value[1] + ... + value[lanes - 1];
+ *  }
+ *
+ *  The lanes may be combined in any order, so floating point sums are
+ *  reassociated.
+ */
+TVM_DLL const Op& vector_reduce_sum();
+
+/*!
+ * \brief Reduce the lanes of a vector to their maximum.
+ */
+TVM_DLL const Op& vector_reduce_max();
+
+/*!
+ * \brief Reduce the lanes of a vector to their minimum.
+ */
+TVM_DLL const Op& vector_reduce_min();
+
 /*!
  * \brief atomic add instruction, corresponding e.g. to atomicAdd in CUDA
  */
@@ -332,6 +332,26 @@ constexpr const char* kIsGlobalFunc = "tir.is_global_func";
  */
 constexpr const char* kIsHostFunc = "tir.is_host_func";
 
+/*!
+ * \brief Mark the function as scheduled, by tuning or a default schedule,
+ *        so that default schedules leave it as it is.
+ *
+ * Type: Integer
+ */
+constexpr const char* kIsScheduled = "tir.is_scheduled";
+
+/*!
+ * \brief The index of the parameter through which the caller provides
+ *        the scratch memory of the function.
+ *
+ * StorageRewrite places the global allocations made at function scope into
+ * the buffer bound to that parameter, as far as they fit, instead of
+ * requesting them from TVMBackendAllocWorkspace on every call.
+ *
+ * Type: Integer
+ */
+constexpr const char* kWorkspaceParam = "tir.workspace_param";
+
 }  // namespace attr
 }  // namespace tir
 }  // namespace tvm
@@ -1413,6 +1413,8 @@ constexpr const char* reduce_scope = "reduce_scope";
 constexpr const char* pragma_auto_unroll_max_step = "pragma_auto_unroll_max_step";
 /*! \brief Pragma: unroll explicit */
 constexpr const char* pragma_unroll_explicit = "pragma_unroll_explicit";
+/*! \brief Pragma: software prefetch distance in loop iterations */
+constexpr const char* pragma_prefetch_distance = "pragma_prefetch_distance";
 /*! \brief Mark region is guarded by the pragma extension */
 constexpr const char* pragma_scope_prefix = "pragma_";
 /*! \brief Import C source or file into the final code gen module */
@@ -1548,6 +1550,20 @@ constexpr const char* script_parsing_detect_access = "tir.script_parsing_detect_
  */
 constexpr const char* pragma_loop_partition_hint = "pragma_loop_partition_hint";
 
+/*!
+ * \brief Mark a loop nest to be versioned by the LoopVersioning pass.
+ * \note The value is the integer factor that symbolic extents and buffer
+ *       offsets are specialized to in the fast version.
+ */
+constexpr const char* loop_versioning = "loop_versioning";
+
+/*!
+ * \brief Mark that, within the body, the buffer data variable (node) does
+ *        not overlap any other buffer marked the same way.
+ * \note Inserted by LoopVersioning under a runtime check.
+ */
+constexpr const char* buffer_noalias = "buffer_noalias";
+
 /*! \brief Mark the stage of a statement in the software pipeline */
 constexpr const char* software_pipeline_stage = "software_pipeline_stage";
 
@@ -114,6 +114,15 @@ TVM_DLL Pass LiftAttrScope(String attr_key);
  */
 TVM_DLL Pass LoopPartition();
 
+/*!
+ * \brief Version the loops annotated with attr::loop_versioning into a fast
+ *  version specialized under runtime-checked divisibility, alignment and
+ *  non-aliasing conditions, and the original loop as fallback.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass LoopVersioning();
+
 /*!
  * \brief Lower vectorization loops.
  *
@@ -147,6 +156,16 @@ TVM_DLL Pass InjectDoubleBuffer();
  */
 TVM_DLL Pass StorageRewrite();
 
+/*!
+ * \brief Insert software prefetches for strided reads in innermost CPU loops.
+ *
+ *  The prefetch distance comes from `pragma_prefetch_distance` or from the
+ *  "tir.InjectSoftwarePrefetch" pass config.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSoftwarePrefetch();
+
 /*!
  * \brief unroll the constant loop marked by unroll.
  * This pass also automatically attach pragma unroll tag to loops which meets the standard.
@@ -642,6 +661,10 @@ TVM_DLL Pass UnifiedStaticMemoryPlanner();
  * should be executed in advance of block C by one iteration. The order 0 and 1 specifies the order
  * of block B and C inside the body block inside the result TIR.
  *
+ * On CPU targets the same annotations pipeline producers such as packing or cache_read blocks
+ * ahead of the compute blocks, with their buffers multi-versioned as above. CPUs have no
+ * asynchronous copies, so `software_pipeline_async_stages` is ignored there.
+ *
  * \return The IR transform pass.
  */
 TVM_DLL Pass InjectSoftwarePipeline();
@@ -717,6 +740,26 @@ TVM_DLL Pass ManifestSharedMemoryLocalStage();
  */
 TVM_DLL Pass InstrumentProfileIntrinsics();
 
+/*!
+ * \brief Insert calls that record loop trip counts and branch outcomes at runtime.
+ *
+ *  The recorded counts can be dumped with tvm.runtime.profiling.dump_loop_profile
+ *  and passed back to a later build through the tir.ApplyLoopProfile config.
+ * \return The pass.
+ */
+TVM_DLL Pass InstrumentLoopCounts();
+
+/*!
+ * \brief Use a recorded loop profile to guide unrolling and loop partitioning.
+ *
+ *  Hot innermost loops with small constant extents are unrolled, loops that never
+ *  ran are kept rolled, and strongly biased branches are marked as likely so that
+ *  LoopPartition can split the loops around them.  The pass is a no-op unless the
+ *  profile path is set in the tir.ApplyLoopProfile config.
+ * \return The pass.
+ */
+TVM_DLL Pass ApplyLoopProfile();
+
 /*!
  * \brief The pass sets default thread bindings for PrimFuncs, including symbolic shape functions,
  *  allowing their build and execution on GPU devices. It examines all the blocks within the
@@ -729,6 +772,18 @@ TVM_DLL Pass InstrumentProfileIntrinsics();
  */
 TVM_DLL Pass DefaultGPUSchedule();
 
+/*!
+ * \brief The pass schedules the blocks of PrimFuncs for CPU with heuristics, so that untuned
+ *  kernels do not run as naive loop nests. Blocks with a loop nest of their own get cache
+ *  blocking tiles for matmul-like reductions, a vectorized innermost spatial loop, parallel
+ *  outer spatial loops and auto unrolling. The cache and vector sizes come from the
+ *  "tir.DefaultCPUSchedule" pass config.
+ * \note Functions marked with tir::attr::kIsScheduled are left as they are, and the scheduled
+ *  functions are marked. The pass is only working for LLVM targets.
+ * \return The Pass.
+ */
+TVM_DLL Pass DefaultCPUSchedule();
+
 }  // namespace transform
 }  // namespace tir
 }  // namespace tvm
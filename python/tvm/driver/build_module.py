@@ -20,6 +20,7 @@
 from typing import Union, Optional, List, Mapping
 
 import warnings
+from contextlib import nullcontext
 
 import tvm.tir
 
@@ -221,29 +222,36 @@ def build(
     ----
     See the note on :any:`tvm.target` on target string format.
     """
-    if isinstance(inputs, te.Schedule):
-        if args is None:
-            raise ValueError("args must be given for build from schedule")
-        input_mod = lower(inputs, args, name=name, binds=binds)
-    elif isinstance(inputs, (list, tuple, container.Array)):
-        merged_mod = tvm.IRModule({})
-        for x in inputs:
-            merged_mod.update(lower(x))
-        input_mod = merged_mod
-    elif isinstance(inputs, PrimFunc):
-        input_mod = lower(inputs, name=name)
-    elif isinstance(inputs, tvm.IRModule):
-        input_mod = lower(inputs)
-    elif not isinstance(inputs, (dict, container.Map)):
-        raise ValueError(
-            f"Inputs must be te.Schedule, IRModule, PrimFunc, "
-            f"or dict of target to IRModule, "
-            f"but got {type(inputs)}."
-        )
-
+    lower_scope = nullcontext()
     if not isinstance(inputs, (dict, container.Map)):
         target = Target.current() if target is None else target
         target = target if target else "llvm"
+        # Lower within the scope of the build target, so that the target dependent
+        # lowering passes also apply to functions without a target attribute.
+        lower_scope = Target(target)
+
+    with lower_scope:
+        if isinstance(inputs, te.Schedule):
+            if args is None:
+                raise ValueError("args must be given for build from schedule")
+            input_mod = lower(inputs, args, name=name, binds=binds)
+        elif isinstance(inputs, (list, tuple, container.Array)):
+            merged_mod = tvm.IRModule({})
+            for x in inputs:
+                merged_mod.update(lower(x))
+            input_mod = merged_mod
+        elif isinstance(inputs, PrimFunc):
+            input_mod = lower(inputs, name=name)
+        elif isinstance(inputs, tvm.IRModule):
+            input_mod = lower(inputs)
+        elif not isinstance(inputs, (dict, container.Map)):
+            raise ValueError(
+                f"Inputs must be te.Schedule, IRModule, PrimFunc, "
+                f"or dict of target to IRModule, "
+                f"but got {type(inputs)}."
+            )
+
+    if not isinstance(inputs, (dict, container.Map)):
         target_input_mod = {target: input_mod}
     else:
         target_input_mod = inputs
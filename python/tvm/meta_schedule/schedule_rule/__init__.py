@@ -20,6 +20,7 @@ Meta Schedule schedule rules are used for modification of
 blocks in a schedule. See also PostOrderApply.
 """
 from .add_rfactor import AddRFactor
+from .add_software_prefetch import AddSoftwarePrefetch
 from .apply_custom_rule import ApplyCustomRule
 from .auto_bind import AutoBind
 from .auto_inline import AutoInline, InlineConstantScalars
@@ -29,6 +30,7 @@ from .multi_level_tiling import (
     MultiLevelTilingTensorCore,
     MultiLevelTilingWideVector,
     MultiLevelTilingWithIntrin,
+    MultiLevelTilingWithPacking,
     ReuseType,
 )
 from .parallel_vectorize_unroll import ParallelizeVectorizeUnroll
@@ -0,0 +1,43 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Rule that samples a software prefetch distance and marks it on the root block"""
+from typing import List, Optional
+
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from .schedule_rule import ScheduleRule
+
+
+@register_object("meta_schedule.AddSoftwarePrefetch")
+class AddSoftwarePrefetch(ScheduleRule):
+    """Rule that samples a software prefetch distance and marks it on the root block. The
+    distance is used by the InjectSoftwarePrefetch pass for the strided reads of innermost loops.
+
+    Parameters
+    ----------
+    prefetch_distances: Optional[List[int]]
+        The candidate prefetch distances in loop iterations. 0 disables prefetching.
+    """
+
+    def __init__(self, prefetch_distances: Optional[List[int]] = None) -> None:
+        if prefetch_distances is None:
+            prefetch_distances = [0, 4, 8, 16]
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleAddSoftwarePrefetch,  # type: ignore # pylint: disable=no-member
+            prefetch_distances,
+        )
@@ -232,3 +232,33 @@ class MultiLevelTilingWideVector(ScheduleRule):
             reuse_read.as_dict() if reuse_read is not None else None,
             reuse_write.as_dict() if reuse_write is not None else None,
         )
+
+
+@register_object("meta_schedule.MultiLevelTilingWithPacking")
+class MultiLevelTilingWithPacking(ScheduleRule):
+    """Extension of MultiLevelTiling for CPUs that packs every read operand into a contiguous
+    buffer under the outermost reduction tile. Each design space is generated with and without a
+    software pipeline that runs the packing one iteration ahead of the computation.
+
+    Parameters
+    ----------
+    structure : str
+        The tiling structure. 'SSRSRS' is recommended.
+    max_innermost_factor : Optional[int]
+        The maximum size of the innermost factor. None means no limit
+    reuse_write : Optional[ReuseType]
+        Data reuse configuration for writing. None means no reuse.
+    """
+
+    def __init__(
+        self,
+        structure: str = "SSRSRS",
+        max_innermost_factor: Optional[int] = None,
+        reuse_write: Optional[ReuseType] = None,
+    ) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleMultiLevelTilingWithPacking,  # type: ignore # pylint: disable=no-member
+            structure,
+            max_innermost_factor,
+            reuse_write.as_dict() if reuse_write is not None else None,
+        )
@@ -118,6 +118,23 @@ def _check_matmul(
     return is_shape_valid_for_cutlass_matmul(lhs_shape, rhs_shape)
 
 
+def _check_attention(
+    match_result: Mapping[DFPattern, Expr],
+    _: Expr,
+) -> bool:
+    """Check if the given attention workload can be offloaded to CUTLASS."""
+
+    attention_call = _find_call("relax.nn.attention", match_result)
+    if attention_call is None:
+        attention_call = _find_call("relax.nn.attention_bias", match_result)
+    if attention_call is None:
+        return False
+
+    # The CUTLASS kernel always uses the default scale and has no causal mask.
+    attrs = attention_call.attrs
+    return attrs is None or (attrs.scale is None and attrs.causal_mask is None)
+
+
 def _get_activation_from_name(pattern_name):
     if "_relu" in pattern_name:
         return "relax.nn.relu"
@@ -218,10 +235,12 @@ def attention_patterns():
         (
             "cutlass.attention",
             *make_attention_pattern(),
+            _check_attention,
         ),
         (
             "cutlass.attention_bias",
             *make_attention_pattern(with_bias=True),
+            _check_attention,
         ),
     ]
 
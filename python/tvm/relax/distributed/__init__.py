@@ -19,3 +19,5 @@
 
 from .global_info import DeviceMesh, device_mesh
 from .struct_info import Placement, DTensorStructInfo, PlacementSpec
+from . import transform
+from .executor import ShardedExecutor
@@ -0,0 +1,309 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Run a sharded relax program on local worker processes.
+
+Each worker is a separate process running a relax VM on its shard of the data. The
+workers exchange data through the shared memory collectives of the relax VM
+(``vm.builtin.ccl.*``), so no network is needed.
+"""
+import multiprocessing
+import multiprocessing.connection
+import os
+import shutil
+import tempfile
+import traceback
+import uuid
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+import tvm
+from tvm.ir import IRModule
+
+from .transform import LowerDistIR
+
+
+def _worker_main(
+    rank: int,
+    num_workers: int,
+    lib_path: str,
+    shm_name: str,
+    cpus: Optional[List[int]],
+    conn: multiprocessing.connection.Connection,
+) -> None:
+    """The loop of one worker process."""
+    if cpus:
+        os.sched_setaffinity(0, cpus)  # pylint: disable=no-member
+        # the thread pool is created at the first parallel call and reads the variable then.
+        os.environ["TVM_NUM_THREADS"] = str(len(cpus))
+    try:
+        # pylint: disable=import-outside-toplevel
+        from tvm import relax
+
+        tvm.get_global_func("runtime.ccl.shm_init")(shm_name, rank, num_workers)
+        vm = relax.VirtualMachine(tvm.runtime.load_module(lib_path), tvm.cpu())
+        conn.send(("ok", None))
+    except Exception:  # pylint: disable=broad-except
+        conn.send(("error", traceback.format_exc()))
+        return
+
+    while True:
+        msg = conn.recv()
+        if msg[0] == "exit":
+            break
+        kind, func_name, args = msg[:3]
+        try:
+            args = [tvm.nd.array(arg) for arg in args]
+            if kind == "time":
+                number, repeat = msg[3:]
+                timer = vm.time_evaluator(func_name, tvm.cpu(), number=number, repeat=repeat)
+                conn.send(("ok", timer(*args).mean))
+                continue
+            out = vm[func_name](*args)
+            if isinstance(out, tvm.nd.NDArray):
+                conn.send(("ok", out.numpy()))
+            else:
+                conn.send(("ok", tuple(field.numpy() for field in out)))
+        except Exception:  # pylint: disable=broad-except
+            conn.send(("error", traceback.format_exc()))
+    tvm.get_global_func("runtime.ccl.shutdown")()
+
+
+def _split_cpus(num_workers: int) -> List[Optional[List[int]]]:
+    """Split the available CPUs in contiguous groups, one per worker."""
+    if not hasattr(os, "sched_getaffinity"):
+        return [None] * num_workers
+    cpus = sorted(os.sched_getaffinity(0))  # pylint: disable=no-member
+    if len(cpus) < num_workers:
+        return [None] * num_workers
+    per_worker = len(cpus) // num_workers
+    return [cpus[i * per_worker : (i + 1) * per_worker] for i in range(num_workers)]
+
+
+class ShardedExecutor:
+    """Executor of a relax module over distributed tensors on local worker processes.
+
+    The module is lowered with :py:func:`LowerDistIR`, built once, and loaded by one
+    worker process per device of the mesh. Calling a function splits each sharded
+    argument among the workers and assembles the sharded results.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The module whose functions take and return distributed tensors.
+
+    target : Union[str, tvm.target.Target]
+        The target to build for. Only CPU targets are supported.
+
+    capacity_bytes : int
+        The largest tensor, in bytes, a worker can pass to a collective.
+
+    cpu_affinity : bool
+        Whether to pin each worker to its own group of CPUs, so that workers
+        placed on different sockets use their local memory.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        with ShardedExecutor(mod, "llvm") as executor:
+            out = executor["main"](x_np, w_np)
+    """
+
+    def __init__(
+        self,
+        mod: IRModule,
+        target="llvm",
+        capacity_bytes: int = 64 << 20,
+        cpu_affinity: bool = True,
+    ) -> None:
+        # pylint: disable=import-outside-toplevel
+        from tvm import relax
+
+        mod = LowerDistIR()(mod)
+        self._signatures: Dict[str, Tuple[List[int], List[int]]] = {}
+        num_workers = None
+        for gvar, func in mod.functions.items():
+            if not isinstance(func, relax.Function) or func.attrs is None:
+                continue
+            if "num_workers" not in func.attrs:
+                continue
+            if num_workers is not None and num_workers != int(func.attrs["num_workers"]):
+                raise ValueError("All the functions must use device meshes of the same size")
+            num_workers = int(func.attrs["num_workers"])
+            self._signatures[gvar.name_hint] = (
+                [int(axis) for axis in func.attrs["dist_param_axes"]],
+                [int(axis) for axis in func.attrs["dist_ret_axes"]],
+            )
+        if num_workers is None:
+            raise ValueError("The module has no function over distributed tensors")
+        self.num_workers = num_workers
+
+        self._workers: List[multiprocessing.Process] = []
+        self._conns: List[multiprocessing.connection.Connection] = []
+        self._tmp_dir = tempfile.mkdtemp(prefix="tvm_sharded_")
+        self._shm_name = None
+        try:
+            lib_path = os.path.join(self._tmp_dir, "lib.so")
+            relax.build(mod, target).export_library(lib_path)
+            shm_name = f"/tvm_ccl_{os.getpid()}_{uuid.uuid4().hex[:8]}"
+            tvm.get_global_func("runtime.ccl.shm_create")(shm_name, num_workers, capacity_bytes)
+            self._shm_name = shm_name
+
+            cpus = _split_cpus(num_workers) if cpu_affinity else [None] * num_workers
+            ctx = multiprocessing.get_context("spawn")
+            for rank in range(num_workers):
+                parent_conn, child_conn = ctx.Pipe()
+                proc = ctx.Process(
+                    target=_worker_main,
+                    args=(rank, num_workers, lib_path, shm_name, cpus[rank], child_conn),
+                    daemon=True,
+                )
+                proc.start()
+                self._workers.append(proc)
+                self._conns.append(parent_conn)
+            self._gather()
+        except Exception:
+            self.close(terminate=True)
+            raise
+
+    def __getitem__(self, func_name: str):
+        if func_name not in self._signatures:
+            raise KeyError(f"{func_name} is not a function over distributed tensors")
+        return lambda *args: self.run(func_name, *args)
+
+    def run(self, func_name: str, *args: Any) -> Any:
+        """Call a function with the full, unsharded, arguments.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : List[Union[numpy.ndarray, tvm.nd.NDArray]]
+            The arguments, each of them holding the full tensor.
+
+        Returns
+        -------
+        ret : Union[numpy.ndarray, Tuple[numpy.ndarray]]
+            The results, assembled from the shards held by the workers.
+        """
+        _, ret_axes = self._signatures[func_name]
+        for conn, shard_args in zip(self._conns, self._shard_args(func_name, args)):
+            conn.send(("run", func_name, shard_args))
+        outs = self._gather()
+        fields = [out if isinstance(out, tuple) else (out,) for out in outs]
+        ret = tuple(
+            fields[0][i]
+            if axis == -1
+            else np.concatenate([field[i] for field in fields], axis=axis)
+            for i, axis in enumerate(ret_axes)
+        )
+        return ret if isinstance(outs[0], tuple) else ret[0]
+
+    def time_evaluator(
+        self, func_name: str, *args: Any, number: int = 10, repeat: int = 1
+    ) -> float:
+        """Measure a function on the workers, without the cost of sending the arguments.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : List[Union[numpy.ndarray, tvm.nd.NDArray]]
+            The arguments, each of them holding the full tensor.
+
+        number : int
+            The number of calls averaged in one measurement.
+
+        repeat : int
+            The number of measurements.
+
+        Returns
+        -------
+        mean : float
+            The mean time of one call in seconds, on the slowest worker.
+        """
+        for conn, shard_args in zip(self._conns, self._shard_args(func_name, args)):
+            conn.send(("time", func_name, shard_args, number, repeat))
+        return max(self._gather())
+
+    def _shard_args(self, func_name: str, args: Sequence[Any]) -> List[List[np.ndarray]]:
+        """Split the arguments among the workers."""
+        param_axes, _ = self._signatures[func_name]
+        if len(args) != len(param_axes):
+            raise ValueError(f"{func_name} expects {len(param_axes)} arguments, got {len(args)}")
+        worker_args: List[List[np.ndarray]] = [[] for _ in range(self.num_workers)]
+        for arg, axis in zip(args, param_axes):
+            arg = arg.numpy() if isinstance(arg, tvm.nd.NDArray) else np.asarray(arg)
+            shards = (
+                [arg] * self.num_workers
+                if axis == -1
+                else np.split(arg, self.num_workers, axis=axis)
+            )
+            for rank, shard in enumerate(shards):
+                worker_args[rank].append(shard)
+        return worker_args
+
+    def _gather(self) -> List[Any]:
+        """Wait for the reply of every worker."""
+        results: List[Any] = [None] * self.num_workers
+        pending = dict(zip(self._conns, range(self.num_workers)))
+        while pending:
+            for conn in multiprocessing.connection.wait(list(pending)):
+                rank = pending.pop(conn)
+                try:
+                    status, value = conn.recv()
+                except EOFError:
+                    status, value = "error", "the worker process exited"
+                if status == "error":
+                    # the other workers may wait in a collective for this one forever.
+                    self.close(terminate=True)
+                    raise RuntimeError(f"worker {rank} failed:\n{value}")
+                results[rank] = value
+        return results
+
+    def close(self, terminate: bool = False) -> None:
+        """Stop the workers and release the shared memory."""
+        for conn, proc in zip(self._conns, self._workers):
+            if terminate:
+                proc.terminate()
+            elif proc.is_alive():
+                try:
+                    conn.send(("exit",))
+                except (BrokenPipeError, OSError):
+                    proc.terminate()
+        for proc in self._workers:
+            proc.join()
+        self._workers, self._conns = [], []
+        if self._shm_name is not None:
+            tvm.get_global_func("runtime.ccl.shm_unlink")(self._shm_name)
+            self._shm_name = None
+        if self._tmp_dir is not None:
+            shutil.rmtree(self._tmp_dir, ignore_errors=True)
+            self._tmp_dir = None
+
+    def __enter__(self) -> "ShardedExecutor":
+        return self
+
+    def __exit__(self, *exc: Sequence[Any]) -> None:
+        self.close()
+
+    def __del__(self) -> None:
+        if getattr(self, "_tmp_dir", None) is not None:
+            self.close()
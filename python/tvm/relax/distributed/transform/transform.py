@@ -0,0 +1,45 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Relax distributed transformation passes."""
+import tvm.ir
+
+from . import _ffi_api
+
+
+def LowerDistIR() -> tvm.ir.transform.Pass:
+    """Lower the functions over distributed tensors to the program run by each worker.
+
+    Distributed tensors become the local shard held by a worker and call_tir
+    callees operate on the local shards. ``R.dist.redistribute`` and
+    ``R.dist.allreduce`` become calls to the ``vm.builtin.ccl`` collectives.
+    Only one-dimensional device meshes are supported.
+
+    Callees with static buffer shapes are cloned with the shapes of the local
+    shards, dividing the loops over the sharded axes among the workers. The
+    sharded axes of such callees must be indexed directly by an iterator over
+    the whole axis.
+
+    The lowered functions carry the ``num_workers``, ``dist_param_axes`` and
+    ``dist_ret_axes`` attributes, the latter two giving the sharded axis of each
+    parameter and of each returned tensor, or -1 if replicated.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+        The registered pass.
+    """
+    return _ffi_api.LowerDistIR()  # type: ignore
@@ -0,0 +1,71 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Distributed operators."""
+from typing import Union
+
+from . import _ffi_api
+from ...expr import Expr
+
+
+def redistribute(
+    x: Expr,
+    device_mesh: "tvm.relax.distributed.DeviceMesh",
+    placement: Union["tvm.relax.distributed.Placement", str],
+) -> Expr:
+    """Change the placement of a distributed tensor.
+
+    Parameters
+    ----------
+    x : relax.Expr
+        The input distributed tensor.
+
+    device_mesh : DeviceMesh
+        The device mesh of the result.
+
+    placement : Union[Placement, str]
+        The placement of the result among the device mesh.
+
+    Returns
+    -------
+    result : relax.Expr
+        The redistributed tensor.
+    """
+    if isinstance(placement, str):
+        # pylint: disable=import-outside-toplevel
+        from ...distributed import Placement
+
+        placement = Placement.from_text(placement)
+    return _ffi_api.redistribute(x, device_mesh, placement)  # type: ignore
+
+
+def allreduce(x: Expr) -> Expr:
+    """Sum the local values of a distributed tensor over its device mesh.
+
+    Each device holds a partial sum of the full tensor, for example the output of
+    a matmul whose reduction axis is sharded, and the input is declared replicated.
+
+    Parameters
+    ----------
+    x : relax.Expr
+        The input distributed tensor.
+
+    Returns
+    -------
+    result : relax.Expr
+        The replicated sum.
+    """
+    return _ffi_api.allreduce(x)  # type: ignore
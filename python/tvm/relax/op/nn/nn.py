@@ -18,6 +18,7 @@
 from typing import List, Optional, Tuple, Union
 
 from tvm import DataType
+from tvm.tir import FloatImm
 
 from . import _ffi_api
 from ...expr import Expr
@@ -868,13 +869,20 @@ def nll_loss(
     return _ffi_api.nll_loss(predictions, targets, weights, reduction, ignore_index)  # type: ignore
 
 
-def attention(query: Expr, key: Expr, value: Expr, bias: Optional[Expr] = None) -> Expr:
+def attention(
+    query: Expr,
+    key: Expr,
+    value: Expr,
+    bias: Optional[Expr] = None,
+    scale: Optional[FloatImm] = None,
+    causal_mask: Optional[str] = None,
+) -> Expr:
     r"""Computes fused multi head attention.
 
     All input tensors are of 4-D tensors with BSNH layout.
 
     .. math::
-        FMA(Q, K, V) = \text{Softmax}(Q @ K^T) @ V
+        FMA(Q, K, V) = \text{Softmax}(Q @ K^T * scale + bias) @ V
 
     .. note::
         The input tensor is required to have float16 dtype
@@ -898,10 +906,21 @@ def attention(query: Expr, key: Expr, value: Expr, bias: Optional[Expr] = None)
         (batch_size, num_head, seq_len, seq_len_kv),
         (batch_size, seq_len, seq_len_kv) or (batch_size, seq_len_kv).
 
+    scale: Optional[FloatImm]
+        The scale value to be applied to the attention score, by default 1 / sqrt(head_dim).
+
+    causal_mask: Optional[str]
+        The optional causal mask, i.e. 'TopLeft' and 'BottomRight'.
+        For 'TopLeft', the query at position i attends to the keys at positions [0, i].
+        For 'BottomRight', the query at position i attends to the keys at positions
+        [0, i + seq_len_kv - seq_len], which aligns the last query with the last key.
+
     Returns
     -------
     result : relax.Expr
         The computed result. The layout of the output should be
         (batch_size, seq_len, num_head, head_dim_v).
     """
-    return _ffi_api.attention(query, key, value, bias)  # type: ignore
+    if scale is not None and not isinstance(scale, FloatImm):
+        scale = FloatImm("float32", scale)
+    return _ffi_api.attention(query, key, value, bias, scale, causal_mask)  # type: ignore
@@ -89,6 +89,11 @@ class DropoutAttrs(Attrs):
     """Attributes for dropout operator"""
 
 
+@tvm._ffi.register_object("relax.attrs.AttentionAttrs")
+class AttentionAttrs(Attrs):
+    """Attributes used in attention operator"""
+
+
 @tvm._ffi.register_object("relax.attrs.StatisticalAttrs")
 class StatisticalAttrs(Attrs):
     """Attributes used in statistical operator"""
@@ -147,3 +152,8 @@ class TileAttrs(Attrs):
 @tvm._ffi.register_object("relax.attrs.CumsumAttrs")
 class CumsumAttrs(Attrs):
     """Attributes for cumsum operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.DistributionAttrs")
+class DistributionAttrs(Attrs):
+    """Attributes for redistribute operator"""
@@ -55,6 +55,10 @@ def zero_pipeline(mod: tvm.ir.IRModule, ctx: tvm.transform.PassContext) -> tvm.i
     mod = seq(mod)
     if ms.Database.current():
         mod = transform.MetaScheduleApplyDatabase()(mod)
+    target = tvm.target.Target.current(allow_none=True)
+    if target is not None and target.kind.name == "llvm":
+        # untuned kernels get a default schedule rather than running as naive loop nests.
+        mod = tvm.tir.transform.DefaultCPUSchedule()(mod)
     return mod
 
 
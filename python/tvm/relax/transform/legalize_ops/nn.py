@@ -18,6 +18,7 @@
 """Default legalization function for neural network operators."""
 import logging
 
+import tvm
 from tvm import topi, tir, te
 from ...block_builder import BlockBuilder
 from ...expr import Call, Expr
@@ -272,6 +273,40 @@ def _nn_group_norm(bb: BlockBuilder, call: Call) -> Expr:
     )
 
 
+@register_legalize("relax.nn.attention")
+def _nn_attention(bb: BlockBuilder, call: Call) -> Expr:
+    # "flash" streams keys and values through a tiled online softmax and never materializes
+    # the score matrix; "naive" is the plain matmul-softmax-matmul composition. "auto" picks
+    # the flash kernel unless the current target is a GPU, where its serial inner loops have
+    # no thread bindings.
+    impl = tvm.transform.PassContext.current().config.get(
+        "relax.LegalizeOps.attention_impl", "auto"
+    )
+    if impl == "auto":
+        target = tvm.target.Target.current(allow_none=True)
+        impl = "naive" if target is not None and "gpu" in target.keys else "flash"
+    if impl not in ("flash", "naive"):
+        raise ValueError(
+            f"Unsupported attention implementation {impl}, expected 'auto', 'flash' or 'naive'"
+        )
+
+    te_func = topi.nn.flash_attention if impl == "flash" else topi.nn.attention
+    bias = call.args[3] if len(call.args) == 4 else None
+    return bb.call_te(
+        te_func,
+        call.args[0],
+        call.args[1],
+        call.args[2],
+        bias,
+        scale=call.attrs.scale,
+        causal_mask=call.attrs.causal_mask,
+        primfunc_name_hint=f"{impl}_attention",
+    )
+
+
+register_legalize("relax.nn.attention_bias", _nn_attention)
+
+
 @register_legalize("relax.nn.dropout")
 def _nn_dropout(bb: BlockBuilder, call: Call) -> Expr:
     logging.info("Dropout is handled by frontend translator at this moment and is not legalized.")
@@ -115,6 +115,48 @@ def RewriteDataflowReshape() -> tvm.ir.transform.Pass:
     return _ffi_api.RewriteDataflowReshape()  # type: ignore
 
 
+def UseStridedViews() -> tvm.ir.transform.Pass:
+    """Rewrite permute_dims, strided_slice and split whose results only feed
+    call_tir into VM builtin calls that create strided views of their input,
+    instead of copying the data.
+
+    A view is only created when every consuming PrimFunc binds the argument
+    with strides and an elem_offset the view satisfies. Kernels accept views
+    by declaring symbolic buffer strides and elem_offset, for example
+    ``T.match_buffer(x, (m, n), strides=(s0, s1), elem_offset=offset)``.
+    Kernels produced by LegalizeOps declare compact buffers, so in practice
+    only hand-written call_tir kernels with symbolic strides benefit.
+
+    The view layout is derived assuming the input is compact, so no view is
+    created from another view or from the result of a packed function.
+
+    This pass has to run before LegalizeOps and operator fusion.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+    """
+    return _ffi_api.UseStridedViews()  # type: ignore
+
+
+def AllocateWorkspace() -> tvm.ir.transform.Pass:
+    """Hoist the global intermediate buffers of the PrimFuncs called through
+    call_tir into a workspace argument, which each calling function allocates
+    once and shares between the kernels it calls.
+
+    The workspace is sized by the largest need over all kernels. It is appended
+    to the call_tir inputs, and StorageRewrite places the intermediate buffers
+    of the kernel into it instead of requesting them on every call.
+
+    This pass has to run before CallTIRRewrite.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+    """
+    return _ffi_api.AllocateWorkspace()  # type: ignore
+
+
 def StaticPlanBlockMemory() -> tvm.ir.transform.Pass:
     """The static memory planning pass on BindingBlock level.
     The pass will reuse allocated memory to its best effort, in order to
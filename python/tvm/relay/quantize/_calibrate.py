@@ -30,7 +30,6 @@ from .. import expr as _expr
 from .. import analysis as _analysis
 from .. import build_module as _build_module
 from ...contrib import graph_executor
-from .kl_divergence import _find_scale_by_kl
 
 
 def _get_profile_runtime(mod):
@@ -90,14 +89,68 @@ def collect_stats(mod, dataset, chunk_by=-1):
         yield [np.concatenate(output).reshape(-1) for output in outputs]
 
 
+def collect_histograms(mod, dataset, num_bins=8001):
+    """Given an annotated graph, accumulate the histogram of every simulated_quantize
+    input over the calibration dataset without copying the outputs to Python.
+
+    The dataset is traversed twice, once for the value ranges and once for the
+    histograms, so a one-shot iterator such as a generator is materialized first.
+    The statistics are accumulated by C++ builtins, in parallel across layers.
+
+    Parameters
+    ----------
+    mod: Module
+        The simulation graph after annotation.
+
+    dataset: Iterable[NDArray]
+        The calibration dataset. A one-shot iterator keeps its inputs in memory.
+
+    num_bins: int
+        The number of histogram bins.
+
+    Returns
+    -------
+    ret: Tuple[NDArray, NDArray]
+        The int64 histograms of shape (num_layers, num_bins) and the float32
+        thresholds of shape (num_layers,). Histogram j covers [-thres[j], thres[j]].
+    """
+    logging.info("collecting histograms for calibration...")
+    if iter(dataset) is dataset:
+        dataset = list(dataset)
+    runtime = _get_profile_runtime(mod)
+    num_outputs = runtime.get_num_outputs()
+
+    def outputs(batch):
+        runtime.set_input(**batch)
+        runtime.run()
+        return [runtime.get_output(j) for j in range(num_outputs)]
+
+    min_max = np.empty((num_outputs, 2), "float32")
+    min_max[:, 0] = np.inf
+    min_max[:, 1] = -np.inf
+    min_max = tvm.nd.array(min_max)
+    for batch in dataset:
+        _quantize.AccumulateMinMax(outputs(batch), min_max)
+    thres = np.abs(min_max.numpy()).max(axis=1)
+    if not np.isfinite(thres).all():
+        raise ValueError(
+            "Calibration found non-finite activations in the layers %s"
+            % np.flatnonzero(~np.isfinite(thres)).tolist()
+        )
+    # Same as numpy.histogram, which widens an empty range to [-0.5, 0.5].
+    thres[thres == 0] = 0.5
+    thres = tvm.nd.array(thres.astype("float32"))
+
+    hists = tvm.nd.array(np.zeros((num_outputs, num_bins), "int64"))
+    for batch in dataset:
+        _quantize.AccumulateHistograms(outputs(batch), hists, thres)
+    return hists, thres
+
+
 def _kl_scale(mod, dataset):
-    cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with kl for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_kl, samples))
+    hists, thres = collect_histograms(mod, dataset)
+    logging.info("finding threshold with kl for calibration...")
+    scales = _quantize.FindScalesByKLMinimization(hists, thres, 255).numpy().tolist()
 
     def func(_):
         scale = scales[func.scale_idx]
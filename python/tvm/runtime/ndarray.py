@@ -281,6 +281,38 @@ class NDArray(NDArrayBase):
 
         return _ffi_api.TVMArrayCreateView(self, shape)
 
+    def _create_strided_view(self, shape, strides, byte_offset=0):
+        """Create a strided view into an existing array.
+
+        The view shares the same allocation and datatype as the existing
+        array, and addresses its elements with the given strides starting
+        at ``byte_offset`` bytes past the start of the array.
+
+        Warning: This function should not be used outside of low-level
+        manipulations, as it breaks non-aliasing assumptions made by TVM.
+
+        Parameters
+        ----------
+        shape: Union[tvm.runtime.ShapeTuple, Sequence[typing.SupportsInt]]
+
+            The shape of the view.
+
+        strides: Union[tvm.runtime.ShapeTuple, Sequence[typing.SupportsInt]]
+
+            The strides of the view, in number of elements.
+
+        byte_offset: int
+
+            The offset of the first element of the view, in bytes.
+        """
+
+        if not isinstance(shape, tvm.runtime.ShapeTuple):
+            shape = tvm.runtime.ShapeTuple([int(dim) for dim in shape])
+        if not isinstance(strides, tvm.runtime.ShapeTuple):
+            strides = tvm.runtime.ShapeTuple([int(stride) for stride in strides])
+
+        return _ffi_api.TVMArrayCreateStridedView(self, shape, strides, int(byte_offset))
+
 
 def device(dev_type, dev_id=0):
     """Construct a TVM device with given device type and id.
@@ -269,6 +269,46 @@ def profile_function(mod, dev, collectors, func_name=None, warmup_iters=10):
     )
 
 
+def dump_loop_profile(path: Optional[str] = None) -> str:
+    """Dump the loop trip counts and branch outcomes recorded so far.
+
+    Counts are recorded by code built with the ``tir.instrument_loop_counts``
+    config. The dumped profile is consumed by a later build through the
+    ``tir.ApplyLoopProfile`` config.
+
+    Example
+    -------
+
+    .. code-block: python
+        with tvm.transform.PassContext(config={"tir.instrument_loop_counts": True}):
+            f = tvm.build(my_func, target="llvm")
+        f(*args)
+        tvm.runtime.profiling.dump_loop_profile("loops.json")
+        with tvm.transform.PassContext(config={"tir.ApplyLoopProfile": {"profile": "loops.json"}}):
+            f = tvm.build(my_func, target="llvm")
+
+    Parameters
+    ----------
+    path: Optional[str]
+        File to write the profile to.
+
+    Returns
+    -------
+    profile: str
+        The profile in JSON format.
+    """
+    profile = _ffi_api.DumpLoopProfile()
+    if path is not None:
+        with open(path, "w") as f:
+            f.write(profile)
+    return profile
+
+
+def reset_loop_profile():
+    """Clear the loop trip counts and branch outcomes recorded so far."""
+    _ffi_api.ResetLoopProfile()
+
+
 # We only enable this class when TVM is build with PAPI support
 if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is not None:
 
@@ -18,6 +18,7 @@
 """The Relax virtual machine."""
 from typing import Callable, List, Optional, Union, Dict, Tuple, Any
 from enum import IntEnum
+import concurrent.futures
 import numpy as np  # type: ignore
 
 import tvm
@@ -506,3 +507,250 @@ class VirtualMachine(object):
 
         report_json = self.module["profile"](func_name, *cargs)
         return Report.from_json(report_json)
+
+
+class BatchScheduler(object):
+    """Continuous-batching request scheduler on top of a relax VM.
+
+    Requests join and leave the running batch at every step. Each step runs one
+    ragged prefill over the newly admitted prompts and one decode over the running
+    sequences. The VM functions must follow the convention, with b the batch size:
+
+    - ``prefill(input_ids: int32[num_tokens], indptr: int32[b + 1], slots: int32[b])``
+      returns the next token of each sequence, ``int32[b]`` or ``int64[b]``.
+    - ``decode(input_ids: int32[b], slots: int32[b])`` returns the next token of
+      each sequence.
+
+    A slot in ``[0, max_batch_size)`` identifies a sequence in the model state for
+    its whole lifetime. Slots are recycled, so prefill must reset the state of the
+    slots it receives.
+    """
+
+    def __init__(
+        self,
+        vm: VirtualMachine,
+        prefill_func: str = "prefill",
+        decode_func: str = "decode",
+        max_batch_size: int = 32,
+        max_num_tokens: int = 2048,
+    ) -> None:
+        """
+        Parameters
+        ----------
+        vm : VirtualMachine
+            The VM holding the compiled prefill and decode functions.
+
+        prefill_func : str
+            The name of the prefill function.
+
+        decode_func : str
+            The name of the decode function.
+
+        max_batch_size : int
+            The maximum number of sequences running at the same time.
+
+        max_num_tokens : int
+            The maximum number of tokens, prompts and decodes together, processed in one step.
+        """
+        self.module = tvm.get_global_func("relax.vm.BatchScheduler")(
+            vm.module, prefill_func, decode_func, max_batch_size, max_num_tokens
+        )
+        self._add_request = self.module["add_request"]
+        self._step = self.module["step"]
+        self._pop_finished = self.module["pop_finished"]
+        self._take_output = self.module["take_output"]
+        self._num_pending = self.module["num_pending"]
+        self._stats = self.module["stats"]
+
+    def add_request(
+        self, request_id: int, prompt: List[int], max_new_tokens: int, eos_token: int = -1
+    ) -> None:
+        """Queue a request.
+
+        Parameters
+        ----------
+        request_id : int
+            The unique id of the request.
+
+        prompt : List[int]
+            The prompt tokens.
+
+        max_new_tokens : int
+            The maximum number of tokens to generate.
+
+        eos_token : int
+            Generation stops after this token is produced. -1 disables it.
+        """
+        self._add_request(request_id, container.ShapeTuple(prompt), max_new_tokens, eos_token)
+
+    def step(self) -> Dict[int, List[int]]:
+        """Run one scheduling step.
+
+        Returns
+        -------
+        finished : Dict[int, List[int]]
+            The generated tokens of the requests that finished in this step.
+        """
+        self._step()
+        return {int(i): list(self._take_output(i)) for i in self._pop_finished()}
+
+    def run(self) -> Dict[int, List[int]]:
+        """Step until every queued request has finished.
+
+        Returns
+        -------
+        finished : Dict[int, List[int]]
+            The generated tokens of all the requests finished.
+        """
+        outputs = {}
+        while self._num_pending() != 0:
+            outputs.update(self.step())
+        return outputs
+
+    @property
+    def num_pending(self) -> int:
+        """The number of requests waiting or running."""
+        return self._num_pending()
+
+    def stats(self) -> Dict[str, int]:
+        """Counters accumulated since the scheduler was created."""
+        steps, prefill_tokens, decode_tokens, finished = self._stats()
+        return {
+            "steps": steps,
+            "prefill_tokens": prefill_tokens,
+            "decode_tokens": decode_tokens,
+            "finished": finished,
+        }
+
+
+@tvm._ffi.register_object("relax.vm.Future")
+class VMFuture(Object):
+    """The result of a VM function invoked through ``AsyncVirtualMachine.submit``.
+
+    The interface follows ``concurrent.futures.Future``.
+    """
+
+    PENDING = 0
+    RUNNING = 1
+    DONE = 2
+    FAILED = 3
+    CANCELLED = 4
+
+    def _state(self) -> int:
+        return tvm.get_global_func("relax.vm.FutureState")(self)
+
+    def done(self) -> bool:
+        """Whether the invocation finished, failed or was cancelled."""
+        return self._state() >= VMFuture.DONE
+
+    def running(self) -> bool:
+        """Whether the invocation is running on a worker."""
+        return self._state() == VMFuture.RUNNING
+
+    def cancelled(self) -> bool:
+        """Whether the invocation was cancelled."""
+        return self._state() == VMFuture.CANCELLED
+
+    def cancel(self) -> bool:
+        """Cancel the invocation if it has not started running.
+
+        Returns
+        -------
+        cancelled : bool
+            Whether the invocation was cancelled. Running invocations cannot be cancelled.
+        """
+        return tvm.get_global_func("relax.vm.FutureCancel")(self)
+
+    def result(self, timeout: Optional[float] = None) -> Any:
+        """Wait for the invocation to complete and return its result.
+
+        Parameters
+        ----------
+        timeout : Optional[float]
+            The number of seconds to wait, None to wait forever.
+
+        Returns
+        -------
+        result : Any
+            The return value of the VM function. The error the function failed with is
+            raised again.
+        """
+        timeout = -1.0 if timeout is None else float(timeout)
+        if not tvm.get_global_func("relax.vm.FutureWait")(self, timeout):
+            raise concurrent.futures.TimeoutError()
+        if self.cancelled():
+            raise concurrent.futures.CancelledError()
+        return tvm.get_global_func("relax.vm.FutureResult")(self)
+
+    def add_done_callback(self, fn: Callable[["VMFuture"], None]) -> None:
+        """Call ``fn(future)`` once the invocation completes.
+
+        The callback runs on the worker thread that completes the invocation, or
+        immediately if the invocation has already completed.
+        """
+        tvm.get_global_func("relax.vm.FutureAddCallback")(self, fn)
+
+
+class AsyncVirtualMachine(object):
+    """Asynchronous invocation of relax VM functions.
+
+    Functions are submitted to a queue and run on a pool of worker threads that
+    each own a fork of the VM, sharing its executable, allocators and constants.
+    Independent invocations therefore overlap instead of blocking a caller thread
+    each. On GPU, every worker runs on its own stream.
+    """
+
+    def __init__(
+        self, vm: VirtualMachine, num_workers: int = 2, threads_per_worker: int = 0
+    ) -> None:
+        """
+        Parameters
+        ----------
+        vm : VirtualMachine
+            The initialized VM to fork the workers from.
+
+        num_workers : int
+            The number of invocations running concurrently.
+
+        threads_per_worker : int
+            The number of threads of the intra-op thread pool of each worker. 0 divides the
+            cores evenly among the workers.
+        """
+        self._vm = vm
+        self.module = tvm.get_global_func("relax.vm.AsyncExecutor")(
+            vm.module, num_workers, threads_per_worker
+        )
+        self._submit = self.module["submit"]
+        self._num_pending = self.module["num_pending"]
+        self._shutdown = self.module["shutdown"]
+
+    def submit(self, func_name: str, *args: Any) -> VMFuture:
+        """Queue an invocation of a VM function.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : Any
+            The arguments. numpy arrays, numbers and tuples are converted as in
+            ``VirtualMachine.set_input``.
+
+        Returns
+        -------
+        future : VMFuture
+            The future holding the result of the invocation.
+        """
+        cargs: List[Any] = []
+        for arg in args:
+            self._vm._convert(arg, cargs)
+        return self._submit(func_name, *cargs)
+
+    @property
+    def num_pending(self) -> int:
+        """The number of invocations waiting for a worker."""
+        return self._num_pending()
+
+    def shutdown(self) -> None:
+        """Cancel the queued invocations and wait for the running ones to complete."""
+        self._shutdown()
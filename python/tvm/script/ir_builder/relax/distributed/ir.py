@@ -22,7 +22,11 @@ from typing import Union, List, Tuple, Optional
 from tvm.ir import PrimExpr
 from tvm.relax.expr import Expr, ShapeExpr, Call, ExternFunc
 from tvm.relax.expr import Tuple as RxTuple
-from tvm.relax.distributed import DTensorStructInfo
+from tvm.relax.distributed import DeviceMesh, DTensorStructInfo, Placement
+from tvm.relax.op.distributed import allreduce  # pylint: disable=unused-import
+from tvm.relax.op.distributed import redistribute as _redistribute
+from tvm.script.ir_builder import IRBuilder
+from tvm.script.ir_builder.ir import IRModuleFrame
 from . import _ffi_api
 from tvm.relax.utils import args_converter
 
@@ -70,3 +74,39 @@ def call_tir(
         tir_vars = ShapeExpr(tir_vars)
 
     return _ffi_api.call_tir_dist(func, args, out_sinfo, tir_vars)  # type: ignore
+
+
+def _lookup_device_mesh(device_mesh: Union[DeviceMesh, str]) -> DeviceMesh:
+    """Resolve a device mesh given as "name[index]" in the module global infos."""
+    if not isinstance(device_mesh, str):
+        return device_mesh
+    name, index = device_mesh.split("[")
+    index = int(index[:-1])
+    for frame in IRBuilder.current().frames:
+        if isinstance(frame, IRModuleFrame):
+            return frame.global_infos[name][index]
+    raise ValueError(f"Cannot find the device mesh {device_mesh} in the module global infos")
+
+
+def redistribute(
+    x: Expr, device_mesh: Union[DeviceMesh, str], placement: Union[Placement, str]
+) -> Call:
+    """Change the placement of a distributed tensor.
+
+    Parameters
+    ----------
+    x : Expr
+        The input distributed tensor.
+
+    device_mesh : Union[DeviceMesh, str]
+        The device mesh of the result, or its name in the module global infos, e.g. "mesh[0]".
+
+    placement : Union[Placement, str]
+        The placement of the result among the device mesh.
+
+    Returns
+    -------
+    ret: Call
+        A call node for the redistribute operator.
+    """
+    return _redistribute(x, _lookup_device_mesh(device_mesh), placement)
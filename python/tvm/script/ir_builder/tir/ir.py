@@ -1842,6 +1842,11 @@ mma_fill = _dtype_forward(_tir_op.mma_fill)
 vectorlow = _dtype_forward(_tir_op.vectorlow)
 vectorhigh = _dtype_forward(_tir_op.vectorhigh)
 vectorcombine = _dtype_forward(_tir_op.vectorcombine)
+masked_load = _op_wrapper(_tir_op.masked_load)
+masked_store = _op_wrapper(_tir_op.masked_store)
+vector_reduce_sum = _op_wrapper(_tir_op.vector_reduce_sum)
+vector_reduce_max = _op_wrapper(_tir_op.vector_reduce_max)
+vector_reduce_min = _op_wrapper(_tir_op.vector_reduce_min)
 
 
 broadcast = Broadcast
@@ -2083,6 +2088,11 @@ __all__ = [
     "vectorlow",
     "vectorhigh",
     "vectorcombine",
+    "masked_load",
+    "masked_store",
+    "vector_reduce_sum",
+    "vector_reduce_max",
+    "vector_reduce_min",
     "assume",
     "undef",
     "tvm_call_packed",
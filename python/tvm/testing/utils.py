@@ -1027,6 +1027,16 @@ def _has_vnni():
     return False
 
 
+def _has_avx2():
+    arch = platform.machine()
+    # Only linux is supported for now.
+    if arch == "x86_64" and sys.platform.startswith("linux"):
+        with open("/proc/cpuinfo", "r") as content:
+            return "avx2" in content.read()
+
+    return False
+
+
 # check avx512 intrinsic groups for SkyLake X
 def _has_slavx512():
     # Check LLVM support
@@ -1057,6 +1067,9 @@ requires_cascadelake = Feature(
 )
 
 
+requires_x86_avx2 = Feature("x86_avx2", "x86 AVX2", run_time_check=_has_avx2)
+
+
 requires_skylake_avx512 = Feature(
     "skylake_avx512",
     "x86 SkyLake AVX512",
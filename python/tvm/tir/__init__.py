@@ -62,7 +62,8 @@ from .op import (
 )
 from .op import ptx_mma, ptx_mma_sp, mma_store, mma_fill
 from .op import ptx_ldmatrix, ptx_cp_async, ptx_commit_group, ptx_wait_group
-from .op import vectorlow, vectorhigh, vectorcombine
+from .op import vectorlow, vectorhigh, vectorcombine, masked_load, masked_store
+from .op import vector_reduce_sum, vector_reduce_max, vector_reduce_min
 from .op import infinity, reinterpret
 from .op import exp, exp2, exp10, log, log2, log10, log1p, ldexp, clz
 from .op import sin, sinh, asin, asinh
@@ -1435,6 +1435,100 @@ def vectorcombine(dtype, vec1, vec2):
     return call_intrin(dtype, "tir.vectorcombine", vec1, vec2)
 
 
+def masked_load(address, mask, passthru):
+    """Load a vector, reading only the lanes enabled by the mask
+
+    Parameters
+    ----------
+    address : PrimExpr
+        The accessed elements, as returned by :py:func:`address_of` on a load
+        whose last index is a unit-stride ramp or a vector of per-lane indices.
+
+    mask : PrimExpr
+        The boolean vector selecting the lanes to read.
+
+    passthru : PrimExpr
+        The values returned for the disabled lanes.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(passthru.dtype, "tir.masked_load", address, mask, passthru)
+
+
+def masked_store(address, value, mask):
+    """Store a vector, writing only the lanes enabled by the mask
+
+    Parameters
+    ----------
+    address : PrimExpr
+        The accessed elements, as returned by :py:func:`address_of` on a load
+        whose last index is a unit-stride ramp or a vector of per-lane indices.
+
+    value : PrimExpr
+        The vector to store.
+
+    mask : PrimExpr
+        The boolean vector selecting the lanes to write.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("void", "tir.masked_store", address, value, mask)
+
+
+def vector_reduce_sum(value):
+    """Sum the lanes of a vector, in any order
+
+    Parameters
+    ----------
+    value : PrimExpr
+        The vector to reduce.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression, a scalar of the element type of value.
+    """
+    return call_intrin(value.dtype.split("x")[0], "tir.vector_reduce_sum", value)
+
+
+def vector_reduce_max(value):
+    """Take the maximum of the lanes of a vector
+
+    Parameters
+    ----------
+    value : PrimExpr
+        The vector to reduce.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression, a scalar of the element type of value.
+    """
+    return call_intrin(value.dtype.split("x")[0], "tir.vector_reduce_max", value)
+
+
+def vector_reduce_min(value):
+    """Take the minimum of the lanes of a vector
+
+    Parameters
+    ----------
+    value : PrimExpr
+        The vector to reduce.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression, a scalar of the element type of value.
+    """
+    return call_intrin(value.dtype.split("x")[0], "tir.vector_reduce_min", value)
+
+
 def ret(val):
     """Create a tir return expression
 
@@ -164,6 +164,22 @@ def LoopPartition():
     return _ffi_api.LoopPartition()  # type: ignore
 
 
+def LoopVersioning():
+    """Version the loops annotated with ``loop_versioning``.
+
+    The annotated loop is cloned into a fast version, in which the symbolic
+    extents and buffer offsets are multiples of the annotated factor and the
+    written buffers do not alias the others, and the original loop as a
+    fallback.  A runtime check selects between them.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.LoopVersioning()  # type: ignore
+
+
 def VectorizeLoop(enable_vectorize: bool = True):
     """Lower vectorization loops.
 
@@ -229,6 +245,21 @@ def StorageRewrite():
     return _ffi_api.StorageRewrite()  # type: ignore
 
 
+def InjectSoftwarePrefetch():
+    """Insert software prefetches for strided reads in innermost CPU loops.
+
+    The prefetch distance, in loop iterations, is taken from the enclosing
+    ``pragma_prefetch_distance`` or from the ``"tir.InjectSoftwarePrefetch"``
+    pass config. Only functions targeting LLVM are changed.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePrefetch()  # type: ignore
+
+
 def UnrollLoop():
     """Unroll the constant loop marked by unroll.
 
@@ -922,6 +953,10 @@ def ConvertForLoopsToSerial():
 def InjectSoftwarePipeline():
     """Transform annotated loops into pipelined one that parallelize producers and consumers
 
+    On CPU targets producers such as packing or cache_read blocks are pipelined ahead of the
+    compute blocks with multi-versioned buffers, and ``software_pipeline_async_stages`` is
+    ignored.
+
     Returns
     -------
     fpass : tvm.transform.Pass
@@ -1045,6 +1080,34 @@ def InstrumentProfileIntrinsics():
     return _ffi_api.InstrumentProfileIntrinsics()  # type: ignore
 
 
+def InstrumentLoopCounts():
+    """Insert calls that record loop trip counts and branch outcomes at runtime.
+
+    The counts can be dumped with :py:func:`tvm.runtime.profiling.dump_loop_profile`
+    and fed back to a later build through the ``tir.ApplyLoopProfile`` config.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InstrumentLoopCounts()  # type: ignore
+
+
+def ApplyLoopProfile():
+    """Use a recorded loop profile to guide unrolling and loop partitioning.
+
+    The profile path is read from the ``profile`` field of the
+    ``tir.ApplyLoopProfile`` config. The pass is a no-op when it is not set.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.ApplyLoopProfile()  # type: ignore
+
+
 def InstallDebugSpans():
     """Add line information from the TIR printer as spans on each statement and
     expression.
@@ -1073,3 +1136,21 @@ def DefaultGPUSchedule():
     ret: tvm.transform.Pass
     """
     return _ffi_api.DefaultGPUSchedule()  # type: ignore
+
+
+def DefaultCPUSchedule():
+    """The pass schedules the blocks of PrimFuncs for CPU with heuristics, so that untuned
+    kernels do not run as naive loop nests. Blocks with a loop nest of their own get cache
+    blocking tiles for matmul-like reductions sized to the L1 and L2 caches, a vectorized
+    innermost spatial loop, parallel outer spatial loops and auto unrolling.
+
+    The cache and vector sizes are read from the "tir.DefaultCPUSchedule" pass config, for
+    example ``{"tir.DefaultCPUSchedule": {"l2_cache_bytes": 2097152, "vector_bytes": 64}}``.
+    Functions with the "tir.is_scheduled" attribute, such as those applied from a tuning
+    database, are left as they are. The pass is currently only working for LLVM targets.
+
+    Returns
+    -------
+    ret: tvm.transform.Pass
+    """
+    return _ffi_api.DefaultCPUSchedule()  # type: ignore
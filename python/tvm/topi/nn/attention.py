@@ -0,0 +1,332 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Multi-head attention operators in BSNH layout."""
+import math
+
+from tvm import te, tir
+
+from .softmax import softmax
+
+
+def _get_scale(scale, head_dim):
+    """Return the float32 scale applied to the attention score."""
+    if isinstance(scale, tir.FloatImm):
+        scale = scale.value
+    if scale is not None:
+        return tir.const(float(scale), "float32")
+    if isinstance(head_dim, (int, tir.IntImm)):
+        return tir.const(1.0 / math.sqrt(int(head_dim)), "float32")
+    return tir.const(1.0, "float32") / tir.sqrt(head_dim.astype("float32"))
+
+
+def _get_causal_offset(causal_mask, num_queries, num_keys):
+    """Return the offset such that query i attends to the keys j <= i + offset."""
+    if causal_mask is None:
+        return None
+    if causal_mask == "TopLeft":
+        return 0
+    if causal_mask == "BottomRight":
+        return num_keys - num_queries
+    raise ValueError(f"Unsupported causal mask {causal_mask}, expected 'TopLeft' or 'BottomRight'")
+
+
+def _load_bias(bias, b, h, i, j):
+    """Load the bias of the score (b, h, i, j) for the 4-D, 3-D and 2-D bias layouts."""
+    if len(bias.shape) == 4:
+        return bias[b, h, i, j]
+    if len(bias.shape) == 3:
+        return bias[b, i, j]
+    return bias[b, j]
+
+
+def attention(query, key, value, bias=None, scale=None, causal_mask=None):
+    """Multi-head attention computed as matmul -> softmax -> matmul.
+
+    The full (batch, num_heads, seq_len, seq_len_kv) score matrix is materialized, which
+    makes this implementation a reference for :py:func:`flash_attention`.
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim]
+
+    key : tvm.te.Tensor
+        4-D with shape [batch, seq_len_kv, num_heads, head_dim]
+
+    value : tvm.te.Tensor
+        4-D with shape [batch, seq_len_kv, num_heads, head_dim_v]
+
+    bias : Optional[tvm.te.Tensor]
+        The bias added to the score, with shape [batch, num_heads, seq_len, seq_len_kv],
+        [batch, seq_len, seq_len_kv] or [batch, seq_len_kv].
+
+    scale : Optional[float]
+        The scale applied to the score, by default 1 / sqrt(head_dim).
+
+    causal_mask : Optional[str]
+        The causal mask, either "TopLeft" or "BottomRight".
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim_v]
+    """
+    batch, num_queries, num_heads, head_dim = query.shape
+    num_keys = key.shape[1]
+    head_dim_v = value.shape[3]
+    scale = _get_scale(scale, head_dim)
+    offset = _get_causal_offset(causal_mask, num_queries, num_keys)
+
+    d = te.reduce_axis((0, head_dim), name="d")
+    qk = te.compute(
+        (batch, num_heads, num_queries, num_keys),
+        lambda b, h, i, j: te.sum(
+            query[b, i, h, d].astype("float32") * key[b, j, h, d].astype("float32"), axis=d
+        ),
+        name="attention_qk",
+    )
+
+    def _score(b, h, i, j):
+        score = qk[b, h, i, j] * scale
+        if bias is not None:
+            score = score + _load_bias(bias, b, h, i, j).astype("float32")
+        if offset is not None:
+            score = tir.Select(j <= i + offset, score, tir.min_value("float32"))
+        return score
+
+    score = te.compute((batch, num_heads, num_queries, num_keys), _score, name="attention_score")
+    attn = softmax(score, axis=-1)
+
+    j = te.reduce_axis((0, num_keys), name="j")
+    av = te.compute(
+        (batch, num_queries, num_heads, head_dim_v),
+        lambda b, i, h, e: te.sum(attn[b, h, i, j] * value[b, j, h, e].astype("float32"), axis=j),
+        name="attention_av",
+    )
+
+    def _output(b, i, h, e):
+        out = av[b, i, h, e]
+        if offset is not None:
+            # A query that sees no key produces zeros, matching flash_attention.
+            out = tir.Select(i + offset >= 0, out, tir.const(0, "float32"))
+        return out.astype(query.dtype)
+
+    return te.compute(
+        (batch, num_queries, num_heads, head_dim_v), _output, name="attention", tag="attention"
+    )
+
+
+def flash_attention(
+    query, key, value, bias=None, scale=None, causal_mask=None, block_q=32, block_kv=64, lanes=8
+):
+    """Multi-head attention with tiled online softmax.
+
+    Each parallel task owns a block of `block_q` queries of one head and streams the keys
+    and values in blocks of `block_kv`, keeping a running row maximum and row sum so that
+    the score matrix is never materialized. Key blocks that are entirely hidden by the
+    causal mask are skipped. Scores and accumulators are kept in float32, and the loops
+    over the head dimensions are vectorized by `lanes` when the dimensions are static
+    multiples of it.
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim]
+
+    key : tvm.te.Tensor
+        4-D with shape [batch, seq_len_kv, num_heads, head_dim]
+
+    value : tvm.te.Tensor
+        4-D with shape [batch, seq_len_kv, num_heads, head_dim_v]
+
+    bias : Optional[tvm.te.Tensor]
+        The bias added to the score, with shape [batch, num_heads, seq_len, seq_len_kv],
+        [batch, seq_len, seq_len_kv] or [batch, seq_len_kv].
+
+    scale : Optional[float]
+        The scale applied to the score, by default 1 / sqrt(head_dim).
+
+    causal_mask : Optional[str]
+        The causal mask, either "TopLeft" or "BottomRight".
+
+    block_q : int
+        The number of queries processed by one parallel task.
+
+    block_kv : int
+        The number of keys and values processed per step of the online softmax.
+
+    lanes : int
+        The vector width used for the loops over the head dimensions.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim_v]
+    """
+    batch, num_queries, num_heads, head_dim = query.shape
+    num_keys = key.shape[1]
+    head_dim_v = value.shape[3]
+    scale = _get_scale(scale, head_dim)
+    offset = _get_causal_offset(causal_mask, num_queries, num_keys)
+    neg_inf = tir.min_value("float32")
+    zero = tir.const(0, "float32")
+    vectorize_dot = isinstance(head_dim, (int, tir.IntImm)) and int(head_dim) % lanes == 0
+
+    def _for_vectorized(ib, extent, body):
+        if isinstance(extent, (int, tir.IntImm)) and int(extent) % lanes == 0:
+            with ib.for_range(0, int(extent) // lanes, "vo") as vo:
+                with ib.for_range(0, lanes, "vi", kind="vectorize") as vi:
+                    body(vo * lanes + vi)
+        else:
+            with ib.for_range(0, extent, "vi") as vi:
+                body(vi)
+
+    def _gen_ir(q_buf, k_buf, v_buf, bias_buf, out_buf):
+        ib = tir.ir_builder.create()
+        q = ib.buffer_ptr(q_buf)
+        k = ib.buffer_ptr(k_buf)
+        v = ib.buffer_ptr(v_buf)
+        bias_ptr = ib.buffer_ptr(bias_buf) if bias_buf is not None else None
+        out = ib.buffer_ptr(out_buf)
+
+        num_q_blocks = tir.indexdiv(num_queries + block_q - 1, block_q)
+        with ib.for_range(0, batch * num_heads * num_q_blocks, "fused", kind="parallel") as fused:
+            b = fused // (num_heads * num_q_blocks)
+            h = fused // num_q_blocks % num_heads
+            q_start = fused % num_q_blocks * block_q
+
+            q_tile = ib.allocate("float32", (block_q, head_dim), "q_tile", scope="local")
+            acc = ib.allocate("float32", (block_q, head_dim_v), "acc", scope="local")
+            row_max = ib.allocate("float32", (block_q,), "row_max", scope="local")
+            row_sum = ib.allocate("float32", (block_q,), "row_sum", scope="local")
+            score = ib.allocate("float32", (block_kv,), "score", scope="local")
+            dot = ib.allocate("float32", (lanes,), "dot", scope="local")
+            # stat[0]: the new row maximum, stat[1]: the block row sum, stat[2]: the rescale.
+            stat = ib.allocate("float32", (3,), "stat", scope="local")
+
+            with ib.for_range(0, block_q, "r") as r:
+                i = q_start + r
+                row_max[r] = neg_inf
+                row_sum[r] = zero
+
+                def _init(e, r=r, i=i):
+                    # Pre-scale the query so that the score needs no extra multiply. Rows past
+                    # the end of the sequence are clamped here and never stored.
+                    q_row = tir.min(i, num_queries - 1)
+                    q_tile[r, e] = q[b, q_row, h, e].astype("float32") * scale
+
+                _for_vectorized(ib, head_dim, _init)
+
+                def _clear(e, r=r):
+                    acc[r, e] = zero
+
+                _for_vectorized(ib, head_dim_v, _clear)
+
+            if offset is None:
+                kv_end = num_keys
+            else:
+                kv_end = tir.max(tir.min(num_keys, q_start + block_q + offset), 0)
+
+            with ib.for_range(0, tir.indexdiv(kv_end + block_kv - 1, block_kv), "kvb") as kvb:
+                kv_start = kvb * block_kv
+                kv_len = tir.min(block_kv, kv_end - kv_start)
+                with ib.for_range(0, block_q, "r") as r:
+                    i = q_start + r
+                    with ib.if_scope(i < num_queries):
+                        # Scores of this query against the key block.
+                        with ib.for_range(0, kv_len, "c") as c:
+                            j = kv_start + c
+                            if vectorize_dot:
+                                with ib.for_range(0, lanes, "l", kind="vectorize") as l:
+                                    dot[l] = zero
+                                with ib.for_range(0, int(head_dim) // lanes, "do") as do:
+                                    with ib.for_range(0, lanes, "l", kind="vectorize") as l:
+                                        dot[l] += q_tile[r, do * lanes + l] * k[
+                                            b, j, h, do * lanes + l
+                                        ].astype("float32")
+                                s = dot[0]
+                                for l in range(1, lanes):
+                                    s = s + dot[l]
+                            else:
+                                dot[0] = zero
+                                with ib.for_range(0, head_dim, "d") as d:
+                                    dot[0] += q_tile[r, d] * k[b, j, h, d].astype("float32")
+                                s = dot[0]
+                            if bias_ptr is not None:
+                                s = s + _load_bias(bias_ptr, b, h, i, j).astype("float32")
+                            if offset is not None:
+                                s = tir.Select(j <= i + offset, s, neg_inf)
+                            score[c] = s
+
+                        # Online softmax update of the running maximum and sum.
+                        stat[0] = row_max[r]
+                        with ib.for_range(0, kv_len, "c") as c:
+                            stat[0] = tir.max(stat[0], score[c])
+                        stat[1] = zero
+                        with ib.for_range(0, kv_len, "c") as c:
+                            p = tir.exp(score[c] - stat[0])
+                            if offset is not None:
+                                p = tir.Select(kv_start + c <= i + offset, p, zero)
+                            score[c] = p
+                            stat[1] += p
+                        stat[2] = tir.exp(row_max[r] - stat[0])
+                        row_sum[r] = row_sum[r] * stat[2] + stat[1]
+                        row_max[r] = stat[0]
+
+                        def _rescale(e, r=r):
+                            acc[r, e] = acc[r, e] * stat[2]
+
+                        _for_vectorized(ib, head_dim_v, _rescale)
+                        with ib.for_range(0, kv_len, "c") as c:
+                            j = kv_start + c
+
+                            def _accumulate(e, r=r, c=c, j=j):
+                                acc[r, e] += score[c] * v[b, j, h, e].astype("float32")
+
+                            _for_vectorized(ib, head_dim_v, _accumulate)
+
+            with ib.for_range(0, block_q, "r") as r:
+                i = q_start + r
+                with ib.if_scope(i < num_queries):
+                    # A query that sees no key produces zeros.
+                    stat[0] = tir.Select(
+                        row_sum[r] > zero, tir.const(1, "float32") / row_sum[r], zero
+                    )
+
+                    def _store(e, r=r, i=i):
+                        out[b, i, h, e] = (acc[r, e] * stat[0]).astype(out_buf.dtype)
+
+                    _for_vectorized(ib, head_dim_v, _store)
+
+        return ib.get()
+
+    inputs = [query, key, value] + ([bias] if bias is not None else [])
+    out_buf = tir.decl_buffer(
+        (batch, num_queries, num_heads, head_dim_v), query.dtype, "flash_attention_buf"
+    )
+    return te.extern(
+        [out_buf.shape],
+        inputs,
+        lambda ins, outs: _gen_ir(
+            ins[0], ins[1], ins[2], ins[3] if bias is not None else None, outs[0]
+        ),
+        dtype=query.dtype,
+        out_buffers=[out_buf],
+        name="flash_attention",
+        tag="flash_attention",
+    )
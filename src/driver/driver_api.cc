@@ -54,6 +54,7 @@ TVM_REGISTER_PASS_CONFIG_OPTION("tir.debug_keep_trivial_loop", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.use_async_copy", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.merge_async_commit_queue_scope", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.instrument_lwp", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.instrument_loop_counts", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.vtcm_capacity", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.ptx_ldg32", Bool);
 
@@ -168,6 +169,8 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
           .value();
 
   bool instrument_lwp = pass_ctx->GetConfig<Bool>("tir.instrument_lwp", Bool(false)).value();
+  bool instrument_loop_counts =
+      pass_ctx->GetConfig<Bool>("tir.instrument_loop_counts", Bool(false)).value();
 
   Array<transform::Pass> user_lower_phase0 = Array<transform::Pass>();
   Array<transform::Pass> user_lower_phase1 = Array<transform::Pass>();
@@ -220,12 +223,19 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
   pass_list.push_back(tir::transform::FlattenBuffer());
   pass_list.push_back(tir::transform::BF16Legalize());
   pass_list.push_back(tir::transform::NarrowDataType(32));
+  pass_list.push_back(tir::transform::LoopVersioning());
   pass_list.push_back(tir::transform::Simplify());
 
   // Add user-defined phase-1 passes
   pass_list.insert(pass_list.end(), user_lower_phase1.begin(), user_lower_phase1.end());
 
   // PHASE 2
+  // Loop counts are recorded and consumed at the same point of the pipeline, so that
+  // the loop indices of the instrumented and of the profile-guided build agree.
+  if (instrument_loop_counts) {
+    pass_list.push_back(tir::transform::InstrumentLoopCounts());
+  }
+  pass_list.push_back(tir::transform::ApplyLoopProfile());
   if (!disable_loop_partition) {
     pass_list.push_back(tir::transform::LoopPartition());
   }
@@ -241,6 +251,7 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
   if (use_async_copy) {
     pass_list.push_back(tir::transform::LowerAsyncDMA());
   }
+  pass_list.push_back(tir::transform::InjectSoftwarePrefetch());
   pass_list.push_back(tir::transform::UnrollLoop());
 
   // Add user-defined phase-2 passes
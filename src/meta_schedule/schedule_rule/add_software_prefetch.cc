@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class AddSoftwarePrefetchNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {}
+
+  // Inherited from ScheduleRuleNode
+  Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final {
+    // The distance is a function-wide knob, so only the root block is marked.
+    if (sch->GetSRef(block_rv)->parent != nullptr || prefetch_distances.empty()) {
+      return {sch};
+    }
+    int n = prefetch_distances.size();
+    Array<FloatImm> probs(n, FloatImm(DataType::Float(64), 1.0 / n));
+    PrimExpr distance = sch->SampleCategorical(prefetch_distances, probs);
+    sch->Annotate(block_rv, tir::attr::pragma_prefetch_distance, distance);
+    return {sch};
+  }
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<AddSoftwarePrefetchNode> n = make_object<AddSoftwarePrefetchNode>(*this);
+    return ScheduleRule(n);
+  }
+
+ public:
+  /*! \brief The candidate prefetch distances in loop iterations, 0 disables prefetching. */
+  Array<Integer> prefetch_distances;
+
+  void VisitAttrs(tvm::AttrVisitor* v) { v->Visit("prefetch_distances", &prefetch_distances); }
+
+  static constexpr const char* _type_key = "meta_schedule.AddSoftwarePrefetch";
+  TVM_DECLARE_FINAL_OBJECT_INFO(AddSoftwarePrefetchNode, ScheduleRuleNode);
+};
+
+ScheduleRule ScheduleRule::AddSoftwarePrefetch(Array<Integer> prefetch_distances) {
+  for (const Integer& distance : prefetch_distances) {
+    CHECK_GE(distance->value, 0)
+        << "ValueError: The prefetch distance must be non-negative, but got " << distance;
+  }
+  ObjectPtr<AddSoftwarePrefetchNode> n = make_object<AddSoftwarePrefetchNode>();
+  n->prefetch_distances = prefetch_distances;
+  return ScheduleRule(n);
+}
+
+TVM_REGISTER_NODE_TYPE(AddSoftwarePrefetchNode);
+TVM_REGISTER_GLOBAL("meta_schedule.ScheduleRuleAddSoftwarePrefetch")
+    .set_body_typed(ScheduleRule::AddSoftwarePrefetch);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../utils.h"
+#include "multi_level_tiling.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+using tir::BlockRV;
+using tir::LoopRV;
+using tir::Schedule;
+
+/*!
+ * \brief Extension of MultiLevelTiling for CPUs that packs the read operands under the outermost
+ * reduction tile, and optionally pipelines the packing one iteration ahead of the computation.
+ */
+class MultiLevelTilingWithPackingNode : public MultiLevelTilingNode {
+ public:
+  static constexpr const char* _type_key = "meta_schedule.MultiLevelTilingWithPacking";
+  TVM_DECLARE_FINAL_OBJECT_INFO(MultiLevelTilingWithPackingNode, MultiLevelTilingNode);
+
+ protected:
+  ScheduleRule Clone() const final {
+    ObjectPtr<MultiLevelTilingWithPackingNode> n =
+        make_object<MultiLevelTilingWithPackingNode>(*this);
+    return ScheduleRule(n);
+  }
+
+  std::vector<State> ApplySubRules(std::vector<State> states) final {
+    states = MultiLevelTilingNode::ApplySubRules(std::move(states));
+    return SubRule(std::move(states),
+                   [&](State state) { return AddPackingPipeline(std::move(state)); });
+  }
+
+  // SubRule: pipeline the packing blocks under the outermost reduction tile
+  std::vector<State> AddPackingPipeline(State state) const;
+};
+
+std::vector<State> MultiLevelTilingWithPackingNode::AddPackingPipeline(State state) const {
+  int n_packs = state->read_reuse.size();
+  if (n_packs == 0) {
+    return {state};
+  }
+  // The body of the loop is expected to be the packing loops followed by the computation.
+  const LoopRV& loop_rv = state->tiles[r_indices_[0]].back();
+  const tir::ForNode* loop = TVM_SREF_TO_FOR(state->sch->GetSRef(loop_rv));
+  const auto* seq = loop->body.as<tir::SeqStmtNode>();
+  if (seq == nullptr || static_cast<int>(seq->size()) != n_packs + 1) {
+    return {state};
+  }
+  for (const tir::Stmt& stmt : seq->seq) {
+    if (!stmt->IsInstance<tir::ForNode>()) {
+      return {state};
+    }
+  }
+  Array<Integer> stages;
+  Array<Integer> orders;
+  for (int i = 0; i <= n_packs; ++i) {
+    stages.push_back(Integer(i == n_packs ? 1 : 0));
+    orders.push_back(Integer(i));
+  }
+  State new_state = state->Copy();
+  new_state->sch->Annotate(loop_rv, tir::attr::software_pipeline_stage, stages);
+  new_state->sch->Annotate(loop_rv, tir::attr::software_pipeline_order, orders);
+  return {state, new_state};
+}
+
+ScheduleRule ScheduleRule::MultiLevelTilingWithPacking(
+    String structure, Optional<Integer> max_innermost_factor,
+    Optional<Map<String, ObjectRef>> reuse_write) {
+  size_t r_index = std::string(structure).find('R');
+  CHECK_NE(r_index, std::string::npos)
+      << "ValueError: The tiling structure must contain a reduction tile, but got " << structure;
+  // Pack every read operand at the outermost reduction tile.
+  Map<String, ObjectRef> reuse_read{{"req", String("must")},
+                                    {"levels", Array<Integer>{Integer(r_index + 1)}},
+                                    {"scope", String("global")}};
+  auto node = MultiLevelTilingInitCommon<MultiLevelTilingWithPackingNode>(
+      structure, NullOpt, max_innermost_factor, NullOpt, reuse_read, reuse_write);
+  return ScheduleRule(node);
+}
+
+TVM_REGISTER_NODE_TYPE(MultiLevelTilingWithPackingNode);
+TVM_REGISTER_GLOBAL("meta_schedule.ScheduleRuleMultiLevelTilingWithPacking")
+    .set_body_typed(ScheduleRule::MultiLevelTilingWithPacking);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,510 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/distributed/transform/lower_distir.cc
+ * \brief Lower functions over distributed tensors to per-worker programs.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/relax/attrs/distributed.h>
+#include <tvm/relax/distributed/transform.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace tvm {
+namespace relax {
+namespace distributed {
+
+/*!
+ * \brief Specialize a PrimFunc with static buffer shapes to the local shards of its arguments.
+ *
+ * Every access to a sharded buffer axis must index it with a loop or block iterator spanning the
+ * whole axis, whose extent is then divided among the workers. Kernels indexing a sharded axis in
+ * any other way are rejected, they need symbolic shapes to run on shards.
+ */
+class PrimFuncShardSpecializer : public tir::StmtExprMutator {
+ public:
+  /*!
+   * \brief Specialize a function.
+   * \param func The callee of call_tir.
+   * \param local_shapes The local shapes of its buffer parameters, in order. Parameters without a
+   *  known shape have an empty entry.
+   * \return The specialized function, or NullOpt if the static shapes already match.
+   */
+  static Optional<tir::PrimFunc> Specialize(const tir::PrimFunc& func,
+                                            const Array<Array<PrimExpr>>& local_shapes) {
+    PrimFuncShardSpecializer specializer;
+    Map<tir::Var, tir::Buffer> buffer_map;
+    size_t index = 0;
+    for (const tir::Var& param : func->params) {
+      auto it = func->buffer_map.find(param);
+      if (it == func->buffer_map.end()) continue;
+      tir::Buffer buffer = (*it).second;
+      if (index < local_shapes.size()) {
+        buffer = specializer.ShardBuffer(buffer, local_shapes[index]);
+      }
+      buffer_map.Set(param, buffer);
+      ++index;
+    }
+    if (specializer.buffer_remap_.empty()) return NullOpt;
+
+    specializer.CollectShardedIters(func->body);
+    tir::PrimFunc ret = func;
+    tir::PrimFuncNode* n = ret.CopyOnWrite();
+    n->body = specializer(func->body);
+    n->buffer_map = buffer_map;
+    return ret;
+  }
+
+ private:
+  /*! \brief The full and local extents of a sharded axis or iterator. */
+  using Extents = std::pair<int64_t, int64_t>;
+
+  tir::Buffer ShardBuffer(const tir::Buffer& buffer, const Array<PrimExpr>& local_shape) {
+    if (local_shape.size() != buffer->shape.size()) return buffer;
+    Array<PrimExpr> shape = buffer->shape;
+    for (size_t axis = 0; axis < shape.size(); ++axis) {
+      const auto* full = shape[axis].as<IntImmNode>();
+      const auto* local = local_shape[axis].as<IntImmNode>();
+      if (full != nullptr && local != nullptr && full->value != local->value) {
+        sharded_axes_[{buffer.get(), axis}] = {full->value, local->value};
+        shape.Set(axis, IntImm(full->dtype, local->value));
+      }
+    }
+    if (shape.same_as(buffer->shape)) return buffer;
+    CHECK(buffer->strides.empty())
+        << "ValueError: LowerDistIR cannot shard the strided buffer " << buffer->name
+        << " of a static-shape PrimFunc";
+    tir::Buffer sharded = buffer;
+    sharded.CopyOnWrite()->shape = shape;
+    buffer_remap_[buffer.get()] = sharded;
+    return sharded;
+  }
+
+  /*! \brief Find the iterators indexing the sharded axes and check that they index nothing else. */
+  void CollectShardedIters(const tir::Stmt& body) {
+    std::unordered_map<const tir::VarNode*, PrimExpr> bindings;
+    tir::PostOrderVisit(body, [&](const ObjectRef& node) {
+      if (const auto* realize = node.as<tir::BlockRealizeNode>()) {
+        for (size_t i = 0; i < realize->iter_values.size(); ++i) {
+          bindings[realize->block->iter_vars[i]->var.get()] = realize->iter_values[i];
+        }
+      }
+    });
+    auto shrink = [this](const tir::VarNode* var, Extents extents) {
+      auto [it, inserted] = sharded_iters_.emplace(var, extents);
+      CHECK(inserted || it->second == extents)
+          << "ValueError: LowerDistIR cannot shard " << var->name_hint
+          << ", it indexes buffer axes sharded to different extents";
+    };
+    auto visit_access = [&](const tir::Buffer& buffer, const Array<PrimExpr>& indices) {
+      for (size_t axis = 0; axis < indices.size(); ++axis) {
+        auto it = sharded_axes_.find({buffer.get(), axis});
+        if (it == sharded_axes_.end()) continue;
+        const auto* var = indices[axis].as<tir::VarNode>();
+        CHECK(var != nullptr) << "ValueError: LowerDistIR cannot shard axis " << axis << " of "
+                              << buffer->name << ", it is indexed by " << indices[axis]
+                              << " instead of an iterator over the whole axis";
+        shrink(var, it->second);
+      }
+    };
+    tir::PostOrderVisit(body, [&](const ObjectRef& node) {
+      if (const auto* load = node.as<tir::BufferLoadNode>()) {
+        visit_access(load->buffer, load->indices);
+      } else if (const auto* store = node.as<tir::BufferStoreNode>()) {
+        visit_access(store->buffer, store->indices);
+      }
+    });
+    // Block iterators are shrunk together with the loops they are bound to.
+    for (const auto& [var, extents] : std::vector<std::pair<const tir::VarNode*, Extents>>(
+             sharded_iters_.begin(), sharded_iters_.end())) {
+      auto it = bindings.find(var);
+      if (it == bindings.end()) continue;
+      const auto* loop_var = it->second.as<tir::VarNode>();
+      CHECK(loop_var != nullptr) << "ValueError: LowerDistIR cannot shard " << var->name_hint
+                                 << ", it is bound to " << it->second << " instead of a loop";
+      shrink(loop_var, extents);
+    }
+    // The shrunk iterators must not index any axis which keeps its size.
+    auto check_access = [&](const tir::Buffer& buffer, const Array<PrimExpr>& indices) {
+      for (size_t axis = 0; axis < indices.size(); ++axis) {
+        if (sharded_axes_.count({buffer.get(), axis})) continue;
+        CHECK(!tir::UsesVar(indices[axis],
+                            [this](const tir::VarNode* var) { return sharded_iters_.count(var); }))
+            << "ValueError: LowerDistIR cannot shard the iterators of " << indices[axis]
+            << ", axis " << axis << " of " << buffer->name << " is not sharded";
+      }
+    };
+    tir::PostOrderVisit(body, [&](const ObjectRef& node) {
+      if (const auto* load = node.as<tir::BufferLoadNode>()) {
+        check_access(load->buffer, load->indices);
+      } else if (const auto* store = node.as<tir::BufferStoreNode>()) {
+        check_access(store->buffer, store->indices);
+      }
+    });
+  }
+
+  /*! \brief The local extent of an iterator, after checking that it spans the whole axis. */
+  PrimExpr ShrinkExtent(const tir::Var& var, const PrimExpr& extent) {
+    auto it = sharded_iters_.find(var.get());
+    if (it == sharded_iters_.end()) return extent;
+    const auto* full = extent.as<IntImmNode>();
+    CHECK(full != nullptr && full->value == it->second.first)
+        << "ValueError: LowerDistIR cannot shard " << var->name_hint << " with extent " << extent
+        << ", it must span the whole sharded axis of extent " << it->second.first;
+    return IntImm(extent.dtype(), it->second.second);
+  }
+
+  tir::Buffer Remap(const tir::Buffer& buffer) const {
+    auto it = buffer_remap_.find(buffer.get());
+    return it == buffer_remap_.end() ? buffer : it->second;
+  }
+
+  tir::Stmt VisitStmt_(const tir::ForNode* op) final {
+    tir::For loop = Downcast<tir::For>(tir::StmtExprMutator::VisitStmt_(op));
+    PrimExpr extent = ShrinkExtent(loop->loop_var, loop->extent);
+    if (!extent.same_as(loop->extent)) {
+      loop.CopyOnWrite()->extent = extent;
+    }
+    return loop;
+  }
+
+  tir::Stmt VisitStmt_(const tir::BlockNode* op) final {
+    tir::Block block = Downcast<tir::Block>(tir::StmtExprMutator::VisitStmt_(op));
+    for (const tir::MatchBufferRegion& match : block->match_buffers) {
+      CHECK(!buffer_remap_.count(match->source->buffer.get()))
+          << "ValueError: LowerDistIR cannot shard " << match->source->buffer->name
+          << ", it is matched by a sub-region";
+    }
+    auto remap_regions = [this](const Array<tir::BufferRegion>& regions) {
+      return regions.Map([this](const tir::BufferRegion& region) {
+        tir::Buffer buffer = Remap(region->buffer);
+        if (buffer.same_as(region->buffer)) return region;
+        Array<Range> ranges = region->region;
+        for (size_t axis = 0; axis < ranges.size(); ++axis) {
+          auto it = sharded_axes_.find({region->buffer.get(), axis});
+          if (it == sharded_axes_.end()) continue;
+          const auto* extent = ranges[axis]->extent.as<IntImmNode>();
+          if (extent != nullptr && extent->value == it->second.first) {
+            ranges.Set(axis, Range::FromMinExtent(ranges[axis]->min,
+                                                  IntImm(extent->dtype, it->second.second)));
+          }
+        }
+        return tir::BufferRegion(buffer, ranges);
+      });
+    };
+    tir::BlockNode* n = block.CopyOnWrite();
+    n->reads = remap_regions(n->reads);
+    n->writes = remap_regions(n->writes);
+    n->iter_vars = n->iter_vars.Map([this](const tir::IterVar& iter) {
+      PrimExpr extent = ShrinkExtent(iter->var, iter->dom->extent);
+      if (extent.same_as(iter->dom->extent)) return iter;
+      tir::IterVar ret = iter;
+      ret.CopyOnWrite()->dom = Range::FromMinExtent(iter->dom->min, extent);
+      return ret;
+    });
+    return block;
+  }
+
+  PrimExpr VisitExpr_(const tir::BufferLoadNode* op) final {
+    tir::BufferLoad load = Downcast<tir::BufferLoad>(tir::StmtExprMutator::VisitExpr_(op));
+    tir::Buffer buffer = Remap(load->buffer);
+    if (!buffer.same_as(load->buffer)) {
+      load.CopyOnWrite()->buffer = buffer;
+    }
+    return load;
+  }
+
+  tir::Stmt VisitStmt_(const tir::BufferStoreNode* op) final {
+    tir::BufferStore store = Downcast<tir::BufferStore>(tir::StmtExprMutator::VisitStmt_(op));
+    tir::Buffer buffer = Remap(store->buffer);
+    if (!buffer.same_as(store->buffer)) {
+      store.CopyOnWrite()->buffer = buffer;
+    }
+    return store;
+  }
+
+  /*! \brief The full and local extents of the sharded axes of the parameter buffers. */
+  std::map<std::pair<const tir::BufferNode*, size_t>, Extents> sharded_axes_;
+  /*! \brief The parameter buffers with sharded static shapes. */
+  std::unordered_map<const tir::BufferNode*, tir::Buffer> buffer_remap_;
+  /*! \brief The loop and block iterators over sharded axes. */
+  std::unordered_map<const tir::VarNode*, Extents> sharded_iters_;
+};
+
+class DistIRLowerer : public ExprMutator {
+ public:
+  explicit DistIRLowerer(IRModule mod) : ExprMutator(mod) {}
+
+  /*!
+   * \brief Lower one function.
+   * \return The lowered function, or NullOpt if it does not use distributed tensors.
+   */
+  Optional<Function> Lower(const Function& func) {
+    Array<Var> params;
+    Array<Integer> param_axes;
+    num_workers_ = -1;
+    bool distributed = FindMeshSize(GetStructInfo(func));
+    if (!distributed) return NullOpt;
+    for (const Var& param : func->params) {
+      Var new_param(param->name_hint(), LocalStructInfo(GetStructInfo(param)), param->span);
+      var_remap_[param->vid] = new_param;
+      params.push_back(new_param);
+      param_axes.push_back(ShardAxis(GetStructInfo(param)));
+    }
+    Expr body = VisitWithNewScope(func->body, params);
+    Array<Integer> ret_axes;
+    if (const auto* tuple = func->ret_struct_info.as<TupleStructInfoNode>()) {
+      for (const StructInfo& field : tuple->fields) {
+        ret_axes.push_back(ShardAxis(field));
+      }
+    } else {
+      ret_axes.push_back(ShardAxis(func->ret_struct_info));
+    }
+    Function ret(params, body, LocalStructInfo(func->ret_struct_info), func->attrs, func->span);
+    ret = WithAttr(std::move(ret), "num_workers", Integer(num_workers_));
+    ret = WithAttr(std::move(ret), "dist_param_axes", param_axes);
+    ret = WithAttr(std::move(ret), "dist_ret_axes", ret_axes);
+    return ret;
+  }
+
+  /*! \brief The module with the PrimFuncs specialized to local shards added. */
+  IRModule GetContextIRModule() const { return builder_->GetContextIRModule(); }
+
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* call) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    static const Op& redistribute_op = Op::Get("relax.dist.redistribute");
+    static const Op& allreduce_op = Op::Get("relax.dist.allreduce");
+
+    if (call->op.same_as(redistribute_op)) {
+      const auto* attrs = call->attrs.as<DistributionAttrs>();
+      return LowerRedistribute(VisitExpr(call->args[0]), GetDTensor(call->args[0]),
+                               attrs->placement, attrs->device_mesh);
+    }
+    if (call->op.same_as(allreduce_op)) {
+      DTensorStructInfo sinfo = GetDTensor(call->args[0]);
+      CHECK(ShardAxis(sinfo) == -1)
+          << "ValueError: allreduce expects the partial sums to be declared replicated, but got "
+          << sinfo->placement->ToString();
+      return CallCollective("vm.builtin.ccl.allreduce", {VisitExpr(call->args[0])},
+                            LocalStructInfo(sinfo));
+    }
+    Expr new_call = ExprMutator::VisitExpr_(call);
+    if (call->op.same_as(call_tir_op)) {
+      // the callee runs on the local shards of its arguments.
+      Call lowered = Downcast<Call>(new_call);
+      StructInfo out_sinfo = LocalStructInfo(call->sinfo_args[0]);
+      Array<Expr> args = lowered->args;
+      args.Set(0, SpecializeCallee(call, out_sinfo));
+      return Call(lowered->op, args, lowered->attrs, {out_sinfo}, lowered->span);
+    }
+    for (const Expr& arg : call->args) {
+      CHECK(!GetStructInfo(arg).as<DTensorStructInfoNode>())
+          << "ValueError: LowerDistIR only supports call_tir, redistribute and allreduce on "
+             "distributed tensors, but got "
+          << call->op;
+    }
+    return new_call;
+  }
+
+ private:
+  /*!
+   * \brief Record the number of workers from the meshes in a struct info.
+   * \return Whether the struct info contains a distributed tensor.
+   */
+  bool FindMeshSize(const StructInfo& sinfo) {
+    if (const auto* dtensor = sinfo.as<DTensorStructInfoNode>()) {
+      CHECK_EQ(dtensor->device_mesh->shape.size(), 1)
+          << "ValueError: LowerDistIR only supports one-dimensional device meshes";
+      int64_t size = dtensor->device_mesh->shape[0];
+      CHECK(num_workers_ == -1 || num_workers_ == size)
+          << "ValueError: all the device meshes of a function must have the same size, but got "
+          << num_workers_ << " and " << size;
+      num_workers_ = size;
+      return true;
+    }
+    bool found = false;
+    if (const auto* tuple = sinfo.as<TupleStructInfoNode>()) {
+      for (const StructInfo& field : tuple->fields) {
+        found |= FindMeshSize(field);
+      }
+    } else if (const auto* func = sinfo.as<FuncStructInfoNode>()) {
+      if (func->params.defined()) {
+        for (const StructInfo& param : func->params.value()) {
+          found |= FindMeshSize(param);
+        }
+      }
+      found |= FindMeshSize(func->ret);
+    }
+    return found;
+  }
+
+  /*!
+   * \brief The callee of a call_tir, specialized to the local shards if it has static shapes.
+   * Each specialization is added to the module once and shared by the calls using it.
+   */
+  Expr SpecializeCallee(const CallNode* call, const StructInfo& out_sinfo) {
+    const auto* gvar = call->args[0].as<GlobalVarNode>();
+    if (gvar == nullptr) return call->args[0];
+    auto callee = builder_->GetContextIRModule()->Lookup(GetRef<GlobalVar>(gvar));
+    const auto* prim_func = callee.as<tir::PrimFuncNode>();
+    if (prim_func == nullptr) return call->args[0];
+
+    Array<Array<PrimExpr>> local_shapes;
+    auto add_shape = [&local_shapes](const StructInfo& sinfo) {
+      const auto* tensor = sinfo.as<TensorStructInfoNode>();
+      const auto* shape = tensor ? tensor->shape.as<ShapeExprNode>() : nullptr;
+      local_shapes.push_back(shape ? shape->values : Array<PrimExpr>());
+    };
+    for (const StructInfo& sinfo : GetStructInfoAs<TupleStructInfoNode>(call->args[1])->fields) {
+      add_shape(LocalStructInfo(sinfo));
+    }
+    if (const auto* tuple = out_sinfo.as<TupleStructInfoNode>()) {
+      for (const StructInfo& field : tuple->fields) {
+        add_shape(field);
+      }
+    } else {
+      add_shape(out_sinfo);
+    }
+    Optional<tir::PrimFunc> specialized =
+        PrimFuncShardSpecializer::Specialize(GetRef<tir::PrimFunc>(prim_func), local_shapes);
+    if (!specialized.defined()) return call->args[0];
+    return builder_->AddFunction(specialized.value(), gvar->name_hint + "_shard");
+  }
+
+  static DTensorStructInfo GetDTensor(const Expr& expr) {
+    const auto* sinfo = GetStructInfoAs<DTensorStructInfoNode>(expr);
+    CHECK(sinfo != nullptr) << "ValueError: expect a distributed tensor, but got "
+                            << GetStructInfo(expr);
+    return GetRef<DTensorStructInfo>(sinfo);
+  }
+
+  /*! \brief The tensor axis sharded over the mesh, or -1 if replicated. */
+  static int ShardAxis(const StructInfo& sinfo) {
+    const auto* dtensor = sinfo.as<DTensorStructInfoNode>();
+    if (dtensor == nullptr) return -1;
+    const PlacementSpec& spec = dtensor->placement->dim_specs[0];
+    return spec->kind == PlacementSpecKind::kSharding ? spec->axis : -1;
+  }
+
+  /*! \brief The struct info of the value held by one worker. */
+  StructInfo LocalStructInfo(const StructInfo& sinfo) {
+    if (const auto* dtensor = sinfo.as<DTensorStructInfoNode>()) {
+      return LocalTensor(GetRef<DTensorStructInfo>(dtensor), ShardAxis(sinfo));
+    }
+    if (const auto* tuple = sinfo.as<TupleStructInfoNode>()) {
+      Array<StructInfo> fields;
+      for (const StructInfo& field : tuple->fields) {
+        fields.push_back(LocalStructInfo(field));
+      }
+      return TupleStructInfo(fields, tuple->span);
+    }
+    return sinfo;
+  }
+
+  /*! \brief The struct info of a tensor sharded along `axis` over the workers. */
+  TensorStructInfo LocalTensor(const DTensorStructInfo& sinfo, int axis) {
+    TensorStructInfo tensor = sinfo->tensor_sinfo;
+    if (axis == -1) return tensor;
+    const auto* shape = tensor->shape.as<ShapeExprNode>();
+    CHECK(shape != nullptr) << "ValueError: sharded tensors must have a known shape, but got "
+                            << tensor;
+    Array<PrimExpr> values = shape->values;
+    const auto* extent = values[axis].as<IntImmNode>();
+    CHECK(extent != nullptr)
+        << "ValueError: the sharded dimension " << axis << " of a distributed tensor must be "
+        << "static, but got " << values[axis];
+    CHECK_EQ(extent->value % num_workers_, 0)
+        << "ValueError: dimension " << axis << " of size " << extent->value
+        << " cannot be split evenly among " << num_workers_ << " workers";
+    values.Set(axis, IntImm(extent->dtype, extent->value / num_workers_));
+    return TensorStructInfo(ShapeExpr(values), tensor->dtype, tensor->span);
+  }
+
+  Expr LowerRedistribute(Expr x, DTensorStructInfo src, Placement dst_placement,
+                         DeviceMesh dst_mesh) {
+    CHECK(StructuralEqual()(src->device_mesh, dst_mesh))
+        << "ValueError: LowerDistIR does not support moving tensors between device meshes";
+    CHECK_EQ(dst_placement->dim_specs.size(), 1)
+        << "ValueError: LowerDistIR only supports one-dimensional device meshes";
+    int src_axis = ShardAxis(src);
+    const PlacementSpec& spec = dst_placement->dim_specs[0];
+    int dst_axis = spec->kind == PlacementSpecKind::kSharding ? spec->axis : -1;
+    if (src_axis == dst_axis) return x;
+    if (src_axis != -1) {
+      // gather the full tensor on every worker.
+      x = builder_->Emit(CallCollective("vm.builtin.ccl.allgather",
+                                        {x, PrimValue::Int64(src_axis)}, src->tensor_sinfo));
+    }
+    if (dst_axis != -1) {
+      // every worker already holds the full tensor and keeps its own part.
+      x = CallCollective("vm.builtin.ccl.shard", {x, PrimValue::Int64(dst_axis)},
+                         LocalTensor(src, dst_axis));
+    }
+    return x;
+  }
+
+  static Call CallCollective(String name, Array<Expr> args, StructInfo ret) {
+    return Call(ExternFunc(name), args, Attrs(), {ret});
+  }
+
+  /*! \brief The number of workers, i.e. the size of the device mesh. */
+  int64_t num_workers_{-1};
+};
+
+namespace transform {
+
+Pass LowerDistIR() {
+  runtime::TypedPackedFunc<IRModule(IRModule, tvm::transform::PassContext)> pass_func =
+      [=](IRModule mod, tvm::transform::PassContext pc) {
+        DistIRLowerer lowerer(mod);
+        IRModule updates;
+        for (const auto& [gvar, base_func] : mod->functions) {
+          if (const auto* func = base_func.as<FunctionNode>()) {
+            Optional<Function> lowered = lowerer.Lower(GetRef<Function>(func));
+            if (lowered.defined()) {
+              updates->Add(gvar, lowered.value());
+            }
+          }
+        }
+        if (updates->functions.empty()) {
+          return mod;
+        }
+        // The context module also holds the PrimFuncs specialized to local shards.
+        IRModule ret = lowerer.GetContextIRModule();
+        ret.CopyOnWrite()->Update(updates);
+        return ret;
+      };
+  return tvm::transform::CreateModulePass(pass_func, 0, "LowerDistIR", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.distributed.transform.LowerDistIR").set_body_typed(LowerDistIR);
+
+}  // namespace transform
+
+}  // namespace distributed
+}  // namespace relax
+}  // namespace tvm
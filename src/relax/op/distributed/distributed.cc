@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file distributed.cc
+ * \brief Distributed operators.
+ */
+
+#include "distributed.h"
+
+#include <utility>
+
+namespace tvm {
+namespace relax {
+
+static distributed::DTensorStructInfo GetInputDTensorStructInfo(const Call& call,
+                                                                const BlockBuilder& ctx) {
+  if (call->args.size() != 1) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << call->op << " op should have 1 argument, while " << call->args.size()
+                     << " arguments are given");
+  }
+  const auto* sinfo = GetStructInfoAs<distributed::DTensorStructInfoNode>(call->args[0]);
+  if (sinfo == nullptr) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << call->op << " requires the input to be a DTensor, but got "
+                     << call->args[0]->struct_info_);
+  }
+  return GetRef<distributed::DTensorStructInfo>(sinfo);
+}
+
+/* relax.dist.redistribute */
+TVM_REGISTER_NODE_TYPE(DistributionAttrs);
+
+Expr redistribute(Expr x, distributed::DeviceMesh device_mesh, distributed::Placement placement) {
+  ObjectPtr<DistributionAttrs> attrs = make_object<DistributionAttrs>();
+  attrs->device_mesh = std::move(device_mesh);
+  attrs->placement = std::move(placement);
+
+  static const Op& op = Op::Get("relax.dist.redistribute");
+  return Call(op, {std::move(x)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.dist.redistribute").set_body_typed(redistribute);
+
+StructInfo InferStructInfoRedistribute(const Call& call, const BlockBuilder& ctx) {
+  distributed::DTensorStructInfo input_sinfo = GetInputDTensorStructInfo(call, ctx);
+  const auto* attrs = call->attrs.as<DistributionAttrs>();
+  if (attrs->device_mesh->shape.size() != attrs->placement->dim_specs.size()) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "redistribute requires the placement to have one spec per dimension of "
+                        "the device mesh, but got "
+                     << attrs->placement->ToString() << " for a mesh of "
+                     << attrs->device_mesh->shape.size() << " dimensions");
+  }
+  return distributed::DTensorStructInfo(input_sinfo->tensor_sinfo, attrs->device_mesh,
+                                        attrs->placement);
+}
+
+TVM_REGISTER_OP("relax.dist.redistribute")
+    .set_attrs_type<DistributionAttrs>()
+    .set_num_inputs(1)
+    .add_argument("x", "DTensor", "The input distributed tensor.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoRedistribute);
+
+/* relax.dist.allreduce */
+Expr allreduce(Expr x) {
+  static const Op& op = Op::Get("relax.dist.allreduce");
+  return Call(op, {std::move(x)}, {}, {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.dist.allreduce").set_body_typed(allreduce);
+
+StructInfo InferStructInfoAllReduce(const Call& call, const BlockBuilder& ctx) {
+  distributed::DTensorStructInfo input_sinfo = GetInputDTensorStructInfo(call, ctx);
+  Array<distributed::PlacementSpec> replica;
+  for (size_t i = 0; i < input_sinfo->device_mesh->shape.size(); ++i) {
+    replica.push_back(distributed::PlacementSpec::Replica());
+  }
+  return distributed::DTensorStructInfo(input_sinfo->tensor_sinfo, input_sinfo->device_mesh,
+                                        distributed::Placement(replica));
+}
+
+TVM_REGISTER_OP("relax.dist.allreduce")
+    .set_num_inputs(1)
+    .add_argument("x", "DTensor", "The input distributed tensor holding partial sums.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoAllReduce);
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file distributed.h
+ * \brief The functions to make Relax distributed operator calls.
+ */
+#ifndef TVM_RELAX_OP_DISTRIBUTED_DISTRIBUTED_H_
+#define TVM_RELAX_OP_DISTRIBUTED_DISTRIBUTED_H_
+
+#include <tvm/relax/attrs/distributed.h>
+
+#include "../op_common.h"
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Change the device mesh and placement of a distributed tensor.
+ * \param x The input distributed tensor.
+ * \param device_mesh The device mesh of the result.
+ * \param placement The placement of the result.
+ * \return The redistributed tensor.
+ */
+Expr redistribute(Expr x, distributed::DeviceMesh device_mesh, distributed::Placement placement);
+
+/*!
+ * \brief Sum the local values of a distributed tensor over its device mesh.
+ * \param x The input distributed tensor. Each device holds a partial sum of the
+ * full tensor, e.g. the output of a matmul whose reduction axis is sharded.
+ * \return The replicated sum.
+ */
+Expr allreduce(Expr x);
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_OP_DISTRIBUTED_DISTRIBUTED_H_
@@ -0,0 +1,279 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/allocate_workspace.cc
+ * \brief Provide the global scratch memory of kernels through one workspace argument.
+ */
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Collect the number of inputs each PrimFunc is called with through call_tir, and the
+ * PrimFuncs that are referenced in any other way.
+ */
+class KernelUseCollector : public ExprVisitor {
+ public:
+  /*! \brief The number of call_tir inputs of each callee, -1 if it is not the same everywhere. */
+  std::unordered_map<const GlobalVarNode*, int> num_inputs;
+  /*! \brief The functions that are referenced other than as a call_tir callee. */
+  std::unordered_set<const GlobalVarNode*> escaped;
+
+ private:
+  void VisitExpr_(const CallNode* call) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    const auto* gv = call->args.empty() ? nullptr : call->args[0].as<GlobalVarNode>();
+    if (!call->op.same_as(call_tir_op) || gv == nullptr) {
+      ExprVisitor::VisitExpr_(call);
+      return;
+    }
+    const auto* inputs = call->args[1].as<TupleNode>();
+    int n = inputs ? static_cast<int>(inputs->fields.size()) : -1;
+    auto it = num_inputs.find(gv);
+    if (it == num_inputs.end()) {
+      num_inputs[gv] = n;
+    } else if (it->second != n) {
+      it->second = -1;
+    }
+    for (size_t i = 1; i < call->args.size(); ++i) {
+      this->VisitExpr(call->args[i]);
+    }
+  }
+
+  void VisitExpr_(const GlobalVarNode* gv) final { escaped.insert(gv); }
+};
+
+/*!
+ * \brief The number of bytes a kernel requests from TVMBackendAllocWorkspace at most, that is
+ * the total size of its global intermediate buffers too large to be allocated on the stack.
+ */
+int64_t KernelWorkspaceBytes(const tir::PrimFunc& func) {
+  int64_t total = 0;
+  tir::PostOrderVisit(func->body, [&](const ObjectRef& obj) {
+    const auto* block = obj.as<tir::BlockNode>();
+    if (block == nullptr) return;
+    for (const tir::Buffer& buf : block->alloc_buffers) {
+      if (buf.scope() != "global") continue;
+      int64_t bits = buf->dtype.bits() * buf->dtype.lanes();
+      for (const PrimExpr& dim : buf->shape) {
+        const auto* extent = dim.as<IntImmNode>();
+        bits = extent ? bits * extent->value : 0;
+      }
+      int64_t bytes = (bits + 7) / 8;
+      // Dynamically shaped buffers keep being allocated by the kernel.
+      if (bytes > runtime::kMaxStackAlloca) {
+        total += (bytes + runtime::kAllocAlignment - 1) / runtime::kAllocAlignment *
+                 runtime::kAllocAlignment;
+      }
+    }
+  });
+  return total;
+}
+
+/*!
+ * \brief Collect the runtime device index of the tensors allocated by relax.builtin.alloc_tensor.
+ */
+class DeviceIndexCollector : public ExprVisitor {
+ public:
+  /*! \brief The runtime device index of each allocated tensor. */
+  std::unordered_map<const VarNode*, int64_t> device_index;
+
+ private:
+  using ExprVisitor::VisitBinding_;
+
+  void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    if (call->op.same_as(alloc_tensor_op)) {
+      if (const auto* index = call->args[2].as<PrimValueNode>()) {
+        if (const auto* value = index->value.as<IntImmNode>()) {
+          device_index[binding->var.get()] = value->value;
+        }
+      }
+    }
+    ExprVisitor::VisitBinding_(binding, call);
+  }
+};
+
+/*! \brief Allocate the workspace in each function and pass it to the kernels that need it. */
+class WorkspaceArgAppender : public ExprMutator {
+ public:
+  WorkspaceArgAppender(std::unordered_set<const GlobalVarNode*> kernels, int64_t bytes)
+      : kernels_(std::move(kernels)), bytes_(bytes) {}
+
+  Function Rewrite(const Function& func) {
+    DeviceIndexCollector collector;
+    collector.VisitExpr(func);
+    device_index_ = std::move(collector.device_index);
+    workspaces_.clear();
+    Function updated = Downcast<Function>(this->VisitExpr(func));
+    if (workspaces_.empty()) return func;
+
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    Array<Binding> bindings;
+    for (const auto& [index, workspace] : workspaces_) {
+      Expr alloc = builder_->Normalize(Call(
+          alloc_tensor_op,
+          {ShapeExpr(WorkspaceShape()), DataTypeImm(DataType::UInt(8)), PrimValue::Int64(index)},
+          Attrs()));
+      bindings.push_back(VarBinding(workspace, alloc));
+    }
+    const auto* seq = updated->body.as<SeqExprNode>();
+    ICHECK(seq) << "The body of a normalized function must be a SeqExpr";
+    Array<BindingBlock> blocks{BindingBlock(bindings)};
+    blocks.insert(blocks.end(), seq->blocks.begin(), seq->blocks.end());
+    SeqExpr body(blocks, seq->body, seq->span);
+    UpdateStructInfo(body, GetStructInfo(updated->body));
+    updated.CopyOnWrite()->body = body;
+    return updated;
+  }
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* op) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    const auto* gv = call->args.empty() ? nullptr : call->args[0].as<GlobalVarNode>();
+    if (!call->op.same_as(call_tir_op) || gv == nullptr || !kernels_.count(gv)) {
+      return std::move(call);
+    }
+    Array<Expr> inputs = Downcast<Tuple>(call->args[1])->fields;
+    inputs.push_back(GetWorkspace(DeviceIndexOf(inputs)));
+    call.CopyOnWrite()->args.Set(1, Tuple(inputs));
+    return std::move(call);
+  }
+
+  /*!
+   * \brief The runtime device index a kernel runs on, which is the one of its inputs allocated
+   * on a known device, or else the device CallTIRRewrite allocates its outputs on.
+   */
+  int64_t DeviceIndexOf(const Array<Expr>& inputs) const {
+    for (const Expr& input : inputs) {
+      const auto* var = input.as<VarNode>();
+      auto it = var ? device_index_.find(var) : device_index_.end();
+      if (it != device_index_.end()) return it->second;
+    }
+    return 0;
+  }
+
+  Var GetWorkspace(int64_t device_index) {
+    auto it = workspaces_.find(device_index);
+    if (it != workspaces_.end()) return it->second;
+    Var workspace("workspace", TensorStructInfo(ShapeExpr(WorkspaceShape()), DataType::UInt(8)));
+    workspaces_.emplace(device_index, workspace);
+    return workspace;
+  }
+
+  Array<PrimExpr> WorkspaceShape() const { return {IntImm(DataType::Int(64), bytes_)}; }
+
+  /*! \brief The kernels that take the workspace. */
+  std::unordered_set<const GlobalVarNode*> kernels_;
+  /*! \brief The size of the workspace in bytes. */
+  int64_t bytes_;
+  /*! \brief The runtime device index of the tensors allocated in the function being rewritten. */
+  std::unordered_map<const VarNode*, int64_t> device_index_;
+  /*! \brief The workspace on each runtime device used by the function being rewritten. */
+  std::map<int64_t, Var> workspaces_;
+};
+
+IRModule AllocateWorkspace(IRModule mod) {
+  KernelUseCollector collector;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<FunctionNode>()) {
+      collector.VisitExpr(GetRef<Function>(func));
+    }
+  }
+
+  // Every kernel receives a workspace as large as the largest need, so that a single
+  // allocation serves all kernels, which run one after another.
+  std::vector<std::pair<GlobalVar, tir::PrimFunc>> kernels;
+  int64_t max_bytes = 0;
+  for (const auto& kv : mod->functions) {
+    const auto* func = kv.second.as<tir::PrimFuncNode>();
+    auto it = collector.num_inputs.find(kv.first.get());
+    if (func == nullptr || it == collector.num_inputs.end() || it->second < 0 ||
+        collector.escaped.count(kv.first.get()) ||
+        func->GetAttr<Integer>(tir::attr::kWorkspaceParam).defined()) {
+      continue;
+    }
+    int64_t bytes = KernelWorkspaceBytes(GetRef<tir::PrimFunc>(func));
+    if (bytes == 0) continue;
+    max_bytes = std::max(max_bytes, bytes);
+    kernels.emplace_back(kv.first, GetRef<tir::PrimFunc>(func));
+  }
+  if (kernels.empty()) return mod;
+
+  std::unordered_set<const GlobalVarNode*> kernel_vars;
+  for (auto& [gv, func] : kernels) {
+    int index = collector.num_inputs.at(gv.get());
+    tir::Var param("workspace", DataType::Handle());
+    tir::Buffer buf = tir::decl_buffer({IntImm(DataType::Int(64), max_bytes)},
+                                       DataType::UInt(8), "workspace");
+    auto* n = func.CopyOnWrite();
+    n->params.insert(n->params.begin() + index, param);
+    n->buffer_map.Set(param, buf);
+    func = WithAttr(std::move(func), tir::attr::kWorkspaceParam, Integer(index));
+    kernel_vars.insert(gv.get());
+  }
+
+  WorkspaceArgAppender appender(kernel_vars, max_bytes);
+  std::vector<std::pair<GlobalVar, Function>> callers;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<FunctionNode>()) {
+      callers.emplace_back(kv.first, appender.Rewrite(GetRef<Function>(func)));
+    }
+  }
+
+  IRModuleNode* n = mod.CopyOnWrite();
+  for (const auto& [gv, func] : kernels) {
+    n->Update(gv, func);
+  }
+  for (const auto& [gv, func] : callers) {
+    n->Update(gv, func);
+  }
+  return mod;
+}
+
+namespace transform {
+
+Pass AllocateWorkspace() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) { return relax::AllocateWorkspace(m); };
+  return CreateModulePass(pass_func, 0, "AllocateWorkspace", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.AllocateWorkspace").set_body_typed(AllocateWorkspace);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
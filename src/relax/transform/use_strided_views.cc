@@ -0,0 +1,387 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/use_strided_views.cc
+ * \brief Turn slices and transposes that only feed stride-aware kernels into zero-copy views.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/relax/attrs/index.h>
+#include <tvm/relax/attrs/manipulate.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The layout of a view of a compact tensor, in number of elements. */
+struct ViewLayout {
+  Array<PrimExpr> shape;
+  Array<PrimExpr> strides;
+  /*! \brief The element offset of the view, undefined if it is not known statically. */
+  PrimExpr elem_offset;
+};
+
+/*!
+ * \brief Collect, for each variable, the PrimFunc buffers that it is bound to as a call_tir
+ * argument, and whether it is referenced anywhere else.
+ */
+class ViewUseCollector : public ExprVisitor {
+ public:
+  explicit ViewUseCollector(const IRModule& mod) : mod_(mod) {}
+
+  /*! \brief The buffers each variable is bound to in call_tir. */
+  std::unordered_map<const VarNode*, std::vector<tir::Buffer>> consumers;
+  /*! \brief The variables bound to an item of each tuple variable, with the item index. */
+  std::unordered_map<const VarNode*, std::vector<std::pair<int, const VarNode*>>> tuple_items;
+  /*! \brief The variables that are referenced other than as a call_tir argument. */
+  std::unordered_set<const VarNode*> escaped;
+
+ private:
+  using ExprVisitor::VisitExpr_;
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    if (const auto* item = binding->value.as<TupleGetItemNode>()) {
+      if (const auto* tuple = item->tuple.as<VarNode>()) {
+        tuple_items[tuple].emplace_back(item->index, binding->var.get());
+        return;
+      }
+    }
+    const auto* call = binding->value.as<CallNode>();
+    if (call == nullptr || !call->op.same_as(call_tir_op)) {
+      ExprVisitor::VisitBinding_(binding);
+      return;
+    }
+    Optional<tir::PrimFunc> func;
+    if (const auto* gv = call->args[0].as<GlobalVarNode>()) {
+      if (auto base_func = mod_->functions.Get(GetRef<GlobalVar>(gv))) {
+        if (const auto* prim_func = base_func.value().as<tir::PrimFuncNode>()) {
+          func = GetRef<tir::PrimFunc>(prim_func);
+        }
+      }
+    }
+    const auto* args = call->args[1].as<TupleNode>();
+    if (!func.defined() || args == nullptr) {
+      ExprVisitor::VisitBinding_(binding);
+      return;
+    }
+    for (size_t i = 0; i < args->fields.size(); ++i) {
+      const auto* var = args->fields[i].as<VarNode>();
+      Optional<tir::Buffer> buffer = func.value()->buffer_map.Get(func.value()->params[i]);
+      if (var != nullptr && buffer.defined()) {
+        consumers[var].push_back(buffer.value());
+      } else {
+        VisitExpr(args->fields[i]);
+      }
+    }
+    for (size_t i = 2; i < call->args.size(); ++i) {
+      VisitExpr(call->args[i]);
+    }
+  }
+
+  void VisitExpr_(const VarNode* var) final { escaped.insert(var); }
+  void VisitExpr_(const DataflowVarNode* var) final { escaped.insert(var); }
+
+  const IRModule& mod_;
+};
+
+class StridedViewRewriter : public ExprMutator {
+ public:
+  explicit StridedViewRewriter(const IRModule& mod) : uses_(mod) {}
+
+  Expr Rewrite(const Function& func) {
+    uses_.VisitExpr(func);
+    return VisitExpr(func);
+  }
+
+ private:
+  using ExprMutator::VisitBinding_;
+
+  void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
+    static const Op& permute_dims_op = Op::Get("relax.permute_dims");
+    static const Op& strided_slice_op = Op::Get("relax.strided_slice");
+    static const Op& split_op = Op::Get("relax.split");
+
+    Optional<Expr> view;
+    if (call->op.same_as(permute_dims_op)) {
+      view = PermuteDimsView(binding->var, call);
+    } else if (call->op.same_as(strided_slice_op)) {
+      view = StridedSliceView(binding->var, call);
+    } else if (call->op.same_as(split_op)) {
+      view = SplitView(binding->var, call);
+    }
+    if (view.defined() || call->op->IsInstance<ExternFuncNode>()) {
+      // Views, and the results of packed functions which may return views, are not compact.
+      MarkNonCompact(binding->var.get());
+    }
+    if (view.defined()) {
+      ReEmitBinding(binding, builder_->Normalize(view.value()));
+    } else {
+      ExprMutator::VisitBinding_(binding, call);
+    }
+  }
+
+  Optional<Expr> PermuteDimsView(const Var& var, const CallNode* call) {
+    Optional<Array<PrimExpr>> shape = GetShape(call->args[0]);
+    if (!shape.defined() || !IsCompact(call->args[0])) return NullOpt;
+    const auto* attrs = call->attrs.as<PermuteDimsAttrs>();
+    int ndim = shape.value().size();
+    Array<PrimExpr> in_strides = CompactStrides(shape.value());
+    Array<PrimExpr> axes;
+    ViewLayout layout;
+    for (int i = 0; i < ndim; ++i) {
+      int64_t axis = attrs->axes.defined() ? attrs->axes.value()[i]->value : ndim - 1 - i;
+      if (axis < 0) axis += ndim;
+      axes.push_back(IntImm(DataType::Int(64), axis));
+      layout.shape.push_back(shape.value()[axis]);
+      layout.strides.push_back(in_strides[axis]);
+    }
+    layout.elem_offset = IntImm(DataType::Int(64), 0);
+    if (!AllUsesAccept(var.get(), layout)) return NullOpt;
+    return Call(permute_dims_view_, {call->args[0], ShapeExpr(axes)}, Attrs(),
+                {GetStructInfo(var)});
+  }
+
+  Optional<Expr> StridedSliceView(const Var& var, const CallNode* call) {
+    Optional<Array<PrimExpr>> shape = GetShape(call->args[0]);
+    if (!shape.defined() || !IsCompact(call->args[0])) return NullOpt;
+    const auto* attrs = call->attrs.as<StridedSliceAttrs>();
+    int ndim = shape.value().size();
+    std::vector<PrimExpr> begin, end, step;
+    for (int i = 0; i < ndim; ++i) {
+      begin.push_back(IntImm(DataType::Int(64), 0));
+      end.push_back(shape.value()[i]);
+      step.push_back(IntImm(DataType::Int(64), 1));
+    }
+    for (size_t k = 0; k < attrs->axes.size(); ++k) {
+      int64_t axis = attrs->axes[k]->value;
+      if (axis < 0) axis += ndim;
+      if (attrs->strides.defined()) {
+        // Views cannot reverse an axis, and the step has to be known to derive the strides.
+        const auto* stride = attrs->strides.value()[k].as<IntImmNode>();
+        if (stride == nullptr || stride->value <= 0) return NullOpt;
+        step[axis] = IntImm(DataType::Int(64), stride->value);
+      }
+      begin[axis] = attrs->begin[k];
+      end[axis] = attrs->end[k];
+    }
+    return SliceView(var, call->args[0], shape.value(), begin, end, step);
+  }
+
+  Optional<Expr> SplitView(const Var& var, const CallNode* call) {
+    Optional<Array<PrimExpr>> shape = GetShape(call->args[0]);
+    const auto* out_sinfo = GetStructInfoAs<TupleStructInfoNode>(var);
+    auto items = uses_.tuple_items.find(var.get());
+    // The tuple itself cannot be a view, so it may only be used through its items.
+    if (!shape.defined() || !IsCompact(call->args[0]) || out_sinfo == nullptr ||
+        uses_.escaped.count(var.get()) || items == uses_.tuple_items.end()) {
+      return NullOpt;
+    }
+    const auto* attrs = call->attrs.as<SplitAttrs>();
+    int ndim = shape.value().size();
+    int axis = attrs->axis < 0 ? attrs->axis + ndim : attrs->axis;
+    Array<PrimExpr> in_strides = CompactStrides(shape.value());
+
+    std::vector<ViewLayout> layouts;
+    std::vector<Expr> parts;
+    PrimExpr part_begin = IntImm(DataType::Int(64), 0);
+    for (const StructInfo& field : out_sinfo->fields) {
+      Optional<Array<PrimExpr>> part_shape = GetShape(field);
+      if (!part_shape.defined()) return NullOpt;
+      std::vector<PrimExpr> begin, end, step;
+      for (int i = 0; i < ndim; ++i) {
+        begin.push_back(IntImm(DataType::Int(64), 0));
+        end.push_back(shape.value()[i]);
+        step.push_back(IntImm(DataType::Int(64), 1));
+      }
+      PrimExpr part_end = analyzer_.Simplify(part_begin + part_shape.value()[axis]);
+      begin[axis] = part_begin;
+      end[axis] = part_end;
+
+      ViewLayout layout;
+      layout.shape = part_shape.value();
+      layout.strides = in_strides;
+      layout.elem_offset = analyzer_.Simplify(part_begin * in_strides[axis]);
+      layouts.push_back(layout);
+      parts.push_back(MakeSliceView(call->args[0], begin, end, step, field));
+      part_begin = part_end;
+    }
+    for (const auto& [index, item] : items->second) {
+      if (!AllUsesAccept(item, layouts[index])) return NullOpt;
+    }
+
+    Array<Expr> fields;
+    for (const Expr& part : parts) {
+      fields.push_back(builder_->Emit(part));
+    }
+    return Tuple(fields);
+  }
+
+  Optional<Expr> SliceView(const Var& var, const Expr& data, const Array<PrimExpr>& shape,
+                           const std::vector<PrimExpr>& begin, const std::vector<PrimExpr>& end,
+                           const std::vector<PrimExpr>& step) {
+    Optional<Array<PrimExpr>> view_shape = GetShape(GetStructInfo(var));
+    if (!view_shape.defined()) return NullOpt;
+    Array<PrimExpr> in_strides = CompactStrides(shape);
+    ViewLayout layout;
+    layout.shape = view_shape.value();
+    layout.elem_offset = IntImm(DataType::Int(64), 0);
+    for (size_t i = 0; i < shape.size(); ++i) {
+      layout.strides.push_back(analyzer_.Simplify(in_strides[i] * step[i]));
+      PrimExpr b = NormalizeBegin(begin[i], shape[i]);
+      if (!layout.elem_offset.defined() || !b.defined()) {
+        layout.elem_offset = PrimExpr();
+      } else {
+        layout.elem_offset = analyzer_.Simplify(layout.elem_offset + b * in_strides[i]);
+      }
+    }
+    if (!AllUsesAccept(var.get(), layout)) return NullOpt;
+    return MakeSliceView(data, begin, end, step, GetStructInfo(var));
+  }
+
+  Expr MakeSliceView(const Expr& data, const std::vector<PrimExpr>& begin,
+                     const std::vector<PrimExpr>& end, const std::vector<PrimExpr>& step,
+                     const StructInfo& sinfo) {
+    auto to_shape = [](const std::vector<PrimExpr>& values) {
+      Array<PrimExpr> result;
+      for (const PrimExpr& value : values) {
+        result.push_back(cast(DataType::Int(64), value));
+      }
+      return ShapeExpr(result);
+    };
+    return Call(strided_slice_view_, {data, to_shape(begin), to_shape(end), to_shape(step)},
+                Attrs(), {sinfo});
+  }
+
+  /*! \brief The begin index clamped into [0, extent], or undefined if its sign is unknown. */
+  PrimExpr NormalizeBegin(const PrimExpr& begin, const PrimExpr& extent) {
+    if (analyzer_.CanProve(begin >= 0)) {
+      return analyzer_.Simplify(tvm::min(cast(extent.dtype(), begin), extent));
+    }
+    if (analyzer_.CanProve(begin < 0)) {
+      return analyzer_.Simplify(tvm::max(cast(extent.dtype(), begin) + extent, 0));
+    }
+    return PrimExpr();
+  }
+
+  /*!
+   * \brief Check that every use of a variable is a call_tir argument whose buffer binds the
+   * strides and offset of the given view layout.
+   */
+  bool AllUsesAccept(const VarNode* var, const ViewLayout& layout) {
+    if (uses_.escaped.count(var)) return false;
+    auto it = uses_.consumers.find(var);
+    if (it == uses_.consumers.end()) return false;
+    for (const tir::Buffer& buffer : it->second) {
+      if (!BufferAccepts(buffer, layout)) return false;
+    }
+    return true;
+  }
+
+  bool BufferAccepts(const tir::Buffer& buffer, const ViewLayout& layout) {
+    // A buffer without explicit strides requires a compact argument.
+    Array<PrimExpr> strides =
+        buffer->strides.empty() ? CompactStrides(layout.shape) : buffer->strides;
+    if (strides.size() != layout.strides.size()) return false;
+    for (size_t i = 0; i < strides.size(); ++i) {
+      if (buffer->strides.empty() || !strides[i]->IsInstance<tir::VarNode>()) {
+        // A fixed stride is asserted against the argument at runtime.
+        if (!analyzer_.CanProveEqual(strides[i], layout.strides[i])) return false;
+      }
+    }
+    if (buffer->elem_offset->IsInstance<tir::VarNode>()) {
+      return buffer->offset_factor <= 1;
+    }
+    return layout.elem_offset.defined() &&
+           analyzer_.CanProveEqual(buffer->elem_offset, layout.elem_offset);
+  }
+
+  void MarkNonCompact(const VarNode* var) {
+    non_compact_.insert(var);
+    auto items = uses_.tuple_items.find(var);
+    if (items != uses_.tuple_items.end()) {
+      for (const auto& item : items->second) {
+        non_compact_.insert(item.second);
+      }
+    }
+  }
+
+  /*!
+   * \brief Whether the input of a view is known to be compact, which the strides and offset of
+   * the view are derived from.
+   */
+  bool IsCompact(const Expr& data) const {
+    const auto* var = data.as<VarNode>();
+    return var != nullptr && !non_compact_.count(var);
+  }
+
+  static Array<PrimExpr> CompactStrides(const Array<PrimExpr>& shape) {
+    std::vector<PrimExpr> strides(shape.size());
+    PrimExpr stride = IntImm(DataType::Int(64), 1);
+    for (int i = static_cast<int>(shape.size()) - 1; i >= 0; --i) {
+      strides[i] = stride;
+      stride = stride * cast(DataType::Int(64), shape[i]);
+    }
+    return Array<PrimExpr>(strides.begin(), strides.end());
+  }
+
+  static Optional<Array<PrimExpr>> GetShape(const Expr& expr) {
+    return GetShape(GetStructInfo(expr));
+  }
+
+  static Optional<Array<PrimExpr>> GetShape(const StructInfo& sinfo) {
+    const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+    if (tensor_sinfo == nullptr || !tensor_sinfo->shape.defined()) return NullOpt;
+    const auto* shape = tensor_sinfo->shape.as<ShapeExprNode>();
+    if (shape == nullptr) return NullOpt;
+    return shape->values;
+  }
+
+  ViewUseCollector uses_;
+  /*! \brief The variables whose layout is not known to be compact. */
+  std::unordered_set<const VarNode*> non_compact_;
+  arith::Analyzer analyzer_;
+  const ExternFunc strided_slice_view_{"vm.builtin.strided_slice_view"};
+  const ExternFunc permute_dims_view_{"vm.builtin.permute_dims_view"};
+};
+
+namespace transform {
+
+Pass UseStridedViews() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(StridedViewRewriter(m).Rewrite(f));
+      };
+  return CreateFunctionPass(pass_func, 0, "UseStridedViews", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.UseStridedViews").set_body_typed(UseStridedViews);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
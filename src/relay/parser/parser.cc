@@ -279,20 +279,17 @@ class Parser {
   /*! \brief The diagnostic context used for error reporting. */
   DiagnosticContext diag_ctx;
 
-  const Source& source;
+  Source source;
 
   /*! \brief The current position in the token stream. */
   int pos;
 
-  /*! \brief The token stream for the parser. */
-  std::vector<Token> tokens;
+  /*! \brief The token stream for the parser, tokenized as the parser advances. */
+  TokenStream tokens;
 
   /*! \brief The configured operator table. */
   OperatorTable op_table;
 
-  /*! \brief Configure the whitespace mode, right now we ignore all whitespace. */
-  bool ignore_whitespace;
-
   /*! \brief A global mapping for GlobalVar. */
   InternTable<GlobalVar> global_names;
 
@@ -311,19 +308,22 @@ class Parser {
   /*! \brief The set of expression scopes used for lexical scope. */
   ScopeStack<Var> expr_scopes;
 
-  /*! \brief The metadata section. */
+  /*! \brief The metadata section, see GetMetaTable(). */
   MetaTable meta_table;
 
-  Parser(IRModule module, DiagnosticContext ctx, const Source& source, std::vector<Token> tokens,
-         OperatorTable op_table, MetaTable table)
+  /*! \brief Whether the metadata section of the source has been merged into meta_table. */
+  bool meta_table_loaded;
+
+  Parser(IRModule module, DiagnosticContext ctx, const Source& source, OperatorTable op_table,
+         MetaTable init_meta_table)
       : module(module),
         diag_ctx(ctx),
         source(source),
         pos(0),
-        tokens(tokens),
+        tokens(ctx, source),
         op_table(op_table),
-        ignore_whitespace(true),
-        meta_table(table) {
+        meta_table(init_meta_table),
+        meta_table_loaded(false) {
     InitializeGlobals();
     InitializeTypeDefs();
   }
@@ -346,25 +346,9 @@ class Parser {
     }
   }
 
-  /*! \brief Examine the next token in the stream, the current parser is configured to be
-   * whitespace insensitive so we will skip all whitespace or comment tokens. */
-  Token Peek() {
-    // For now we ignore all whitespace tokens and comments.
-    // We can tweak this behavior later to enable white space sensitivity in the parser.
-    while (pos < static_cast<int64_t>(tokens.size()) && ignore_whitespace &&
-           (tokens.at(pos)->token_type == TokenType::kWhitespace ||
-            tokens.at(pos)->token_type == TokenType::kNewline ||
-            tokens.at(pos)->token_type == TokenType::kLineComment ||
-            tokens.at(pos)->token_type == TokenType::kComment)) {
-      pos++;
-    }
-
-    if (pos < static_cast<int64_t>(tokens.size())) {
-      return Token(this->tokens.at(pos));
-    } else {
-      return Token::Null();
-    }
-  }
+  /*! \brief Examine the next token in the stream, the parser is whitespace insensitive so
+   * the stream never contains whitespace or comment tokens. */
+  Token Peek() { return tokens.At(pos); }
 
   /*! \brief Lookahead by N tokens.
    * \param n The number of tokens to lookahead.
@@ -391,12 +375,14 @@ class Parser {
    * /param token_type The token type to match.
    */
   void Consume(const TokenType& token_type) {
-    if (tokens[pos]->token_type != token_type) {
-      this->diag_ctx.EmitFatal(Diagnostic::Error(tokens[pos]->span)
+    auto token = tokens.At(pos);
+    if (token->token_type != token_type) {
+      this->diag_ctx.EmitFatal(Diagnostic::Error(token->span)
                                << "expected a " << Pretty(token_type) << " found "
-                               << Pretty(Peek()->token_type));
+                               << Pretty(token->token_type));
     }
     pos++;
+    tokens.Release(pos);
   }
 
   /*! Match a token in the stream, this will first invoke Peek, ignoring tokens such
@@ -575,14 +561,7 @@ class Parser {
       // The token at the head of the stream is now 1 past where we parsed. So we find its start
       // position as its start and end, so that when we merge we only grow the spanned region
       // to the start of the current stream.
-      auto span_pos = pos - 1;
-      while ((tokens.at(span_pos)->token_type == TokenType::kWhitespace ||
-              tokens.at(span_pos)->token_type == TokenType::kNewline ||
-              tokens.at(span_pos)->token_type == TokenType::kLineComment ||
-              tokens.at(span_pos)->token_type == TokenType::kComment)) {
-        span_pos--;
-      }
-      auto end_token = tokens.at(span_pos);
+      auto end_token = tokens.At(pos - 1);
       VLOG(9) << "WithSpan: end_span = " << end_token->span;
       ast->span = start_span.Merge(end_token->span);
     }
@@ -609,11 +588,35 @@ class Parser {
    * For example `meta[relay.Constant][0]` references the first constant, `meta[relay.Constant][1]`
    * the second, and so on.
    */
+  /*! \brief The metadata available to meta references. The metadata section of the source is
+   * decoded the first time it is needed, and the initial table's entries follow its own. */
+  const MetaTable& GetMetaTable() {
+    if (!meta_table_loaded) {
+      meta_table_loaded = true;
+      ObjectRef metadata = tokens.Metadata();
+      MetaTable table = metadata.defined() ? Downcast<MetaTable>(metadata) : MetaTable();
+      // Metadata references within the source must use indexes which account for this ordering.
+      for (const auto& pair : this->meta_table) {
+        Array<ObjectRef> items;
+        if (table.count(pair.first)) {
+          items = table[pair.first];
+        }
+        for (const auto& obj : pair.second) {
+          items.push_back(obj);
+        }
+        table.Set(pair.first, items);
+      }
+      this->meta_table = table;
+    }
+    return this->meta_table;
+  }
+
   ObjectRef ParseMetaRef() {
     auto meta_ref_tok = Match(TokenType::kMetaReference);
     auto meta_ref = MetaRefFromToken(meta_ref_tok);
-    auto it = this->meta_table.find(meta_ref.type_key);
-    if (it != this->meta_table.end()) {
+    const MetaTable& meta_table = GetMetaTable();
+    auto it = meta_table.find(meta_ref.type_key);
+    if (it != meta_table.end()) {
       auto nodes = (*it).second;
       if (meta_ref.node_index < nodes.size()) {
         return nodes[meta_ref.node_index];
@@ -704,8 +707,7 @@ class Parser {
     this->version = ParseSemVer();
     // Parse the definitions.
     auto defs = ParseDefinitions();
-    // Parse the metadata section at the end.
-    auto metadata = ParseMetadata();
+    // The metadata section at the end is skipped by the tokenizer, see GetMetaTable().
 
     Match(TokenType::kEndOfFile);
 
@@ -844,9 +846,16 @@ class Parser {
 
   std::string HackTokensAsString(int n) {
     std::stringstream key;
-    n = std::min(static_cast<int>(tokens.size() - pos), n);
+    Token prev;
     for (int i = 0; i < n; i++) {
-      key << ToString(tokens.at(pos + i)->token_type);
+      auto token = tokens.At(pos + i);
+      // The tokens of a multi-token operator such as `<=` must not be separated by whitespace.
+      if (prev.defined() && (prev->span->end_line != token->span->line ||
+                             prev->span->end_column != token->span->column)) {
+        return "";
+      }
+      key << ToString(token->token_type);
+      prev = token;
     }
     return key.str();
   }
@@ -1830,32 +1839,13 @@ class Parser {
     });
   }
 
-  template <typename R>
-  R ConsumeWhitespace(std::function<R()> func) {
-    auto old = this->ignore_whitespace;
-    this->ignore_whitespace = true;
-    while (tokens[pos]->token_type == TokenType::kWhitespace) {
-      pos++;
-    }
-    auto res = func();
-    this->ignore_whitespace = old;
-    return res;
-  }
-
-  Map<String, Array<ObjectRef>> ParseMetadata() {
-    if (Peek()->token_type == TokenType::kMetadata) {
-      return Match(TokenType::kMetadata).ToMetadata();
-    } else {
-      return Map<String, Array<ObjectRef>>();
-    }
-  }
-
   /*! \brief A helper for debugging the parser, displays the next N tokens in the token stream. */
   void DisplayNextN(int n) {
     std::cout << "remaining tokens: " << std::endl;
-    auto bound = std::min(pos + n, static_cast<int>(tokens.size()));
-    for (int i = 0; i < bound - pos; i++) {
-      std::cout << tokens[pos + i] << std::endl;
+    for (int i = 0; i < n; i++) {
+      auto token = tokens.At(pos + i);
+      if (token->token_type == TokenType::kNull) break;
+      std::cout << token << std::endl;
     }
   }
 
@@ -1893,26 +1883,9 @@ Parser InitParser(const std::string& file_name, const std::string& file_content,
   module->source_map.Add(source);
 
   auto diag_ctx = DiagnosticContext::Default(module);
-  auto tokens_and_table = Tokenize(diag_ctx, source);
-
-  auto tokens = tokens_and_table.first;
-  MetaTable meta_data_table = tokens_and_table.second.ToMetadata();
-
-  // Merge any entries in init_meta_table into anything captured in the #[metadata] section
-  // of the file_content. Metadata references within file_content must use indexes which account
-  // for this ordering.
-  for (const auto& pair : init_meta_table) {
-    Array<ObjectRef> items;
-    if (meta_data_table.count(pair.first)) {
-      items = meta_data_table[pair.first];
-    }
-    for (const auto& obj : pair.second) {
-      items.push_back(obj);
-    }
-    meta_data_table.Set(pair.first, items);
-  }
-
-  return Parser(module, diag_ctx, source, tokens, DefaultOpTable(), std::move(meta_data_table));
+  // Any entries in init_meta_table are merged after those captured in the #[metadata] section of
+  // the file_content once a meta reference needs them, see Parser::GetMetaTable.
+  return Parser(module, diag_ctx, source, DefaultOpTable(), init_meta_table);
 }
 
 IRModule ParseModule(const std::string& file_name, const std::string& file_content,
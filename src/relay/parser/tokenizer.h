@@ -27,9 +27,11 @@
 #include <tvm/node/serialization.h>
 #include <tvm/runtime/object.h>
 
+#include <deque>
 #include <fstream>
 #include <limits>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -79,17 +81,27 @@ static std::unordered_map<std::string, TokenType> KEYWORD_TABLE = {
 
 struct Tokenizer {
   DiagnosticContext diag_ctx;
-  const SourceName& source_name;
+  SourceName source_name;
 
   size_t pos;
   int col;
   int line;
   char next_char;
   String source;
-  std::vector<Token> tokens;
+  /*! \brief A view of the source text, kept alive by source. */
+  std::string_view text;
+  /*! \brief A raw token read ahead by NextToken which has not been returned yet. */
+  Token lookahead;
+  /*! \brief The offset of the text following `#[metadata]`, npos until it is found. */
+  size_t metadata_begin;
+  /*! \brief Whether the metadata section has been decoded into metadata. */
+  bool metadata_decoded;
+  /*! \brief The decoded metadata section, undefined if the source has none. */
+  ObjectRef metadata;
 
   char Next() {
-    char c = this->source.at(this->pos);
+    ICHECK_LT(this->pos, this->text.size());
+    char c = this->text[this->pos];
     if (c == '\n') {
       this->line += 1;
       this->col = 1;
@@ -100,13 +112,16 @@ struct Tokenizer {
     return c;
   }
 
-  bool More() { return this->pos < this->source.size(); }
+  bool More() { return this->pos < this->text.size(); }
 
   char Peek() {
-    ICHECK(pos < this->source.size());
-    return this->source.at(this->pos);
+    ICHECK(pos < this->text.size());
+    return this->text[this->pos];
   }
 
+  /*! \brief The source text from begin up to the current position. */
+  std::string Slice(size_t begin) const { return std::string(text.substr(begin, pos - begin)); }
+
   Token NewToken(TokenType token_type, ObjectRef data = ObjectRef(), int lines = 0, int cols = 1) {
     auto span =
         Span(this->source_name, this->line, this->line + lines, this->col, this->col + cols);
@@ -259,21 +274,21 @@ struct Tokenizer {
   }
 
   Token ParseNumber(bool is_pos) {
-    std::stringstream ss;
+    size_t begin = this->pos;
     while (More() && IsNumeric(Peek())) {
-      ss << Next();
+      Next();
     }
 
     bool is_float = false;
     if (More() && (Peek() == 'f' || Peek() == 'i')) {
       is_float = Peek() == 'f';
       // Capture trailing width suffix
-      ss << Next();
+      Next();
       while (More() && IsNumeric(Peek())) {
-        ss << Next();
+        Next();
       }
     }
-    return ParseNumber(is_pos, is_float, ss.str());
+    return ParseNumber(is_pos, is_float, Slice(begin));
   }
 
   bool MatchString(const std::string& string) {
@@ -295,25 +310,27 @@ struct Tokenizer {
     int line = this->line;
     int column = this->col;
 
-    std::stringstream type_key;
+    size_t type_key_begin = this->pos;
     while (More() && Peek() != ']') {
-      type_key << Next();
+      Next();
     }
+    std::string type_key = Slice(type_key_begin);
     ICHECK_EQ(Peek(), ']');
     Next();
 
     ICHECK_EQ(Peek(), '[');
     Next();
-    std::stringstream str_index;
+    size_t index_begin = this->pos;
     while (More() && Peek() != ']') {
-      str_index << Next();
+      Next();
     }
+    std::string str_index = Slice(index_begin);
     ICHECK_EQ(Peek(), ']');
     Next();
     // todo: add error handling around bad indices
-    auto index = ParseNumber(true, false, str_index.str()).ToNumber();
+    auto index = ParseNumber(true, false, str_index).ToNumber();
     auto span = SpanFrom(line, column);
-    return Token(span, TokenType::kMetaReference, MetaRef(type_key.str(), index));
+    return Token(span, TokenType::kMetaReference, MetaRef(type_key, index));
   }
 
   Token TokenizeAttr() {
@@ -322,28 +339,26 @@ struct Tokenizer {
     Next();
     if (Peek() == '[') {
       Next();
-      std::stringstream raw_attribute;
+      size_t attribute_begin = this->pos;
 
       while (More() && Peek() != ']') {
-        raw_attribute << Next();
+        Next();
       }
 
+      auto attribute = Slice(attribute_begin);
       ICHECK_EQ(Next(), ']');
 
-      auto attribute = raw_attribute.str();
       // Clean up the white-space on both sides.
       ltrim(attribute);
       rtrim(attribute);
 
-      // Metadata can only appear at the bottom of a file and goes to EOF.
+      // Metadata can only appear at the bottom of a file and goes to EOF. It is only decoded
+      // once a meta reference needs it, see Metadata().
       if (attribute == "metadata") {
-        std::stringstream metadata;
-        while (More()) {
-          metadata << Next();
-        }
-        ObjectRef metadata_map = tvm::LoadJSON(metadata.str());
         auto span = SpanFrom(line, column);
-        return Token(span, TokenType::kMetadata, metadata_map);
+        this->metadata_begin = this->pos;
+        this->pos = this->text.size();
+        return Token(span, TokenType::kMetadata);
       }
       if (attribute.rfind("version", 0) == 0) {
         std::string version = attribute.substr(attribute.find("=") + 1);
@@ -392,12 +407,13 @@ struct Tokenizer {
       // TODO(@jroesch): Properly tokenize escape sequences in strings.
       // see https://github.com/apache/tvm/issues/6153.
       Next();
-      std::stringstream string_content;
+      size_t content_begin = this->pos;
       while (More() && Peek() != '"') {
-        string_content << Next();
+        Next();
       }
+      auto string_content = Slice(content_begin);
       Next();
-      return NewToken(TokenType::kStringLiteral, tvm::String(string_content.str()));
+      return NewToken(TokenType::kStringLiteral, tvm::String(string_content));
     } else if (IsWhitespace(next)) {
       auto token = NewToken(TokenType::kWhitespace);
       Next();
@@ -504,12 +520,12 @@ struct Tokenizer {
       auto token = NewToken(TokenType::kPercent);
       Next();
 
-      std::stringstream number;
+      size_t number_begin = this->pos;
       while (More() && IsDigit(Peek())) {
-        number << Next();
+        Next();
       }
 
-      auto number_str = number.str();
+      auto number_str = Slice(number_begin);
       if (number_str.size()) {
         auto num_tok = ParseNumber(true, false, number_str);
         auto span = SpanFrom(token->span->line, token->span->column);
@@ -523,11 +539,11 @@ struct Tokenizer {
         auto token = NewToken(TokenType::kLineComment);
         // Consume the /
         Next();
-        std::stringstream comment;
+        size_t comment_begin = this->pos;
         while (More() && Peek() != '\n') {
-          comment << Next();
+          Next();
         }
-        token->data = tvm::String(comment.str());
+        token->data = tvm::String(Slice(comment_begin));
         return token;
       } else if (Peek() == '*') {
         // Eat the first /* pair before entering the state machine.
@@ -540,18 +556,18 @@ struct Tokenizer {
         return NewToken(TokenType::kDivision);
       }
     } else if (IsIdentLetter(next)) {
-      std::stringstream ss;
       // Due the below code we need to patch
       // the line/col info to the start of
       // token.
       int line = this->line;
       int col = this->col;
+      size_t begin = this->pos;
 
       while (More() && IsIdent(Peek())) {
-        ss << Next();
+        Next();
       }
 
-      std::string keyword = ss.str();
+      std::string keyword = Slice(begin);
       auto it = KEYWORD_TABLE.find(keyword);
 
       TokenType token_type;
@@ -569,128 +585,215 @@ struct Tokenizer {
       }
 
       auto span = SpanFrom(line, col);
-      return Token(span, token_type, tvm::String(ss.str()));
+      return Token(span, token_type, tvm::String(keyword));
     } else {
-      std::stringstream ss;
+      size_t begin = this->pos;
       while (More() && !IsWhitespace(Peek())) {
-        ss << Next();
+        Next();
       }
       auto token = NewToken(TokenType::kUnknown);
-      token->data = tvm::String(ss.str());
+      token->data = tvm::String(Slice(begin));
       return token;
     }
   }
 
-  void Tokenize() {
-    VLOG(9) << "tvm::relay::Tokenize";
-    while (this->More()) {
-      auto token = TokenizeOnce();
-      ICHECK(token.defined());
-      this->tokens.push_back(token);
+  /*! \brief Read the next raw token, starting with one put back by NextToken. */
+  Token NextRawToken() {
+    if (lookahead.defined()) {
+      Token token = lookahead;
+      lookahead = Token();
+      return token;
     }
-    this->tokens.push_back(NewToken(TokenType::kEndOfFile));
+    if (!More()) {
+      return NewToken(TokenType::kEndOfFile);
+    }
+    auto token = TokenizeOnce();
+    ICHECK(token.defined());
+    return token;
   }
 
-  explicit Tokenizer(const DiagnosticContext& ctx, const Source& source)
-      : diag_ctx(ctx),
-        source_name(source->source_name),
-        pos(0),
-        col(1),
-        line(1),
-        source(source->source),
-        tokens() {}
-};
-
-inline std::vector<Token> Condense(const std::vector<Token>& tokens, Token* table) {
-  std::vector<Token> out;
-  bool found_metadata = false;
-
-  for (size_t i = 0; i < tokens.size(); i++) {
-    auto current = tokens.at(i);
-    switch (current->token_type) {
-      case TokenType::kMetadata: {
-        if (!found_metadata) {
-          found_metadata = true;
-          *table = current;
-        } else {
-          LOG(FATAL) << "duplicate metadata section";
+  /*!
+   * \brief Produce the next token for the parser.
+   *
+   * Whitespace, comments and the metadata section are dropped, `%` and `@` are merged with
+   * the identifier or number directly following them, and `True`, `False` and `_` become
+   * boolean and underscore tokens. Returns kEndOfFile once the source is exhausted.
+   */
+  Token NextToken() {
+    while (true) {
+      // Skip runs of whitespace without materializing a token for each character.
+      if (!lookahead.defined()) {
+        while (More() && IsWhitespace(Peek())) {
+          Next();
         }
-        continue;
       }
-      case TokenType::kPercent: {
-        auto next = tokens.at(i + 1);
-        if (next->token_type == TokenType::kIdentifier) {
-          // Match this token.
-          i += 1;
-          // TODO(@jroesch): merge spans
-          auto tok = Token(current->span, TokenType::kLocal, next->data);
-          ICHECK(tok.defined());
-          out.push_back(tok);
-        } else if (next->token_type == TokenType::kInteger) {
-          i += 1;
-          auto tok = Token(current->span, TokenType::kGraph, next->data);
-          ICHECK(tok.defined());
-          out.push_back(tok);
-        } else {
-          ICHECK(current.defined());
-          out.push_back(current);
+      Token current = NextRawToken();
+      switch (current->token_type) {
+        case TokenType::kWhitespace:
+        case TokenType::kNewline:
+        case TokenType::kLineComment:
+        case TokenType::kComment:
+        case TokenType::kMetadata:
+          continue;
+        case TokenType::kPercent: {
+          auto next = NextRawToken();
+          if (next->token_type == TokenType::kIdentifier) {
+            // TODO(@jroesch): merge spans
+            return Token(current->span, TokenType::kLocal, next->data);
+          } else if (next->token_type == TokenType::kInteger) {
+            return Token(current->span, TokenType::kGraph, next->data);
+          }
+          lookahead = next;
+          return current;
         }
-        continue;
-      }
-      case TokenType::kAt: {
-        auto next = tokens.at(i + 1);
-        if (next->token_type == TokenType::kIdentifier) {
-          // Match this token.
-          i += 1;
+        case TokenType::kAt: {
+          auto next = NextRawToken();
+          if (next->token_type == TokenType::kIdentifier) {
+            // TODO(@jroesch): merge spans
+            return Token(current->span, TokenType::kGlobal, next->data);
+          }
+          lookahead = next;
+          return current;
+        }
+        case TokenType::kIdentifier: {
+          std::string str = Downcast<tvm::String>(current->data);
           // TODO(@jroesch): merge spans
-          auto tok = Token(current->span, TokenType::kGlobal, next->data);
-          ICHECK(tok.defined());
-          out.push_back(tok);
-        } else {
-          ICHECK(current.defined());
-          out.push_back(current);
+          if (str == "True") {
+            return Token(current->span, TokenType::kBoolean, tvm::Integer(1));
+          } else if (str == "False") {
+            return Token(current->span, TokenType::kBoolean, tvm::Integer(0));
+          } else if (str == "_") {
+            return Token(current->span, TokenType::kUnderscore);
+          }
+          return current;
         }
-        continue;
+        default:
+          return current;
       }
-      case TokenType::kIdentifier: {
-        std::string str = Downcast<tvm::String>(current->data);
-        Token tok;
-        // TODO(@jroesch): merge spans
-        if (str == "True") {
-          auto data = tvm::Integer(1);
-          tok = Token(current->span, TokenType::kBoolean, data);
-        } else if (str == "False") {
-          auto data = tvm::Integer(0);
-          tok = Token(current->span, TokenType::kBoolean, data);
-        } else if (str == "_") {
-          tok = Token(current->span, TokenType::kUnderscore);
-        } else {
-          tok = current;
+    }
+  }
+
+  /*!
+   * \brief Find the text following `#[metadata]` without tokenizing, skipping over string
+   * literals and comments.
+   * \param begin The offset to start searching from, which must be between tokens.
+   * \return The offset, or npos if the source has no metadata section.
+   */
+  size_t FindMetadata(size_t begin) const {
+    size_t i = begin;
+    while (i < text.size()) {
+      if (text[i] == '"') {
+        i = text.find('"', i + 1);
+        if (i == std::string_view::npos) break;
+      } else if (text.compare(i, 2, "//") == 0) {
+        i = text.find('\n', i);
+        if (i == std::string_view::npos) break;
+      } else if (text.compare(i, 2, "/*") == 0) {
+        int nesting = 1;
+        for (i += 2; i < text.size() && nesting > 0; ++i) {
+          if (text.compare(i, 2, "/*") == 0) {
+            ++nesting;
+            ++i;
+          } else if (text.compare(i, 2, "*/") == 0) {
+            --nesting;
+            ++i;
+          }
         }
-        out.push_back(tok);
         continue;
+      } else if (text.compare(i, 2, "#[") == 0) {
+        size_t end = text.find(']', i + 2);
+        if (end == std::string_view::npos) break;
+        std::string attribute(text.substr(i + 2, end - i - 2));
+        ltrim(attribute);
+        rtrim(attribute);
+        if (attribute == "metadata") {
+          return end + 1;
+        }
+        i = end;
       }
-      default: {
-        out.push_back(current);
-        continue;
+      ++i;
+    }
+    return std::string_view::npos;
+  }
+
+  /*!
+   * \brief The metadata section of the source, decoded on first use.
+   *
+   * Large modules keep their constants in the metadata section, so it is only decoded when a
+   * meta reference is parsed. If the tokenizer has not reached the section yet it is located by
+   * scanning ahead.
+   */
+  ObjectRef Metadata() {
+    if (!metadata_decoded) {
+      metadata_decoded = true;
+      if (metadata_begin == std::string_view::npos) {
+        metadata_begin = FindMetadata(this->pos);
+      }
+      if (metadata_begin != std::string_view::npos) {
+        metadata = tvm::LoadJSON(std::string(text.substr(metadata_begin)));
       }
     }
+    return metadata;
   }
 
-  return out;
-}
+  explicit Tokenizer(const DiagnosticContext& ctx, const Source& source)
+      : diag_ctx(ctx),
+        source_name(source->source_name),
+        pos(0),
+        col(1),
+        line(1),
+        source(source->source),
+        text(this->source.data(), this->source.size()),
+        metadata_begin(std::string_view::npos),
+        metadata_decoded(false) {}
+};
 
-inline std::pair<std::vector<Token>, Token> Tokenize(const DiagnosticContext& ctx,
-                                                     const Source& source) {
-  auto tokenizer = Tokenizer(ctx, source);
-  tokenizer.Tokenize();
-  Token meta_table(Span(), TokenType::kUnknown, ObjectRef());
-  auto tokens = Condense(tokenizer.tokens, &meta_table);
-  for (auto token : tokens) {
-    ICHECK(token.defined());
+/*!
+ * \brief The parser's window on the token stream.
+ *
+ * Tokens are addressed by their absolute index in the stream, but are only tokenized when the
+ * parser first looks at them and are dropped once it has consumed them. Memory is therefore
+ * proportional to the parser's lookahead rather than to the size of the source.
+ */
+class TokenStream {
+ public:
+  explicit TokenStream(const DiagnosticContext& ctx, const Source& source)
+      : tokenizer_(ctx, source) {}
+
+  /*! \brief The token at index, or Token::Null() past the end of the file. */
+  Token At(int64_t index) {
+    ICHECK_GE(index, begin_) << "internal error: token " << index << " was already released";
+    while (!finished_ && index >= begin_ + static_cast<int64_t>(buffer_.size())) {
+      Token token = tokenizer_.NextToken();
+      finished_ = token->token_type == TokenType::kEndOfFile;
+      buffer_.push_back(token);
+    }
+    if (index >= begin_ + static_cast<int64_t>(buffer_.size())) {
+      return Token::Null();
+    }
+    return buffer_[index - begin_];
   }
-  return {tokens, meta_table};
-}
+
+  /*! \brief Drop the tokens before index, keeping a few for the parser to step back to. */
+  void Release(int64_t index) {
+    while (begin_ < index - kHistory && !buffer_.empty()) {
+      buffer_.pop_front();
+      begin_++;
+    }
+  }
+
+  /*! \brief The decoded metadata section of the source, see Tokenizer::Metadata(). */
+  ObjectRef Metadata() { return tokenizer_.Metadata(); }
+
+ private:
+  /*! \brief The number of consumed tokens kept for backtracking and span lookups. */
+  static constexpr int64_t kHistory = 4;
+
+  Tokenizer tokenizer_;
+  std::deque<Token> buffer_;
+  int64_t begin_{0};
+  bool finished_{false};
+};
 
 }  // namespace relay
 }  // namespace tvm
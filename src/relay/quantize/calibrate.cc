@@ -26,7 +26,12 @@
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <numeric>
 
 #include "./quantize.h"
@@ -79,70 +84,233 @@ static float ComputeEntropy(float* p, float* q, size_t size) {
   return ret;
 }
 
-float MinimizeKL(const std::vector<int>& hist, const std::vector<float>& hist_edges, int num_bins,
-                 int num_quantized_bins) {
+/*!
+ * \brief KL divergence between the reference distribution clipped to the central 2 * i + 1 bins
+ * of hist and its quantized version.
+ */
+static float KLDivergenceAt(const std::vector<int64_t>& hist, int num_bins, int num_quantized_bins,
+                            int i) {
   const int zero_bin_idx = num_bins / 2;
-  const int num_half_quantized_bins = num_quantized_bins / 2;
-  std::vector<float> thresholds(num_bins / 2 + 1 - num_quantized_bins / 2, 0.f);
-  std::vector<float> divergence(thresholds.size(), 0.f);
-  std::vector<float> quantized_bins(num_quantized_bins, 0);
-  for (int i = num_quantized_bins / 2; i < zero_bin_idx + 1; ++i) {
-    const int p_bin_idx_start = zero_bin_idx - i;
-    const int p_bin_idx_stop = zero_bin_idx + i + 1;
-    thresholds[i - num_half_quantized_bins] = hist_edges[p_bin_idx_stop];
-
-    std::vector<int> sliced_nd_hist(p_bin_idx_stop - p_bin_idx_start);
-    std::vector<float> p(sliced_nd_hist.size());
-    p[0] = 0;
-    p.back() = 0;
-    for (int j = 0; j < num_bins; j++) {
-      if (j <= p_bin_idx_start) {
-        p[0] += hist[j];
-      } else if (j >= p_bin_idx_stop) {
-        p.back() += hist[j];
-      } else {
-        sliced_nd_hist[j - p_bin_idx_start] = hist[j];
-        p[j - p_bin_idx_start] = hist[j];
-      }
-    }
-    // calculate how many bins should be merged to generate quantized distribution q
-    const auto num_merged_bins = sliced_nd_hist.size() / num_quantized_bins;
-    for (int j = 0; j < num_quantized_bins; j++) {
-      const int start = j * num_merged_bins;
-      const int stop = (j + 1) * num_merged_bins;
-      quantized_bins[j] =
-          std::accumulate(sliced_nd_hist.begin() + start, sliced_nd_hist.begin() + stop, 0);
+  const int p_bin_idx_start = zero_bin_idx - i;
+  const int p_bin_idx_stop = zero_bin_idx + i + 1;
+
+  std::vector<int64_t> sliced_nd_hist(p_bin_idx_stop - p_bin_idx_start);
+  std::vector<float> p(sliced_nd_hist.size());
+  p[0] = 0;
+  p.back() = 0;
+  for (int j = 0; j < num_bins; j++) {
+    if (j <= p_bin_idx_start) {
+      p[0] += hist[j];
+    } else if (j >= p_bin_idx_stop) {
+      p.back() += hist[j];
+    } else {
+      sliced_nd_hist[j - p_bin_idx_start] = hist[j];
+      p[j - p_bin_idx_start] = hist[j];
     }
-    quantized_bins.back() += std::accumulate(
-        sliced_nd_hist.begin() + static_cast<int>(num_quantized_bins * num_merged_bins),
-        sliced_nd_hist.end(), 0);
-    // expand quantized_bins into p.size bins
-    std::vector<float> q(sliced_nd_hist.size(), 0);
-    for (int j = 0; j < num_quantized_bins; j++) {
-      const int start = j * num_merged_bins;
-      const int stop = (j == num_quantized_bins - 1) ? q.size() : ((j + 1) * num_merged_bins);
-      int norm = std::count_if(sliced_nd_hist.begin() + start, sliced_nd_hist.begin() + stop,
-                               [](size_t i) { return i != 0; });
-      if (norm) {
-        for (int k = start; k < stop; k++) {
-          if (p[k]) q[k] = quantized_bins[j] / norm;
-        }
+  }
+  // calculate how many bins should be merged to generate quantized distribution q
+  std::vector<float> quantized_bins(num_quantized_bins, 0);
+  const auto num_merged_bins = sliced_nd_hist.size() / num_quantized_bins;
+  for (int j = 0; j < num_quantized_bins; j++) {
+    const int start = j * num_merged_bins;
+    const int stop = (j + 1) * num_merged_bins;
+    quantized_bins[j] = std::accumulate(sliced_nd_hist.begin() + start,
+                                        sliced_nd_hist.begin() + stop, int64_t{0});
+  }
+  quantized_bins.back() += std::accumulate(
+      sliced_nd_hist.begin() + static_cast<int>(num_quantized_bins * num_merged_bins),
+      sliced_nd_hist.end(), int64_t{0});
+  // expand quantized_bins into p.size bins
+  std::vector<float> q(sliced_nd_hist.size(), 0);
+  for (int j = 0; j < num_quantized_bins; j++) {
+    const int start = j * num_merged_bins;
+    const int stop = (j == num_quantized_bins - 1) ? q.size() : ((j + 1) * num_merged_bins);
+    int norm = std::count_if(sliced_nd_hist.begin() + start, sliced_nd_hist.begin() + stop,
+                             [](int64_t i) { return i != 0; });
+    if (norm) {
+      for (int k = start; k < stop; k++) {
+        if (p[k]) q[k] = quantized_bins[j] / norm;
       }
     }
-    p = SmoothDistribution(p);
-    q = SmoothDistribution(q);
+  }
+  p = SmoothDistribution(p);
+  q = SmoothDistribution(q);
 
-    if (!q.size()) {
-      divergence[i - num_half_quantized_bins] = std::numeric_limits<float>::infinity();
-    } else {
-      divergence[i - num_half_quantized_bins] = ComputeEntropy(p.data(), q.data(), p.size());
-    }
+  if (!q.size()) {
+    return std::numeric_limits<float>::infinity();
+  }
+  return ComputeEntropy(p.data(), q.data(), p.size());
+}
+
+float MinimizeKL(const std::vector<int64_t>& hist, const std::vector<float>& hist_edges,
+                 int num_bins, int num_quantized_bins) {
+  const int zero_bin_idx = num_bins / 2;
+  const int num_half_quantized_bins = num_quantized_bins / 2;
+  std::vector<float> thresholds(num_bins / 2 + 1 - num_quantized_bins / 2, 0.f);
+  std::vector<float> divergence(thresholds.size(), 0.f);
+  for (int i = num_quantized_bins / 2; i < zero_bin_idx + 1; ++i) {
+    thresholds[i - num_half_quantized_bins] = hist_edges[zero_bin_idx + i + 1];
+    divergence[i - num_half_quantized_bins] =
+        KLDivergenceAt(hist, num_bins, num_quantized_bins, i);
   }
   auto min_divergence_idx =
       std::distance(divergence.begin(), std::min_element(divergence.begin(), divergence.end()));
   return thresholds[min_divergence_idx];
 }
 
+/*! \brief Get a float32 tensor in host memory, copying it from the device if needed. */
+static runtime::NDArray HostFloatTensor(const runtime::NDArray& arr) {
+  ICHECK(arr.DataType() == DataType::Float(32))
+      << "ValueError: Calibration expects float32 tensors, but got " << arr.DataType();
+  ICHECK(arr.IsContiguous()) << "ValueError: Calibration expects contiguous tensors";
+  if (arr->device.device_type == kDLCPU) return arr;
+  return arr.CopyTo(Device{kDLCPU, 0});
+}
+
+/*! \brief Check an array the calibration builtins read or update in place. */
+static void CheckHostArray(const runtime::NDArray& arr, DataType dtype, int ndim,
+                           const char* name) {
+  ICHECK(arr->device.device_type == kDLCPU) << "ValueError: " << name << " must be on the CPU";
+  ICHECK(arr.DataType() == dtype) << "ValueError: " << name << " must be " << dtype
+                                  << ", but got " << arr.DataType();
+  ICHECK_EQ(arr->ndim, ndim) << "ValueError: " << name << " must be " << ndim << "-d";
+  ICHECK(arr.IsContiguous()) << "ValueError: " << name << " must be contiguous";
+}
+
+/*! \brief The worker count of the TVM thread pool, which honors TVM_NUM_THREADS. */
+static int NumCalibrationThreads() { return std::max(1, runtime::threading::NumThreads()); }
+
+/*!
+ * \brief Fold the value range of one output of every layer into min_max.
+ *
+ * \param outputs One tensor per layer.
+ * \param min_max float32 array of shape (num_layers, 2), updated in place.
+ */
+void AccumulateMinMax(const Array<runtime::NDArray>& outputs, runtime::NDArray min_max) {
+  CheckHostArray(min_max, DataType::Float(32), 2, "min_max");
+  ICHECK_EQ(min_max.Shape()[0], static_cast<int64_t>(outputs.size()));
+  ICHECK_EQ(min_max.Shape()[1], 2);
+  float* range = static_cast<float*>(min_max->data);
+  support::parallel_for_dynamic(
+      0, outputs.size(), NumCalibrationThreads(), [&](int thread_id, int layer) {
+        runtime::NDArray data = HostFloatTensor(outputs[layer]);
+        const float* x = static_cast<const float*>(data->data);
+        const int64_t size = runtime::GetDataSize(*data.operator->()) / sizeof(float);
+        // Independent lanes so the loop vectorizes without reassociating a single reduction.
+        constexpr int kLanes = 8;
+        float lo[kLanes], hi[kLanes];
+        std::fill(lo, lo + kLanes, range[layer * 2]);
+        std::fill(hi, hi + kLanes, range[layer * 2 + 1]);
+        int64_t i = 0;
+        for (; i + kLanes <= size; i += kLanes) {
+          for (int k = 0; k < kLanes; k++) {
+            lo[k] = x[i + k] < lo[k] ? x[i + k] : lo[k];
+            hi[k] = x[i + k] > hi[k] ? x[i + k] : hi[k];
+          }
+        }
+        for (; i < size; i++) {
+          lo[0] = std::min(lo[0], x[i]);
+          hi[0] = std::max(hi[0], x[i]);
+        }
+        range[layer * 2] = *std::min_element(lo, lo + kLanes);
+        range[layer * 2 + 1] = *std::max_element(hi, hi + kLanes);
+      });
+}
+
+/*!
+ * \brief Add one output of every layer to its histogram over [-thres, thres].
+ *
+ * Bins follow numpy.histogram, the last bin is closed on the right and NaN values are skipped.
+ *
+ * \param outputs One tensor per layer.
+ * \param hists int64 array of shape (num_layers, num_bins), updated in place.
+ * \param thres float32 array of shape (num_layers,), the range of every histogram.
+ */
+void AccumulateHistograms(const Array<runtime::NDArray>& outputs, runtime::NDArray hists,
+                          runtime::NDArray thres) {
+  CheckHostArray(hists, DataType::Int(64), 2, "hists");
+  CheckHostArray(thres, DataType::Float(32), 1, "thres");
+  ICHECK_EQ(hists.Shape()[0], static_cast<int64_t>(outputs.size()));
+  ICHECK_EQ(thres.Shape()[0], static_cast<int64_t>(outputs.size()));
+  const int64_t num_bins = hists.Shape()[1];
+  support::parallel_for_dynamic(
+      0, outputs.size(), NumCalibrationThreads(), [&](int thread_id, int layer) {
+        runtime::NDArray data = HostFloatTensor(outputs[layer]);
+        const float* x = static_cast<const float*>(data->data);
+        const int64_t size = runtime::GetDataSize(*data.operator->()) / sizeof(float);
+        int64_t* hist = static_cast<int64_t*>(hists->data) + layer * num_bins;
+        const float t = static_cast<const float*>(thres->data)[layer];
+        ICHECK(std::isfinite(t) && t > 0)
+            << "ValueError: the histogram range of layer " << layer << " is " << t;
+        const float scale = num_bins / (2 * t);
+        // Compute bin indices in blocks, which vectorizes, then scatter the counts.
+        constexpr int64_t kBlock = 256;
+        int32_t bins[kBlock];
+        for (int64_t begin = 0; begin < size; begin += kBlock) {
+          const int64_t n = std::min(kBlock, size - begin);
+          for (int64_t i = 0; i < n; i++) {
+            float b = (x[begin + i] + t) * scale;
+            // Both clamps are false for NaN, mark it with -1 before the cast.
+            bool valid = b == b;
+            b = valid ? b : 0.f;
+            b = b < 0.f ? 0.f : b;
+            b = b > num_bins - 1 ? num_bins - 1 : b;
+            bins[i] = valid ? static_cast<int32_t>(b) : -1;
+          }
+          for (int64_t i = 0; i < n; i++) {
+            if (bins[i] >= 0) ++hist[bins[i]];
+          }
+        }
+      });
+}
+
+/*!
+ * \brief Find the KL minimizing threshold of every layer.
+ *
+ * The candidate thresholds of all layers are evaluated in parallel.
+ *
+ * \param hists int64 array of shape (num_layers, num_bins), histograms over [-thres, thres].
+ * \param thres float32 array of shape (num_layers,).
+ * \param num_quantized_bins The number of bins of the quantized distribution.
+ * \return float32 array of shape (num_layers,), the threshold of every layer.
+ */
+runtime::NDArray FindScalesByKLMinimization(runtime::NDArray hists, runtime::NDArray thres,
+                                            int num_quantized_bins) {
+  CheckHostArray(hists, DataType::Int(64), 2, "hists");
+  CheckHostArray(thres, DataType::Float(32), 1, "thres");
+  const int num_layers = hists.Shape()[0];
+  const int num_bins = hists.Shape()[1];
+  const int zero_bin_idx = num_bins / 2;
+  const int num_half_quantized_bins = num_quantized_bins / 2;
+  const int num_candidates = zero_bin_idx + 1 - num_half_quantized_bins;
+  ICHECK_GT(num_candidates, 0) << "ValueError: num_bins must be larger than num_quantized_bins";
+
+  std::vector<std::vector<int64_t>> layer_hists(num_layers);
+  for (int layer = 0; layer < num_layers; layer++) {
+    const int64_t* hist = static_cast<const int64_t*>(hists->data) + layer * num_bins;
+    layer_hists[layer].assign(hist, hist + num_bins);
+  }
+  std::vector<float> divergence(num_layers * num_candidates);
+  support::parallel_for_dynamic(
+      0, divergence.size(), NumCalibrationThreads(), [&](int thread_id, int task) {
+        int layer = task / num_candidates;
+        int i = task % num_candidates + num_half_quantized_bins;
+        divergence[task] = KLDivergenceAt(layer_hists[layer], num_bins, num_quantized_bins, i);
+      });
+
+  runtime::NDArray scales =
+      runtime::NDArray::Empty({num_layers}, DataType::Float(32), Device{kDLCPU, 0});
+  for (int layer = 0; layer < num_layers; layer++) {
+    auto begin = divergence.begin() + layer * num_candidates;
+    int i = std::distance(begin, std::min_element(begin, begin + num_candidates)) +
+            num_half_quantized_bins;
+    // The upper edge of bin zero_bin_idx + i, numpy.histogram edges of [-thres, thres].
+    float t = static_cast<const float*>(thres->data)[layer];
+    static_cast<float*>(scales->data)[layer] = -t + 2 * t * (zero_bin_idx + i + 1) / num_bins;
+  }
+  return scales;
+}
+
 class StatsCollector : private ExprMutator {
  public:
   StatsCollector() : simulated_quantize_op_(Op::Get("relay.op.annotation.simulated_quantize")) {}
@@ -214,11 +382,18 @@ TVM_REGISTER_GLOBAL("relay._quantize.FindScaleByKLMinimization")
       float* hist_edges_ptr = static_cast<float*>(static_cast<void*>(args[1]));
       int num_bins = args[2];
       int num_quantized_bins = args[3];
-      std::vector<int> hist(hist_ptr, hist_ptr + num_bins);
+      std::vector<int64_t> hist(hist_ptr, hist_ptr + num_bins);
       std::vector<float> hist_edges(hist_edges_ptr, hist_edges_ptr + num_bins + 1);
       ret[0] = MinimizeKL(hist, hist_edges, num_bins, num_quantized_bins);
     });
 
+TVM_REGISTER_GLOBAL("relay._quantize.AccumulateMinMax").set_body_typed(AccumulateMinMax);
+
+TVM_REGISTER_GLOBAL("relay._quantize.AccumulateHistograms").set_body_typed(AccumulateHistograms);
+
+TVM_REGISTER_GLOBAL("relay._quantize.FindScalesByKLMinimization")
+    .set_body_typed(FindScalesByKLMinimization);
+
 }  // namespace quantize
 }  // namespace relay
 }  // namespace tvm
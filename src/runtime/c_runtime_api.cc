@@ -33,8 +33,10 @@
 #include <array>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "object_internal.h"
 #include "runtime_base.h"
@@ -171,13 +173,74 @@ void* DeviceAPI::AllocDataSpace(Device dev, int ndim, const int64_t* shape, DLDa
   return nullptr;
 }
 
+/*!
+ * \brief Copy between two host tensors of the same shape, either of which may be strided.
+ *  Runs of the innermost dimension that are contiguous on both sides are copied with memcpy.
+ */
+static void CopyStridedHostData(const DLTensor* from, DLTensor* to) {
+  ICHECK_EQ(from->ndim, to->ndim);
+  ICHECK_EQ(from->dtype.bits % 8, 0) << "Strided copy of sub-byte data types is not supported";
+  int ndim = from->ndim;
+  int64_t elem_bytes = (from->dtype.bits * from->dtype.lanes + 7) / 8;
+  auto get_strides = [ndim](const DLTensor* arr) {
+    std::vector<int64_t> strides(ndim);
+    int64_t stride = 1;
+    for (int i = ndim - 1; i >= 0; --i) {
+      strides[i] = arr->strides != nullptr ? arr->strides[i] : stride;
+      stride *= arr->shape[i];
+    }
+    return strides;
+  };
+  std::vector<int64_t> from_strides = get_strides(from);
+  std::vector<int64_t> to_strides = get_strides(to);
+  for (int i = 0; i < ndim; ++i) {
+    ICHECK_EQ(from->shape[i], to->shape[i]);
+    if (from->shape[i] == 0) return;
+  }
+  const char* src = static_cast<const char*>(from->data) + from->byte_offset;
+  char* dst = static_cast<char*>(to->data) + to->byte_offset;
+  if (ndim == 0) {
+    std::memcpy(dst, src, elem_bytes);
+    return;
+  }
+  int64_t inner = from->shape[ndim - 1];
+  bool inner_contiguous = from_strides[ndim - 1] == 1 && to_strides[ndim - 1] == 1;
+  // Walk the outer ndim - 1 dimensions in row-major order.
+  std::vector<int64_t> index(ndim - 1, 0);
+  while (true) {
+    int64_t src_offset = 0, dst_offset = 0;
+    for (int i = 0; i < ndim - 1; ++i) {
+      src_offset += index[i] * from_strides[i];
+      dst_offset += index[i] * to_strides[i];
+    }
+    if (inner_contiguous) {
+      std::memcpy(dst + dst_offset * elem_bytes, src + src_offset * elem_bytes, inner * elem_bytes);
+    } else {
+      for (int64_t j = 0; j < inner; ++j) {
+        std::memcpy(dst + (dst_offset + j * to_strides[ndim - 1]) * elem_bytes,
+                    src + (src_offset + j * from_strides[ndim - 1]) * elem_bytes, elem_bytes);
+      }
+    }
+    int axis = ndim - 2;
+    while (axis >= 0 && ++index[axis] == from->shape[axis]) {
+      index[axis--] = 0;
+    }
+    if (axis < 0) break;
+  }
+}
+
 void DeviceAPI::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHandle stream) {
   // by default, we can always redirect to the flat memory copy operation.
   size_t nbytes = GetDataSize(*from);
   ICHECK_EQ(nbytes, GetDataSize(*to));
 
-  ICHECK(IsContiguous(*from) && IsContiguous(*to))
-      << "CopyDataFromTo only support contiguous array for now";
+  if (!IsContiguous(*from) || !IsContiguous(*to)) {
+    // Strided views are only supported for copies between host tensors.
+    ICHECK(from->device.device_type == kDLCPU && to->device.device_type == kDLCPU)
+        << "CopyDataFromTo only support contiguous array for now";
+    CopyStridedHostData(from, to);
+    return;
+  }
   CopyDataFromTo(from->data, from->byte_offset, to->data, to->byte_offset, nbytes, from->device,
                  to->device, from->dtype, stream);
 }
@@ -22,10 +22,16 @@
  * \brief A simple JSON runtime for DNNL.
  */
 
+#include <dmlc/parameter.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
 #include <vector>
@@ -65,36 +71,36 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     // Setup constants entries for weights.
     SetupConstants(consts);
-    BuildEngine();
+
+    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
+    stream_ = dnnl::stream(engine_);
+    // Independent primitives of a wave run concurrently on up to this many streams.
+    int num_streams = std::max(1, dmlc::GetEnv("TVM_DNNL_INTER_OP_STREAMS", 1));
+    streams_ = {stream_};
+    for (int i = 1; i < num_streams; i++) streams_.emplace_back(engine_);
+
+    // A static graph has a single plan, build it now so unsupported ops fail early.
+    ShapeKey graph_shapes = GraphInputShapes();
+    bool is_static = std::all_of(graph_shapes.begin(), graph_shapes.end(), [](const auto& shape) {
+      return std::all_of(shape.begin(), shape.end(), [](int64_t dim) { return dim >= 0; });
+    });
+    if (is_static) GetPlan(graph_shapes);
   }
 
   /* Unused stub implementation */
   void Run() override { LOG(FATAL) << "Unreachable code"; }
 
-  /* Thread safe implementation of Run. Keep runtime instance immutable */
-  void Run(const TVMArgs& args) const {
-    auto arg_data_provider = makeIODataProvider(args);
-    auto mem_solver = tensor_registry_.MakeSolver(arg_data_provider);
-    // Execute primitives one by one
-    for (const auto& act : net_) {
-      auto prim = std::get<0>(act);
-      auto arg_reqs = std::get<1>(act);
-
-      // Find proper dnnl::memory buffers
-      std::unordered_map<int, dnnl::memory> mem_args;
-      for (const auto& kvp : arg_reqs) mem_args[kvp.first] = mem_solver(kvp.second);
-
-      // skip the reorder if src==dst to enable inplace operation
-      if (prim.get_kind() == dnnl::primitive::kind::reorder) {
-        const auto& mem_src = mem_args.at(DNNL_ARG_SRC);
-        const auto& mem_dst = mem_args.at(DNNL_ARG_DST);
-        if ((mem_src.get_desc() == mem_dst.get_desc()) &&
-            (mem_src.get_data_handle() == mem_dst.get_data_handle())) {
-          continue;
-        }
-      }
-
-      prim.execute(stream_, mem_args);
+  /* Thread safe implementation of Run. Plans of new input shapes are built under build_mutex_ */
+  void Run(const TVMArgs& args) {
+    auto plan = GetPlan(InputShapes(args));
+    // Reuse the memory objects bound by the previous call while the IO buffers stay the same.
+    // The cached binding is used by one caller at a time, concurrent callers bind privately.
+    std::unique_lock<std::mutex> lock(plan->bound_mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+      if (!plan->bound.SameIO(args)) plan->bound = Bind(*plan, args);
+      Execute(*plan, plan->bound);
+    } else {
+      Execute(*plan, Bind(*plan, args));
     }
   }
 
@@ -116,16 +122,9 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
   /* Same as makeInitDataProvider but in case of InputOutput return real DLTensor */
   TensorRegistry::DLTensorProvider makeIODataProvider(const TVMArgs& args) const {
-    auto extract_dl_tensor = [](const TVMArgValue& val) -> const DLTensor* {
-      ICHECK(val.type_code() == kTVMNDArrayHandle || val.type_code() == kTVMDLTensorHandle)
-          << "Expect NDArray or DLTensor";
-      return val.IsObjectRef<NDArray>() ? val.operator NDArray().operator->()
-                                        : val.operator DLTensor*();
-    };
-
     std::map<uint32_t, const DLTensor*> io_map;  // eid to dl tensor map
     for (size_t i = 0; i < run_arg_eid_.size(); i++) {
-      io_map[run_arg_eid_[i]] = extract_dl_tensor(args[i]);
+      io_map[run_arg_eid_[i]] = ExtractDLTensor(args[i]);
     }
 
     // lambda with captured IO data handlers
@@ -133,6 +132,236 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   }
 
  private:
+  /*! \brief Memory objects of all actions, resolved for one set of IO buffers. */
+  struct BoundArgs {
+    /*! \brief Data pointers of the IO tensors this binding was made for. */
+    std::vector<void*> io_data;
+    /*! \brief Keeps the intermediate buffers referenced by mem_args alive. */
+    TensorRegistry::MemSolver solver;
+    /*! \brief Arguments of every action of the plan net. */
+    std::vector<std::unordered_map<int, dnnl::memory>> mem_args;
+    /*! \brief Private scratchpads of the inter-op streams, stream 0 uses the shared one. */
+    std::vector<dnnl::memory> scratchpads;
+
+    bool SameIO(const TVMArgs& args) const {
+      if (io_data.size() != static_cast<size_t>(args.size())) return false;
+      for (size_t i = 0; i < io_data.size(); i++) {
+        if (ExtractDLTensor(args[i])->data != io_data[i]) return false;
+      }
+      return true;
+    }
+  };
+
+  /*! \brief The primitives and memory objects of the subgraph for one set of input shapes. */
+  struct Plan {
+    /*! \brief The network layers that are represented in dnnl primitives. */
+    TensorRegistry::ActionQue net;
+    /*! \brief Indices of net actions grouped into waves of independent primitives. */
+    std::vector<std::vector<size_t>> waves;
+    /*! \brief The stream index of each net action within its wave. */
+    std::vector<size_t> action_stream;
+    /*! \brief Storage for all memory objects. */
+    TensorRegistry tensor_registry;
+    /*! \brief The binding of the last call, reused while the IO buffers stay the same. */
+    BoundArgs bound;
+    std::mutex bound_mutex;
+  };
+
+  ShapeTuple GetStateCacheStats() const override { return plans_.Stats(); }
+
+  std::shared_ptr<Plan> GetPlan(const ShapeKey& shapes) {
+    return plans_.GetOrBuild(shapes, [this](const ShapeKey& key) { return BuildPlan(key); });
+  }
+
+  std::shared_ptr<Plan> BuildPlan(const ShapeKey& shapes) {
+    std::lock_guard<std::mutex> lock(build_mutex_);
+    BindDynamicExtents(shapes);
+    plan_ = std::make_shared<Plan>();
+    next_unique_eid_offset_ = data_entry_.size();
+    BuildEngine();
+    return std::move(plan_);
+  }
+
+  /*!
+   * \brief Record the extents of the dynamic axes for the input shapes of a call.
+   *
+   * A dynamic (-1) dimension on axis k of any tensor of the graph takes the extent of axis k of
+   * the inputs which are dynamic on that axis, e.g. a dynamic batch. These inputs must agree.
+   */
+  void BindDynamicExtents(const ShapeKey& shapes) {
+    ShapeKey graph_shapes = GraphInputShapes();
+    ICHECK_EQ(shapes.size(), graph_shapes.size());
+    dynamic_extents_.clear();
+    for (size_t i = 0; i < shapes.size(); i++) {
+      ICHECK_EQ(shapes[i].size(), graph_shapes[i].size())
+          << "DNNL runtime. Rank mismatch of input " << i;
+      for (size_t k = 0; k < shapes[i].size(); k++) {
+        if (graph_shapes[i][k] >= 0) {
+          ICHECK_EQ(shapes[i][k], graph_shapes[i][k])
+              << "DNNL runtime. Shape mismatch of input " << i << " on axis " << k;
+          continue;
+        }
+        auto it = dynamic_extents_.emplace(k, shapes[i][k]).first;
+        ICHECK_EQ(it->second, shapes[i][k])
+            << "DNNL runtime. Inputs disagree on the extent of dynamic axis " << k;
+      }
+    }
+  }
+
+  std::vector<int64_t> ResolveShape(std::vector<int64_t> shape) const {
+    for (size_t k = 0; k < shape.size(); k++) {
+      if (shape[k] >= 0) continue;
+      auto it = dynamic_extents_.find(k);
+      ICHECK(it != dynamic_extents_.end()) << "DNNL runtime. Can not resolve dynamic axis " << k;
+      shape[k] = it->second;
+    }
+    return shape;
+  }
+
+  BoundArgs Bind(const Plan& plan, const TVMArgs& args) const {
+    BoundArgs bound;
+    for (int i = 0; i < args.size(); i++) {
+      bound.io_data.push_back(ExtractDLTensor(args[i])->data);
+    }
+    // The solver only reads IO tensors from the provider while binding below.
+    auto arg_data_provider = makeIODataProvider(args);
+    bound.solver = plan.tensor_registry.MakeSolver(arg_data_provider);
+    bound.mem_args.resize(plan.net.size());
+    for (size_t i = 0; i < plan.net.size(); i++) {
+      for (const auto& kvp : std::get<1>(plan.net[i])) {
+        bound.mem_args[i][kvp.first] = bound.solver(kvp.second);
+      }
+    }
+
+    // Actions running concurrently on the other streams get a private scratchpad.
+    std::vector<size_t> scratchpad_sizes(streams_.size(), 0);
+    for (size_t i = 0; i < plan.net.size(); i++) {
+      auto it = bound.mem_args[i].find(DNNL_ARG_SCRATCHPAD);
+      if (it == bound.mem_args[i].end()) continue;
+      auto& size = scratchpad_sizes[plan.action_stream[i]];
+      size = std::max(size, it->second.get_desc().get_size());
+    }
+    bound.scratchpads.resize(streams_.size());
+    for (size_t k = 1; k < streams_.size(); k++) {
+      if (scratchpad_sizes[k] == 0) continue;
+      dnnl::memory::desc desc({static_cast<dnnl::memory::dim>(scratchpad_sizes[k])},
+                              dnnl::memory::data_type::u8, dnnl::memory::format_tag::a);
+      bound.scratchpads[k] = dnnl::memory(desc, engine_);
+    }
+    for (size_t i = 0; i < plan.net.size(); i++) {
+      auto it = bound.mem_args[i].find(DNNL_ARG_SCRATCHPAD);
+      if (it == bound.mem_args[i].end() || plan.action_stream[i] == 0) continue;
+      auto handle = bound.scratchpads[plan.action_stream[i]].get_data_handle();
+      it->second = dnnl::memory(it->second.get_desc(), engine_, handle);
+    }
+    return bound;
+  }
+
+  void ExecuteAction(const Plan& plan, size_t idx, const BoundArgs& bound,
+                     const dnnl::stream& stream) const {
+    const auto& prim = std::get<0>(plan.net[idx]);
+    const auto& mem_args = bound.mem_args[idx];
+
+    // skip the reorder if src==dst to enable inplace operation
+    if (prim.get_kind() == dnnl::primitive::kind::reorder) {
+      const auto& mem_src = mem_args.at(DNNL_ARG_SRC);
+      const auto& mem_dst = mem_args.at(DNNL_ARG_DST);
+      if ((mem_src.get_desc() == mem_dst.get_desc()) &&
+          (mem_src.get_data_handle() == mem_dst.get_data_handle())) {
+        return;
+      }
+    }
+
+    prim.execute(stream, mem_args);
+  }
+
+  void Execute(const Plan& plan, const BoundArgs& bound) const {
+    if (streams_.size() == 1) {
+      // Execute primitives one by one
+      for (size_t i = 0; i < plan.net.size(); i++) ExecuteAction(plan, i, bound, stream_);
+      return;
+    }
+
+    struct WaveTask {
+      const DNNLJSONRuntime* self;
+      const Plan* plan;
+      const std::vector<size_t>* wave;
+      const BoundArgs* bound;
+
+      static int Run(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+        auto* task = static_cast<WaveTask*>(cdata);
+        auto& streams = task->self->streams_;
+        for (size_t k = task_id; k < streams.size(); k += penv->num_task) {
+          for (size_t idx : *task->wave) {
+            if (task->plan->action_stream[idx] != k) continue;
+            task->self->ExecuteAction(*task->plan, idx, *task->bound, streams[k]);
+          }
+          streams[k].wait();
+        }
+        return 0;
+      }
+    };
+
+    for (const auto& wave : plan.waves) {
+      if (wave.size() == 1) {
+        ExecuteAction(plan, wave[0], bound, stream_);
+        continue;
+      }
+      WaveTask task{this, &plan, &wave, &bound};
+      int num_task = static_cast<int>(std::min(wave.size(), streams_.size()));
+      int res = TVMBackendParallelLaunch(WaveTask::Run, &task, num_task);
+      ICHECK_EQ(res, 0) << "DNNL runtime. Inter-op parallel launch failed";
+    }
+  }
+
+  static bool IsOutputArg(int arg) {
+    return arg == DNNL_ARG_DST || arg == DNNL_ARG_DST_1 || arg == DNNL_ARG_DST_2 ||
+           arg == DNNL_ARG_WORKSPACE;
+  }
+
+  /*!
+   * \brief Group the actions of the plan_ net into waves of mutually independent primitives.
+   *
+   * An action is placed one wave after the last action it has a read-after-write, write-after-read
+   * or write-after-write hazard with. Scratchpads are left out, every stream binds a private one.
+   */
+  void PlanWaves() {
+    std::unordered_map<int64_t, size_t> last_write;
+    std::unordered_map<int64_t, size_t> last_read;
+    std::vector<size_t> action_wave(plan_->net.size(), 0);
+    for (size_t i = 0; i < plan_->net.size(); i++) {
+      size_t wave = 0;
+      std::vector<std::pair<int64_t, bool>> accesses;
+      for (const auto& kvp : std::get<1>(plan_->net[i])) {
+        if (kvp.first == DNNL_ARG_SCRATCHPAD) continue;
+        int64_t sid = plan_->tensor_registry.StorageId(kvp.second);
+        if (sid < 0) continue;
+        bool is_write = IsOutputArg(kvp.first);
+        if (last_write.count(sid)) wave = std::max(wave, last_write[sid] + 1);
+        if (is_write && last_read.count(sid)) wave = std::max(wave, last_read[sid] + 1);
+        accesses.push_back({sid, is_write});
+      }
+      for (const auto& access : accesses) {
+        if (access.second) {
+          last_write[access.first] = wave;
+          last_read.erase(access.first);
+        } else {
+          last_read[access.first] = std::max(last_read[access.first], wave);
+        }
+      }
+      action_wave[i] = wave;
+    }
+
+    plan_->waves.clear();
+    plan_->action_stream.assign(plan_->net.size(), 0);
+    for (size_t i = 0; i < plan_->net.size(); i++) {
+      if (action_wave[i] >= plan_->waves.size()) plan_->waves.resize(action_wave[i] + 1);
+      auto& wave = plan_->waves[action_wave[i]];
+      plan_->action_stream[i] = wave.size() % streams_.size();
+      wave.push_back(i);
+    }
+  }
+
   const std::map<std::string, dnnl::algorithm> elt_name2algo{
       {"abs", dnnl::algorithm::eltwise_abs},
       {"exp", dnnl::algorithm::eltwise_exp},
@@ -245,13 +474,10 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     return attr;
   }
 
-  // Build up the engine based on the input graph.
+  // Build up the plan_ primitives based on the input graph.
   void BuildEngine() {
-    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
-    stream_ = dnnl::stream(engine_);
-
     std::set<uint32_t> io_eid_set(run_arg_eid_.begin(), run_arg_eid_.end());
-    tensor_registry_ = TensorRegistry(engine_, io_eid_set);
+    plan_->tensor_registry = TensorRegistry(engine_, io_eid_set);
 
     std::regex conv_pat(".*conv[1-3]d.*");
     std::regex deconv_pat(".*deconv[1-3]d.*");
@@ -296,6 +522,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         }
       }
     }
+    PlanWaves();
   }
 
   void Convolution(const size_t& nid) {
@@ -820,7 +1047,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     ICHECK_LT(idx, node.GetInputs().size());
     auto data_entry = node.GetInputs()[idx];
 
-    auto shape = nodes_[data_entry.id_].GetOpShape()[data_entry.index_];
+    auto shape = ResolveShape(nodes_[data_entry.id_].GetOpShape()[data_entry.index_]);
     auto dtype = nodes_[data_entry.id_].GetOpDataType()[data_entry.index_];
     auto eid = node_row_ptr_[data_entry.id_] + data_entry.index_;
     auto const_dl_tensor = data_entry_[eid];
@@ -849,7 +1076,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     const JSONGraphNode& node = nodes_[nid];
 
     ICHECK_LT(idx, node.GetNumOutput());
-    auto shape = node.GetOpShape()[idx];
+    auto shape = ResolveShape(node.GetOpShape()[idx]);
     auto dtype = node.GetOpDataType()[idx];
     auto eid = node_row_ptr_[nid] + static_cast<uint32_t>(idx);
 
@@ -883,8 +1110,8 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     if (auto tr_in = inplace_conf.first) {
       auto tr_out = tr_args.at(inplace_conf.second);
       if (IsIntermidate(tr_in) && IsIntermidate(tr_out)) {
-        tensor_registry_.Register(tr_in, &net_);
-        tensor_registry_.MarkInplace(tr_out, tr_in);
+        plan_->tensor_registry.Register(tr_in, &plan_->net);
+        plan_->tensor_registry.MarkInplace(tr_out, tr_in);
       }
     }
 
@@ -893,27 +1120,28 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
       const auto& tr = kvp.second;
 
       if (!tr.defined()) continue;  // empty arg is admitted. Just skip it
-      auto arg_id = tensor_registry_.Register(tr, tr.IsReversed() ? &post_prim_actions : &net_);
+      auto* que = tr.IsReversed() ? &post_prim_actions : &plan_->net;
+      auto arg_id = plan_->tensor_registry.Register(tr, que);
       prim_arg_id[key] = arg_id;
     }
 
     // Simulate inplace primitive, the reorder with src==dst will be skipped in Run()
     if (auto tr = inplace_conf.first) {
-      auto arg_id = tensor_registry_.Register(tr, &net_);
+      auto arg_id = plan_->tensor_registry.Register(tr, &plan_->net);
       auto dst_tr = tr_args.at(inplace_conf.second);
       auto dst_arg_id = prim_arg_id.at(inplace_conf.second);
 
       // Register copy action direct before main primitive
       dnnl::reorder::primitive_desc io_copy_pd(engine_, tr.desc(), engine_, dst_tr.desc());
-      net_.push_back(
+      plan_->net.push_back(
           {dnnl::reorder(io_copy_pd), {{DNNL_ARG_SRC, arg_id}, {DNNL_ARG_DST, dst_arg_id}}});
     }
 
     // Register main primitive
-    net_.push_back({prim, prim_arg_id});
+    plan_->net.push_back({prim, prim_arg_id});
 
     // Register post actions
-    net_.insert(net_.end(), post_prim_actions.begin(), post_prim_actions.end());
+    plan_->net.insert(plan_->net.end(), post_prim_actions.begin(), post_prim_actions.end());
   }
 
   uint32_t GenUniqueEid() { return next_unique_eid_offset_++; }
@@ -922,10 +1150,14 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   dnnl::engine engine_;
   /* The dnnl stream. */
   dnnl::stream stream_;
-  /* The network layers that are represented in dnnl primitives. */
-  TensorRegistry::ActionQue net_;
-  /* Storage for all memory objects */
-  TensorRegistry tensor_registry_;
+  /* The streams of inter-op parallel execution, streams_[0] is stream_. */
+  mutable std::vector<dnnl::stream> streams_;
+  /* The plan of every input shape seen, dynamic axes are not bucketed as IO is bound in place. */
+  ShapeStateCache<Plan> plans_;
+  /* The plan under construction and the extents of its dynamic axes, guarded by build_mutex_. */
+  std::shared_ptr<Plan> plan_;
+  std::map<size_t, int64_t> dynamic_extents_;
+  std::mutex build_mutex_;
   /* Generator of new unique eid which doesn't match with existing data entry */
   uint32_t next_unique_eid_offset_;
   /* Map of Run arg idx to corresponding eid */
@@ -603,6 +603,33 @@ class TensorRegistry {
                          tmp_mem_collection_, tmp_mem_mapping_);
   }
 
+  /*!
+   * \brief Identify the buffer an ArgId resolves to.
+   *
+   * ArgIds which alias the same memory, through reinterpretation, inplace marks or the shared
+   * scratchpad, get the same storage id.
+   *
+   * \param ar ArgId to resolve.
+   * \return storage id, or -1 for constant tensors which are never written.
+   */
+  int64_t StorageId(const ArgId& ar) const {
+    switch (ar.flag_) {
+      case CONST:
+        return -1;
+      case TMP_STORAGE: {
+        size_t idx = ar.idx_;
+        for (auto it = tmp_mem_mapping_.find(idx); it != tmp_mem_mapping_.end();
+             it = tmp_mem_mapping_.find(idx)) {
+          idx = it->second;
+        }
+        return static_cast<int64_t>(idx) * 2;
+      }
+      case EXT_EID:
+        return static_cast<int64_t>(ext_mem_collection_[ar.idx_].first) * 2 + 1;
+    }
+    return -1;
+  }
+
   void MarkInplace(const TensorRequisite& tr, const TensorRequisite& shared) {
     const auto tr_id = tr.eid();
     ICHECK(tr_id != TensorRequisite::kUndefinedTid);
@@ -37,6 +37,7 @@
 #include <vector>
 
 #include "json_node.h"
+#include "json_state_cache.h"
 
 namespace tvm {
 namespace runtime {
@@ -77,6 +78,10 @@ class JSONRuntimeBase : public ModuleNode {
     } else if (name == "get_const_vars") {
       return PackedFunc(
           [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->const_names_; });
+    } else if (name == "get_state_cache_stats") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = this->GetStateCacheStats();
+      });
     } else if (this->symbol_name_ == name) {
       return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         ICHECK(this->initialized_) << "The module has not been initialized";
@@ -143,6 +148,57 @@ class JSONRuntimeBase : public ModuleNode {
   std::string GetSource(const std::string& format = "json") override { return graph_json_; }
 
  protected:
+  /*!
+   * \brief The statistics of the shape keyed state cache of this runtime.
+   *
+   * Runtimes which keep their backend states in a ShapeStateCache return its Stats().
+   *
+   * \return (num_lookups, num_hits, num_builds, num_evictions, size), empty without a cache.
+   */
+  virtual ShapeTuple GetStateCacheStats() const { return ShapeTuple(); }
+
+  /*!
+   * \brief Get the tensor of an input or output argument.
+   *
+   * \param val The packed arg, an NDArray or a DLTensor.
+   * \return The tensor.
+   */
+  static const DLTensor* ExtractDLTensor(const TVMArgValue& val) {
+    ICHECK(val.type_code() == kTVMNDArrayHandle || val.type_code() == kTVMDLTensorHandle)
+        << "Expect NDArray or DLTensor as inputs";
+    return val.IsObjectRef<NDArray>() ? val.operator NDArray().operator->()
+                                      : val.operator DLTensor*();
+  }
+
+  /*!
+   * \brief Get the shapes of the input tensors of a call, the key of a ShapeStateCache.
+   *
+   * \param args The packed args.
+   * \return The shape of every input, in input order.
+   */
+  ShapeKey InputShapes(const TVMArgs& args) const {
+    ShapeKey shapes;
+    for (size_t i = 0; i < input_var_eid_.size(); i++) {
+      const DLTensor* arg = ExtractDLTensor(args[i]);
+      shapes.emplace_back(arg->shape, arg->shape + arg->ndim);
+    }
+    return shapes;
+  }
+
+  /*!
+   * \brief Get the shapes of the input tensors as recorded in the graph.
+   *
+   * \return The shape of every input, in input order, with -1 for dynamic dimensions.
+   */
+  ShapeKey GraphInputShapes() const {
+    ShapeKey shapes;
+    for (uint32_t nid : input_nodes_) {
+      if (nodes_[nid].op_type_ != "input") continue;
+      for (const auto& shape : nodes_[nid].GetOpShape()) shapes.push_back(shape);
+    }
+    return shapes;
+  }
+
   /*!
    * \brief Set up the input and output buffers by binding their DLTensor pointers to the
    * corresponding data entry.
@@ -156,20 +212,9 @@ class JSONRuntimeBase : public ModuleNode {
     for (size_t i = 0; i < static_cast<size_t>(args.size()); i++) {
       auto eid = i < input_var_eid_.size() ? input_var_eid_[i]
                                            : EntryID(outputs_[i - input_var_eid_.size()]);
-      ICHECK(args[i].type_code() == kTVMNDArrayHandle || args[i].type_code() == kTVMDLTensorHandle)
-          << "Expect NDArray or DLTensor as inputs";
-
-      const DLTensor* arg;
-      if (args[i].IsObjectRef<NDArray>()) {
-        NDArray arr = args[i];
-        arg = arr.operator->();
-      } else {
-        arg = args[i].operator DLTensor*();
-      }
-
       // Assign input/output the NDArray pointers to data entry so that we can directly
       // read/write host buffers.
-      data_entry_[eid] = arg;
+      data_entry_[eid] = ExtractDLTensor(args[i]);
     }
   }
 
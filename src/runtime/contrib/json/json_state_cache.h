@@ -0,0 +1,208 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/json/json_state_cache.h
+ * \brief Shape keyed cache of backend states for json runtimes.
+ */
+
+#ifndef TVM_RUNTIME_CONTRIB_JSON_JSON_STATE_CACHE_H_
+#define TVM_RUNTIME_CONTRIB_JSON_JSON_STATE_CACHE_H_
+
+#include <dmlc/parameter.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/logging.h>
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace json {
+
+/*! \brief The shapes of the inputs of one call, in input order. */
+using ShapeKey = std::vector<std::vector<int64_t>>;
+
+/*! \brief For every input, the axes which are bucketed in the cache key. */
+using BucketAxes = std::vector<std::vector<size_t>>;
+
+/*!
+ * \brief Get the dynamic axes of the graph input shapes, the usual axes to bucket.
+ * \param graph_shapes The input shapes recorded in the graph, -1 for dynamic dimensions.
+ * \return For every input, its dynamic axes.
+ */
+inline BucketAxes DynamicAxes(const ShapeKey& graph_shapes) {
+  BucketAxes axes(graph_shapes.size());
+  for (size_t i = 0; i < graph_shapes.size(); i++) {
+    for (size_t k = 0; k < graph_shapes[i].size(); k++) {
+      if (graph_shapes[i][k] < 0) axes[i].push_back(k);
+    }
+  }
+  return axes;
+}
+
+/*!
+ * \brief LRU cache of backend states keyed by the input shapes of a subgraph.
+ *
+ * Runtimes whose backend state depends on the input shapes (engines, primitives, execution
+ * plans) keep one state per shape here instead of rebuilding or rejecting calls when the batch
+ * size or sequence length changes.
+ *
+ * Bucketing is opt in per axis, typically the dynamic axes of the graph. A bucketed dimension is
+ * rounded up to the next power of two. The state is built for the padded shape and serves all
+ * calls in the bucket, the backend pads the inputs or runs the bucket state on the smaller
+ * actual shape.
+ *
+ * \tparam State The backend specific state.
+ */
+template <typename State>
+class ShapeStateCache {
+ public:
+  using StatePtr = std::shared_ptr<State>;
+  using FBuild = std::function<StatePtr(const ShapeKey&)>;
+
+  /*! \brief Create the cache with TVM_JSON_RUNTIME_CACHE_SIZE states and no bucketing. */
+  ShapeStateCache() : ShapeStateCache(dmlc::GetEnv("TVM_JSON_RUNTIME_CACHE_SIZE", 8)) {}
+
+  /*!
+   * \param capacity The maximum number of states kept, at least one.
+   * \param bucket_axes For every input, the axes rounded up to the next power of two.
+   */
+  explicit ShapeStateCache(size_t capacity, BucketAxes bucket_axes = {})
+      : capacity_(capacity), bucket_axes_(std::move(bucket_axes)) {
+    ICHECK_GT(capacity_, 0U) << "The state cache must hold at least one state";
+  }
+
+  /*! \brief The key a call with the given input shapes is cached under. */
+  ShapeKey MakeKey(ShapeKey shapes) const {
+    for (size_t i = 0; i < std::min(shapes.size(), bucket_axes_.size()); i++) {
+      for (size_t k : bucket_axes_[i]) {
+        if (k >= shapes[i].size()) continue;
+        int64_t bucket = 1;
+        while (bucket < shapes[i][k]) bucket <<= 1;
+        shapes[i][k] = bucket;
+      }
+    }
+    return shapes;
+  }
+
+  /*!
+   * \brief Get the state for the input shapes, building it on a miss.
+   *
+   * The state is built outside the cache lock. Concurrent calls with the same new key wait for
+   * the one build, calls with other keys proceed. A failed build is rethrown to all its waiters
+   * and is not cached.
+   *
+   * \param shapes The actual input shapes of the call.
+   * \param fbuild Builds the state for the (possibly bucketed) key.
+   * \return The state, shared with the cache so eviction does not free it while in use.
+   */
+  StatePtr GetOrBuild(const ShapeKey& shapes, const FBuild& fbuild) {
+    ShapeKey key = MakeKey(shapes);
+    std::promise<StatePtr> promise;
+    std::shared_future<StatePtr> state;
+    int64_t build_id = -1;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++num_lookups_;
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        ++num_hits_;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        state = it->second->state;
+      } else {
+        build_id = ++num_builds_;
+        state = promise.get_future().share();
+        lru_.push_front(Entry{key, state, build_id});
+        index_[key] = lru_.begin();
+        if (lru_.size() > capacity_) {
+          index_.erase(lru_.back().key);
+          lru_.pop_back();
+          ++num_evictions_;
+        }
+      }
+    }
+    // A hit may still be building, wait for it outside the lock.
+    if (build_id < 0) return state.get();
+    try {
+      promise.set_value(fbuild(key));
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(key);
+      if (it != index_.end() && it->second->build_id == build_id) {
+        lru_.erase(it->second);
+        index_.erase(it);
+      }
+      throw;
+    }
+    return state.get();
+  }
+
+  /*! \brief Drop all states, keeping the statistics. */
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_.clear();
+    lru_.clear();
+  }
+
+  /*!
+   * \brief The statistics of the cache.
+   * \return (num_lookups, num_hits, num_builds, num_evictions, size). The hit rate is
+   *  num_hits / num_lookups.
+   */
+  ShapeTuple Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ShapeTuple({num_lookups_, num_hits_, num_builds_, num_evictions_,
+                       static_cast<int64_t>(lru_.size())});
+  }
+
+ private:
+  struct Entry {
+    ShapeKey key;
+    /*! \brief Ready once the build of the state finished. */
+    std::shared_future<StatePtr> state;
+    /*! \brief Tells a failed build which entry it inserted. */
+    int64_t build_id;
+  };
+
+  size_t capacity_;
+  BucketAxes bucket_axes_;
+  mutable std::mutex mutex_;
+  /*! \brief States from the most to the least recently used. */
+  std::list<Entry> lru_;
+  std::map<ShapeKey, typename std::list<Entry>::iterator> index_;
+  int64_t num_lookups_{0};
+  int64_t num_hits_{0};
+  int64_t num_builds_{0};
+  int64_t num_evictions_{0};
+};
+
+}  // namespace json
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_CONTRIB_JSON_JSON_STATE_CACHE_H_
@@ -25,8 +25,14 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 #include "workspace_pool.h"
 
@@ -34,8 +40,97 @@
 #include <android/api-level.h>
 #endif
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define TVM_CPU_MMAP_DATA_SPACE 1
+#endif
+
 namespace tvm {
 namespace runtime {
+
+#ifdef TVM_CPU_MMAP_DATA_SPACE
+namespace {
+
+// The huge page size assumed when aligning huge page backed regions.
+constexpr size_t kHugePageSize = 2 << 20;
+// mbind(2) policy, see <numaif.h>, which we do not depend on.
+constexpr int kMPolBind = 2;
+
+/*!
+ * \brief Placement policy of CPU data space, read once from the environment.
+ *
+ *  - TVM_CPU_NUMA_BIND=1 binds the pages allocated for cpu(i) to NUMA node i.
+ *  - TVM_CPU_HUGE_PAGE=transparent|explicit backs allocations of at least
+ *    TVM_CPU_HUGE_PAGE_MIN_BYTES bytes (2MB by default) with transparent huge
+ *    pages (madvise) or explicit huge pages (MAP_HUGETLB).
+ */
+struct CPUMemoryPolicy {
+  enum HugePageMode { kNone = 0, kTransparent = 1, kExplicit = 2 };
+
+  bool numa_bind{false};
+  int num_numa_nodes{1};
+  HugePageMode huge_page{kNone};
+  size_t huge_page_min_bytes{kHugePageSize};
+
+  /*! \return Whether any allocation may go through the mmap path. */
+  bool Enabled() const { return (numa_bind && num_numa_nodes > 1) || huge_page != kNone; }
+
+  /*!
+   * \brief Get the NUMA node an allocation of the device is bound to.
+   * \return The node, or -1 when no binding applies.
+   */
+  int GetNode(Device dev) const {
+    if (!numa_bind || dev.device_id < 0 || dev.device_id >= num_numa_nodes) return -1;
+    return dev.device_id;
+  }
+
+  static const CPUMemoryPolicy& Global() {
+    static CPUMemoryPolicy inst = Create();
+    return inst;
+  }
+
+ private:
+  static CPUMemoryPolicy Create() {
+    CPUMemoryPolicy policy;
+    if (const char* val = getenv("TVM_CPU_NUMA_BIND")) {
+      policy.numa_bind = atoi(val) == 1;
+    }
+    if (policy.numa_bind) {
+      policy.num_numa_nodes = CountNUMANodes();
+    }
+    if (const char* val = getenv("TVM_CPU_HUGE_PAGE")) {
+      std::string mode = val;
+      if (mode == "transparent") {
+        policy.huge_page = kTransparent;
+      } else if (mode == "explicit") {
+        policy.huge_page = kExplicit;
+      } else if (!mode.empty() && mode != "none") {
+        LOG(WARNING) << "Unknown TVM_CPU_HUGE_PAGE=" << mode
+                     << ", expect one of none, transparent, explicit";
+      }
+    }
+    if (const char* val = getenv("TVM_CPU_HUGE_PAGE_MIN_BYTES")) {
+      policy.huge_page_min_bytes = static_cast<size_t>(atoll(val));
+    }
+    return policy;
+  }
+
+  // The online nodes are listed as ranges, e.g. "0-1" or "0,2-3".
+  static int CountNUMANodes() {
+    std::ifstream fin("/sys/devices/system/node/online");
+    std::string online;
+    if (!(fin >> online) || online.empty()) return 1;
+    size_t pos = online.find_last_of("-,");
+    std::string last = pos == std::string::npos ? online : online.substr(pos + 1);
+    return std::max(atoi(last.c_str()) + 1, 1);
+  }
+};
+
+}  // namespace
+#endif  // TVM_CPU_MMAP_DATA_SPACE
+
 class CPUDeviceAPI final : public DeviceAPI {
  public:
   void SetDevice(Device dev) final {}
@@ -46,6 +141,13 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
   void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
     void* ptr;
+#ifdef TVM_CPU_MMAP_DATA_SPACE
+    const CPUMemoryPolicy& policy = CPUMemoryPolicy::Global();
+    if (policy.Enabled()) {
+      ptr = MapDataSpace(policy, dev, nbytes, alignment);
+      if (ptr != nullptr) return ptr;
+    }
+#endif
 #if _MSC_VER
     ptr = _aligned_malloc(nbytes, alignment);
     if (ptr == nullptr) throw std::bad_alloc();
@@ -61,6 +163,9 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
 
   void FreeDataSpace(Device dev, void* ptr) final {
+#ifdef TVM_CPU_MMAP_DATA_SPACE
+    if (CPUMemoryPolicy::Global().Enabled() && UnmapDataSpace(ptr)) return;
+#endif
 #if _MSC_VER
     _aligned_free(ptr);
 #else
@@ -86,6 +191,89 @@ class CPUDeviceAPI final : public DeviceAPI {
                       TVMStreamHandle stream) final {
     memcpy(static_cast<char*>(to) + to_offset, static_cast<const char*>(from) + from_offset, size);
   }
+
+ private:
+#ifdef TVM_CPU_MMAP_DATA_SPACE
+  /*!
+   * \brief Allocate data space with mmap when the policy asks for NUMA binding or huge pages.
+   * \return The allocated space, or nullptr when the regular allocator should be used.
+   */
+  void* MapDataSpace(const CPUMemoryPolicy& policy, Device dev, size_t nbytes, size_t alignment) {
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    int node = policy.GetNode(dev);
+    bool huge = policy.huge_page != CPUMemoryPolicy::kNone && nbytes >= policy.huge_page_min_bytes;
+    // Small allocations share pages with unrelated data, leave them to malloc.
+    if (!huge && (node < 0 || nbytes < page_size)) return nullptr;
+    if (alignment > (huge ? kHugePageSize : page_size)) return nullptr;
+
+    size_t align = huge ? kHugePageSize : page_size;
+    size_t size = (nbytes + align - 1) / align * align;
+    void* ptr = MAP_FAILED;
+    if (huge && policy.huge_page == CPUMemoryPolicy::kExplicit) {
+      ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                 -1, 0);
+      if (ptr == MAP_FAILED) {
+        static std::once_flag warned;
+        std::call_once(warned, [] {
+          LOG(WARNING) << "MAP_HUGETLB allocation failed, fall back to transparent huge pages. "
+                       << "Check /proc/sys/vm/nr_hugepages";
+        });
+      }
+    }
+    if (ptr == MAP_FAILED && huge) {
+      // Over-allocate so that the region can be trimmed to a huge page boundary.
+      size_t mapped = size + kHugePageSize;
+      char* base = static_cast<char*>(
+          mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+      if (base == MAP_FAILED) throw std::bad_alloc();
+      char* begin = reinterpret_cast<char*>(
+          (reinterpret_cast<uintptr_t>(base) + kHugePageSize - 1) / kHugePageSize * kHugePageSize);
+      if (begin != base) munmap(base, begin - base);
+      if (base + mapped != begin + size) munmap(begin + size, base + mapped - (begin + size));
+      madvise(begin, size, MADV_HUGEPAGE);
+      ptr = begin;
+    }
+    if (ptr == MAP_FAILED) {
+      ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (ptr == MAP_FAILED) throw std::bad_alloc();
+    }
+    if (node >= 0 && node < static_cast<int>(sizeof(unsigned long) * 8)) {  // NOLINT(*)
+      unsigned long nodemask = 1UL << node;                                  // NOLINT(*)
+      // Pages are not touched yet, so binding places them on first touch without migration.
+      if (syscall(SYS_mbind, ptr, size, kMPolBind, &nodemask, sizeof(nodemask) * 8, 0) != 0) {
+        static std::once_flag warned;
+        std::call_once(warned, [node] {
+          LOG(WARNING) << "mbind to NUMA node " << node << " failed, errno=" << errno;
+        });
+      }
+    }
+    std::lock_guard<std::mutex> lock(mapped_mutex_);
+    mapped_[ptr] = size;
+    return ptr;
+  }
+
+  /*!
+   * \brief Release data space allocated by MapDataSpace.
+   * \return Whether the pointer was allocated by MapDataSpace.
+   */
+  bool UnmapDataSpace(void* ptr) {
+    size_t size;
+    {
+      std::lock_guard<std::mutex> lock(mapped_mutex_);
+      auto it = mapped_.find(ptr);
+      if (it == mapped_.end()) return false;
+      size = it->second;
+      mapped_.erase(it);
+    }
+    munmap(ptr, size);
+    return true;
+  }
+
+  /*! \brief Mutex guarding the mmap allocated regions. */
+  std::mutex mapped_mutex_;
+  /*! \brief The size of each region allocated by MapDataSpace. */
+  std::unordered_map<void*, size_t> mapped_;
+#endif  // TVM_CPU_MMAP_DATA_SPACE
 };
 
 struct CPUWorkspacePool : public WorkspacePool {
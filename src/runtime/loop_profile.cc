@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file loop_profile.cc
+ * \brief Trip count and branch outcome counters for profile-guided lowering.
+ *
+ *  Code built with the tir.instrument_loop_counts option calls
+ *  TVMBackendProfileLoop before every loop and TVMBackendProfileBranch before
+ *  every conditional.  The counts are dumped as JSON and fed back to the
+ *  compiler through the tir.ApplyLoopProfile pass config.
+ */
+#include <dmlc/json.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+/*! \brief Counters of one loop (entries, trips) or branch (evaluations, taken). */
+struct SiteCounts {
+  int64_t first{0};
+  int64_t second{0};
+};
+
+/*! \brief Counters of all instrumented sites in one function. */
+struct FuncCounts {
+  std::string name;
+  std::vector<SiteCounts> loops;
+  std::vector<SiteCounts> branches;
+
+  static SiteCounts* At(std::vector<SiteCounts>* sites, int32_t id) {
+    if (static_cast<size_t>(id) >= sites->size()) sites->resize(id + 1);
+    return &(*sites)[id];
+  }
+};
+
+/*!
+ * \brief Counters recorded by one thread.
+ *
+ *  Each thread only contends with the dump and reset paths on its own lock,
+ *  so parallel loops do not serialize on a global mutex.
+ */
+struct ThreadCounts {
+  std::mutex mutex;
+  std::unordered_map<std::string, FuncCounts> table;
+  // Name pointers passed by generated code are constant strings of the module,
+  // cache them to avoid hashing the name on every call.
+  std::unordered_map<const char*, FuncCounts*> cache;
+
+  FuncCounts* Lookup(const char* func_name) {
+    auto it = cache.find(func_name);
+    if (it != cache.end() && it->second->name == func_name) return it->second;
+    FuncCounts* counts = &table[func_name];
+    counts->name = func_name;
+    cache[func_name] = counts;
+    return counts;
+  }
+};
+
+class LoopProfileRegistry {
+ public:
+  static LoopProfileRegistry* Global() {
+    // Deliberately leaked, worker threads may record counts during static destruction.
+    static LoopProfileRegistry* inst = new LoopProfileRegistry();
+    return inst;
+  }
+
+  static ThreadCounts* ThreadLocal() {
+    thread_local std::shared_ptr<ThreadCounts> counts = Global()->Register();
+    return counts.get();
+  }
+
+  std::string DumpJSON() {
+    // func name -> {"loops": [[id, entries, trips]], "branches": [[id, evals, taken]]}
+    std::map<std::string, std::map<std::string, std::vector<std::vector<int64_t>>>> merged;
+    auto append = [](std::vector<std::vector<int64_t>>* out, const std::vector<SiteCounts>& sites) {
+      std::map<int64_t, SiteCounts> sum;
+      for (const auto& row : *out) {
+        sum[row[0]].first += row[1];
+        sum[row[0]].second += row[2];
+      }
+      for (size_t i = 0; i < sites.size(); ++i) {
+        if (sites[i].first == 0) continue;
+        sum[i].first += sites[i].first;
+        sum[i].second += sites[i].second;
+      }
+      out->clear();
+      for (const auto& kv : sum) {
+        out->push_back({kv.first, kv.second.first, kv.second.second});
+      }
+    };
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& thread : threads_) {
+      std::lock_guard<std::mutex> thread_lock(thread->mutex);
+      for (const auto& kv : thread->table) {
+        auto& entry = merged[kv.first];
+        append(&entry["loops"], kv.second.loops);
+        append(&entry["branches"], kv.second.branches);
+      }
+    }
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.Write(merged);
+    return os.str();
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& thread : threads_) {
+      std::lock_guard<std::mutex> thread_lock(thread->mutex);
+      thread->cache.clear();
+      thread->table.clear();
+    }
+  }
+
+ private:
+  std::shared_ptr<ThreadCounts> Register() {
+    auto counts = std::make_shared<ThreadCounts>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back(counts);
+    return counts;
+  }
+
+  std::mutex mutex_;
+  // Kept alive past thread exit so that counts of finished threads are still dumped.
+  std::vector<std::shared_ptr<ThreadCounts>> threads_;
+};
+
+}  // namespace
+
+TVM_REGISTER_GLOBAL("runtime.profiling.DumpLoopProfile").set_body_typed([]() {
+  return LoopProfileRegistry::Global()->DumpJSON();
+});
+
+TVM_REGISTER_GLOBAL("runtime.profiling.ResetLoopProfile").set_body_typed([]() {
+  LoopProfileRegistry::Global()->Reset();
+});
+
+}  // namespace runtime
+}  // namespace tvm
+
+int TVMBackendProfileLoop(const char* func_name, int32_t loop_id, int64_t trip_count) {
+  using tvm::runtime::FuncCounts;
+  tvm::runtime::ThreadCounts* counts = tvm::runtime::LoopProfileRegistry::ThreadLocal();
+  std::lock_guard<std::mutex> lock(counts->mutex);
+  auto* site = FuncCounts::At(&counts->Lookup(func_name)->loops, loop_id);
+  site->first += 1;
+  site->second += trip_count;
+  return 0;
+}
+
+int TVMBackendProfileBranch(const char* func_name, int32_t branch_id, int32_t taken) {
+  using tvm::runtime::FuncCounts;
+  tvm::runtime::ThreadCounts* counts = tvm::runtime::LoopProfileRegistry::ThreadLocal();
+  std::lock_guard<std::mutex> lock(counts->mutex);
+  auto* site = FuncCounts::At(&counts->Lookup(func_name)->branches, branch_id);
+  site->first += 1;
+  site->second += taken != 0;
+  return 0;
+}
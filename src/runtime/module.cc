@@ -59,6 +59,65 @@ void ModuleNode::Import(Module other) {
   }
   ICHECK(!visited.count(this)) << "Cyclic dependency detected during import";
   this->imports_.emplace_back(std::move(other));
+  // The new import may provide functions that were recorded as missing.
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ImportCacheTable* table = import_cache_.load()) {
+    RebuildImportCache(table->capacity, false);
+  }
+}
+
+void ModuleNode::ClearImports() {
+  imports_.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ImportCacheTable* table = import_cache_.load()) {
+    // Generated code may still hold pointers to the cached functions, so the entries stay alive
+    // and only an empty table is published.
+    auto empty = std::make_unique<ImportCacheTable>(table->capacity);
+    import_cache_.store(empty.get(), std::memory_order_release);
+    import_cache_tables_.emplace_back(std::move(empty));
+  }
+}
+
+ModuleNode::ImportCacheTable::ImportCacheTable(size_t capacity)
+    : capacity(capacity), slots(new std::atomic<const ImportCacheEntry*>[capacity]) {
+  for (size_t i = 0; i < capacity; ++i) {
+    slots[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+void ModuleNode::InsertImportCache(const ImportCacheEntry* entry) {
+  ImportCacheTable* table = import_cache_.load(std::memory_order_relaxed);
+  if (table == nullptr || (table->size + 1) * 2 > table->capacity) {
+    RebuildImportCache(table == nullptr ? 16 : table->capacity * 2, true);
+    table = import_cache_.load(std::memory_order_relaxed);
+  }
+  size_t mask = table->capacity - 1;
+  size_t i = std::hash<std::string>()(entry->name) & mask;
+  while (table->slots[i].load(std::memory_order_relaxed) != nullptr) {
+    i = (i + 1) & mask;
+  }
+  table->slots[i].store(entry, std::memory_order_release);
+  table->size += 1;
+}
+
+void ModuleNode::RebuildImportCache(size_t capacity, bool keep_misses) {
+  ImportCacheTable* old_table = import_cache_.load(std::memory_order_relaxed);
+  auto table = std::make_unique<ImportCacheTable>(capacity);
+  if (old_table != nullptr) {
+    size_t mask = capacity - 1;
+    for (size_t j = 0; j < old_table->capacity; ++j) {
+      const ImportCacheEntry* entry = old_table->slots[j].load(std::memory_order_relaxed);
+      if (entry == nullptr || (!keep_misses && entry->func == nullptr)) continue;
+      size_t i = std::hash<std::string>()(entry->name) & mask;
+      while (table->slots[i].load(std::memory_order_relaxed) != nullptr) {
+        i = (i + 1) & mask;
+      }
+      table->slots[i].store(entry, std::memory_order_relaxed);
+      table->size += 1;
+    }
+  }
+  import_cache_.store(table.get(), std::memory_order_release);
+  import_cache_tables_.emplace_back(std::move(table));
 }
 
 PackedFunc ModuleNode::GetFunction(const std::string& name, bool query_imports) {
@@ -106,26 +165,44 @@ std::string ModuleNode::GetSource(const std::string& format) {
 }
 
 const PackedFunc* ModuleNode::GetFuncFromEnv(const std::string& name) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = import_cache_.find(name);
-  if (it != import_cache_.end()) return it->second.get();
-  PackedFunc pf;
-  for (Module& m : this->imports_) {
-    pf = m.GetFunction(name, true);
-    if (pf != nullptr) break;
-  }
-  if (pf == nullptr) {
-    const PackedFunc* f = Registry::Get(name);
-    ICHECK(f != nullptr) << "Cannot find function " << name
-                         << " in the imported modules or global registry."
-                         << " If this involves ops from a contrib library like"
-                         << " cuDNN, ensure TVM was built with the relevant"
-                         << " library.";
-    return f;
-  } else {
-    import_cache_.insert(std::make_pair(name, std::make_shared<PackedFunc>(pf)));
-    return import_cache_.at(name).get();
+  auto find = [&name](const ImportCacheTable* table) -> const ImportCacheEntry* {
+    if (table == nullptr) return nullptr;
+    size_t mask = table->capacity - 1;
+    for (size_t i = std::hash<std::string>()(name) & mask;; i = (i + 1) & mask) {
+      const ImportCacheEntry* entry = table->slots[i].load(std::memory_order_acquire);
+      if (entry == nullptr || entry->name == name) return entry;
+    }
+  };
+  // fast path, lock-free lookup in the current table.
+  const ImportCacheEntry* entry = find(import_cache_.load(std::memory_order_acquire));
+  if (entry == nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry = find(import_cache_.load(std::memory_order_relaxed));
+    if (entry == nullptr) {
+      auto new_entry = std::make_unique<ImportCacheEntry>();
+      new_entry->name = name;
+      for (Module& m : this->imports_) {
+        PackedFunc pf = m.GetFunction(name, true);
+        if (pf != nullptr) {
+          new_entry->func = std::make_shared<PackedFunc>(pf);
+          break;
+        }
+      }
+      entry = new_entry.get();
+      import_cache_entries_.emplace_back(std::move(new_entry));
+      InsertImportCache(entry);
+    }
   }
+  const PackedFunc* cached = entry->func.get();
+  if (cached != nullptr) return cached;
+  // Global functions may be overridden, so they are not cached here.
+  const PackedFunc* f = Registry::Get(name);
+  ICHECK(f != nullptr) << "Cannot find function " << name
+                       << " in the imported modules or global registry."
+                       << " If this involves ops from a contrib library like"
+                       << " cuDNN, ensure TVM was built with the relevant"
+                       << " library.";
+  return f;
 }
 
 std::string ModuleNode::GetFormat() {
@@ -62,7 +62,6 @@ inline void VerifyDataType(DLDataType dtype) {
 void ArrayCopyFromBytes(DLTensor* handle, const void* data, size_t nbytes) {
   size_t arr_size = GetDataSize(*handle);
   ICHECK_EQ(arr_size, nbytes) << "ArrayCopyFromBytes: size mismatch";
-  ICHECK(IsContiguous(*handle)) << "ArrayCopyFromBytes only support contiguous array for now";
 
   DLTensor from;
   from.data = const_cast<void*>(data);
@@ -80,7 +79,6 @@ void ArrayCopyFromBytes(DLTensor* handle, const void* data, size_t nbytes) {
 void ArrayCopyToBytes(const DLTensor* handle, void* data, size_t nbytes) {
   size_t arr_size = GetDataSize(*handle);
   ICHECK_EQ(arr_size, nbytes) << "ArrayCopyToBytes: size mismatch";
-  ICHECK(IsContiguous(*handle)) << "ArrayCopyToBytes only support contiguous array for now";
 
   DLTensor to;
   to.data = const_cast<void*>(data);
@@ -179,14 +177,29 @@ struct NDArray::Internal {
   }
 };
 
-NDArray NDArray::CreateView(ShapeTuple shape, DLDataType dtype) {
+/*!
+ * \brief The number of bytes between the first element of a tensor and the end of its last one.
+ * \param arr The input DLTensor, which may be strided.
+ */
+inline size_t GetDataSpan(const DLTensor& arr) {
+  if (arr.strides == nullptr) return GetDataSize(arr);
+  int64_t last = 0;
+  for (int i = 0; i < arr.ndim; ++i) {
+    if (arr.shape[i] == 0) return 0;
+    last += (arr.shape[i] - 1) * arr.strides[i];
+  }
+  return static_cast<size_t>(last + 1) * ((arr.dtype.bits * arr.dtype.lanes + 7) / 8);
+}
+
+NDArray NDArray::CreateView(ShapeTuple shape, DLDataType dtype, uint64_t relative_byte_offset) {
   ICHECK(data_ != nullptr);
   ICHECK(get_mutable()->dl_tensor.strides == nullptr) << "Can only create view for compact tensor";
   NDArray ret = Internal::Create(shape, dtype, get_mutable()->dl_tensor.device);
-  ret.get_mutable()->dl_tensor.byte_offset = this->get_mutable()->dl_tensor.byte_offset;
+  ret.get_mutable()->dl_tensor.byte_offset =
+      this->get_mutable()->dl_tensor.byte_offset + relative_byte_offset;
   size_t curr_size = GetDataSize(this->get_mutable()->dl_tensor);
   size_t view_size = GetDataSize(ret.get_mutable()->dl_tensor);
-  ICHECK_LE(view_size, curr_size)
+  ICHECK_LE(view_size + relative_byte_offset, curr_size)
       << "Tries to create a view that has bigger memory than current one";
   // increase ref count
   get_mutable()->IncRef();
@@ -195,6 +208,32 @@ NDArray NDArray::CreateView(ShapeTuple shape, DLDataType dtype) {
   return ret;
 }
 
+NDArray NDArray::CreateStridedView(ShapeTuple shape, ShapeTuple strides,
+                                   uint64_t relative_byte_offset) {
+  ICHECK(data_ != nullptr);
+  const DLTensor& curr = get_mutable()->dl_tensor;
+  ICHECK_EQ(shape.size(), strides.size())
+      << "The view has " << shape.size() << " dimensions but " << strides.size() << " strides";
+  ICHECK_EQ(curr.dtype.bits % 8, 0) << "Strided views of sub-byte data types are not supported";
+  for (int64_t stride : strides) {
+    ICHECK_GE(stride, 0) << "Strided views do not support negative strides";
+  }
+  NDArray ret = Internal::Create(shape, curr.dtype, curr.device);
+  NDArray::Container* view = ret.get_mutable();
+  if (strides.size() != 0) {
+    view->strides_ = std::move(strides);
+    view->dl_tensor.strides = const_cast<ShapeTuple::index_type*>(view->strides_.data());
+  }
+  view->dl_tensor.byte_offset = curr.byte_offset + relative_byte_offset;
+  ICHECK_LE(relative_byte_offset + GetDataSpan(view->dl_tensor), GetDataSpan(curr))
+      << "Tries to create a view that addresses memory outside of the current one";
+  // increase ref count
+  get_mutable()->IncRef();
+  view->manager_ctx = get_mutable();
+  view->dl_tensor.data = curr.data;
+  return ret;
+}
+
 DLManagedTensor* NDArray::ToDLPack() const { return Internal::ToDLPack(get_mutable()); }
 
 NDArray NDArray::Empty(ShapeTuple shape, DLDataType dtype, Device dev, Optional<String> mem_scope) {
@@ -341,6 +380,12 @@ TVM_REGISTER_GLOBAL("runtime.TVMArrayCreateView").set_body_typed([](NDArray arr,
   return view;
 });
 
+TVM_REGISTER_GLOBAL("runtime.TVMArrayCreateStridedView")
+    .set_body_typed([](NDArray arr, ShapeTuple shape, ShapeTuple strides, int64_t byte_offset) {
+      CHECK_GE(byte_offset, 0) << "ValueError: The byte offset of a view must be non-negative";
+      return arr.CreateStridedView(shape, strides, static_cast<uint64_t>(byte_offset));
+    });
+
 int TVMArrayFree(TVMArrayHandle handle) {
   API_BEGIN();
   NDArray::Internal::FFIDecRef(handle);
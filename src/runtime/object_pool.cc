@@ -0,0 +1,183 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file object_pool.cc
+ * \brief Thread-local size-class pools backing PooledObjAllocator.
+ */
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
+
+#include <mutex>
+#include <type_traits>
+
+namespace tvm {
+namespace runtime {
+namespace detail {
+namespace {
+
+constexpr size_t kNumSizeClasses = kObjPoolMaxBytes / kObjPoolGranularity + 1;
+// Bytes requested from the system at a time, carved into blocks of one size class.
+constexpr size_t kChunkBytes = 64 << 10;
+// Number of blocks moved between the thread cache and the shared pool at a time.
+constexpr size_t kTransferBatch = 64;
+// Upper bound of free blocks a thread keeps per size class.
+constexpr size_t kMaxCachedBlocks = 4 * kTransferBatch;
+
+using ChunkUnit = std::aligned_storage<kObjPoolGranularity, kObjPoolGranularity>::type;
+
+/*! \brief Intrusive singly linked list of free blocks. */
+struct FreeList {
+  struct Block {
+    Block* next;
+  };
+  Block* head{nullptr};
+  size_t count{0};
+
+  void Push(void* ptr) {
+    Block* block = static_cast<Block*>(ptr);
+    block->next = head;
+    head = block;
+    ++count;
+  }
+
+  void* Pop() {
+    Block* block = head;
+    head = block->next;
+    --count;
+    return block;
+  }
+};
+
+/*! \brief The pool shared by all threads, blocks are never returned to the system. */
+class SharedObjPool {
+ public:
+  /*!
+   * \brief Move free blocks into list until it holds at least n blocks.
+   * \param size_class The size class.
+   * \param list The list to fill.
+   * \param n The number of blocks wanted.
+   */
+  void Fill(size_t size_class, FreeList* list, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FreeList& shared = free_[size_class];
+    while (list->count < n && shared.count != 0) {
+      list->Push(shared.Pop());
+    }
+    if (list->count < n) {
+      size_t block_bytes = size_class * kObjPoolGranularity;
+      char* chunk = reinterpret_cast<char*>(new ChunkUnit[kChunkBytes / sizeof(ChunkUnit)]);
+      for (size_t offset = 0; offset + block_bytes <= kChunkBytes; offset += block_bytes) {
+        FreeList* target = list->count < n ? list : &shared;
+        target->Push(chunk + offset);
+      }
+    }
+  }
+  /*!
+   * \brief Move free blocks out of list until it holds at most n blocks.
+   * \param size_class The size class.
+   * \param list The list to drain.
+   * \param n The number of blocks to keep.
+   */
+  void Drain(size_t size_class, FreeList* list, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FreeList& shared = free_[size_class];
+    while (list->count > n) {
+      shared.Push(list->Pop());
+    }
+  }
+
+  static SharedObjPool* Global() {
+    // NOTE: deliberately leaked, objects can be freed during program exit.
+    static SharedObjPool* inst = new SharedObjPool();
+    return inst;
+  }
+
+ private:
+  std::mutex mutex_;
+  FreeList free_[kNumSizeClasses];
+};
+
+/*! \brief The free blocks cached by one thread. */
+struct ThreadObjPoolCache {
+  FreeList free[kNumSizeClasses];
+
+  ~ThreadObjPoolCache() {
+    for (size_t i = 1; i < kNumSizeClasses; ++i) {
+      SharedObjPool::Global()->Drain(i, &free[i], 0);
+    }
+  }
+};
+
+// The raw pointer is trivially destructible, so it stays readable while the
+// thread-local destructors run and objects freed after the cache is gone go
+// straight to the shared pool.
+thread_local ThreadObjPoolCache* tls_cache = nullptr;
+thread_local bool tls_cache_released = false;
+
+/*! \brief Owner of the cache of the current thread, flushes it on thread exit. */
+struct ThreadObjPoolCacheOwner {
+  ThreadObjPoolCache cache;
+  ThreadObjPoolCacheOwner() { tls_cache = &cache; }
+  ~ThreadObjPoolCacheOwner() {
+    tls_cache = nullptr;
+    tls_cache_released = true;
+  }
+};
+
+ThreadObjPoolCache* GetThreadCache() {
+  if (tls_cache == nullptr && !tls_cache_released) {
+    static thread_local ThreadObjPoolCacheOwner owner;
+  }
+  return tls_cache;
+}
+
+}  // namespace
+
+void* ObjPoolAlloc(size_t size_class) {
+  ICHECK(size_class != 0 && size_class < kNumSizeClasses);
+  if (ThreadObjPoolCache* cache = GetThreadCache()) {
+    FreeList& list = cache->free[size_class];
+    if (list.count == 0) {
+      SharedObjPool::Global()->Fill(size_class, &list, kTransferBatch);
+    }
+    return list.Pop();
+  }
+  FreeList list;
+  SharedObjPool::Global()->Fill(size_class, &list, 1);
+  return list.Pop();
+}
+
+void ObjPoolFree(void* ptr, size_t size_class) {
+  if (ThreadObjPoolCache* cache = GetThreadCache()) {
+    FreeList& list = cache->free[size_class];
+    list.Push(ptr);
+    if (list.count > kMaxCachedBlocks) {
+      SharedObjPool::Global()->Drain(size_class, &list, kMaxCachedBlocks - kTransferBatch);
+    }
+    return;
+  }
+  FreeList list;
+  list.Push(ptr);
+  SharedObjPool::Global()->Drain(size_class, &list, 0);
+}
+
+}  // namespace detail
+}  // namespace runtime
+}  // namespace tvm
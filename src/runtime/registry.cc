@@ -27,6 +27,8 @@
 #include <tvm/runtime/registry.h>
 
 #include <array>
+#include <atomic>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -36,6 +38,20 @@
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief Per-thread cache of registry lookups.
+ *
+ *  Lookups are much more frequent than registrations, so each thread serves them
+ *  from its own copy of the entries it has seen, without taking the registry lock.
+ *  Registry entries are never freed, so the cached pointers stay valid; the cache
+ *  is only dropped when the registry version changes.
+ */
+struct RegistryLookupCache {
+  uint64_t version{std::numeric_limits<uint64_t>::max()};
+  // entries looked up by this thread, nullptr records a missing function.
+  std::unordered_map<std::string, Registry*> entries;
+};
+
 struct Registry::Manager {
   // map storing the functions.
   // We deliberately used raw pointer.
@@ -45,6 +61,8 @@ struct Registry::Manager {
   std::unordered_map<std::string, Registry*> fmap;
   // mutex
   std::mutex mutex;
+  // version of fmap, bumped under mutex on every change to invalidate the lookup caches.
+  std::atomic<uint64_t> version{0};
 
   Manager() {}
 
@@ -72,6 +90,7 @@ Registry& Registry::Register(const std::string& name, bool can_override) {  // N
   Registry* r = new Registry();
   r->name_ = name;
   m->fmap[name] = r;
+  m->version.fetch_add(1, std::memory_order_release);
   return *r;
 }
 
@@ -81,14 +100,26 @@ bool Registry::Remove(const std::string& name) {
   auto it = m->fmap.find(name);
   if (it == m->fmap.end()) return false;
   m->fmap.erase(it);
+  m->version.fetch_add(1, std::memory_order_release);
   return true;
 }
 
 const PackedFunc* Registry::Get(const std::string& name) {
   Manager* m = Manager::Global();
-  std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return nullptr;
+  RegistryLookupCache* cache = dmlc::ThreadLocalStore<RegistryLookupCache>::Get();
+  uint64_t version = m->version.load(std::memory_order_acquire);
+  if (cache->version != version) {
+    cache->entries.clear();
+    cache->version = version;
+  }
+  auto it = cache->entries.find(name);
+  if (it == cache->entries.end()) {
+    // slow path, the registration is serialized by the lock.
+    std::lock_guard<std::mutex> lock(m->mutex);
+    auto fit = m->fmap.find(name);
+    it = cache->entries.emplace(name, fit == m->fmap.end() ? nullptr : fit->second).first;
+  }
+  if (it->second == nullptr) return nullptr;
   return &(it->second->func_);
 }
 
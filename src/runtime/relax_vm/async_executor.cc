@@ -0,0 +1,424 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/async_executor.cc
+ * \brief Asynchronous invocation of relax VM functions on a pool of worker threads.
+ */
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+#include <tvm/runtime/threading_backend.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The result of an asynchronous VM invocation.
+ *
+ *  A future starts pending in the queue of its executor, runs on one of its
+ *  workers and ends either done, failed, or cancelled. Completion callbacks
+ *  run on the thread that completes the future, or immediately on the calling
+ *  thread if the future has already completed.
+ */
+class VMFutureObj : public Object {
+ public:
+  enum class State : int {
+    kPending = 0,
+    kRunning = 1,
+    kDone = 2,
+    kFailed = 3,
+    kCancelled = 4,
+  };
+
+  VMFutureObj(String func_name, std::vector<TVMRetValue> args)
+      : func_name(std::move(func_name)), args(std::move(args)) {}
+
+  /*! \brief The function to invoke. */
+  String func_name;
+  /*! \brief The arguments, already converted to the device of the VM. */
+  std::vector<TVMRetValue> args;
+
+  State GetState() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return state_;
+  }
+
+  /*! \brief Move a pending future to running, return false if it was cancelled. */
+  bool TryStart() {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (state_ != State::kPending) return false;
+    state_ = State::kRunning;
+    return true;
+  }
+
+  void Finish(TVMRetValue result) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      result_ = std::move(result);
+    }
+    Complete(State::kDone);
+  }
+
+  void Fail(std::exception_ptr error) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      error_ = error;
+    }
+    Complete(State::kFailed);
+  }
+
+  /*! \brief Cancel the future if it has not started running yet. */
+  bool Cancel() {
+    std::vector<PackedFunc> callbacks;
+    {
+      // Check and leave the pending state atomically, so a worker cannot start the future.
+      std::lock_guard<std::mutex> lock(mu_);
+      if (state_ != State::kPending) return false;
+      callbacks = CompleteLocked(State::kCancelled);
+    }
+    NotifyCompletion(callbacks);
+    return true;
+  }
+
+  /*!
+   * \brief Wait for the future to complete.
+   * \param timeout The timeout in seconds, negative to wait forever.
+   * \return Whether the future completed within the timeout.
+   */
+  bool Wait(double timeout) {
+    std::unique_lock<std::mutex> lock(mu_);
+    auto completed = [this] { return state_ >= State::kDone; };
+    if (timeout < 0) {
+      cv_.wait(lock, completed);
+      return true;
+    }
+    return cv_.wait_for(lock, std::chrono::duration<double>(timeout), completed);
+  }
+
+  /*! \brief Wait for the future and return its result, rethrowing the error it failed with. */
+  TVMRetValue Result() {
+    Wait(-1);
+    std::lock_guard<std::mutex> lock(mu_);
+    CHECK(state_ != State::kCancelled) << "The invocation of " << func_name << " was cancelled";
+    if (error_ != nullptr) std::rethrow_exception(error_);
+    return result_;
+  }
+
+  void AddCallback(PackedFunc callback) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      if (state_ < State::kDone) {
+        callbacks_.push_back(callback);
+        return;
+      }
+    }
+    RunCallback(callback);
+  }
+
+  static constexpr const char* _type_key = "relax.vm.Future";
+  TVM_DECLARE_FINAL_OBJECT_INFO(VMFutureObj, Object);
+
+ private:
+  void Complete(State state) {
+    std::vector<PackedFunc> callbacks;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      callbacks = CompleteLocked(state);
+    }
+    NotifyCompletion(callbacks);
+  }
+
+  /*! \brief Move to a completed state with mu_ held, return the callbacks to run. */
+  std::vector<PackedFunc> CompleteLocked(State state) {
+    state_ = state;
+    // The arguments are no longer needed, release them early.
+    args.clear();
+    std::vector<PackedFunc> callbacks;
+    std::swap(callbacks, callbacks_);
+    return callbacks;
+  }
+
+  /*! \brief Wake up the waiters and run the callbacks, without holding mu_. */
+  void NotifyCompletion(const std::vector<PackedFunc>& callbacks) {
+    cv_.notify_all();
+    for (const PackedFunc& callback : callbacks) {
+      RunCallback(callback);
+    }
+  }
+
+  void RunCallback(const PackedFunc& callback) {
+    // A failing callback must not take down the worker that completed the future.
+    try {
+      callback(GetRef<ObjectRef>(this));
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "The completion callback of " << func_name << " failed: " << e.what();
+    }
+  }
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  State state_{State::kPending};
+  TVMRetValue result_;
+  std::exception_ptr error_{nullptr};
+  std::vector<PackedFunc> callbacks_;
+};
+
+TVM_REGISTER_OBJECT_TYPE(VMFutureObj);
+
+/*!
+ * \brief Executor running VM invocations asynchronously on a pool of worker threads.
+ *
+ *  Every worker owns a fork of the VM, so that independent invocations run
+ *  concurrently while sharing the executable, the allocators and the
+ *  constants. Invocations are served in submission order.
+ *
+ *  Every worker runs on its own stream on each non-CPU device of the VM and
+ *  synchronizes it before completing a future, so the kernels of concurrent
+ *  invocations never serialize on a shared stream and a completed result is
+ *  ready to use.
+ *
+ *  To avoid oversubscribing the CPU, the intra-op thread pool of each worker
+ *  is limited to `threads_per_worker` threads, sharing a disjoint range of
+ *  cores when the cores suffice.
+ */
+class AsyncVMExecutorNode : public ModuleNode {
+ public:
+  AsyncVMExecutorNode(Module vm, int num_workers, int threads_per_worker) : vm_(vm) {
+    CHECK_EQ(std::string(vm->type_key()), "relax.VirtualMachine")
+        << "ValueError: The async executor expects a relax VM, got " << vm->type_key();
+    CHECK_GT(num_workers, 0) << "ValueError: num_workers must be positive";
+    CHECK_GE(threads_per_worker, 0) << "ValueError: threads_per_worker must be non-negative";
+    auto* base = static_cast<VirtualMachine*>(vm.operator->());
+    int max_concurrency = threading::MaxConcurrency();
+    if (threads_per_worker == 0) {
+      threads_per_worker = std::max(1, max_concurrency / num_workers);
+    }
+    for (int i = 0; i < num_workers; ++i) {
+      auto worker = std::make_unique<Worker>();
+      worker->vm = base->Fork();
+      workers_.push_back(std::move(worker));
+    }
+    int num_ready = 0;
+    for (int i = 0; i < num_workers; ++i) {
+      std::vector<unsigned int> cpus;
+      for (int k = 0; k < threads_per_worker; ++k) {
+        cpus.push_back((i * threads_per_worker + k) % max_concurrency);
+      }
+      workers_[i]->thread = std::thread([this, i, cpus, &num_ready]() {
+        threading::Configure(threading::ThreadGroup::kSpecifyThreadShareAllCore, 0, cpus);
+        {
+          std::lock_guard<std::mutex> lock(mu_);
+          ++num_ready;
+        }
+        cv_.notify_all();
+        WorkerLoop(workers_[i].get());
+      });
+    }
+    // Configuring a worker pool resets the global maximum concurrency, restore it once
+    // every worker has been configured.
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [&] { return num_ready == num_workers; });
+    threading::SetMaxConcurrency(max_concurrency);
+  }
+
+  ~AsyncVMExecutorNode() { Shutdown(); }
+
+  const char* type_key() const final { return "relax.vm.AsyncExecutor"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "submit") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        CHECK_GE(args.size(), 1) << "ValueError: submit expects the function name";
+        *rv = Submit(args[0], TVMArgs(args.values + 1, args.type_codes + 1, args.size() - 1));
+      });
+    } else if (name == "num_workers") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = static_cast<int64_t>(workers_.size());
+      });
+    } else if (name == "num_pending") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        std::lock_guard<std::mutex> lock(mu_);
+        *rv = static_cast<int64_t>(queue_.size());
+      });
+    } else if (name == "shutdown") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { Shutdown(); });
+    }
+    return PackedFunc(nullptr);
+  }
+
+ private:
+  struct Worker {
+    ObjectPtr<VirtualMachine> vm;
+    std::thread thread;
+    /*! \brief The stream of the worker on each non-CPU device of the VM. */
+    std::vector<std::pair<Device, TVMStreamHandle>> streams;
+    /*! \brief The closures looked up so far, by function name. */
+    std::unordered_map<std::string, VMClosure> closures;
+  };
+
+  ObjectRef Submit(String func_name, TVMArgs args) {
+    // Convert the arguments on the calling thread, which still owns any DLTensor passed in.
+    VirtualMachine* vm = workers_[0]->vm.get();
+    std::vector<TVMRetValue> converted;
+    converted.reserve(args.size());
+    for (int i = 0; i < args.size(); ++i) {
+      converted.push_back(ConvertArgToDevice(args[i], vm->devices[0], vm->allocators[0]));
+    }
+    auto future = make_object<VMFutureObj>(func_name, std::move(converted));
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      CHECK(!shutdown_) << "The async executor has been shut down";
+      queue_.push_back(future);
+    }
+    cv_.notify_one();
+    return ObjectRef(future);
+  }
+
+  void WorkerLoop(Worker* worker) {
+    // The current stream is thread local, so setting it here affects this worker only.
+    for (const Device& dev : worker->vm->devices) {
+      if (dev.device_type == kDLCPU) continue;
+      DeviceAPI* api = DeviceAPI::Get(dev);
+      TVMStreamHandle stream = api->CreateStream(dev);
+      api->SetStream(dev, stream);
+      worker->streams.emplace_back(dev, stream);
+    }
+    while (true) {
+      ObjectPtr<VMFutureObj> future;
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+        if (queue_.empty()) break;
+        future = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      if (!future->TryStart()) continue;
+      try {
+        future->Finish(Invoke(worker, future.get()));
+      } catch (...) {
+        future->Fail(std::current_exception());
+      }
+    }
+    for (const auto& [dev, stream] : worker->streams) {
+      DeviceAPI::Get(dev)->FreeStream(dev, stream);
+    }
+  }
+
+  TVMRetValue Invoke(Worker* worker, VMFutureObj* future) {
+    auto it = worker->closures.find(future->func_name);
+    if (it == worker->closures.end()) {
+      it = worker->closures.emplace(future->func_name, worker->vm->GetClosure(future->func_name))
+               .first;
+    }
+    size_t num_args = future->args.size();
+    std::vector<TVMValue> values(num_args);
+    std::vector<int> tcodes(num_args);
+    TVMArgsSetter setter(values.data(), tcodes.data());
+    for (size_t i = 0; i < num_args; ++i) {
+      setter(i, future->args[i]);
+    }
+    TVMRetValue rv;
+    worker->vm->InvokeClosurePacked(it->second, TVMArgs(values.data(), tcodes.data(), num_args),
+                                    &rv);
+    for (const auto& [dev, stream] : worker->streams) {
+      DeviceAPI::Get(dev)->StreamSync(dev, stream);
+    }
+    return rv;
+  }
+
+  /*! \brief Stop the workers after their current invocation and cancel the queued ones. */
+  void Shutdown() {
+    std::deque<ObjectPtr<VMFutureObj>> queued;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      if (shutdown_) return;
+      shutdown_ = true;
+      std::swap(queued, queue_);
+    }
+    cv_.notify_all();
+    for (const auto& future : queued) {
+      future->Cancel();
+    }
+    for (auto& worker : workers_) {
+      if (worker->thread.joinable()) worker->thread.join();
+    }
+  }
+
+  Module vm_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<ObjectPtr<VMFutureObj>> queue_;
+  bool shutdown_{false};
+};
+
+TVM_REGISTER_GLOBAL("relax.vm.AsyncExecutor")
+    .set_body_typed([](Module vm, int num_workers, int threads_per_worker) {
+      auto n = make_object<AsyncVMExecutorNode>(vm, num_workers, threads_per_worker);
+      return Module(n);
+    });
+
+static VMFutureObj* GetFuture(const ObjectRef& future) {
+  auto* node = future.as<VMFutureObj>();
+  CHECK(node != nullptr) << "TypeError: Expected a relax.vm.Future, got " << future->GetTypeKey();
+  return const_cast<VMFutureObj*>(node);
+}
+
+TVM_REGISTER_GLOBAL("relax.vm.FutureState").set_body_typed([](ObjectRef future) {
+  return static_cast<int>(GetFuture(future)->GetState());
+});
+
+TVM_REGISTER_GLOBAL("relax.vm.FutureWait").set_body_typed([](ObjectRef future, double timeout) {
+  return GetFuture(future)->Wait(timeout);
+});
+
+TVM_REGISTER_GLOBAL("relax.vm.FutureResult").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = GetFuture(args[0])->Result();
+});
+
+TVM_REGISTER_GLOBAL("relax.vm.FutureCancel").set_body_typed([](ObjectRef future) {
+  return GetFuture(future)->Cancel();
+});
+
+TVM_REGISTER_GLOBAL("relax.vm.FutureAddCallback")
+    .set_body_typed([](ObjectRef future, PackedFunc callback) {
+      GetFuture(future)->AddCallback(callback);
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,323 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/batch_scheduler.cc
+ * \brief Continuous-batching request scheduler on top of the relax VM.
+ */
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief Continuous-batching scheduler driving the prefill and decode functions of a VM.
+ *
+ *  Requests are queued with a prompt and join the running batch as soon as a
+ *  state slot and enough of the per-step token budget are available, instead
+ *  of waiting for the whole batch to finish. Every step runs one ragged
+ *  prefill over all newly admitted prompts and one decode over all running
+ *  sequences, then retires the sequences that hit their stop condition and
+ *  frees their slots for the next step.
+ *
+ *  The compiled functions are invoked through `set_input`/`invoke_stateful`
+ *  and must follow the calling convention below, where b is the batch size:
+ *
+ *  - prefill(input_ids: int32[num_tokens], indptr: int32[b + 1], slots: int32[b])
+ *    -> next_tokens: int[b]. The prompt of sequence i is
+ *    input_ids[indptr[i]:indptr[i + 1]].
+ *  - decode(input_ids: int32[b], slots: int32[b]) -> next_tokens: int[b].
+ *
+ *  A slot is an integer in [0, max_batch_size) that identifies the sequence in
+ *  any state kept by the model (e.g. a KV cache) for its whole lifetime. Slots
+ *  are recycled after a sequence retires, so prefill has to reset the state
+ *  of the slots it is given.
+ *
+ *  Inputs are staged into host buffers allocated once at construction and
+ *  passed as views, so building a batch does not allocate.
+ */
+class BatchSchedulerNode : public ModuleNode {
+ public:
+  BatchSchedulerNode(Module vm, String prefill_func, String decode_func, int64_t max_batch_size,
+                     int64_t max_num_tokens)
+      : prefill_func_(prefill_func),
+        decode_func_(decode_func),
+        max_batch_size_(max_batch_size),
+        max_num_tokens_(max_num_tokens) {
+    CHECK_GT(max_batch_size, 0) << "ValueError: max_batch_size must be positive";
+    CHECK_GE(max_num_tokens, max_batch_size)
+        << "ValueError: max_num_tokens must be at least max_batch_size, so that every "
+           "running sequence can decode in the same step";
+    set_input_ = vm.GetFunction("set_input");
+    invoke_stateful_ = vm.GetFunction("invoke_stateful");
+    get_output_ = vm.GetFunction("get_output");
+    CHECK(set_input_ != nullptr && invoke_stateful_ != nullptr && get_output_ != nullptr)
+        << "ValueError: the batch scheduler expects a relax VM module";
+    vm_ = vm;
+
+    DLDataType i32 = DataType::Int(32);
+    Device cpu{kDLCPU, 0};
+    prefill_ids_ = NDArray::Empty({max_num_tokens}, i32, cpu);
+    prefill_indptr_ = NDArray::Empty({max_batch_size + 1}, i32, cpu);
+    prefill_slots_ = NDArray::Empty({max_batch_size}, i32, cpu);
+    decode_ids_ = NDArray::Empty({max_batch_size}, i32, cpu);
+    decode_slots_ = NDArray::Empty({max_batch_size}, i32, cpu);
+
+    // pop from the back, so slots are handed out in increasing order.
+    free_slots_.reserve(max_batch_size);
+    for (int64_t i = max_batch_size - 1; i >= 0; --i) {
+      free_slots_.push_back(static_cast<int32_t>(i));
+    }
+    running_.reserve(max_batch_size);
+  }
+
+  const char* type_key() const final { return "relax.vm.BatchScheduler"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "add_request") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK_EQ(args.size(), 4);
+        int64_t eos = args[3];
+        this->AddRequest(args[0], args[1], args[2], eos);
+      });
+    } else if (name == "step") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->Step(); });
+    } else if (name == "pop_finished") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ShapeTuple finished(finished_.begin(), finished_.end());
+        finished_.clear();
+        *rv = finished;
+      });
+    } else if (name == "take_output") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        int64_t request_id = args[0];
+        auto it = outputs_.find(request_id);
+        CHECK(it != outputs_.end())
+            << "ValueError: request " << request_id << " has not finished or was already taken";
+        *rv = ShapeTuple(std::move(it->second));
+        outputs_.erase(it);
+      });
+    } else if (name == "num_pending") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = static_cast<int64_t>(waiting_.size() + running_.size());
+      });
+    } else if (name == "stats") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = ShapeTuple({num_steps_, num_prefill_tokens_, num_decode_tokens_, num_finished_});
+      });
+    }
+    return PackedFunc(nullptr);
+  }
+
+ private:
+  /*! \brief A request that has not been admitted yet or is being decoded. */
+  struct Sequence {
+    int64_t request_id;
+    std::vector<int64_t> prompt;
+    std::vector<int64_t> generated;
+    int64_t max_new_tokens;
+    int64_t eos;
+    int32_t slot = -1;
+  };
+
+  void AddRequest(int64_t request_id, ShapeTuple prompt, int64_t max_new_tokens, int64_t eos) {
+    CHECK_GT(prompt.size(), 0) << "ValueError: request " << request_id << " has an empty prompt";
+    CHECK_LE(static_cast<int64_t>(prompt.size()), max_num_tokens_)
+        << "ValueError: the prompt of request " << request_id << " has " << prompt.size()
+        << " tokens, which exceeds max_num_tokens=" << max_num_tokens_;
+    CHECK_GT(max_new_tokens, 0) << "ValueError: max_new_tokens must be positive";
+    CHECK(!active_ids_.count(request_id) && !outputs_.count(request_id))
+        << "ValueError: request " << request_id << " is already scheduled";
+    Sequence seq;
+    seq.request_id = request_id;
+    seq.prompt.assign(prompt.begin(), prompt.end());
+    seq.max_new_tokens = max_new_tokens;
+    seq.eos = eos;
+    active_ids_.insert(request_id);
+    waiting_.push_back(std::move(seq));
+  }
+
+  /*!
+   * \brief Run one scheduling step.
+   * \return The number of requests still waiting or running afterwards.
+   */
+  int64_t Step() {
+    // Sequences that were prefilled in an earlier step decode now; their tokens
+    // are reserved from the budget before admitting new prompts.
+    size_t num_decode = running_.size();
+    int64_t budget = max_num_tokens_ - static_cast<int64_t>(num_decode);
+    size_t num_prefill = 0;
+    int64_t num_prefill_tokens = 0;
+    int32_t* indptr = static_cast<int32_t*>(prefill_indptr_->data);
+    int32_t* prefill_ids = static_cast<int32_t*>(prefill_ids_->data);
+    int32_t* prefill_slots = static_cast<int32_t*>(prefill_slots_->data);
+    indptr[0] = 0;
+    // admit in arrival order; a prompt that does not fit blocks the later ones
+    // so long prompts are not starved by short ones.
+    while (!waiting_.empty() && !free_slots_.empty()) {
+      Sequence& seq = waiting_.front();
+      int64_t len = static_cast<int64_t>(seq.prompt.size());
+      if (len > budget) break;
+      seq.slot = free_slots_.back();
+      free_slots_.pop_back();
+      for (int64_t i = 0; i < len; ++i) {
+        prefill_ids[num_prefill_tokens + i] = static_cast<int32_t>(seq.prompt[i]);
+      }
+      num_prefill_tokens += len;
+      budget -= len;
+      prefill_slots[num_prefill] = seq.slot;
+      indptr[++num_prefill] = static_cast<int32_t>(num_prefill_tokens);
+      running_.push_back(std::move(seq));
+      waiting_.pop_front();
+    }
+
+    if (num_decode != 0) {
+      int32_t* decode_ids = static_cast<int32_t*>(decode_ids_->data);
+      int32_t* decode_slots = static_cast<int32_t*>(decode_slots_->data);
+      for (size_t i = 0; i < num_decode; ++i) {
+        decode_ids[i] = static_cast<int32_t>(running_[i].generated.back());
+        decode_slots[i] = running_[i].slot;
+      }
+      int64_t b = static_cast<int64_t>(num_decode);
+      NDArray next = Invoke(decode_func_, {View(decode_ids_, b), View(decode_slots_, b)}, b);
+      AppendTokens(next, 0, num_decode);
+    }
+    if (num_prefill != 0) {
+      int64_t b = static_cast<int64_t>(num_prefill);
+      NDArray next = Invoke(prefill_func_,
+                            {View(prefill_ids_, num_prefill_tokens),
+                             View(prefill_indptr_, b + 1), View(prefill_slots_, b)},
+                            b);
+      AppendTokens(next, num_decode, num_prefill);
+    }
+
+    num_steps_ += 1;
+    num_prefill_tokens_ += num_prefill_tokens;
+    num_decode_tokens_ += static_cast<int64_t>(num_decode);
+    Retire();
+    return static_cast<int64_t>(waiting_.size() + running_.size());
+  }
+
+  static NDArray View(NDArray buffer, int64_t n) { return buffer.CreateView({n}, buffer->dtype); }
+
+  /*! \brief Call a VM function statefully and return its output on the host. */
+  NDArray Invoke(const String& func_name, std::vector<NDArray> inputs, int64_t batch) {
+    std::vector<TVMValue> values(inputs.size() + 1);
+    std::vector<int> codes(inputs.size() + 1);
+    TVMArgsSetter setter(values.data(), codes.data());
+    setter(0, func_name);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      setter(i + 1, inputs[i]);
+    }
+    TVMRetValue rv;
+    set_input_.CallPacked(TVMArgs(values.data(), codes.data(), values.size()), &rv);
+    invoke_stateful_(func_name);
+    NDArray out = get_output_(func_name);
+    CHECK(out->ndim == 1 && out->shape[0] == batch)
+        << "ValueError: " << func_name << " is expected to return one token per sequence, "
+        << "got a " << out->ndim << "-d output for a batch of " << batch;
+    if (out->device.device_type != kDLCPU) {
+      out = out.CopyTo(Device{kDLCPU, 0});
+    }
+    return out;
+  }
+
+  void AppendTokens(const NDArray& next, size_t begin, size_t n) {
+    DataType dtype(next->dtype);
+    CHECK(dtype == DataType::Int(32) || dtype == DataType::Int(64))
+        << "ValueError: the next tokens must be int32 or int64, got " << dtype;
+    for (size_t i = 0; i < n; ++i) {
+      int64_t token = dtype.bits() == 32 ? static_cast<const int32_t*>(next->data)[i]
+                                         : static_cast<const int64_t*>(next->data)[i];
+      running_[begin + i].generated.push_back(token);
+    }
+  }
+
+  /*! \brief Move the sequences which hit their stop condition out of the batch. */
+  void Retire() {
+    size_t keep = 0;
+    for (size_t i = 0; i < running_.size(); ++i) {
+      Sequence& seq = running_[i];
+      bool done = seq.generated.back() == seq.eos ||
+                  static_cast<int64_t>(seq.generated.size()) >= seq.max_new_tokens;
+      if (done) {
+        free_slots_.push_back(seq.slot);
+        finished_.push_back(seq.request_id);
+        active_ids_.erase(seq.request_id);
+        outputs_[seq.request_id] = std::move(seq.generated);
+        num_finished_ += 1;
+      } else {
+        if (keep != i) running_[keep] = std::move(seq);
+        ++keep;
+      }
+    }
+    running_.erase(running_.begin() + keep, running_.end());
+  }
+
+  Module vm_;
+  PackedFunc set_input_;
+  PackedFunc invoke_stateful_;
+  PackedFunc get_output_;
+  String prefill_func_;
+  String decode_func_;
+  int64_t max_batch_size_;
+  int64_t max_num_tokens_;
+
+  /*! \brief Preallocated host staging buffers for the batch inputs. */
+  NDArray prefill_ids_, prefill_indptr_, prefill_slots_;
+  NDArray decode_ids_, decode_slots_;
+
+  std::deque<Sequence> waiting_;
+  std::vector<Sequence> running_;
+  std::vector<int32_t> free_slots_;
+  std::unordered_set<int64_t> active_ids_;
+  std::vector<int64_t> finished_;
+  std::unordered_map<int64_t, std::vector<int64_t>> outputs_;
+
+  int64_t num_steps_{0};
+  int64_t num_prefill_tokens_{0};
+  int64_t num_decode_tokens_{0};
+  int64_t num_finished_{0};
+};
+
+TVM_REGISTER_GLOBAL("relax.vm.BatchScheduler")
+    .set_body_typed([](Module vm, String prefill_func, String decode_func, int64_t max_batch_size,
+                       int64_t max_num_tokens) {
+      auto n = make_object<BatchSchedulerNode>(vm, prefill_func, decode_func, max_batch_size,
+                                               max_num_tokens);
+      return Module(n);
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
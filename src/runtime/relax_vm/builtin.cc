@@ -32,6 +32,9 @@
 #include <tvm/runtime/relax_vm/memory_manager.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "../runtime_base.h"
 
 namespace tvm {
@@ -323,6 +326,83 @@ TVM_REGISTER_GLOBAL("vm.builtin.reshape").set_body_typed([](NDArray data, ShapeT
   return data.CreateView(new_shape, data->dtype);
 });
 
+/*!
+ * \brief Get the element strides of an array, which are implied by its shape when it is compact.
+ * \param data The input array.
+ * \return The strides in number of elements.
+ */
+std::vector<int64_t> GetElemStrides(const NDArray& data) {
+  std::vector<int64_t> strides(data->ndim);
+  int64_t stride = 1;
+  for (int i = data->ndim - 1; i >= 0; --i) {
+    strides[i] = data->strides != nullptr ? data->strides[i] : stride;
+    stride *= data->shape[i];
+  }
+  return strides;
+}
+
+/*!
+ * \brief Create a strided view of a slice of the input, with the semantics of
+ *  relax.strided_slice for non-negative steps.
+ * \param data The input array.
+ * \param begin The begin index of each axis, clamped into the axis.
+ * \param end The end index of each axis, clamped into the axis.
+ * \param step The positive step of each axis.
+ * \return The view, which shares the memory of the input.
+ */
+NDArray StridedSliceView(NDArray data, ShapeTuple begin, ShapeTuple end, ShapeTuple step) {
+  int ndim = data->ndim;
+  CHECK(static_cast<int>(begin.size()) == ndim && static_cast<int>(end.size()) == ndim &&
+        static_cast<int>(step.size()) == ndim)
+      << "ValueError: The begin, end and step of a strided slice view should each have " << ndim
+      << " elements";
+  std::vector<int64_t> strides = GetElemStrides(data);
+  std::vector<int64_t> view_shape(ndim), view_strides(ndim);
+  int64_t elem_offset = 0;
+  for (int i = 0; i < ndim; ++i) {
+    int64_t dim = data->shape[i];
+    CHECK_GT(step[i], 0) << "ValueError: Strided slice views only support positive steps, but "
+                         << step[i] << " is given on axis " << i;
+    int64_t b = std::min(std::max(begin[i] < 0 ? begin[i] + dim : begin[i], int64_t(0)), dim);
+    int64_t e = std::min(std::max(end[i] < 0 ? end[i] + dim : end[i], int64_t(0)), dim);
+    view_shape[i] = e > b ? (e - b + step[i] - 1) / step[i] : 0;
+    view_strides[i] = strides[i] * step[i];
+    elem_offset += b * strides[i];
+  }
+  int64_t elem_bytes = (data->dtype.bits * data->dtype.lanes + 7) / 8;
+  return data.CreateStridedView(ShapeTuple(view_shape), ShapeTuple(view_strides),
+                                elem_offset * elem_bytes);
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.strided_slice_view").set_body_typed(StridedSliceView);
+
+/*!
+ * \brief Create a strided view of the input with permuted axes.
+ * \param data The input array.
+ * \param axes The input axis of each output axis.
+ * \return The view, which shares the memory of the input.
+ */
+NDArray PermuteDimsView(NDArray data, ShapeTuple axes) {
+  int ndim = data->ndim;
+  CHECK_EQ(static_cast<int>(axes.size()), ndim)
+      << "ValueError: The axes of a permute_dims view should have " << ndim << " elements";
+  std::vector<int64_t> strides = GetElemStrides(data);
+  std::vector<int64_t> view_shape(ndim), view_strides(ndim);
+  std::vector<bool> seen(ndim, false);
+  for (int i = 0; i < ndim; ++i) {
+    int64_t axis = axes[i];
+    CHECK(axis >= 0 && axis < ndim && !seen[axis])
+        << "ValueError: The axes of a permute_dims view are not a permutation, axis " << axis
+        << " is out of range or repeated";
+    seen[axis] = true;
+    view_shape[i] = data->shape[axis];
+    view_strides[i] = strides[axis];
+  }
+  return data.CreateStridedView(ShapeTuple(view_shape), ShapeTuple(view_strides));
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.permute_dims_view").set_body_typed(PermuteDimsView);
+
 /*!
  * \brief Load the scalar value in cond and return the result value.
  * \param cond The condition
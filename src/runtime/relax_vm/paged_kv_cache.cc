@@ -0,0 +1,303 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/paged_kv_cache.cc
+ * \brief Paged key/value cache and its VM builtins.
+ */
+#include "paged_kv_cache.h"
+
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+PagedKVCache PagedKVCache::Create(ShapeTuple elem_shape, DLDataType dtype, Device device,
+                                  int64_t num_blocks, int64_t block_size) {
+  CHECK_GT(num_blocks, 0) << "ValueError: the cache needs at least one block";
+  CHECK_GT(block_size, 0) << "ValueError: block_size must be positive";
+  std::vector<int64_t> shape = {num_blocks, block_size};
+  shape.insert(shape.end(), elem_shape.begin(), elem_shape.end());
+
+  auto n = make_object<PagedKVCacheObj>();
+  n->pages = NDArray::Empty(ShapeTuple(shape), dtype, device);
+  n->block_size = block_size;
+  n->entry_bytes_ = (dtype.bits * dtype.lanes + 7) / 8;
+  for (int64_t dim : elem_shape) {
+    n->entry_bytes_ *= dim;
+  }
+  n->ref_count_.resize(num_blocks, 0);
+  // pop from the back, so blocks are handed out in increasing order.
+  n->free_blocks_.reserve(num_blocks);
+  for (int64_t i = num_blocks - 1; i >= 0; --i) {
+    n->free_blocks_.push_back(static_cast<int32_t>(i));
+  }
+  return PagedKVCache(n);
+}
+
+int32_t PagedKVCacheObj::AllocBlock() {
+  CHECK(!free_blocks_.empty()) << "RuntimeError: the paged KV cache is out of blocks, all "
+                               << ref_count_.size() << " blocks are in use";
+  int32_t block = free_blocks_.back();
+  free_blocks_.pop_back();
+  ref_count_[block] = 1;
+  return block;
+}
+
+void PagedKVCacheObj::ReleaseBlock(int32_t block) {
+  ICHECK_GT(ref_count_[block], 0);
+  if (--ref_count_[block] == 0) {
+    free_blocks_.push_back(block);
+  }
+}
+
+PagedKVCacheObj::Sequence& PagedKVCacheObj::GetSequence(int64_t seq_id) {
+  auto it = seqs_.find(seq_id);
+  CHECK(it != seqs_.end()) << "ValueError: sequence " << seq_id << " is not in the KV cache";
+  return it->second;
+}
+
+const PagedKVCacheObj::Sequence& PagedKVCacheObj::GetSequence(int64_t seq_id) const {
+  auto it = seqs_.find(seq_id);
+  CHECK(it != seqs_.end()) << "ValueError: sequence " << seq_id << " is not in the KV cache";
+  return it->second;
+}
+
+void PagedKVCacheObj::CopyEntries(const DLTensor* from, int64_t from_offset, DLTensor* to,
+                                  int64_t to_offset, int64_t count) const {
+  int64_t elems_per_entry = entry_bytes_ * 8 / (pages->dtype.bits * pages->dtype.lanes);
+  int64_t num_elems = count * elems_per_entry;
+  DLTensor src = *from;
+  src.ndim = 1;
+  src.shape = &num_elems;
+  src.strides = nullptr;
+  src.byte_offset = from->byte_offset + from_offset * entry_bytes_;
+  DLTensor dst = *to;
+  dst.ndim = 1;
+  dst.shape = &num_elems;
+  dst.strides = nullptr;
+  dst.byte_offset = to->byte_offset + to_offset * entry_bytes_;
+  NDArray::CopyFromTo(&src, &dst);
+}
+
+void PagedKVCacheObj::AddSequence(int64_t seq_id) {
+  CHECK(!seqs_.count(seq_id)) << "ValueError: sequence " << seq_id << " is already in the cache";
+  seqs_.emplace(seq_id, Sequence());
+}
+
+void PagedKVCacheObj::ForkSequence(int64_t parent_id, int64_t child_id) {
+  CHECK(!seqs_.count(child_id)) << "ValueError: sequence " << child_id
+                                << " is already in the cache";
+  Sequence child = GetSequence(parent_id);
+  for (int32_t block : child.blocks) {
+    ++ref_count_[block];
+  }
+  seqs_.emplace(child_id, std::move(child));
+}
+
+void PagedKVCacheObj::RemoveSequence(int64_t seq_id) {
+  Sequence& seq = GetSequence(seq_id);
+  for (int32_t block : seq.blocks) {
+    ReleaseBlock(block);
+  }
+  seqs_.erase(seq_id);
+}
+
+void PagedKVCacheObj::Append(int64_t seq_id, NDArray data) {
+  Sequence& seq = GetSequence(seq_id);
+  CHECK_EQ(data->ndim, pages->ndim - 1)
+      << "ValueError: expect entries of shape (n, *elem_shape) with ndim " << pages->ndim - 1;
+  for (int i = 1; i < data->ndim; ++i) {
+    CHECK_EQ(data->shape[i], pages->shape[i + 1])
+        << "ValueError: entry shape mismatch at dimension " << i;
+  }
+  CHECK(DataType(data->dtype) == DataType(pages->dtype))
+      << "ValueError: expect entries of dtype " << pages->dtype << " but get " << data->dtype;
+  CHECK(data.IsContiguous()) << "ValueError: expect contiguous entries";
+
+  int64_t num_entries = data->shape[0];
+  // Reserve every block up front so that running out of blocks leaves the sequence unchanged.
+  int64_t tail_offset = seq.length % block_size;
+  int64_t num_new_entries = num_entries;
+  size_t num_needed_blocks = 0;
+  if (num_entries > 0 && tail_offset != 0) {
+    num_new_entries -= std::min(block_size - tail_offset, num_entries);
+    if (ref_count_[seq.blocks.back()] > 1) ++num_needed_blocks;
+  }
+  num_needed_blocks += static_cast<size_t>((num_new_entries + block_size - 1) / block_size);
+  CHECK_LE(num_needed_blocks, free_blocks_.size())
+      << "RuntimeError: the paged KV cache is out of blocks, appending " << num_entries
+      << " entries needs " << num_needed_blocks << " blocks but only " << free_blocks_.size()
+      << " of " << ref_count_.size() << " are free";
+
+  int64_t written = 0;
+  DLTensor* pages_tensor = const_cast<DLTensor*>(pages.operator->());
+  while (written < num_entries) {
+    int64_t offset = seq.length % block_size;
+    if (offset == 0) {
+      seq.blocks.push_back(AllocBlock());
+    } else if (ref_count_[seq.blocks.back()] > 1) {
+      // copy-on-write the partially filled block shared with a forked sequence.
+      int32_t shared = seq.blocks.back();
+      int32_t block = AllocBlock();
+      CopyEntries(pages_tensor, shared * block_size, pages_tensor, block * block_size, offset);
+      ReleaseBlock(shared);
+      seq.blocks.back() = block;
+    }
+    int64_t count = std::min(block_size - offset, num_entries - written);
+    CopyEntries(data.operator->(), written, pages_tensor, seq.blocks.back() * block_size + offset,
+                count);
+    written += count;
+    seq.length += count;
+  }
+}
+
+void PagedKVCacheObj::PopN(int64_t seq_id, int64_t n) {
+  Sequence& seq = GetSequence(seq_id);
+  CHECK(n >= 0 && n <= seq.length) << "ValueError: cannot pop " << n << " entries from sequence "
+                                   << seq_id << " of length " << seq.length;
+  seq.length -= n;
+  size_t num_blocks = static_cast<size_t>((seq.length + block_size - 1) / block_size);
+  while (seq.blocks.size() > num_blocks) {
+    ReleaseBlock(seq.blocks.back());
+    seq.blocks.pop_back();
+  }
+}
+
+NDArray PagedKVCacheObj::View(int64_t seq_id) const {
+  const Sequence& seq = GetSequence(seq_id);
+  std::vector<int64_t> shape(pages.Shape().begin() + 1, pages.Shape().end());
+  shape[0] = seq.length;
+  NDArray view = NDArray::Empty(ShapeTuple(shape), pages->dtype, pages->device);
+  DLTensor* view_tensor = const_cast<DLTensor*>(view.operator->());
+  for (size_t i = 0; i < seq.blocks.size(); ++i) {
+    int64_t begin = static_cast<int64_t>(i) * block_size;
+    int64_t count = std::min(block_size, seq.length - begin);
+    CopyEntries(pages.operator->(), seq.blocks[i] * block_size, view_tensor, begin, count);
+  }
+  return view;
+}
+
+NDArray PagedKVCacheObj::BlockTable(const ShapeTuple& seq_ids) const {
+  size_t max_blocks = 0;
+  for (int64_t seq_id : seq_ids) {
+    max_blocks = std::max(max_blocks, GetSequence(seq_id).blocks.size());
+  }
+  int64_t num_seqs = static_cast<int64_t>(seq_ids.size());
+  NDArray table = NDArray::Empty({num_seqs, static_cast<int64_t>(max_blocks)},
+                                 DLDataType{kDLInt, 32, 1}, {kDLCPU, 0});
+  int32_t* data = static_cast<int32_t*>(table->data);
+  std::fill(data, data + num_seqs * max_blocks, -1);
+  for (int64_t i = 0; i < num_seqs; ++i) {
+    const Sequence& seq = GetSequence(seq_ids[i]);
+    std::copy(seq.blocks.begin(), seq.blocks.end(), data + i * max_blocks);
+  }
+  return table;
+}
+
+NDArray PagedKVCacheObj::SequenceLengths(const ShapeTuple& seq_ids) const {
+  int64_t num_seqs = static_cast<int64_t>(seq_ids.size());
+  NDArray lengths = NDArray::Empty({num_seqs}, DLDataType{kDLInt, 32, 1}, {kDLCPU, 0});
+  int32_t* data = static_cast<int32_t*>(lengths->data);
+  for (int64_t i = 0; i < num_seqs; ++i) {
+    data[i] = static_cast<int32_t>(GetSequence(seq_ids[i]).length);
+  }
+  return lengths;
+}
+
+ShapeTuple PagedKVCacheObj::Stats() const {
+  int64_t num_blocks = static_cast<int64_t>(ref_count_.size());
+  int64_t num_used = num_blocks - static_cast<int64_t>(free_blocks_.size());
+  // entries shared by forked sequences are counted once per block.
+  std::vector<int64_t> block_fill(num_blocks, 0);
+  for (const auto& kv : seqs_) {
+    const Sequence& seq = kv.second;
+    for (size_t i = 0; i < seq.blocks.size(); ++i) {
+      int64_t fill = std::min(block_size, seq.length - static_cast<int64_t>(i) * block_size);
+      block_fill[seq.blocks[i]] = std::max(block_fill[seq.blocks[i]], fill);
+    }
+  }
+  int64_t num_entries = 0;
+  for (int64_t fill : block_fill) {
+    num_entries += fill;
+  }
+  return ShapeTuple({num_blocks, num_used, num_entries, block_size});
+}
+
+TVM_REGISTER_OBJECT_TYPE(PagedKVCacheObj);
+
+//-------------------------------------------------
+//  VM builtins, usable through call_packed.
+//-------------------------------------------------
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_create")
+    .set_body_typed([](ShapeTuple elem_shape, DataType dtype, Device device, int64_t num_blocks,
+                       int64_t block_size) {
+      return PagedKVCache::Create(elem_shape, dtype, device, num_blocks, block_size);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_add_sequence")
+    .set_body_typed([](PagedKVCache cache, int64_t seq_id) { cache->AddSequence(seq_id); });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_fork_sequence")
+    .set_body_typed([](PagedKVCache cache, int64_t parent_id, int64_t child_id) {
+      cache->ForkSequence(parent_id, child_id);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_remove_sequence")
+    .set_body_typed([](PagedKVCache cache, int64_t seq_id) { cache->RemoveSequence(seq_id); });
+
+// returns the cache so that the updated cache can be threaded through dataflow.
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_append")
+    .set_body_typed([](PagedKVCache cache, int64_t seq_id, NDArray data) {
+      cache->Append(seq_id, data);
+      return cache;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_popn")
+    .set_body_typed([](PagedKVCache cache, int64_t seq_id, int64_t n) { cache->PopN(seq_id, n); });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_view")
+    .set_body_typed([](PagedKVCache cache, int64_t seq_id) { return cache->View(seq_id); });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_pages").set_body_typed([](PagedKVCache cache) {
+  return cache->pages;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_block_table")
+    .set_body_typed([](PagedKVCache cache, ShapeTuple seq_ids) {
+      return cache->BlockTable(seq_ids);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_sequence_lengths")
+    .set_body_typed([](PagedKVCache cache, ShapeTuple seq_ids) {
+      return cache->SequenceLengths(seq_ids);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_stats").set_body_typed([](PagedKVCache cache) {
+  return cache->Stats();
+});
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,166 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/paged_kv_cache.h
+ * \brief Paged key/value cache for autoregressive decoding.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_PAGED_KV_CACHE_H_
+#define TVM_RUNTIME_RELAX_VM_PAGED_KV_CACHE_H_
+
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/object.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief A key/value cache whose storage is split into fixed-size blocks.
+ *
+ *  The cache owns a page pool NDArray of shape (num_blocks, block_size, *elem_shape).
+ *  Each sequence records the blocks that hold its entries in a block table, so
+ *  sequences grow without reallocating or copying the past entries. Blocks are
+ *  reference counted: a forked sequence shares the blocks of its parent and
+ *  the last, partially filled block is copied on the first write (copy-on-write),
+ *  which keeps beam search candidates cheap.
+ *
+ *  Kernels invoked through call_tir can consume the paged layout directly
+ *  through the page pool and the block table.
+ */
+class PagedKVCacheObj : public Object {
+ public:
+  /*! \brief The page pool, of shape (num_blocks, block_size, *elem_shape). */
+  NDArray pages;
+  /*! \brief The number of entries held by one block. */
+  int64_t block_size;
+
+  /*!
+   * \brief Add an empty sequence.
+   * \param seq_id The id of the sequence.
+   */
+  void AddSequence(int64_t seq_id);
+  /*!
+   * \brief Create a sequence sharing all the entries of another one.
+   * \param parent_id The id of the sequence to fork.
+   * \param child_id The id of the new sequence.
+   */
+  void ForkSequence(int64_t parent_id, int64_t child_id);
+  /*!
+   * \brief Remove a sequence and release the blocks no longer referenced.
+   * \param seq_id The id of the sequence.
+   */
+  void RemoveSequence(int64_t seq_id);
+  /*!
+   * \brief Append entries to a sequence.
+   * \param seq_id The id of the sequence.
+   * \param data The entries, of shape (n, *elem_shape).
+   */
+  void Append(int64_t seq_id, NDArray data);
+  /*!
+   * \brief Drop the last entries of a sequence.
+   * \param seq_id The id of the sequence.
+   * \param n The number of entries to drop.
+   */
+  void PopN(int64_t seq_id, int64_t n);
+  /*!
+   * \brief Gather the entries of a sequence into a contiguous array.
+   * \param seq_id The id of the sequence.
+   * \return The entries, of shape (length, *elem_shape).
+   */
+  NDArray View(int64_t seq_id) const;
+  /*!
+   * \brief Get the block table of a batch of sequences.
+   * \param seq_ids The ids of the sequences.
+   * \return An int32 array of shape (len(seq_ids), max_num_blocks), padded with -1.
+   */
+  NDArray BlockTable(const ShapeTuple& seq_ids) const;
+  /*!
+   * \brief Get the lengths of a batch of sequences.
+   * \param seq_ids The ids of the sequences.
+   * \return An int32 array of shape (len(seq_ids),).
+   */
+  NDArray SequenceLengths(const ShapeTuple& seq_ids) const;
+  /*!
+   * \brief Get the memory utilization statistics.
+   * \return (num_blocks, num_used_blocks, num_entries, block_size).
+   */
+  ShapeTuple Stats() const;
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.PagedKVCache";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PagedKVCacheObj, Object);
+
+ private:
+  friend class PagedKVCache;
+  /*! \brief The entries of one sequence. */
+  struct Sequence {
+    /*! \brief The blocks holding the entries, in order. */
+    std::vector<int32_t> blocks;
+    /*! \brief The number of entries. */
+    int64_t length{0};
+  };
+
+  /*! \return A free block, throws when the pool is exhausted. */
+  int32_t AllocBlock();
+  /*! \brief Drop a reference to a block. */
+  void ReleaseBlock(int32_t block);
+  /*! \brief Find a sequence, throws when it does not exist. */
+  Sequence& GetSequence(int64_t seq_id);
+  const Sequence& GetSequence(int64_t seq_id) const;
+  /*! \brief Copy entries between two arrays, offsets and count are in entries. */
+  void CopyEntries(const DLTensor* from, int64_t from_offset, DLTensor* to, int64_t to_offset,
+                   int64_t count) const;
+
+  /*! \brief The number of bytes of one entry. */
+  int64_t entry_bytes_;
+  /*! \brief The reference count of each block. */
+  std::vector<int32_t> ref_count_;
+  /*! \brief The free blocks. */
+  std::vector<int32_t> free_blocks_;
+  /*! \brief The sequences in the cache. */
+  std::unordered_map<int64_t, Sequence> seqs_;
+};
+
+/*! \brief Managed reference to PagedKVCacheObj. */
+class PagedKVCache : public ObjectRef {
+ public:
+  /*!
+   * \brief Create a paged cache.
+   * \param elem_shape The shape of one entry, e.g. (num_heads, head_dim).
+   * \param dtype The data type of the entries.
+   * \param device The device of the page pool.
+   * \param num_blocks The number of blocks in the pool.
+   * \param block_size The number of entries in a block.
+   */
+  TVM_DLL static PagedKVCache Create(ShapeTuple elem_shape, DLDataType dtype, Device device,
+                                     int64_t num_blocks, int64_t block_size);
+
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(PagedKVCache, ObjectRef, PagedKVCacheObj);
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_PAGED_KV_CACHE_H_
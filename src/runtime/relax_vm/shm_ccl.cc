@@ -0,0 +1,389 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/shm_ccl.cc
+ * \brief Collective communication between local worker processes over shared memory.
+ *
+ *  Each worker process of a sharded relax program attaches to one POSIX shared
+ *  memory segment and calls the vm.builtin.ccl.* builtins, which the
+ *  distributed lowering emits for the data movement between shards.
+ */
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#if (defined(__linux__) && !defined(__ANDROID__)) || defined(__APPLE__)
+#define TVM_CCL_SHM_ENABLED 1
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+#ifdef TVM_CCL_SHM_ENABLED
+
+/*!
+ * \brief Header at the beginning of the shared memory segment.
+ *
+ *  The segment layout is the header, followed by one slot of `capacity` bytes
+ *  per worker, into which each worker publishes its input, and a result area
+ *  of `capacity` bytes used by allreduce.
+ */
+struct alignas(64) ShmHeader {
+  static constexpr uint64_t kMagic = 0x74766d63636c7368;  // "tvmcclsh"
+  uint64_t magic;
+  int64_t world_size;
+  int64_t capacity;
+  /*! \brief Number of workers arrived at the current barrier. */
+  alignas(64) std::atomic<int64_t> arrived;
+  /*! \brief Incremented each time all the workers pass a barrier. */
+  alignas(64) std::atomic<int64_t> generation;
+};
+
+static_assert(std::atomic<int64_t>::is_always_lock_free,
+              "cross-process barrier needs lock-free atomics");
+
+/*! \brief The communicator of the current worker process. */
+class ShmCommunicator {
+ public:
+  static size_t SegmentBytes(int64_t world_size, int64_t capacity) {
+    return sizeof(ShmHeader) + static_cast<size_t>(world_size + 1) * capacity;
+  }
+
+  /*! \brief Create the segment, called once by the process launching the workers. */
+  static void Create(const std::string& name, int64_t world_size, int64_t capacity) {
+    CHECK_GT(world_size, 0) << "ValueError: world_size must be positive";
+    CHECK_GT(capacity, 0) << "ValueError: capacity must be positive";
+    // keep every slot aligned for any element type.
+    capacity = (capacity + 63) / 64 * 64;
+    size_t nbytes = SegmentBytes(world_size, capacity);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    CHECK_GE(fd, 0) << "RuntimeError: shm_open(" << name << ") failed: " << strerror(errno);
+    int ret = ftruncate(fd, static_cast<off_t>(nbytes));
+    if (ret != 0) {
+      close(fd);
+      shm_unlink(name.c_str());
+      LOG(FATAL) << "RuntimeError: cannot allocate " << nbytes << " bytes of shared memory for "
+                 << name << ": " << strerror(errno);
+    }
+    void* ptr = mmap(nullptr, sizeof(ShmHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(ptr != MAP_FAILED) << "RuntimeError: mmap failed: " << strerror(errno);
+    ShmHeader* header = new (ptr) ShmHeader();
+    header->world_size = world_size;
+    header->capacity = capacity;
+    header->arrived.store(0);
+    header->generation.store(0);
+    header->magic = ShmHeader::kMagic;
+    munmap(ptr, sizeof(ShmHeader));
+  }
+
+  static void Unlink(const std::string& name) { shm_unlink(name.c_str()); }
+
+  ShmCommunicator(const std::string& name, int64_t rank, int64_t world_size) : rank_(rank) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    CHECK_GE(fd, 0) << "RuntimeError: cannot open the shared memory segment " << name << ": "
+                    << strerror(errno);
+    struct stat st;
+    CHECK_EQ(fstat(fd, &st), 0);
+    nbytes_ = static_cast<size_t>(st.st_size);
+    void* ptr = mmap(nullptr, nbytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(ptr != MAP_FAILED) << "RuntimeError: mmap failed: " << strerror(errno);
+    header_ = static_cast<ShmHeader*>(ptr);
+    CHECK_EQ(header_->magic, ShmHeader::kMagic)
+        << "RuntimeError: " << name << " is not a segment created by runtime.ccl.shm_create";
+    CHECK_EQ(header_->world_size, world_size)
+        << "ValueError: the segment " << name << " was created for " << header_->world_size
+        << " workers";
+    CHECK(rank >= 0 && rank < world_size) << "ValueError: invalid rank " << rank;
+    CHECK_EQ(nbytes_, SegmentBytes(world_size, header_->capacity));
+    world_size_ = world_size;
+    capacity_ = header_->capacity;
+  }
+
+  ~ShmCommunicator() { munmap(header_, nbytes_); }
+
+  int64_t rank() const { return rank_; }
+  int64_t world_size() const { return world_size_; }
+
+  NDArray AllReduce(NDArray input) {
+    size_t nbytes = CheckInput(input, "allreduce");
+    std::memcpy(Slot(rank_), Data(input), nbytes);
+    Barrier();
+    // every worker reduces its own contiguous chunk of the elements.
+    int64_t numel = nbytes / ElemBytes(input);
+    int64_t chunk = (numel + world_size_ - 1) / world_size_;
+    int64_t begin = std::min(numel, rank_ * chunk);
+    int64_t end = std::min(numel, begin + chunk);
+    DataType dtype(input->dtype);
+    if (dtype == DataType::Float(32)) {
+      ReduceSum<float>(begin, end);
+    } else if (dtype == DataType::Float(64)) {
+      ReduceSum<double>(begin, end);
+    } else if (dtype == DataType::Int(32)) {
+      ReduceSum<int32_t>(begin, end);
+    } else if (dtype == DataType::Int(64)) {
+      ReduceSum<int64_t>(begin, end);
+    } else {
+      LOG(FATAL) << "TypeError: allreduce does not support " << dtype;
+    }
+    Barrier();
+    NDArray output = NDArray::Empty(input.Shape(), input->dtype, input->device);
+    std::memcpy(Data(output), Result(), nbytes);
+    // the slots are reused by the next collective.
+    Barrier();
+    return output;
+  }
+
+  NDArray AllGather(NDArray input, int axis) {
+    size_t nbytes = CheckInput(input, "allgather");
+    axis = NormalizeAxis(input, axis);
+    std::memcpy(Slot(rank_), Data(input), nbytes);
+    Barrier();
+    std::vector<int64_t> shape(input->shape, input->shape + input->ndim);
+    int64_t outer = Prod(shape, 0, axis);
+    size_t inner_bytes = Prod(shape, axis, shape.size()) * ElemBytes(input);
+    shape[axis] *= world_size_;
+    NDArray output = NDArray::Empty(shape, input->dtype, input->device);
+    char* dst = Data(output);
+    for (int64_t i = 0; i < outer; ++i) {
+      for (int64_t k = 0; k < world_size_; ++k) {
+        std::memcpy(dst, Slot(k) + i * inner_bytes, inner_bytes);
+        dst += inner_bytes;
+      }
+    }
+    Barrier();
+    return output;
+  }
+
+  NDArray Broadcast(NDArray input, int64_t root) {
+    size_t nbytes = CheckInput(input, "broadcast");
+    CheckRoot(root);
+    if (rank_ == root) {
+      std::memcpy(Slot(root), Data(input), nbytes);
+    }
+    Barrier();
+    NDArray output = NDArray::Empty(input.Shape(), input->dtype, input->device);
+    std::memcpy(Data(output), Slot(root), nbytes);
+    Barrier();
+    return output;
+  }
+
+  NDArray Scatter(NDArray input, int64_t root, int axis) {
+    size_t nbytes = CheckInput(input, "scatter");
+    CheckRoot(root);
+    if (rank_ == root) {
+      std::memcpy(Slot(root), Data(input), nbytes);
+    }
+    Barrier();
+    NDArray output = ShardFrom(Slot(root), input, axis, rank_, world_size_);
+    Barrier();
+    return output;
+  }
+
+  /*!
+   * \brief Take the part of `input` along `axis` owned by worker `rank`.
+   * \param data The data of the input, which may live outside `input` (e.g. in a slot).
+   */
+  static NDArray ShardFrom(const void* data, NDArray input, int axis, int64_t rank,
+                           int64_t world_size) {
+    axis = NormalizeAxis(input, axis);
+    std::vector<int64_t> shape(input->shape, input->shape + input->ndim);
+    CHECK_EQ(shape[axis] % world_size, 0)
+        << "ValueError: dimension " << axis << " of size " << shape[axis]
+        << " cannot be split evenly among " << world_size << " workers";
+    int64_t outer = Prod(shape, 0, axis);
+    size_t full_bytes = Prod(shape, axis, shape.size()) * ElemBytes(input);
+    size_t local_bytes = full_bytes / world_size;
+    shape[axis] /= world_size;
+    NDArray output = NDArray::Empty(shape, input->dtype, input->device);
+    const char* src = static_cast<const char*>(data) + rank * local_bytes;
+    char* dst = Data(output);
+    for (int64_t i = 0; i < outer; ++i) {
+      std::memcpy(dst + i * local_bytes, src + i * full_bytes, local_bytes);
+    }
+    return output;
+  }
+
+  /*! \brief The first byte of the elements of `t`, honoring its byte_offset. */
+  static char* Data(const NDArray& t) { return static_cast<char*>(t->data) + t->byte_offset; }
+
+ private:
+  /*! \brief Wait until all the workers arrive. */
+  void Barrier() {
+    int64_t generation = header_->generation.load(std::memory_order_acquire);
+    if (header_->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == world_size_) {
+      header_->arrived.store(0, std::memory_order_relaxed);
+      header_->generation.fetch_add(1, std::memory_order_release);
+      return;
+    }
+    int spins = 0;
+    while (header_->generation.load(std::memory_order_acquire) == generation) {
+      // workers are processes which may share cores, give up the core after a short spin.
+      if (++spins > 1024) sched_yield();
+    }
+  }
+
+  template <typename T>
+  void ReduceSum(int64_t begin, int64_t end) {
+    T* result = reinterpret_cast<T*>(Result());
+    for (int64_t i = begin; i < end; ++i) {
+      result[i] = reinterpret_cast<const T*>(Slot(0))[i];
+    }
+    for (int64_t k = 1; k < world_size_; ++k) {
+      const T* src = reinterpret_cast<const T*>(Slot(k));
+      for (int64_t i = begin; i < end; ++i) {
+        result[i] += src[i];
+      }
+    }
+  }
+
+  size_t CheckInput(const NDArray& input, const char* name) const {
+    CHECK_EQ(input->device.device_type, kDLCPU)
+        << "ValueError: " << name << " over shared memory expects CPU tensors";
+    CHECK(input.IsContiguous()) << "ValueError: " << name << " expects a contiguous tensor";
+    size_t nbytes = GetDataSize(*input.operator->());
+    CHECK_LE(nbytes, static_cast<size_t>(capacity_))
+        << "ValueError: " << name << " of " << nbytes << " bytes exceeds the " << capacity_
+        << " bytes per worker of the shared memory segment; create it with a larger capacity";
+    return nbytes;
+  }
+
+  void CheckRoot(int64_t root) const {
+    CHECK(root >= 0 && root < world_size_) << "ValueError: invalid root worker " << root;
+  }
+
+  static int NormalizeAxis(const NDArray& input, int axis) {
+    int ndim = input->ndim;
+    CHECK(axis >= -ndim && axis < ndim)
+        << "ValueError: axis " << axis << " is out of range for a " << ndim << "-d tensor";
+    return axis < 0 ? axis + ndim : axis;
+  }
+
+  static size_t ElemBytes(const NDArray& input) {
+    return (input->dtype.bits * input->dtype.lanes + 7) / 8;
+  }
+
+  static int64_t Prod(const std::vector<int64_t>& shape, size_t begin, size_t end) {
+    int64_t prod = 1;
+    for (size_t i = begin; i < end; ++i) prod *= shape[i];
+    return prod;
+  }
+
+  char* Slot(int64_t k) const {
+    return reinterpret_cast<char*>(header_ + 1) + static_cast<size_t>(k) * capacity_;
+  }
+  char* Result() const { return Slot(world_size_); }
+
+  ShmHeader* header_{nullptr};
+  size_t nbytes_{0};
+  int64_t rank_{0};
+  int64_t world_size_{1};
+  int64_t capacity_{0};
+};
+
+/*! \brief The communicator of this process, set by runtime.ccl.shm_init. */
+static std::unique_ptr<ShmCommunicator>& GlobalCommunicator() {
+  static std::unique_ptr<ShmCommunicator> comm;
+  return comm;
+}
+
+static ShmCommunicator* GetCommunicator() {
+  ShmCommunicator* comm = GlobalCommunicator().get();
+  CHECK(comm != nullptr) << "RuntimeError: the collective communicator is not initialized, "
+                            "call runtime.ccl.shm_init in the worker first";
+  return comm;
+}
+
+TVM_REGISTER_GLOBAL("runtime.ccl.shm_create")
+    .set_body_typed([](String name, int64_t world_size, int64_t capacity) {
+      ShmCommunicator::Create(name, world_size, capacity);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.ccl.shm_unlink").set_body_typed([](String name) {
+  ShmCommunicator::Unlink(name);
+});
+
+TVM_REGISTER_GLOBAL("runtime.ccl.shm_init")
+    .set_body_typed([](String name, int64_t rank, int64_t world_size) {
+      GlobalCommunicator() = std::make_unique<ShmCommunicator>(name, rank, world_size);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.ccl.shutdown").set_body_typed([]() { GlobalCommunicator().reset(); });
+
+TVM_REGISTER_GLOBAL("runtime.ccl.rank").set_body_typed([]() {
+  return GetCommunicator()->rank();
+});
+
+TVM_REGISTER_GLOBAL("runtime.ccl.world_size").set_body_typed([]() {
+  return GetCommunicator()->world_size();
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.allreduce").set_body_typed([](NDArray input) {
+  return GetCommunicator()->AllReduce(input);
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.allgather").set_body_typed([](NDArray input, int axis) {
+  return GetCommunicator()->AllGather(input, axis);
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.broadcast").set_body_typed([](NDArray input, int64_t root) {
+  return GetCommunicator()->Broadcast(input, root);
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.scatter")
+    .set_body_typed([](NDArray input, int64_t root, int axis) {
+      return GetCommunicator()->Scatter(input, root, axis);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.shard").set_body_typed([](NDArray input, int axis) {
+  ShmCommunicator* comm = GetCommunicator();
+  CHECK_EQ(input->device.device_type, kDLCPU) << "ValueError: shard expects a CPU tensor";
+  CHECK(input.IsContiguous()) << "ValueError: shard expects a contiguous tensor";
+  return ShmCommunicator::ShardFrom(ShmCommunicator::Data(input), input, axis, comm->rank(),
+                                    comm->world_size());
+});
+
+#else
+
+TVM_REGISTER_GLOBAL("runtime.ccl.shm_init").set_body_typed([](String, int64_t, int64_t) {
+  LOG(FATAL) << "RuntimeError: shared memory collectives are not supported on this platform";
+});
+
+#endif  // TVM_CCL_SHM_ENABLED
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -195,6 +195,8 @@ class VirtualMachineImpl : public VirtualMachine {
 
   void SetInstrument(PackedFunc instrument) final { this->instrument_ = instrument; }
 
+  ObjectPtr<VirtualMachine> Fork() final;
+
   //--------------------------------------------------
   // Additional support arguments functions for VM
   //--------------------------------------------------
@@ -420,6 +422,19 @@ void VirtualMachineImpl::Init(const std::vector<Device>& devices,
   this->InitFuncPool();
 }
 
+ObjectPtr<VirtualMachine> VirtualMachineImpl::Fork() {
+  ICHECK(!devices.empty()) << "The VM has to be initialized before it is forked";
+  auto vm = make_object<VirtualMachineImpl>();
+  vm->LoadExecutable(exec_);
+  vm->devices = devices;
+  vm->allocators = allocators;
+  // Constants are read-only, so the forked VM can share them instead of copying
+  // them to the device again.
+  vm->const_pool_ = const_pool_;
+  vm->InitFuncPool();
+  return vm;
+}
+
 VMFuncInfo VirtualMachineImpl::LookupVMFuncInfo(const std::string& func_name) {
   ICHECK(exec_) << "The executable is not created yet.";
   auto it = this->exec_->func_map.find(func_name);
@@ -23,113 +23,245 @@
  */
 #include "workspace_pool.h"
 
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <utility>
 
 namespace tvm {
 namespace runtime {
 
 // page size.
 constexpr size_t kWorkspacePageSize = 4 << 10;
+// Number of size classes between two powers of two, bounding the rounding waste to 25%.
+constexpr int kClassesPerDoubling = 4;
+// Enough size classes to cover any 64-bit size.
+constexpr int kNumSizeClasses = kClassesPerDoubling * 64;
+// Upper bound of free entries a thread keeps per size class.
+constexpr size_t kMaxThreadCachedEntries = 4;
+// Upper bound of free entries the shared pool keeps per size class.
+constexpr size_t kMaxSharedEntries = 16;
 
-class WorkspacePool::Pool {
+/*!
+ * \brief Get the size class of an allocation.
+ * \param nbytes The requested number of bytes.
+ * \return The size class.
+ */
+inline int SizeClassOf(size_t nbytes) {
+  size_t pages = std::max<size_t>((nbytes + kWorkspacePageSize - 1) / kWorkspacePageSize, 1);
+  if (pages <= kClassesPerDoubling) return static_cast<int>(pages - 1);
+  // 2^e < pages <= 2^(e+1), split into kClassesPerDoubling steps.
+  int e = 0;
+  while ((size_t(2) << e) < pages) ++e;
+  size_t step = (size_t(1) << e) / kClassesPerDoubling;
+  size_t k = (pages - 1 - (size_t(1) << e)) / step;
+  return (e - 1) * kClassesPerDoubling + static_cast<int>(k);
+}
+
+/*!
+ * \brief Get the number of bytes allocated for a size class.
+ * \param size_class The size class.
+ * \return The number of bytes, a multiple of the page size.
+ */
+inline size_t SizeClassBytes(int size_class) {
+  if (size_class < kClassesPerDoubling) return (size_class + 1) * kWorkspacePageSize;
+  int e = size_class / kClassesPerDoubling + 1;
+  size_t k = size_class % kClassesPerDoubling;
+  size_t step = (size_t(1) << e) / kClassesPerDoubling;
+  return ((size_t(1) << e) + (k + 1) * step) * kWorkspacePageSize;
+}
+
+/*! \brief The allocation counters of one thread, read by other threads for the statistics. */
+struct WorkspaceCounters {
+  std::atomic<int64_t> num_allocs{0};
+  std::atomic<int64_t> num_thread_hits{0};
+  std::atomic<int64_t> num_shared_hits{0};
+
+  void Add(std::atomic<int64_t>* counter) {
+    counter->store(counter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+};
+
+/*!
+ * \brief The free entries of one device shared by all threads, which take
+ *  from it on a miss in their own cache and give back what they do not keep.
+ *
+ *  Entries are only shared on CPU. Kernels on other devices run
+ *  asynchronously on the stream of the thread that launched them, so an
+ *  entry freed by one thread may still be in use when another thread takes
+ *  it. There, every thread keeps to its own entries and the shared pool only
+ *  tracks the reserved bytes and the statistics.
+ */
+class SharedWorkspacePool {
  public:
-  // constructor
-  Pool() {
-    // safe guard header on each list.
-    Entry e;
-    e.data = nullptr;
-    e.size = 0;
-    free_list_.push_back(e);
-    allocated_.push_back(e);
+  static SharedWorkspacePool* Get(DLDeviceType device_type, int device_id) {
+    // NOTE: deliberately leaked, thread-local pools release into it during program exit.
+    static std::mutex* mutex = new std::mutex();
+    static auto* pools = new std::map<std::pair<int, int>, SharedWorkspacePool*>();
+    std::lock_guard<std::mutex> lock(*mutex);
+    SharedWorkspacePool*& pool = (*pools)[{static_cast<int>(device_type), device_id}];
+    if (pool == nullptr) pool = new SharedWorkspacePool();
+    return pool;
   }
-  // allocate from pool
-  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes) {
-    // Allocate align to page.
-    nbytes = (nbytes + (kWorkspacePageSize - 1)) / kWorkspacePageSize * kWorkspacePageSize;
-    if (nbytes == 0) nbytes = kWorkspacePageSize;
-    Entry e;
+
+  /*! \brief Take a free entry of a size class, return nullptr if there is none. */
+  void* Take(int size_class) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<void*>& entries = free_[size_class];
+    if (entries.empty()) return nullptr;
+    void* data = entries.back();
+    entries.pop_back();
+    return data;
+  }
+
+  /*! \brief Whether the threads of a device may share free entries. */
+  static bool IsShareable(DLDeviceType device_type) { return device_type == kDLCPU; }
+
+  /*! \brief Give back a free entry of a size class, releasing it if the pool is full. */
+  void Give(Device dev, DeviceAPI* device, int size_class, void* data) {
+    if (IsShareable(dev.device_type)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::vector<void*>& entries = free_[size_class];
+      if (entries.size() < kMaxSharedEntries) {
+        entries.push_back(data);
+        return;
+      }
+    }
+    device->FreeDataSpace(dev, data);
+    reserved_bytes_.fetch_sub(static_cast<int64_t>(SizeClassBytes(size_class)),
+                              std::memory_order_relaxed);
+  }
+
+  /*! \brief Allocate a new entry of a size class from the device. */
+  void* AllocDataSpace(Device dev, DeviceAPI* device, int size_class) {
+    size_t class_bytes = SizeClassBytes(size_class);
     DLDataType type;
     type.code = kDLUInt;
     type.bits = 8;
     type.lanes = 1;
-    if (free_list_.size() == 2) {
-      e = free_list_.back();
-      free_list_.pop_back();
-      if (e.size < nbytes) {
-        // resize the page
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
-      }
-    } else if (free_list_.size() == 1) {
-      e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-      e.size = nbytes;
+    void* data = device->AllocDataSpace(dev, class_bytes, kTempAllocaAlignment, type);
+    int64_t reserved = reserved_bytes_.fetch_add(static_cast<int64_t>(class_bytes),
+                                                 std::memory_order_relaxed) +
+                       static_cast<int64_t>(class_bytes);
+    int64_t peak = peak_reserved_bytes_.load(std::memory_order_relaxed);
+    while (reserved > peak &&
+           !peak_reserved_bytes_.compare_exchange_weak(peak, reserved, std::memory_order_relaxed)) {
+    }
+    return data;
+  }
+
+  void Register(const WorkspaceCounters* counters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    live_.push_back(counters);
+  }
+
+  void Unregister(const WorkspaceCounters* counters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    live_.erase(std::find(live_.begin(), live_.end(), counters));
+    retired_.num_allocs += counters->num_allocs.load(std::memory_order_relaxed);
+    retired_.num_thread_hits += counters->num_thread_hits.load(std::memory_order_relaxed);
+    retired_.num_shared_hits += counters->num_shared_hits.load(std::memory_order_relaxed);
+  }
+
+  WorkspacePoolStats GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    WorkspacePoolStats stats = retired_;
+    for (const WorkspaceCounters* counters : live_) {
+      stats.num_allocs += counters->num_allocs.load(std::memory_order_relaxed);
+      stats.num_thread_hits += counters->num_thread_hits.load(std::memory_order_relaxed);
+      stats.num_shared_hits += counters->num_shared_hits.load(std::memory_order_relaxed);
+    }
+    stats.reserved_bytes = reserved_bytes_.load(std::memory_order_relaxed);
+    stats.peak_reserved_bytes = peak_reserved_bytes_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+ private:
+  std::mutex mutex_;
+  /*! \brief The free entries of each size class. */
+  std::vector<void*> free_[kNumSizeClasses];
+  /*! \brief The counters of the pools of live threads. */
+  std::vector<const WorkspaceCounters*> live_;
+  /*! \brief The counters of the pools of exited threads. */
+  WorkspacePoolStats retired_;
+  std::atomic<int64_t> reserved_bytes_{0};
+  std::atomic<int64_t> peak_reserved_bytes_{0};
+};
+
+class WorkspacePool::Pool {
+ public:
+  // constructor
+  Pool(DLDeviceType device_type, int device_id)
+      : shared_(SharedWorkspacePool::Get(device_type, device_id)) {
+    shared_->Register(&counters_);
+  }
+  ~Pool() { shared_->Unregister(&counters_); }
+  // allocate from pool
+  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes) {
+    int size_class = SizeClassOf(nbytes);
+    counters_.Add(&counters_.num_allocs);
+    std::vector<void*>& entries = free_[size_class];
+    void* data;
+    if (!entries.empty()) {
+      counters_.Add(&counters_.num_thread_hits);
+      data = entries.back();
+      entries.pop_back();
+    } else if ((data = shared_->Take(size_class)) != nullptr) {
+      counters_.Add(&counters_.num_shared_hits);
     } else {
-      if (free_list_.back().size >= nbytes) {
-        // find smallest fit
-        auto it = free_list_.end() - 2;
-        for (; it->size >= nbytes; --it) {
-        }
-        e = *(it + 1);
-        free_list_.erase(it + 1);
-      } else {
-        // resize the page
-        e = free_list_.back();
-        free_list_.pop_back();
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
-      }
+      data = shared_->AllocDataSpace(dev, device, size_class);
     }
-    allocated_.push_back(e);
-    return e.data;
+    allocated_.push_back({data, size_class});
+    return data;
   }
   // free resource back to pool
-  void Free(void* data) {
+  void Free(Device dev, DeviceAPI* device, void* data) {
     Entry e;
-    if (allocated_.back().data == data) {
+    if (!allocated_.empty() && allocated_.back().data == data) {
       // quick path, last allocated.
       e = allocated_.back();
       allocated_.pop_back();
     } else {
-      int index = static_cast<int>(allocated_.size()) - 2;
-      for (; index > 0 && allocated_[index].data != data; --index) {
-      }
-      ICHECK_GT(index, 0) << "trying to free things that has not been allocated";
-      e = allocated_[index];
-      allocated_.erase(allocated_.begin() + index);
+      auto it = std::find_if(allocated_.rbegin(), allocated_.rend(),
+                             [data](const Entry& entry) { return entry.data == data; });
+      ICHECK(it != allocated_.rend()) << "trying to free things that has not been allocated";
+      e = *it;
+      allocated_.erase(std::next(it).base());
     }
-    if (free_list_.back().size < e.size) {
-      free_list_.push_back(e);
-    } else if (free_list_.size() == 2) {
-      free_list_.push_back(free_list_.back());
-      free_list_[1] = e;
+    std::vector<void*>& entries = free_[e.size_class];
+    if (entries.size() < kMaxThreadCachedEntries) {
+      entries.push_back(e.data);
     } else {
-      size_t i = free_list_.size() - 1;
-      free_list_.resize(free_list_.size() + 1);
-      for (; e.size < free_list_[i].size; --i) {
-        free_list_[i + 1] = free_list_[i];
-      }
-      free_list_[i + 1] = e;
+      shared_->Give(dev, device, e.size_class, e.data);
     }
   }
   // Release all resources
   void Release(Device dev, DeviceAPI* device) {
-    for (size_t i = 1; i < free_list_.size(); ++i) {
-      device->FreeDataSpace(dev, free_list_[i].data);
+    for (int i = 0; i < kNumSizeClasses; ++i) {
+      for (void* data : free_[i]) {
+        shared_->Give(dev, device, i, data);
+      }
+      free_[i].clear();
     }
-    free_list_.clear();
   }
 
  private:
   /*! \brief a single entry in the pool */
   struct Entry {
     void* data;
-    size_t size;
+    int size_class;
   };
-  /*! \brief List of free items, sorted from small to big size */
-  std::vector<Entry> free_list_;
-  /*! \brief List of allocated items */
+  /*! \brief The pool shared with the other threads. */
+  SharedWorkspacePool* shared_;
+  /*! \brief The allocation counters of this thread. */
+  WorkspaceCounters counters_;
+  /*! \brief The free entries of each size class. */
+  std::vector<void*> free_[kNumSizeClasses];
+  /*! \brief List of allocated items, in allocation order */
   std::vector<Entry> allocated_;
 };
 
@@ -153,15 +285,25 @@ void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
     array_.resize(dev.device_id + 1, nullptr);
   }
   if (array_[dev.device_id] == nullptr) {
-    array_[dev.device_id] = new Pool();
+    array_[dev.device_id] = new Pool(device_type_, dev.device_id);
   }
   return array_[dev.device_id]->Alloc(dev, device_, size);
 }
 
 void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
-  array_[dev.device_id]->Free(ptr);
+  array_[dev.device_id]->Free(dev, device_, ptr);
 }
 
+WorkspacePoolStats WorkspacePool::GetStats(Device dev) {
+  return SharedWorkspacePool::Get(dev.device_type, dev.device_id)->GetStats();
+}
+
+TVM_REGISTER_GLOBAL("runtime.WorkspacePoolStats").set_body_typed([](Device dev) {
+  WorkspacePoolStats stats = WorkspacePool::GetStats(dev);
+  return ShapeTuple({stats.num_allocs, stats.num_thread_hits, stats.num_shared_hits,
+                     stats.reserved_bytes, stats.peak_reserved_bytes});
+});
+
 }  // namespace runtime
 }  // namespace tvm
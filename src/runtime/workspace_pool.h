@@ -31,6 +31,20 @@
 
 namespace tvm {
 namespace runtime {
+/*! \brief Statistics of the workspace pools of one device, summed over all threads. */
+struct WorkspacePoolStats {
+  /*! \brief Number of workspace allocations. */
+  int64_t num_allocs{0};
+  /*! \brief Number of allocations served from the cache of the allocating thread. */
+  int64_t num_thread_hits{0};
+  /*! \brief Number of allocations served from the pool shared by all threads. */
+  int64_t num_shared_hits{0};
+  /*! \brief Number of bytes currently obtained from the device. */
+  int64_t reserved_bytes{0};
+  /*! \brief The peak of reserved_bytes. */
+  int64_t peak_reserved_bytes{0};
+};
+
 /*!
  * \brief A workspace pool to manage
  *
@@ -41,6 +55,12 @@ namespace runtime {
  *  - Only a few allocation will happen, and space will be released after use.
  *  - The release order is usually in reverse order of allocate
  *  - Repeative pattern of same allocations over different runs.
+ *
+ *  Each thread owns its pool. Sizes are rounded up to size classes, each
+ *  with a free list, so that allocation and release in reverse order are
+ *  constant time. On CPU, entries beyond what a thread caches, and the
+ *  entries of exiting threads, go to a backing pool shared by the threads.
+ *  Other devices release them, as kernels may still use them asynchronously.
  */
 class TVM_DLL WorkspacePool {
  public:
@@ -65,6 +85,12 @@ class TVM_DLL WorkspacePool {
    * \param ptr The pointer to be freed.
    */
   void FreeWorkspace(Device dev, void* ptr);
+  /*!
+   * \brief Get the statistics of the workspace pools of a device.
+   * \param dev The device.
+   * \return The statistics summed over all threads.
+   */
+  static WorkspacePoolStats GetStats(Device dev);
 
  private:
   class Pool;
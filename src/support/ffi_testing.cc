@@ -30,6 +30,7 @@
 
 #include <chrono>
 #include <thread>
+#include <vector>
 
 namespace tvm {
 // Attrs used to python API
@@ -160,6 +161,34 @@ runtime::Module NewFrontendTestModule() {
 
 TVM_REGISTER_GLOBAL("testing.FrontendTestModule").set_body_typed(NewFrontendTestModule);
 
+/*!
+ * \brief Measure concurrent function lookups, as issued by generated host code.
+ * \param num_threads The number of threads looking up concurrently.
+ * \param num_lookups The number of lookups done by each thread.
+ * \return The average nanoseconds per lookup of Registry::Get and ModuleNode::GetFuncFromEnv.
+ */
+Array<FloatImm> BenchmarkFuncLookup(int num_threads, int num_lookups) {
+  runtime::Module mod = NewFrontendTestModule();
+  auto measure = [&](std::function<void()> lookup) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.emplace_back([&]() {
+        for (int j = 0; j < num_lookups; ++j) lookup();
+      });
+    }
+    for (auto& t : threads) t.join();
+    std::chrono::duration<double, std::nano> duration =
+        std::chrono::high_resolution_clock::now() - start;
+    return FloatImm(DataType::Float(64), duration.count() / num_lookups);
+  };
+  std::string name = "testing.nop";
+  return {measure([&]() { ICHECK(runtime::Registry::Get(name) != nullptr); }),
+          measure([&]() { ICHECK(mod->GetFuncFromEnv(name) != nullptr); })};
+}
+
+TVM_REGISTER_GLOBAL("testing.benchmark_func_lookup").set_body_typed(BenchmarkFuncLookup);
+
 TVM_REGISTER_GLOBAL("testing.sleep_in_ffi").set_body_typed([](double timeout) {
   std::chrono::duration<int64_t, std::nano> duration(static_cast<int64_t>(timeout * 1e9));
   std::this_thread::sleep_for(duration);
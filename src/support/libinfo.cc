@@ -99,6 +99,10 @@
 #define TVM_INFO_USE_GRAPH_EXECUTOR "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_POOLED_OBJ_ALLOC
+#define TVM_INFO_USE_POOLED_OBJ_ALLOC "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_PROFILER
 #define TVM_INFO_USE_PROFILER "NOT-FOUND"
 #endif
@@ -312,6 +316,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_OPENCL_GTEST", TVM_INFO_USE_OPENCL_GTEST},
       {"USE_OPENMP", TVM_INFO_USE_OPENMP},
       {"USE_PAPI", TVM_INFO_USE_PAPI},
+      {"USE_POOLED_OBJ_ALLOC", TVM_INFO_USE_POOLED_OBJ_ALLOC},
       {"USE_PROFILER", TVM_INFO_USE_PROFILER},
       {"USE_PT_TVMDSOOP", TVM_INFO_USE_PT_TVMDSOOP},
       {"USE_RANDOM", TVM_INFO_USE_RANDOM},
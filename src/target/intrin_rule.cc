@@ -255,6 +255,32 @@ TVM_REGISTER_OP("tir.q_multiply_shift")
         // Only int32 types are supported (any number of lanes is allowed)
         ICHECK(s.dtype().code() == DLDataTypeCode::kDLInt && s.dtype().bits() == 32);
 
+        // Requantization shifts are usually constant and right shifts of at least 2. With a
+        // total shift T = q - s >= 33 the rounding constant 2^(T-1) only touches the high word
+        // of the 64-bit product p, so (p + 2^(T-1)) >> T == (hi(p) + 2^(T-33)) >> (T-32).
+        // This keeps everything but the multiply-high in int32, which LLVM selects as pmuldq
+        // on x86 and smull/smull2 on ARM instead of emulating 64-bit vector shifts.
+        // Like get_int_value, but returns nullptr for non-constants.
+        auto get_const_int_value = [](const PrimExpr& node) {
+          if (const auto* broadcast_node = node.as<BroadcastNode>()) {
+            return tir::as_const_int(broadcast_node->value);
+          }
+          return tir::as_const_int(node);
+        };
+        const int64_t* q_value = get_const_int_value(q);
+        const int64_t* s_value = get_const_int_value(s);
+        if (q_value != nullptr && s_value != nullptr && *s_value <= 0) {
+          int64_t total_right_shift = *q_value - *s_value;
+          if (total_right_shift >= 33 && total_right_shift <= 62) {
+            DataType hp_dtype = DataType::Int(64, x.dtype().lanes());
+            DataType lp_dtype = DataType::Int(32, x.dtype().lanes());
+            PrimExpr high =
+                cast(lp_dtype, (cast(hp_dtype, x) * cast(hp_dtype, y)) >> make_const(hp_dtype, 32));
+            PrimExpr rounding = make_const(lp_dtype, int64_t{1} << (total_right_shift - 33));
+            return (high + rounding) >> make_const(lp_dtype, total_right_shift - 32);
+          }
+        }
+
         // Calculating integer shifts
         PrimExpr zero = make_const(s.dtype(), 0);
         PrimExpr left_shift = tir::Select(s > zero, s, zero);
@@ -76,6 +76,7 @@ void CodeGenCPU::Init(const std::string& module_name, LLVMTarget* llvm_target, b
   dbg_info_ = CreateDebugInfo(module_.get());
   static_assert(sizeof(TVMValue) == sizeof(double), "invariant");
   func_handle_map_.clear();
+  local_packed_funcs_.clear();
   export_system_symbols_.clear();
 
   // Runtime types.
@@ -218,6 +219,15 @@ llvm::DISubprogram* CodeGenCPU::CreateDebugFunction(const PrimFunc& f) {
 #endif
 }
 
+void CodeGenCPU::DeclareFunctions(const std::vector<PrimFunc>& funcs) {
+  for (const PrimFunc& f : funcs) {
+    if (f->GetAttr<Integer>(tvm::attr::kCallingConv, Integer(CallingConv::kDefault)) ==
+        CallingConv::kCPackedFunc) {
+      local_packed_funcs_.insert(f->GetAttr<String>(tvm::attr::kGlobalSymbol).value());
+    }
+  }
+}
+
 void CodeGenCPU::AddFunction(const PrimFunc& f) {
 #if TVM_LLVM_VERSION >= 50
   di_subprogram_ = CreateDebugFunction(f);
@@ -871,6 +881,14 @@ CodeGenCPU::PackedCall CodeGenCPU::MakeCallPackedLowered(const Array<PrimExpr>&
                                                          bool use_string_lookup) {
   PackedCall pc;
   std::string func_name = args[0].as<StringImmNode>()->value;
+  // A packed function generated into this module is called through its C symbol, which only
+  // skips the string lookup of its handle in the module environment. The call keeps the packed
+  // calling convention: the caller still packs the TVMValue argument stack and the callee
+  // still unpacks it, no unpacked entry point with the typed signature is emitted. Functions
+  // of imported modules are unknown here and still go through the cached lookup below.
+  if (use_string_lookup && local_packed_funcs_.count(func_name)) {
+    use_string_lookup = false;
+  }
   // call the function
   int64_t nargs = end - begin;
   ICHECK_GE(nargs, 0);
@@ -29,6 +29,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -66,6 +67,7 @@ class CodeGenCPU : public CodeGenLLVM {
 
   void Init(const std::string& module_name, LLVMTarget* llvm_target, bool system_lib,
             bool dynamic_lookup, bool target_c_runtime) override;
+  void DeclareFunctions(const std::vector<PrimFunc>& funcs) override;
   void AddFunction(const PrimFunc& f) override;
   void AddMainFunction(const std::string& entry_func_name) override;
   std::unique_ptr<llvm::Module> Finish() override;
@@ -90,6 +92,7 @@ class CodeGenCPU : public CodeGenLLVM {
 
  protected:
   void AddStartupFunction() final;
+  bool SupportsGatherScatter() const override { return true; }
   // meta data
   llvm::MDNode* md_tbaa_ctx_ptr_{nullptr};
   // TVM related data types
@@ -184,6 +187,8 @@ class CodeGenCPU : public CodeGenLLVM {
   ParallelEnv parallel_env_;
   // global to packed function handle
   std::unordered_map<std::string, llvm::GlobalVariable*> func_handle_map_;
+  // The packed functions defined in the current module, called without the string lookup.
+  std::unordered_set<std::string> local_packed_funcs_;
   // List of symbols to be exported to TVM system lib.
   std::vector<std::pair<std::string, llvm::Constant*>> export_system_symbols_;
   // List of functions to be registered in the FuncRegistry, if generated.
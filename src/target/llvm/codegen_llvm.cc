@@ -229,6 +229,8 @@ void CodeGenLLVM::InitFuncState() {
   alias_var_set_.clear();
   alloc_storage_info_.clear();
   volatile_buf_.clear();
+  noalias_scopes_.clear();
+  noalias_domain_ = nullptr;
   analyzer_.reset(new arith::Analyzer());
 }
 
@@ -561,6 +563,26 @@ llvm::Type* CodeGenLLVM::GetLLVMType(const PrimExpr& expr) const {
 //
 void CodeGenLLVM::AddAliasInfo(llvm::Instruction* inst, const VarNode* buffer_var, PrimExpr index,
                                DataType access_dtype) {
+  if (!noalias_scopes_.empty()) {
+    // Within a buffer_noalias region, each listed buffer gets its own
+    // alias scope and does not alias the others.
+    llvm::MDNode* scope = nullptr;
+    std::vector<llvm::Metadata*> others;
+    for (const auto& kv : noalias_scopes_) {
+      if (kv.first == buffer_var) {
+        scope = kv.second;
+      } else {
+        others.push_back(kv.second);
+      }
+    }
+    if (scope != nullptr) {
+      llvm::LLVMContext* ctx = llvm_target_->GetContext();
+      inst->setMetadata(llvm::LLVMContext::MD_alias_scope, llvm::MDNode::get(*ctx, {scope}));
+      if (!others.empty()) {
+        inst->setMetadata(llvm::LLVMContext::MD_noalias, llvm::MDNode::get(*ctx, others));
+      }
+    }
+  }
   if (alias_var_set_.count(buffer_var) != 0) {
     // Mark all possibly aliased pointer as same type.
     llvm::MDNode* meta = md_tbaa_alias_set_;
@@ -826,6 +848,9 @@ llvm::Value* CodeGenLLVM::CreateCast(DataType from, DataType to, llvm::Value* va
   if (value->getType() == target) return value;
   if (to.is_handle()) {
     return builder_->CreateBitCast(value, target);
+  } else if (from.is_handle()) {
+    ICHECK(to.is_int() || to.is_uint()) << "Cannot cast a handle to " << to;
+    return builder_->CreatePtrToInt(value, target);
   } else if (to.is_uint() && to.bits() == 1) {
     if (from.is_float()) {
       llvm::Constant* zero = llvm::ConstantFP::get(DTypeToLLVMType(from), 0.);
@@ -897,7 +922,7 @@ CodeGenLLVM::TypedPointer CodeGenLLVM::CreateBufferPtr(llvm::Value* buffer_ptr,
   llvm::Type* value_type = DTypeToLLVMType(value_dtype);
   llvm::PointerType* value_ptr_type = value_type->getPointerTo(address_space);
 
-  ICHECK(index->getType()->isIntegerTy()) << "Expected buffer index to be an integer";
+  ICHECK(index->getType()->isIntOrIntVectorTy()) << "Expected buffer index to be an integer";
 
   if (buffer_ptr_type != element_ptr_type) {
     buffer_ptr = builder_->CreatePointerCast(buffer_ptr, element_ptr_type);
@@ -1380,6 +1405,14 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
       indices.push_back(i);
     }
     return builder_->CreateShuffleVector(v0, v1, indices);
+  } else if (op->op.same_as(builtin::masked_load())) {
+    return CreateMaskedLoad(op);
+  } else if (op->op.same_as(builtin::masked_store())) {
+    return CreateMaskedStore(op);
+  } else if (op->op.same_as(builtin::vector_reduce_sum()) ||
+             op->op.same_as(builtin::vector_reduce_max()) ||
+             op->op.same_as(builtin::vector_reduce_min())) {
+    return CreateVectorReduce(op);
   } else if (op->op.same_as(builtin::atomic_add())) {
     // TODO(masahi): Support atomic for CPU backend
     LOG(FATAL) << "CPU backend does not support atomic add yet.";
@@ -1392,6 +1425,161 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
   }
 }
 
+const BufferLoadNode* CodeGenLLVM::GetMaskedAccess(const CallNode* op) {
+  const CallNode* addr = op->args[0].as<CallNode>();
+  ICHECK(addr && addr->op.same_as(builtin::address_of()))
+      << op->op << " expects the address of a buffer element, but got " << op->args[0];
+  const BufferLoadNode* load = addr->args[0].as<BufferLoadNode>();
+  ICHECK(load) << op->op << " expects the address of a buffer element, but got " << op->args[0];
+  return load;
+}
+
+llvm::Value* CodeGenLLVM::CreateMaskedLoad(const CallNode* op) {
+  const BufferLoadNode* load = GetMaskedAccess(op);
+  llvm::Value* mask = MakeValue(op->args[1]);
+  llvm::Value* passthru = MakeValue(op->args[2]);
+  // A masked access cannot be split into unconditional scalar accesses. Without native
+  // support, LLVM scalarizes the gather into one guarded load per lane.
+  if (IsNonContiguousAccess(load->buffer, load->indices, load->dtype)) {
+    return CreateGather(load->buffer, load->indices[0], load->dtype, mask, passthru);
+  }
+  llvm::Value* ret = nullptr;
+  auto make_load = [&](TypedPointer buffer_ptr, int subelement_i, int alignment,
+                       bool /* is_volatile */) {
+    ICHECK_EQ(subelement_i, -1) << "masked_load requires a contiguous vector access";
+#if TVM_LLVM_VERSION >= 130
+    auto* inst = builder_->CreateMaskedLoad(buffer_ptr.type, buffer_ptr.addr,
+                                            llvm::Align(alignment), mask, passthru);
+#elif TVM_LLVM_VERSION >= 110
+    auto* inst =
+        builder_->CreateMaskedLoad(buffer_ptr.addr, llvm::Align(alignment), mask, passthru);
+#else
+    auto* inst = builder_->CreateMaskedLoad(buffer_ptr.addr, alignment, mask, passthru);
+#endif
+    ret = inst;
+    return inst;
+  };
+  BufferAccessHelper(load->buffer, load->indices, load->dtype, make_load);
+  return ret;
+}
+
+llvm::Value* CodeGenLLVM::CreateMaskedStore(const CallNode* op) {
+  const BufferLoadNode* load = GetMaskedAccess(op);
+  llvm::Value* value = MakeValue(op->args[1]);
+  llvm::Value* mask = MakeValue(op->args[2]);
+  if (IsNonContiguousAccess(load->buffer, load->indices, op->args[1].dtype())) {
+    return CreateScatter(load->buffer, load->indices[0], value, mask);
+  }
+  llvm::Value* ret = nullptr;
+  auto make_store = [&](TypedPointer buffer_ptr, int subelement_i, int alignment,
+                        bool /* is_volatile */) {
+    ICHECK_EQ(subelement_i, -1) << "masked_store requires a contiguous vector access";
+#if TVM_LLVM_VERSION >= 110
+    auto* inst =
+        builder_->CreateMaskedStore(value, buffer_ptr.addr, llvm::Align(alignment), mask);
+#else
+    auto* inst = builder_->CreateMaskedStore(value, buffer_ptr.addr, alignment, mask);
+#endif
+    ret = inst;
+    return inst;
+  };
+  BufferAccessHelper(load->buffer, load->indices, op->args[1].dtype(), make_store);
+  return ret;
+}
+
+bool CodeGenLLVM::IsNonContiguousAccess(const Buffer& buffer, const Array<PrimExpr>& indices,
+                                        DataType value_dtype) {
+  if (indices.size() != 1 || value_dtype.lanes() == 1) return false;
+  const PrimExpr& index = indices[0];
+  if (buffer->dtype.lanes() != 1 || index.dtype().lanes() != value_dtype.lanes()) return false;
+  if (const RampNode* ramp = index.as<RampNode>()) {
+    // Contiguous accesses are a plain vector load/store.
+    if (is_one(ramp->stride)) return false;
+  }
+  return buffer->dtype.bits() >= 8 && !HasAlignmentPadding(buffer->dtype);
+}
+
+bool CodeGenLLVM::IsGatherScatter(const Buffer& buffer, const Array<PrimExpr>& indices,
+                                  DataType value_dtype) {
+  return SupportsGatherScatter() && IsNonContiguousAccess(buffer, indices, value_dtype) &&
+         !volatile_buf_.count(buffer->data.get());
+}
+
+llvm::Value* CodeGenLLVM::CreateGather(const Buffer& buffer, const PrimExpr& index,
+                                       DataType value_dtype, llvm::Value* mask,
+                                       llvm::Value* passthru) {
+  // A GEP with a vector index yields the vector of element pointers.
+  TypedPointer ptrs =
+      CreateBufferPtr(MakeValue(buffer->data), buffer->dtype, {MakeValue(index)}, buffer->dtype);
+  llvm::Type* value_type = DTypeToLLVMType(value_dtype);
+  if (mask == nullptr) {
+    mask = llvm::Constant::getAllOnesValue(DTypeToLLVMType(DataType::Bool(value_dtype.lanes())));
+  }
+  if (passthru == nullptr) {
+    passthru = llvm::UndefValue::get(value_type);
+  }
+  int alignment = buffer->dtype.bytes();
+#if TVM_LLVM_VERSION >= 130
+  llvm::Instruction* gather = builder_->CreateMaskedGather(value_type, ptrs.addr,
+                                                           llvm::Align(alignment), mask, passthru);
+#elif TVM_LLVM_VERSION >= 110
+  llvm::Instruction* gather =
+      builder_->CreateMaskedGather(ptrs.addr, llvm::Align(alignment), mask, passthru);
+#else
+  llvm::Instruction* gather = builder_->CreateMaskedGather(ptrs.addr, alignment, mask, passthru);
+#endif
+  AddAliasInfo(gather, buffer->data.get(), index, buffer->dtype);
+  return gather;
+}
+
+llvm::Value* CodeGenLLVM::CreateScatter(const Buffer& buffer, const PrimExpr& index,
+                                        llvm::Value* value, llvm::Value* mask) {
+  TypedPointer ptrs =
+      CreateBufferPtr(MakeValue(buffer->data), buffer->dtype, {MakeValue(index)}, buffer->dtype);
+  if (mask == nullptr) {
+    mask = llvm::Constant::getAllOnesValue(
+        DTypeToLLVMType(DataType::Bool(index.dtype().lanes())));
+  }
+  int alignment = buffer->dtype.bytes();
+#if TVM_LLVM_VERSION >= 110
+  llvm::Instruction* scatter =
+      builder_->CreateMaskedScatter(value, ptrs.addr, llvm::Align(alignment), mask);
+#else
+  llvm::Instruction* scatter = builder_->CreateMaskedScatter(value, ptrs.addr, alignment, mask);
+#endif
+  AddAliasInfo(scatter, buffer->data.get(), index, buffer->dtype);
+  return scatter;
+}
+
+llvm::Value* CodeGenLLVM::CreateVectorReduce(const CallNode* op) {
+  DataType dtype = op->args[0].dtype();
+  llvm::Value* value = MakeValue(op->args[0]);
+  if (dtype.is_scalar()) return value;
+  bool is_signed = dtype.is_int();
+  if (op->op.same_as(builtin::vector_reduce_sum())) {
+    if (!dtype.is_float()) return builder_->CreateAddReduce(value);
+    llvm::Value* start = llvm::ConstantFP::getNegativeZero(DTypeToLLVMType(dtype.element_of()));
+    auto* inst = llvm::cast<llvm::Instruction>(builder_->CreateFAddReduce(start, value));
+    // Without reassociation the lanes are added in order, one at a time.
+    inst->setHasAllowReassoc(true);
+    return inst;
+  } else if (op->op.same_as(builtin::vector_reduce_max())) {
+    if (!dtype.is_float()) return builder_->CreateIntMaxReduce(value, is_signed);
+#if TVM_LLVM_VERSION >= 120
+    return builder_->CreateFPMaxReduce(value);
+#else
+    return builder_->CreateFPMaxReduce(value, /*NoNaN=*/false);
+#endif
+  } else {
+    if (!dtype.is_float()) return builder_->CreateIntMinReduce(value, is_signed);
+#if TVM_LLVM_VERSION >= 120
+    return builder_->CreateFPMinReduce(value);
+#else
+    return builder_->CreateFPMinReduce(value, /*NoNaN=*/false);
+#endif
+  }
+}
+
 void CodeGenLLVM::Scalarize(const PrimExpr& e, std::function<void(int i, llvm::Value* v)> f) {
   if (const RampNode* ramp = e.as<RampNode>()) {
     for (int i = 0; i < ramp->dtype.lanes(); ++i) {
@@ -1663,6 +1851,10 @@ void CodeGenLLVM::BufferAccessHelper(
 llvm::Value* CodeGenLLVM::VisitExpr_(const BufferLoadNode* op) {
   DataType value_dtype = op->dtype;
 
+  if (IsGatherScatter(op->buffer, op->indices, value_dtype)) {
+    return CreateGather(op->buffer, op->indices[0], value_dtype, nullptr, nullptr);
+  }
+
   std::vector<llvm::Value*> loads;
 
   auto make_load = [this, &loads](TypedPointer buffer_ptr, int /* subelement_i */, int alignment,
@@ -1770,6 +1962,11 @@ void CodeGenLLVM::VisitStmt_(const BufferStoreNode* op) {
 
   llvm::Value* value = MakeValue(op->value);
 
+  if (IsGatherScatter(op->buffer, op->indices, value_dtype)) {
+    CreateScatter(op->buffer, op->indices[0], value, nullptr);
+    return;
+  }
+
   auto make_store = [this, value](TypedPointer buffer_ptr, int subelement_i, int alignment,
                                   bool is_volatile) {
     llvm::Value* to_store = value;
@@ -1928,6 +2125,18 @@ void CodeGenLLVM::VisitStmt_(const AttrStmtNode* op) {
     const VarNode* v = op->node.as<VarNode>();
     ICHECK(v);
     volatile_buf_.insert(v);
+  } else if (op->attr_key == tir::attr::buffer_noalias) {
+    const VarNode* v = op->node.as<VarNode>();
+    ICHECK(v);
+    if (noalias_domain_ == nullptr) {
+      noalias_domain_ = md_builder_->createAnonymousAliasScopeDomain("tvm.buffer_noalias");
+    }
+    noalias_scopes_.emplace_back(
+        v, md_builder_->createAnonymousAliasScope(noalias_domain_, v->name_hint.c_str()));
+    this->VisitStmt(op->body);
+    noalias_scopes_.pop_back();
+    if (noalias_scopes_.empty()) noalias_domain_ = nullptr;
+    return;
   }
   this->VisitStmt(op->body);
 }
@@ -136,6 +136,14 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
    * \param f The function to be added.
    */
   virtual void AddFunction(const PrimFunc& f);
+  /*!
+   * \brief Declare the functions that are about to be added to the current module.
+   *
+   *  Called before any of the functions is added, so that calls to a function
+   *  can be specialized even if the callee is added after the caller.
+   * \param funcs The functions to be added.
+   */
+  virtual void DeclareFunctions(const std::vector<PrimFunc>& funcs) {}
   /*!
    * \brief Add main function as the entry name
    * \param entry_func_name The name of entry function to be added.
@@ -288,6 +296,25 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
    */
   virtual void CreatePrintf(const std::string& format, llvm::ArrayRef<llvm::Value*> format_args);
 
+  // Lower tir.masked_load and tir.masked_store to the LLVM masked memory intrinsics.
+  const BufferLoadNode* GetMaskedAccess(const CallNode* op);
+  llvm::Value* CreateMaskedLoad(const CallNode* op);
+  llvm::Value* CreateMaskedStore(const CallNode* op);
+  // Whether a vector access goes through one index per lane rather than a contiguous ramp.
+  bool IsNonContiguousAccess(const Buffer& buffer, const Array<PrimExpr>& indices,
+                             DataType value_dtype);
+  // Whether a vector access through a non-contiguous index is emitted as a single
+  // llvm.masked.gather/scatter rather than one scalar access per lane.
+  bool IsGatherScatter(const Buffer& buffer, const Array<PrimExpr>& indices,
+                       DataType value_dtype);
+  // Create a gather/scatter. A null mask enables all lanes.
+  llvm::Value* CreateGather(const Buffer& buffer, const PrimExpr& index, DataType value_dtype,
+                            llvm::Value* mask, llvm::Value* passthru);
+  llvm::Value* CreateScatter(const Buffer& buffer, const PrimExpr& index, llvm::Value* value,
+                             llvm::Value* mask);
+  // Lower tir.vector_reduce_sum/max/min to the LLVM horizontal reduction intrinsics.
+  llvm::Value* CreateVectorReduce(const CallNode* op);
+
   /*! \brief Lookup return address, for debugging purposes
    *
    * This is intended solely for debugging purposes.  Calls the
@@ -351,6 +378,8 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   virtual int NativeVectorBits(const runtime::StorageScope& storage_scope) const;
   // Get correct address space depending on the backend
   virtual unsigned GetGlobalAddressSpace() const;
+  // Whether the backend lowers vector accesses with arbitrary indices to gather/scatter.
+  virtual bool SupportsGatherScatter() const { return false; }
   void AddFunctionInternal(const PrimFunc& f, bool ret_void);
   // Create extern call
   llvm::CallInst* CreateCallExtern(llvm::Type* ret, const std::string& name,
@@ -520,6 +549,9 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   std::unordered_set<const VarNode*> alias_var_set_;
   // set of volatile buffer.
   std::unordered_set<const VarNode*> volatile_buf_;
+  // Alias scopes of the buffers known not to overlap in the current region
+  std::vector<std::pair<const VarNode*, llvm::MDNode*>> noalias_scopes_;
+  llvm::MDNode* noalias_domain_{nullptr};
   // deep comparison of PrimExpr
   ExprDeepEqual deep_equal_;
   // binding of let variables. Enables duplicate var defs that map to same value
@@ -573,6 +605,7 @@ void CodeGenLLVM::AddFunctionsOrdered(IterType begin, IterType end, ConvType pfu
     std::string name_b = func_b->GetAttr<String>(tvm::attr::kGlobalSymbol).value();
     return name_a < name_b;
   });
+  DeclareFunctions(funcs);
   for (auto& f : funcs) {
     auto global_symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
     AddFunction(f);
@@ -0,0 +1,217 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file default_cpu_schedule.cc
+ * \brief Schedule the blocks of untuned PrimFuncs for CPU.
+ *
+ *  Each block whose loop nest is its own and unscheduled gets:
+ *  - for matmul-like reductions, cache-blocking tiles of the two innermost
+ *    spatial loops and the reduction loop, sized to the L1 and L2 caches;
+ *  - the innermost spatial loop vectorized, when its extent allows;
+ *  - the outer spatial loops fused and parallelized, when there is enough work;
+ *  - auto unrolling on the outermost loop.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/schedule/schedule.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+
+#include "../../meta_schedule/utils.h"
+#include "../schedule/analysis.h"
+
+namespace tvm {
+namespace tir {
+
+struct DefaultCPUScheduleConfigNode : public tvm::AttrsNode<DefaultCPUScheduleConfigNode> {
+  int l1_cache_bytes;
+  int l2_cache_bytes;
+  int vector_bytes;
+  int unroll_max_step;
+  int parallel_grain;
+
+  TVM_DECLARE_ATTRS(DefaultCPUScheduleConfigNode, "tir.transform.DefaultCPUScheduleConfig") {
+    TVM_ATTR_FIELD(l1_cache_bytes).describe("The L1 data cache size in bytes").set_default(32768);
+    TVM_ATTR_FIELD(l2_cache_bytes).describe("The L2 cache size in bytes").set_default(1 << 20);
+    TVM_ATTR_FIELD(vector_bytes).describe("The SIMD register width in bytes").set_default(32);
+    TVM_ATTR_FIELD(unroll_max_step)
+        .describe("The pragma_auto_unroll_max_step set on each loop nest")
+        .set_default(16);
+    TVM_ATTR_FIELD(parallel_grain)
+        .describe("The number of iterations below which a loop nest is not parallelized")
+        .set_default(1 << 14);
+  }
+};
+
+class DefaultCPUScheduleConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(DefaultCPUScheduleConfig, Attrs,
+                                            DefaultCPUScheduleConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(DefaultCPUScheduleConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.DefaultCPUSchedule", DefaultCPUScheduleConfig);
+
+namespace transform {
+
+/*! \brief The largest divisor of extent that is at most limit. */
+int64_t LargestDivisor(int64_t extent, int64_t limit) {
+  for (int64_t d = std::min(extent, limit); d > 1; --d) {
+    if (extent % d == 0) return d;
+  }
+  return 1;
+}
+
+/*!
+ * \brief Schedule a block for CPU.
+ * \param sch The schedule to work on.
+ * \param block_rv The block to be scheduled.
+ * \param cfg The cache, vector and unroll parameters.
+ */
+void ScheduleBlockForCPU(const tir::Schedule& sch, const tir::BlockRV& block_rv,
+                         const DefaultCPUScheduleConfigNode* cfg) {
+  tir::StmtSRef block_sref = sch->GetSRef(block_rv);
+  const tir::BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+  Array<tir::LoopRV> loops = sch->GetLoops(block_rv);
+  // Only leaf blocks with one loop per iterator, in iterator order, and a loop nest of their own.
+  if (loops.empty() || loops.size() != block->iter_vars.size() || block->writes.size() != 1 ||
+      !sch->GetChildBlocks(block_rv).empty() || sch->GetChildBlocks(loops[0]).size() != 1 ||
+      !tir::IsTrivialBinding(sch->state(), block_sref)) {
+    return;
+  }
+  // The total number of iterations, -1 if it is not known statically.
+  int64_t work = 1;
+  std::vector<int64_t> extents;
+  for (const tir::LoopRV& loop_rv : loops) {
+    tir::For loop = sch->Get(loop_rv);
+    // skip block if already scheduled
+    if (loop->kind != tir::ForKind::kSerial || !loop->annotations.empty()) return;
+    const auto* extent = loop->extent.as<IntImmNode>();
+    extents.push_back(extent ? extent->value : -1);
+    work = (extent && work >= 0) ? work * extent->value : -1;
+  }
+  // Spatial loops first, then reduction loops, as LegalizeOps emits them.
+  size_t num_spatial = 0;
+  while (num_spatial < loops.size() &&
+         block->iter_vars[num_spatial]->iter_type == tir::IterVarType::kDataPar) {
+    ++num_spatial;
+  }
+  for (size_t i = num_spatial; i < loops.size(); ++i) {
+    if (block->iter_vars[i]->iter_type != tir::IterVarType::kCommReduce) return;
+  }
+  if (num_spatial == 0) return;
+  size_t num_reduce = loops.size() - num_spatial;
+
+  int64_t bytes = std::max(block->writes[0]->buffer->dtype.bytes(), 1);
+  int64_t vector_lanes = std::max<int64_t>(cfg->vector_bytes / bytes, 1);
+  Array<tir::LoopRV> outer(loops.begin(), loops.begin() + num_spatial);
+  if (num_reduce == 1 && num_spatial >= 2 && block->init.defined() &&
+      extents[num_spatial - 2] > 0 && extents[num_spatial - 1] > 0 && extents.back() > 0) {
+    // Matmul-like: a strip of j1 columns accumulates over k1, with the k1 x j1 panel of the
+    // second operand kept in L1 across the i1 rows, and the i1 x k1 block of the first in L2.
+    int64_t tile_j = LargestDivisor(extents[num_spatial - 1], 4 * vector_lanes);
+    int64_t tile_k = LargestDivisor(extents.back(), cfg->l1_cache_bytes / 2 / (tile_j * bytes));
+    int64_t tile_i = LargestDivisor(extents[num_spatial - 2],
+                                    std::min<int64_t>(cfg->l2_cache_bytes / 2 / (tile_k * bytes),
+                                                      64));
+    Array<tir::LoopRV> i = sch->Split(loops[num_spatial - 2], {NullOpt, Integer(tile_i)});
+    Array<tir::LoopRV> j = sch->Split(loops[num_spatial - 1], {NullOpt, Integer(tile_j)});
+    Array<tir::LoopRV> k = sch->Split(loops.back(), {NullOpt, Integer(tile_k)});
+    sch->Reorder({i[0], j[0], k[0], i[1], k[1], j[1]});
+    sch->DecomposeReduction(block_rv, k[0]);
+    if (tile_j > 1) sch->Vectorize(j[1]);
+    outer = Array<tir::LoopRV>(loops.begin(), loops.begin() + num_spatial - 2);
+    outer.push_back(i[0]);
+    outer.push_back(j[0]);
+  } else if (num_reduce == 0 && extents.back() > 0) {
+    int64_t tile = LargestDivisor(extents.back(), 4 * vector_lanes);
+    if (tile > 1) {
+      Array<tir::LoopRV> split = sch->Split(loops.back(), {NullOpt, Integer(tile)});
+      sch->Vectorize(split[1]);
+      outer.Set(num_spatial - 1, split[0]);
+    }
+  }
+
+  tir::LoopRV outermost = outer[0];
+  if (work < 0 || work >= cfg->parallel_grain) {
+    outermost = outer.size() > 1 ? sch->Fuse(outer) : outer[0];
+    sch->Parallel(outermost);
+  }
+  if (cfg->unroll_max_step > 0) {
+    sch->Annotate(outermost, tir::attr::pragma_auto_unroll_max_step,
+                  IntImm(DataType::Int(32), cfg->unroll_max_step));
+    sch->Annotate(outermost, tir::attr::pragma_unroll_explicit, IntImm(DataType::Int(32), 1));
+  }
+}
+
+Pass DefaultCPUSchedule() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =  //
+      [=](IRModule m, PassContext pc) {
+        // get the target from context.
+        tvm::Target target = tvm::Target::Current();
+        ICHECK(target.defined()) << "Target is not set in current context";
+        // skip non-cpu targets.
+        if (target->kind->name != "llvm") {
+          return m;
+        }
+        auto cfg = pc->GetConfig<DefaultCPUScheduleConfig>("tir.DefaultCPUSchedule");
+        if (!cfg.defined()) {
+          cfg = AttrsWithDefaultValues<DefaultCPUScheduleConfig>();
+        }
+        Map<GlobalVar, BaseFunc> updates;
+        for (const auto& [gv, func] : m->functions) {
+          if (!func->IsInstance<tir::PrimFuncNode>() || func->HasNonzeroAttr(attr::kIsScheduled)) {
+            continue;
+          }
+          tir::Schedule sch =
+              tir::Schedule::Concrete(IRModule({{gv, func}}), /*seed=*/-1, /*debug_mask=*/0,
+                                      tir::ScheduleErrorRenderLevel::kNone);
+          Array<tir::BlockRV> blocks = meta_schedule::BlockCollector::Collect(sch);
+          for (const tir::BlockRV& block : blocks) {
+            // A block the heuristics do not apply to is left as it was.
+            tir::Schedule backup = sch->Copy();
+            try {
+              ScheduleBlockForCPU(sch, block, cfg.value().get());
+            } catch (const tvm::runtime::Error& e) {
+              sch = backup;
+            }
+          }
+          updates.Set(gv, WithAttr(Downcast<tir::PrimFunc>(sch->mod()->Lookup(gv)),
+                                   attr::kIsScheduled, Integer(1)));
+        }
+        IRModuleNode* n = m.CopyOnWrite();
+        for (const auto& [gv, func] : updates) {
+          n->Update(gv, func);
+        }
+        return m;
+      };
+  return CreateModulePass(/*pass_function=*/pass_func,         //
+                          /*opt_level=*/0,                     //
+                          /*pass_name=*/"DefaultCPUSchedule",  //
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.DefaultCPUSchedule").set_body_typed(DefaultCPUSchedule);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
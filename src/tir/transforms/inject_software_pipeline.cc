@@ -993,8 +993,8 @@ void BuildDependencyGraph(
 
 class PipelineInjector : private StmtExprMutator {
  public:
-  static Stmt Inject(const PrimFunc& func, bool merge_async_commit_queue_scope) {
-    PipelineInjector injector(merge_async_commit_queue_scope);
+  static Stmt Inject(const PrimFunc& func, bool merge_async_commit_queue_scope, bool is_cpu) {
+    PipelineInjector injector(merge_async_commit_queue_scope, is_cpu);
     for (const auto& kv : func->buffer_map) {
       const Buffer& buffer = kv.second;
       injector.buffer_data_to_buffer_.Set(buffer->data, buffer);
@@ -1004,8 +1004,8 @@ class PipelineInjector : private StmtExprMutator {
   }
 
  private:
-  explicit PipelineInjector(bool merge_async_commit_queue_scope)
-      : merge_async_commit_queue_scope_(merge_async_commit_queue_scope) {}
+  explicit PipelineInjector(bool merge_async_commit_queue_scope, bool is_cpu)
+      : merge_async_commit_queue_scope_(merge_async_commit_queue_scope), is_cpu_(is_cpu) {}
 
   /*!
    * \brief Check the pipeline satisfies the following conditions:
@@ -1114,8 +1114,15 @@ class PipelineInjector : private StmtExprMutator {
 
     std::unordered_set<int> pipeline_async_stages;
     if (auto annot = op->annotations.Get(attr::software_pipeline_async_stages)) {
-      for (auto s : Downcast<Array<Integer>>(annot)) {
-        pipeline_async_stages.insert(s->value);
+      if (is_cpu_) {
+        // CPUs have no asynchronous copy engine, so producers are issued synchronously one
+        // iteration ahead of their consumers and only the multi-versioning of their buffers
+        // is kept.
+        DLOG(INFO) << "software_pipeline_async_stages is ignored on CPU targets";
+      } else {
+        for (auto s : Downcast<Array<Integer>>(annot)) {
+          pipeline_async_stages.insert(s->value);
+        }
       }
     }
 
@@ -1212,22 +1219,31 @@ class PipelineInjector : private StmtExprMutator {
   std::unordered_map<const VarNode*, FragmentInfo> fragment_info_;
   std::unordered_set<Buffer, ObjectPtrHash, ObjectPtrEqual> double_buffers;
   bool merge_async_commit_queue_scope_ = true;
+  /*! \brief Whether the function runs on a CPU, where async stages are lowered synchronously. */
+  bool is_cpu_ = false;
 };
 
 }  // namespace software_pipeline
 
 namespace transform {
 
+static bool IsCPUFunc(const PrimFunc& f) {
+  Optional<Target> target = GetLoweringTarget(f);
+  return target && target.value()->GetTargetDeviceType() == kDLCPU;
+}
+
 /*!
  * \brief Transform annotated loops into pipelined one that parallelize producers and consumers.
  * \return The IR transform pass.
  */
 Pass InjectSoftwarePipeline() {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    bool is_cpu = IsCPUFunc(f);
     auto* fptr = f.CopyOnWrite();
     bool merge_async_commit_queue_scope =
         ctx->GetConfig<Bool>("tir.merge_async_commit_queue_scope", Bool(true)).value();
-    fptr->body = software_pipeline::PipelineInjector::Inject(f, merge_async_commit_queue_scope);
+    fptr->body =
+        software_pipeline::PipelineInjector::Inject(f, merge_async_commit_queue_scope, is_cpu);
     fptr->body = ConvertSSA(std::move(fptr->body));
     return f;
   };
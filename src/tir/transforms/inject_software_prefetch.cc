@@ -0,0 +1,228 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_prefetch.cc
+ * \brief Insert software prefetches for strided reads in innermost CPU loops.
+ *
+ *  For every serial innermost loop, the region each iteration reads from a
+ *  buffer is computed with DomainTouched. When the region moves by at least
+ *  a cache line per iteration, prefetches for the region touched `distance`
+ *  iterations ahead are inserted at the start of the loop body. Small and
+ *  unit strides are left to the hardware prefetcher.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/bound.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_set>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+struct InjectSoftwarePrefetchConfigNode
+    : public tvm::AttrsNode<InjectSoftwarePrefetchConfigNode> {
+  int distance;
+  int cache_line_bytes;
+  int max_lines_per_access;
+
+  TVM_DECLARE_ATTRS(InjectSoftwarePrefetchConfigNode,
+                    "tir.transform.InjectSoftwarePrefetchConfig") {
+    TVM_ATTR_FIELD(distance)
+        .describe(
+            "Number of iterations to prefetch ahead in loops without a "
+            "pragma_prefetch_distance. 0 disables prefetching for those loops")
+        .set_default(0);
+    TVM_ATTR_FIELD(cache_line_bytes).describe("The cache line size in bytes").set_default(64);
+    TVM_ATTR_FIELD(max_lines_per_access)
+        .describe("The maximum number of cache lines prefetched per access and iteration")
+        .set_default(4);
+  }
+};
+
+class InjectSoftwarePrefetchConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(InjectSoftwarePrefetchConfig, Attrs,
+                                            InjectSoftwarePrefetchConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(InjectSoftwarePrefetchConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.InjectSoftwarePrefetch", InjectSoftwarePrefetchConfig);
+
+class SoftwarePrefetchInjector : public StmtMutator {
+ public:
+  SoftwarePrefetchInjector(bool enabled, int distance, int cache_line_bytes, int max_lines)
+      : enabled_(enabled),
+        distance_(distance),
+        cache_line_bytes_(cache_line_bytes),
+        max_lines_(max_lines) {}
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::pragma_prefetch_distance) {
+      int value = static_cast<int>(Downcast<Integer>(op->value)->value);
+      std::swap(value, distance_);
+      Stmt ret = this->VisitStmt(op->body);
+      std::swap(value, distance_);
+      return ret;
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const AllocateNode* op) final {
+    if (GetPtrStorageScope(op->buffer_var) != "global") {
+      non_global_.insert(op->buffer_var.get());
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    if (!enabled_ || distance_ <= 0 || op->kind != ForKind::kSerial || !IsInnermost(op->body)) {
+      return stmt;
+    }
+    if (const auto* extent = op->extent.as<IntImmNode>()) {
+      if (extent->value <= distance_) return stmt;
+    }
+    Array<Stmt> seq = MakePrefetches(op);
+    if (seq.empty()) return stmt;
+    seq.push_back(op->body);
+    auto n = CopyOnWrite(op);
+    n->body = SeqStmt(seq);
+    return For(n);
+  }
+
+ private:
+  // A loop is innermost if it only contains loops that are fully unrolled.
+  static bool IsInnermost(const Stmt& body) {
+    bool innermost = true;
+    PostOrderVisit(body, [&innermost](const ObjectRef& obj) {
+      if (const auto* loop = obj.as<ForNode>()) {
+        innermost = innermost && loop->kind == ForKind::kUnrolled;
+      }
+    });
+    return innermost;
+  }
+
+  Array<Stmt> MakePrefetches(const ForNode* loop) {
+    std::vector<Buffer> buffers;
+    std::unordered_set<const BufferNode*> visited;
+    std::unordered_set<const VarNode*> local_vars;
+    PostOrderVisit(loop->body, [&](const ObjectRef& obj) {
+      if (const auto* load = obj.as<BufferLoadNode>()) {
+        if (visited.insert(load->buffer.get()).second) buffers.push_back(load->buffer);
+      } else if (const auto* let = obj.as<LetStmtNode>()) {
+        local_vars.insert(let->var.get());
+      } else if (const auto* let = obj.as<LetNode>()) {
+        local_vars.insert(let->var.get());
+      } else if (const auto* inner = obj.as<ForNode>()) {
+        local_vars.insert(inner->loop_var.get());
+      } else if (const auto* alloc = obj.as<AllocateNode>()) {
+        local_vars.insert(alloc->buffer_var.get());
+      }
+    });
+    auto f_is_local = [&local_vars](const VarNode* var) { return local_vars.count(var) != 0; };
+
+    Array<Stmt> seq;
+    for (const Buffer& buffer : buffers) {
+      const VarNode* data = buffer->data.get();
+      int64_t elem_bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+      if (buffer->shape.size() != 1 || non_global_.count(data) || local_vars.count(data) ||
+          elem_bytes == 0) {
+        continue;
+      }
+      Region region = arith::DomainTouched(loop->body, buffer, true, false);
+      if (region.size() != 1 || !region[0].defined()) continue;
+      PrimExpr min = analyzer_.Simplify(region[0]->min);
+      const auto* extent = analyzer_.Simplify(region[0]->extent).as<IntImmNode>();
+      if (extent == nullptr || extent->value <= 0 || UsesVar(min, f_is_local)) continue;
+      Array<PrimExpr> coeffs = arith::DetectLinearEquation(min, {loop->loop_var});
+      if (coeffs.size() != 2) continue;
+      const auto* stride = coeffs[0].as<IntImmNode>();
+      if (stride == nullptr || std::abs(stride->value) * elem_bytes < cache_line_bytes_) continue;
+
+      int64_t line_elems = std::max<int64_t>(cache_line_bytes_ / elem_bytes, 1);
+      std::vector<int64_t> offsets;
+      for (int64_t offset = 0; offset < extent->value; offset += line_elems) {
+        offsets.push_back(offset);
+      }
+      if ((extent->value - 1) % line_elems != 0) offsets.push_back(extent->value - 1);
+      if (static_cast<int64_t>(offsets.size()) > max_lines_) continue;
+
+      // Clamp to the last iteration so the address stays inside the buffer.
+      DataType dtype = loop->loop_var.dtype();
+      PrimExpr ahead = tvm::min(loop->loop_var + make_const(dtype, distance_),
+                                loop->min + loop->extent - make_const(dtype, 1));
+      PrimExpr base = Substitute(min, {{loop->loop_var, ahead}});
+      for (int64_t offset : offsets) {
+        BufferLoad load(buffer, {base + make_const(base.dtype(), offset)});
+        PrimExpr address = Call(DataType::Handle(), builtin::address_of(), {load});
+        seq.push_back(Evaluate(Call(DataType::Int(32), builtin::prefetch(), {address, 0, 3, 1})));
+      }
+    }
+    return seq;
+  }
+
+  bool enabled_;
+  int distance_;
+  int cache_line_bytes_;
+  int max_lines_;
+  arith::Analyzer analyzer_;
+  std::unordered_set<const VarNode*> non_global_;
+};
+
+namespace transform {
+
+// The prefetch intrinsic is only lowered by the LLVM CPU backend.
+static bool SupportsSoftwarePrefetch(const PrimFunc& f) {
+  Optional<Target> target = GetLoweringTarget(f);
+  return target && target.value()->kind->name == "llvm";
+}
+
+Pass InjectSoftwarePrefetch() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<InjectSoftwarePrefetchConfig>("tir.InjectSoftwarePrefetch");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<InjectSoftwarePrefetchConfig>();
+    }
+    auto* n = f.CopyOnWrite();
+    n->body = SoftwarePrefetchInjector(SupportsSoftwarePrefetch(f), cfg.value()->distance,
+                                       cfg.value()->cache_line_bytes,
+                                       cfg.value()->max_lines_per_access)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePrefetch", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSoftwarePrefetch").set_body_typed(InjectSoftwarePrefetch);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
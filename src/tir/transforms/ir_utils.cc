@@ -325,6 +325,12 @@ Bool IsFromLegacyTESchedule(PrimFunc f) {
   return from_legacy_te_schedule.value();
 }
 
+Optional<Target> GetLoweringTarget(const PrimFunc& f) {
+  Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+  if (!target) target = Target::Current(true);
+  return target;
+}
+
 Map<Var, Range> ConditionalBoundsContext::GetVarBoundsFromCondition() {
   // extract equations and related vars from condition expression.
   // currently only extract simple integral equations which could be solvable.
@@ -27,6 +27,7 @@
 #include <tvm/arith/int_set.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/support/with.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/function.h>
@@ -234,6 +235,18 @@ Region ConvertRegion(const MatchBufferRegion& match_buffer, const Region& region
  */
 Bool IsFromLegacyTESchedule(PrimFunc f);
 
+/*!
+ * \brief Get the target a PrimFunc is lowered for.
+ *
+ * The target attribute of the function is bound late in the pipeline, so the
+ * lowering passes fall back to the current target, which the build driver
+ * enters while lowering.
+ *
+ * \param f The PrimFunc being lowered.
+ * \return The target of the function, or NullOpt if it is unknown.
+ */
+Optional<Target> GetLoweringTarget(const PrimFunc& f);
+
 /*!
  *\brief Context helper to update domain map within conditional scope.
  *
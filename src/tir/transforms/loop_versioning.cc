@@ -0,0 +1,332 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file loop_versioning.cc
+ * \brief Clone annotated loop nests into a fast version, specialized
+ *  under conditions checked at runtime, and a general fallback.
+ *
+ *  For a loop annotated with `loop_versioning = factor`:
+ *
+ *  - Symbolic variables of the function that appear in guard conditions
+ *    or in divided loop extents are assumed to be multiples of `factor`,
+ *    so the guards produced by non-divisible splits fold away.
+ *  - Symbolic element offsets of the accessed buffers are assumed to be
+ *    multiples of `factor`, so vector accesses are aligned.
+ *  - Unless the function is already marked noalias, the buffers written
+ *    by the nest are assumed not to overlap with the other buffers it
+ *    accesses.
+ *
+ *  \code
+ *
+ *  if (likely(n % 8 == 0 && offset % 8 == 0 && !overlap(A, B))) {
+ *    // loop nest with n, offset replaced by n // 8 * 8, offset // 8 * 8
+ *  } else {
+ *    // original loop nest
+ *  }
+ *
+ *  \endcode
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/int_set.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief Collect what a loop nest needs to be specialized. */
+class VersioningInfoCollector : public StmtExprVisitor {
+ public:
+  VersioningInfoCollector(const std::unordered_set<const VarNode*>& symbolic_vars,
+                          const std::unordered_set<const VarNode*>& offset_vars)
+      : symbolic_vars_(symbolic_vars), offset_vars_(offset_vars) {}
+
+  /*! \brief Variables to be specialized to multiples of the factor. */
+  std::vector<Var> spec_vars;
+  /*! \brief Data variables accessed by the nest, in visit order. */
+  std::vector<Var> accessed;
+  /*! \brief Data variables written by the nest. */
+  std::unordered_set<const VarNode*> written;
+
+ private:
+  void VisitStmt_(const ForNode* op) final {
+    bool has_div = false;
+    PostOrderVisit(op->extent, [&has_div](const ObjectRef& obj) {
+      if (obj->IsInstance<FloorDivNode>() || obj->IsInstance<DivNode>() ||
+          obj->IsInstance<FloorModNode>() || obj->IsInstance<ModNode>()) {
+        has_div = true;
+      }
+    });
+    if (has_div) AddSymbolicVars(op->extent, symbolic_vars_);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const IfThenElseNode* op) final {
+    AddSymbolicVars(op->condition, symbolic_vars_);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::if_then_else()) || op->op.same_as(builtin::likely())) {
+      AddSymbolicVars(op->args[0], symbolic_vars_);
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    AddAccess(op->buffer->data);
+    for (const PrimExpr& index : op->indices) AddSymbolicVars(index, offset_vars_);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    AddAccess(op->buffer->data);
+    written.insert(op->buffer->data.get());
+    for (const PrimExpr& index : op->indices) AddSymbolicVars(index, offset_vars_);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void AddSymbolicVars(const PrimExpr& expr, const std::unordered_set<const VarNode*>& candidates) {
+    PostOrderVisit(expr, [&](const ObjectRef& obj) {
+      if (const VarNode* var = obj.as<VarNode>()) {
+        if (candidates.count(var) && visited_vars_.insert(var).second) {
+          spec_vars.push_back(GetRef<Var>(var));
+        }
+      }
+    });
+  }
+
+  void AddAccess(const Var& data) {
+    if (visited_buffers_.insert(data.get()).second) accessed.push_back(data);
+  }
+
+  const std::unordered_set<const VarNode*>& symbolic_vars_;
+  const std::unordered_set<const VarNode*>& offset_vars_;
+  std::unordered_set<const VarNode*> visited_vars_;
+  std::unordered_set<const VarNode*> visited_buffers_;
+};
+
+/*!
+ * \brief Remove the guards of the fast version that the specialization
+ *  makes redundant, by bounding them over the symbolic loop ranges.
+ */
+class GuardEliminator : public StmtExprMutator {
+ public:
+  Stmt VisitStmt_(const ForNode* op) final {
+    PrimExpr extent = analyzer_.Simplify(op->extent);
+    dom_map_.Set(op->loop_var, arith::IntSet::FromMinExtent(op->min, extent));
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    dom_map_.erase(op->loop_var);
+    return stmt;
+  }
+
+  Stmt VisitStmt_(const IfThenElseNode* op) final {
+    if (Provable(op->condition)) return this->VisitStmt(op->then_case);
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  PrimExpr VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::likely()) && Provable(op->args[0])) {
+      return make_const(op->dtype, true);
+    } else if (op->op.same_as(builtin::if_then_else()) && Provable(op->args[0])) {
+      return this->VisitExpr(op->args[1]);
+    }
+    return StmtExprMutator::VisitExpr_(op);
+  }
+
+ private:
+  bool Provable(const PrimExpr& cond) {
+    if (const CallNode* op = cond.as<CallNode>()) {
+      if (op->op.same_as(builtin::likely())) return Provable(op->args[0]);
+    } else if (const AndNode* op = cond.as<AndNode>()) {
+      return Provable(op->a) && Provable(op->b);
+    } else if (const LTNode* op = cond.as<LTNode>()) {
+      return UpperBoundBelowZero(op->a - op->b, true);
+    } else if (const LENode* op = cond.as<LENode>()) {
+      return UpperBoundBelowZero(op->a - op->b, false);
+    } else if (const GTNode* op = cond.as<GTNode>()) {
+      return UpperBoundBelowZero(op->b - op->a, true);
+    } else if (const GENode* op = cond.as<GENode>()) {
+      return UpperBoundBelowZero(op->b - op->a, false);
+    }
+    return false;
+  }
+
+  bool UpperBoundBelowZero(const PrimExpr& diff, bool strict) {
+    if (!diff.dtype().is_int() && !diff.dtype().is_uint()) return false;
+    arith::IntSet set = arith::EvalSet(analyzer_.Simplify(diff), dom_map_);
+    if (!set.HasUpperBound()) return false;
+    PrimExpr max = analyzer_.Simplify(set.max());
+    PrimExpr zero = make_zero(max.dtype());
+    return analyzer_.CanProve(strict ? max < zero : max <= zero);
+  }
+
+  arith::Analyzer analyzer_;
+  Map<Var, arith::IntSet> dom_map_;
+};
+
+class LoopVersioner : public StmtExprMutator {
+ public:
+  explicit LoopVersioner(const PrimFunc& f) : check_alias_(!f->HasNonzeroAttr(attr::kNoAlias)) {
+    auto add_var = [this](const PrimExpr& expr) {
+      if (const VarNode* var = expr.as<VarNode>()) symbolic_vars_.insert(var);
+    };
+    for (const Var& param : f->params) {
+      if (param.dtype().is_int() || param.dtype().is_uint()) symbolic_vars_.insert(param.get());
+    }
+    for (const auto& kv : f->buffer_map) {
+      const Buffer& buffer = kv.second;
+      param_buffers_[buffer->data.get()] = buffer;
+      for (const PrimExpr& dim : buffer->shape) add_var(dim);
+      for (const PrimExpr& stride : buffer->strides) add_var(stride);
+      if (const VarNode* offset = buffer->elem_offset.as<VarNode>()) offset_vars_.insert(offset);
+    }
+    PostOrderVisit(f->body, [this](const ObjectRef& obj) {
+      if (const AllocateNode* op = obj.as<AllocateNode>()) {
+        allocated_.insert(op->buffer_var.get());
+      } else if (const AllocateConstNode* op = obj.as<AllocateConstNode>()) {
+        allocated_.insert(op->buffer_var.get());
+      }
+    });
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    auto it = op->annotations.find(attr::loop_versioning);
+    if (it == op->annotations.end()) return stmt;
+
+    const auto* factor = (*it).second.as<IntImmNode>();
+    CHECK(factor && factor->value > 0)
+        << "ValueError: The " << attr::loop_versioning
+        << " annotation expects a positive integer factor, but got " << (*it).second;
+    For general = GetRef<For>(op);
+    general.CopyOnWrite()->annotations.erase(attr::loop_versioning);
+    return Version(general, factor->value);
+  }
+
+ private:
+  Stmt Version(const For& loop, int64_t factor) {
+    VersioningInfoCollector info(symbolic_vars_, offset_vars_);
+    info(loop);
+
+    PrimExpr condition;
+    auto add_condition = [&condition](PrimExpr cond) {
+      condition = condition.defined() ? (condition && cond) : cond;
+    };
+
+    Map<Var, PrimExpr> vmap;
+    if (factor > 1) {
+      for (const Var& var : info.spec_vars) {
+        PrimExpr f = make_const(var.dtype(), factor);
+        add_condition(floormod(var, f) == make_zero(var.dtype()));
+        vmap.Set(var, floordiv(var, f) * f);
+      }
+    }
+    Stmt fast = GuardEliminator()(Substitute(loop, vmap));
+
+    if (check_alias_ && !info.written.empty() && info.accessed.size() > 1) {
+      bool all_known = true;
+      for (const Var& data : info.accessed) {
+        all_known = all_known && (param_buffers_.count(data.get()) || allocated_.count(data.get()));
+      }
+      // Local allocations never overlap the parameters, only the
+      // parameter buffers need a runtime check.
+      std::vector<Buffer> params;
+      for (const Var& data : info.accessed) {
+        auto it = param_buffers_.find(data.get());
+        if (it != param_buffers_.end()) params.push_back(it->second);
+      }
+      if (all_known && params.size() > 1) {
+        for (size_t i = 0; i < params.size(); ++i) {
+          for (size_t j = i + 1; j < params.size(); ++j) {
+            if (info.written.count(params[i]->data.get()) ||
+                info.written.count(params[j]->data.get())) {
+              add_condition(Disjoint(params[i], params[j]));
+            }
+          }
+        }
+        for (auto it = params.rbegin(); it != params.rend(); ++it) {
+          fast = AttrStmt((*it)->data, attr::buffer_noalias, Integer(1), fast);
+        }
+      }
+    }
+
+    if (!condition.defined()) return std::move(loop);
+    PrimExpr predicate = Call(DataType::Bool(), builtin::likely(), {condition});
+    return IfThenElse(predicate, fast, loop);
+  }
+
+  // The byte range [begin, end) covered by a parameter buffer.
+  static std::pair<PrimExpr, PrimExpr> ByteRange(const Buffer& buffer) {
+    DataType dtype = DataType::UInt(64);
+    PrimExpr extent = make_const(dtype, 1);
+    if (buffer->strides.empty()) {
+      for (const PrimExpr& dim : buffer->shape) extent = extent * cast(dtype, dim);
+    } else {
+      for (size_t i = 0; i < buffer->shape.size(); ++i) {
+        extent = extent + (cast(dtype, buffer->shape[i]) - make_const(dtype, 1)) *
+                              cast(dtype, buffer->strides[i]);
+      }
+    }
+    PrimExpr bytes = make_const(dtype, buffer->dtype.bytes() * buffer->dtype.lanes());
+    PrimExpr begin = cast(dtype, buffer->data) + cast(dtype, buffer->elem_offset) * bytes;
+    return {begin, begin + extent * bytes};
+  }
+
+  static PrimExpr Disjoint(const Buffer& a, const Buffer& b) {
+    auto [a_begin, a_end] = ByteRange(a);
+    auto [b_begin, b_end] = ByteRange(b);
+    return a_end <= b_begin || b_end <= a_begin;
+  }
+
+  bool check_alias_;
+  std::unordered_set<const VarNode*> symbolic_vars_;
+  std::unordered_set<const VarNode*> offset_vars_;
+  std::unordered_set<const VarNode*> allocated_;
+  std::unordered_map<const VarNode*, Buffer> param_buffers_;
+};
+
+namespace transform {
+
+Pass LoopVersioning() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* n = f.CopyOnWrite();
+    n->body = LoopVersioner(f)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.LoopVersioning", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.LoopVersioning").set_body_typed(LoopVersioning);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -23,13 +23,28 @@
 // Insert profile intrinsic at loop and function level. During codegen,
 // these instruction can be replaced with a call to a target specific handler
 // and can be used to capture profiling information such as processor cycles.
+//
+// The loop count mode instead inserts calls to TVMBackendProfileLoop and
+// TVMBackendProfileBranch which record trip counts and branch outcomes.  The
+// recorded profile is consumed by ApplyLoopProfile on a later build to drive
+// unrolling and loop partitioning.
 
+#include <dmlc/json.h>
+#include <tvm/ir/attrs.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
 #include <tvm/tir/stmt.h>
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace tvm {
 namespace tir {
 namespace lwp {
@@ -246,6 +261,219 @@ PrimFunc AddProfileBuiltins(PrimFunc func, int32_t max_instr_depth, int32_t min_
   return func;
 }
 
+/*!
+ * \brief Number the loops and conditionals that can carry loop count calls.
+ *
+ *  Sites are numbered in pre-order.  The instrumented build and the build that
+ *  consumes the profile run the same passes up to this point, so an index names
+ *  the same site in both.  Bodies of vectorized loops and of device thread
+ *  scopes are not numbered, as no host call can be placed there.
+ */
+class ProfileSiteNumbering : public StmtVisitor {
+ public:
+  std::unordered_map<const ForNode*, int32_t> loops;
+  std::unordered_map<const IfThenElseNode*, int32_t> branches;
+
+  static ProfileSiteNumbering Number(const Stmt& body) {
+    ProfileSiteNumbering numbering;
+    numbering(body);
+    return numbering;
+  }
+
+ private:
+  void VisitStmt_(const ForNode* op) final {
+    if (op->kind == ForKind::kThreadBinding) return;
+    int32_t id = static_cast<int32_t>(loops.size());
+    loops[op] = id;
+    if (op->kind != ForKind::kVectorized) {
+      StmtVisitor::VisitStmt_(op);
+    }
+  }
+
+  void VisitStmt_(const IfThenElseNode* op) final {
+    int32_t id = static_cast<int32_t>(branches.size());
+    branches[op] = id;
+    StmtVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) return;
+    StmtVisitor::VisitStmt_(op);
+  }
+};
+
+/*! \brief Whether the function runs on a CPU, where the count calls can be placed. */
+bool IsHostFunc(const PrimFunc& func) {
+  auto target = func->GetAttr<Target>(tvm::attr::kTarget);
+  if (!target.defined()) return true;
+  String kind = target.value()->kind->name;
+  return kind == "llvm" || kind == "c";
+}
+
+class LoopCountInstrumenter : public StmtMutator {
+ public:
+  LoopCountInstrumenter(String func_name, const Stmt& body)
+      : func_name_(func_name), sites_(ProfileSiteNumbering::Number(body)) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    auto it = sites_.loops.find(op);
+    if (it == sites_.loops.end()) return GetRef<Stmt>(op);
+    Stmt stmt = op->kind == ForKind::kVectorized ? GetRef<Stmt>(op) : StmtMutator::VisitStmt_(op);
+    PrimExpr trip_count = cast(DataType::Int(64), op->extent);
+    return SeqStmt({CountCall("TVMBackendProfileLoop", it->second, trip_count), stmt});
+  }
+
+  Stmt VisitStmt_(const IfThenElseNode* op) final {
+    int32_t id = sites_.branches.at(op);
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    return SeqStmt(
+        {CountCall("TVMBackendProfileBranch", id, cast(DataType::Int(32), op->condition)), stmt});
+  }
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) {
+      return GetRef<Stmt>(op);
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
+ private:
+  Stmt CountCall(const char* handler, int32_t id, PrimExpr value) {
+    return Evaluate(Call(DataType::Int(32), builtin::call_extern(),
+                         {StringImm(handler), StringImm(func_name_), IntImm(DataType::Int(32), id),
+                          value}));
+  }
+
+  String func_name_;
+  ProfileSiteNumbering sites_;
+};
+
+struct ApplyLoopProfileConfigNode : public tvm::AttrsNode<ApplyLoopProfileConfigNode> {
+  String profile;
+  int unroll_max_extent;
+  double hot_fraction;
+  double likely_ratio;
+
+  TVM_DECLARE_ATTRS(ApplyLoopProfileConfigNode, "tir.transform.ApplyLoopProfileConfig") {
+    TVM_ATTR_FIELD(profile)
+        .describe("Path of the loop profile recorded with tir.instrument_loop_counts")
+        .set_default("");
+    TVM_ATTR_FIELD(unroll_max_extent)
+        .describe("The maximum constant extent of a hot innermost loop to be unrolled.")
+        .set_default(16);
+    TVM_ATTR_FIELD(hot_fraction)
+        .describe("Fraction of the hottest loop's trips above which a loop is considered hot.")
+        .set_default(0.1);
+    TVM_ATTR_FIELD(likely_ratio)
+        .describe("Ratio of one branch outcome above which the condition is marked as likely.")
+        .set_default(0.95);
+  }
+};
+
+class ApplyLoopProfileConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(ApplyLoopProfileConfig, Attrs,
+                                            ApplyLoopProfileConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(ApplyLoopProfileConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.ApplyLoopProfile", ApplyLoopProfileConfig);
+
+// site kind -> [[id, entries or evaluations, trips or taken]]
+using FuncLoopProfile = std::map<std::string, std::vector<std::vector<int64_t>>>;
+// func name -> {"loops": [...], "branches": [...]}
+using LoopProfile = std::map<std::string, FuncLoopProfile>;
+
+LoopProfile LoadLoopProfile(const std::string& path) {
+  std::ifstream is(path);
+  CHECK(is) << "ValueError: Cannot open loop profile " << path;
+  LoopProfile profile;
+  dmlc::JSONReader reader(&is);
+  reader.Read(&profile);
+  return profile;
+}
+
+class LoopProfileApplier : public StmtMutator {
+ public:
+  using SiteCounts = std::unordered_map<int32_t, std::pair<int64_t, int64_t>>;
+
+  LoopProfileApplier(const Stmt& body, const FuncLoopProfile& counts,
+                     const ApplyLoopProfileConfig& cfg)
+      : sites_(ProfileSiteNumbering::Number(body)), cfg_(cfg) {
+    auto read = [&counts](const std::string& key, SiteCounts* out) {
+      auto it = counts.find(key);
+      if (it == counts.end()) return;
+      for (const std::vector<int64_t>& row : it->second) {
+        CHECK_EQ(row.size(), 3U) << "ValueError: Malformed loop profile entry";
+        (*out)[static_cast<int32_t>(row[0])] = {row[1], row[2]};
+      }
+    };
+    read("loops", &loop_counts_);
+    read("branches", &branch_counts_);
+    for (const auto& kv : loop_counts_) {
+      max_trips_ = std::max(max_trips_, kv.second.second);
+    }
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    auto site = sites_.loops.find(op);
+    if (site == sites_.loops.end() || op->kind != ForKind::kSerial) return stmt;
+    auto it = loop_counts_.find(site->second);
+    if (it == loop_counts_.end()) {
+      // Never entered while profiling, keep it rolled to save code size.
+      return AttrStmt(op->loop_var, attr::pragma_auto_unroll_max_step,
+                      IntImm(DataType::Int(32), 0), stmt);
+    }
+    const auto* extent = op->extent.as<IntImmNode>();
+    bool is_hot = it->second.second >= cfg_->hot_fraction * max_trips_;
+    if (is_hot && extent && extent->value <= cfg_->unroll_max_extent && !HasLoop(op->body)) {
+      For loop = Downcast<For>(stmt);
+      loop.CopyOnWrite()->kind = ForKind::kUnrolled;
+      return std::move(loop);
+    }
+    return stmt;
+  }
+
+  Stmt VisitStmt_(const IfThenElseNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    auto site = sites_.branches.find(op);
+    if (site == sites_.branches.end()) return stmt;
+    auto it = branch_counts_.find(site->second);
+    if (it == branch_counts_.end() || IsLikely(op->condition)) return stmt;
+    // Likely conditions let LoopPartition split the enclosing loop at the branch.
+    double taken_ratio = static_cast<double>(it->second.second) / it->second.first;
+    IfThenElse branch = Downcast<IfThenElse>(stmt);
+    if (taken_ratio >= cfg_->likely_ratio) {
+      branch.CopyOnWrite()->condition = likely(op->condition);
+    } else if (taken_ratio <= 1.0 - cfg_->likely_ratio && op->else_case.defined()) {
+      branch = IfThenElse(likely(!op->condition), branch->else_case.value(), branch->then_case,
+                          op->span);
+    }
+    return std::move(branch);
+  }
+
+ private:
+  static bool HasLoop(const Stmt& stmt) {
+    bool has_loop = false;
+    PostOrderVisit(stmt, [&has_loop](const ObjectRef& node) {
+      if (node->IsInstance<ForNode>()) has_loop = true;
+    });
+    return has_loop;
+  }
+
+  static bool IsLikely(const PrimExpr& cond) {
+    const auto* call = cond.as<CallNode>();
+    return call && call->op.same_as(builtin::likely());
+  }
+
+  ProfileSiteNumbering sites_;
+  ApplyLoopProfileConfig cfg_;
+  SiteCounts loop_counts_;
+  SiteCounts branch_counts_;
+  int64_t max_trips_{0};
+};
+
 }  // namespace lwp
 
 namespace transform {
@@ -287,6 +515,60 @@ Pass InstrumentProfileIntrinsics() {
 TVM_REGISTER_GLOBAL("tir.transform.InstrumentProfileIntrinsics")
     .set_body_typed(InstrumentProfileIntrinsics);
 
+Pass InstrumentLoopCounts() {
+  auto pass_func = [](IRModule m, PassContext ctx) {
+    auto* mptr = m.CopyOnWrite();
+    std::vector<std::pair<GlobalVar, PrimFunc>> updates;
+    for (const auto& kv : mptr->functions) {
+      if (auto* n = kv.second.as<PrimFuncNode>()) {
+        PrimFunc func = GetRef<PrimFunc>(n);
+        if (!lwp::IsHostFunc(func)) continue;
+        lwp::LoopCountInstrumenter instrumenter(kv.first->name_hint, func->body);
+        func.CopyOnWrite()->body = instrumenter(func->body);
+        updates.push_back({kv.first, func});
+      }
+    }
+    for (const auto& pair : updates) {
+      mptr->AddUnchecked(pair.first, pair.second);
+    }
+    return m;
+  };
+  return tvm::transform::CreateModulePass(pass_func, 0, "tir.InstrumentLoopCounts", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InstrumentLoopCounts").set_body_typed(InstrumentLoopCounts);
+
+Pass ApplyLoopProfile() {
+  auto pass_func = [](IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<lwp::ApplyLoopProfileConfig>("tir.ApplyLoopProfile");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<lwp::ApplyLoopProfileConfig>();
+    }
+    if (cfg.value()->profile.empty()) return m;
+    lwp::LoopProfile profile = lwp::LoadLoopProfile(cfg.value()->profile);
+
+    auto* mptr = m.CopyOnWrite();
+    std::vector<std::pair<GlobalVar, PrimFunc>> updates;
+    for (const auto& kv : mptr->functions) {
+      auto* n = kv.second.as<PrimFuncNode>();
+      auto it = profile.find(kv.first->name_hint);
+      // Functions that never ran while profiling are left to the static heuristics.
+      if (n == nullptr || it == profile.end()) continue;
+      PrimFunc func = GetRef<PrimFunc>(n);
+      lwp::LoopProfileApplier applier(func->body, it->second, cfg.value());
+      func.CopyOnWrite()->body = applier(func->body);
+      updates.push_back({kv.first, func});
+    }
+    for (const auto& pair : updates) {
+      mptr->AddUnchecked(pair.first, pair.second);
+    }
+    return m;
+  };
+  return tvm::transform::CreateModulePass(pass_func, 0, "tir.ApplyLoopProfile", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.ApplyLoopProfile").set_body_typed(ApplyLoopProfile);
+
 }  // namespace transform
 
 }  // namespace tir
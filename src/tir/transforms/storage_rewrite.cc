@@ -24,6 +24,7 @@
  */
 #include <tvm/arith/analyzer.h>
 #include <tvm/ir/type.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/target/target_info.h>
 #include <tvm/tir/analysis.h>
@@ -1670,6 +1671,81 @@ PrimFunc PointerValueTypeRewrite(PrimFunc f, bool allow_untyped_pointers = false
   return f;
 }
 
+/*!
+ * \brief Place the global allocations made at function scope into the
+ *  workspace parameter of the function, see attr::kWorkspaceParam.
+ *
+ *  Allocations small enough to live on the stack, and those under a loop
+ *  or a thread launch, are left as they are. So is any allocation that
+ *  does not fit in the remaining workspace.
+ */
+class WorkspaceHoister : public StmtMutator {
+ public:
+  static PrimFunc Hoist(PrimFunc f) {
+    Optional<Integer> index = f->GetAttr<Integer>(attr::kWorkspaceParam);
+    if (!index) return f;
+    ICHECK_LT(index.value()->value, f->params.size())
+        << "ValueError: The workspace parameter index " << index.value()
+        << " is out of range for a function with " << f->params.size() << " parameters";
+    Optional<Buffer> workspace = f->buffer_map.Get(f->params[index.value()->value]);
+    ICHECK(workspace) << "ValueError: The workspace parameter must be bound to a buffer";
+    const Buffer& buf = workspace.value();
+    const auto* capacity = buf->shape.size() == 1 ? buf->shape[0].as<IntImmNode>() : nullptr;
+    ICHECK(capacity && buf->dtype == DataType::UInt(8))
+        << "ValueError: The workspace must be a 1-d uint8 buffer of constant size, but got "
+        << buf->dtype << " buffer of shape " << buf->shape;
+    WorkspaceHoister hoister(buf, capacity->value);
+    auto* n = f.CopyOnWrite();
+    n->body = hoister(std::move(n->body));
+    return f;
+  }
+
+ private:
+  WorkspaceHoister(Buffer workspace, int64_t capacity)
+      : workspace_(workspace), capacity_(capacity) {}
+
+  Stmt VisitStmt_(const AllocateNode* op) final {
+    Stmt body = this->VisitStmt(op->body);
+    int64_t bytes = op->ConstantAllocationSize() * ((op->dtype.bits() * op->dtype.lanes() + 7) / 8);
+    StorageScope scope = StorageScope::Create(GetPtrStorageScope(op->buffer_var));
+    if (scope.rank == StorageRank::kGlobal && is_one(op->condition) &&
+        bytes > runtime::kMaxStackAlloca) {
+      int64_t offset = (used_ + runtime::kAllocAlignment - 1) / runtime::kAllocAlignment *
+                       runtime::kAllocAlignment;
+      if (offset + bytes <= capacity_) {
+        used_ = offset + bytes;
+        PrimExpr index = make_const(workspace_->shape[0].dtype(), offset);
+        PrimExpr address =
+            Call(DataType::Handle(), builtin::address_of(), {BufferLoad(workspace_, {index})});
+        return LetStmt(op->buffer_var, address, body);
+      }
+    }
+    if (body.same_as(op->body)) return GetRef<Stmt>(op);
+    auto n = CopyOnWrite(op);
+    n->body = std::move(body);
+    return Stmt(n);
+  }
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) {
+      return GetRef<Stmt>(op);
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  // Allocations below these are not live for the whole call.
+  Stmt VisitStmt_(const ForNode* op) final { return GetRef<Stmt>(op); }
+  Stmt VisitStmt_(const WhileNode* op) final { return GetRef<Stmt>(op); }
+  Stmt VisitStmt_(const IfThenElseNode* op) final { return GetRef<Stmt>(op); }
+
+  /*! \brief The workspace buffer. */
+  Buffer workspace_;
+  /*! \brief The size of the workspace in bytes. */
+  int64_t capacity_;
+  /*! \brief The number of bytes of the workspace in use. */
+  int64_t used_{0};
+};
+
 namespace transform {
 
 Pass StorageRewrite() {
@@ -1682,7 +1758,8 @@ Pass StorageRewrite() {
     // padded out to 32 bits) would require either rewriting
     // AllocateConst::data, or would require the code generators to
     // handle vectorized constants.
-    return PointerValueTypeRewrite(std::move(f), true, false, false, true, true, true, false);
+    f = PointerValueTypeRewrite(std::move(f), true, false, false, true, true, true, false);
+    return WorkspaceHoister::Hoist(std::move(f));
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.StorageRewrite", {});
 }
@@ -23,6 +23,7 @@
 // Loop vectorizer as in Halide pipeline.
 #include <tvm/arith/analyzer.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
@@ -31,10 +32,14 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <functional>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "ir_utils.h"
+
 namespace tvm {
 namespace tir {
 
@@ -149,6 +154,59 @@ class VecAllocAccess : public StmtExprMutator {
   arith::Analyzer analyzer_;
 };
 
+// Replace the vector loads of an already vectorized expression by
+// masked loads, so that lanes disabled by the mask never touch memory.
+// Loads that cannot be masked (vector element types, or loads whose
+// lane count differs from the mask) make the rewrite fail.
+class MaskedLoadRewriter : public ExprMutator {
+ public:
+  explicit MaskedLoadRewriter(PrimExpr mask) : mask_(mask) {}
+
+  Optional<PrimExpr> Rewrite(const PrimExpr& expr) {
+    PrimExpr ret = this->VisitExpr(expr);
+    if (failed_) return NullOpt;
+    return ret;
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    auto load = Downcast<BufferLoad>(ExprMutator::VisitExpr_(op));
+    if (load->dtype.lanes() == 1) return std::move(load);
+    if (!IsMaskableAccess(load->buffer, load->indices, mask_.dtype().lanes())) {
+      failed_ = true;
+      return std::move(load);
+    }
+    PrimExpr addr = Call(DataType::Handle(), builtin::address_of(), {load});
+    return Call(load->dtype, builtin::masked_load(), {addr, mask_, make_zero(load->dtype)});
+  }
+
+  PrimExpr VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::address_of())) {
+      // Taking the address does not access memory.
+      return GetRef<PrimExpr>(op);
+    } else if (op->op.same_as(builtin::masked_load())) {
+      // A load masked by an inner condition must also respect the outer one.
+      return Call(op->dtype, op->op, {op->args[0], mask_ && op->args[1], op->args[2]});
+    }
+    return ExprMutator::VisitExpr_(op);
+  }
+
+  // A masked access is either contiguous (a unit-stride ramp) or a
+  // gather/scatter through one index per lane. The LLVM backend emits every
+  // other access accepted here as a gather/scatter, which LLVM scalarizes
+  // into guarded scalar accesses on targets without native support.
+  static bool IsMaskableAccess(const Buffer& buffer, const Array<PrimExpr>& indices, int lanes) {
+    if (buffer->dtype.lanes() != 1 || buffer->dtype.bits() < 8) return false;
+    for (size_t i = 0; i + 1 < indices.size(); ++i) {
+      if (indices[i].dtype().lanes() != 1) return false;
+    }
+    return indices[indices.size() - 1].dtype().lanes() == lanes;
+  }
+
+ private:
+  PrimExpr mask_;
+  bool failed_{false};
+};
+
 // We use ExprFunctor directly instead of StmtExprMutator
 // This is because the transformation can change the dtype of the Expr
 // The existing ExprMutator transformation rules may not be well defined.
@@ -157,10 +215,31 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  Vectorizer(Var var, int var_lanes) : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool enable_predication, bool enable_vector_reduce)
+      : var_(var),
+        var_lanes_(var_lanes),
+        enable_predication_(enable_predication),
+        enable_vector_reduce_(enable_vector_reduce) {
     ramp_ = Ramp(IntImm(var->dtype, 0), IntImm(var->dtype, 1), var_lanes);
   }
 
+  /*! \brief Vectorize the body of the loop over var. */
+  Stmt Vectorize(const Stmt& body) {
+    PostOrderVisit(body, [this](const ObjectRef& obj) {
+      if (const auto* load = obj.as<BufferLoadNode>()) {
+        buffer_accesses_[load->buffer->data.get()].push_back(load->indices);
+      } else if (const auto* store = obj.as<BufferStoreNode>()) {
+        buffer_accesses_[store->buffer->data.get()].push_back(store->indices);
+      } else if (const auto* var = obj.as<VarNode>()) {
+        // The data pointer itself, e.g. in tvm_access_ptr, may access any element.
+        buffer_accesses_[var].push_back(NullOpt);
+      }
+    });
+    Stmt ret = this->operator()(body);
+    // An accumulator observed elsewhere in the loop requires the serial order of its updates.
+    return scalarize_loop_ ? Scalarize(body) : ret;
+  }
+
   Stmt VisitStmt(const Stmt& stmt) final {
     ICHECK(!need_scalarize_);
     Stmt ret = StmtMutator::VisitStmt(stmt);
@@ -304,6 +383,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr MutateIfThenElseExpr_(const CallNode* op) {
     PrimExpr cond = this->VisitExpr(op->args[0]);
     if (cond.dtype().is_vector()) {
+      if (enable_predication_ && !need_scalarize_) {
+        if (Optional<PrimExpr> ret = PredicateIfThenElseExpr(op)) return ret.value();
+      }
       need_scalarize_ = true;
       return GetRef<PrimExpr>(op);
     }
@@ -425,6 +507,10 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     auto fmutate = [this](const PrimExpr& index) { return this->VisitExpr(index); };
     Array<PrimExpr> indices = op->indices.Map(fmutate);
 
+    if (!need_scalarize_) {
+      if (Optional<Stmt> ret = VectorizeReduction(op, indices)) return ret.value();
+    }
+
     PrimExpr value = this->VisitExpr(op->value);
 
     if (!indices.same_as(op->indices) || !value.same_as(op->value)) {
@@ -483,6 +569,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     ICHECK(!op->condition.dtype().is_vector());
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
+      if (enable_predication_ && !need_scalarize_) {
+        if (Optional<Stmt> ret = PredicateIfThenElse(op, NullOpt)) return ret.value();
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -557,6 +646,88 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     return Allocate(op->buffer_var, op->dtype, extents, condition, body);
   }
 
+  // Rewrite `acc = acc op value` where acc does not depend on the vectorized
+  // variable into `acc = acc op vector_reduce_op(value)` for op in +, max, min.
+  // Without vector reductions such updates are scalarized.
+  Optional<Stmt> VectorizeReduction(const BufferStoreNode* op, const Array<PrimExpr>& indices) {
+    if (op->buffer->dtype.lanes() != 1) return NullOpt;
+    for (const PrimExpr& index : indices) {
+      if (index.dtype().is_vector()) return NullOpt;
+    }
+    PrimExpr a, b;
+    Op reduce;
+    std::function<PrimExpr(PrimExpr, PrimExpr)> combine;
+    if (const auto* add = op->value.as<AddNode>()) {
+      std::tie(a, b, reduce) = std::make_tuple(add->a, add->b, builtin::vector_reduce_sum());
+      combine = [](PrimExpr x, PrimExpr y) { return x + y; };
+    } else if (const auto* max = op->value.as<MaxNode>()) {
+      std::tie(a, b, reduce) = std::make_tuple(max->a, max->b, builtin::vector_reduce_max());
+      combine = [](PrimExpr x, PrimExpr y) { return Max(x, y); };
+    } else if (const auto* min = op->value.as<MinNode>()) {
+      std::tie(a, b, reduce) = std::make_tuple(min->a, min->b, builtin::vector_reduce_min());
+      combine = [](PrimExpr x, PrimExpr y) { return Min(x, y); };
+    } else {
+      return NullOpt;
+    }
+    auto f_is_acc = [&](const PrimExpr& e) {
+      const auto* load = e.as<BufferLoadNode>();
+      if (load == nullptr || !load->buffer->data.same_as(op->buffer->data) ||
+          load->indices.size() != op->indices.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < op->indices.size(); ++i) {
+        if (!deep_equal_(load->indices[i], op->indices[i])) return false;
+      }
+      return true;
+    };
+    PrimExpr update;
+    if (f_is_acc(a)) {
+      update = b;
+    } else if (f_is_acc(b)) {
+      update = a;
+    } else {
+      return NullOpt;
+    }
+    if (!IsOnlyAccess(op)) {
+      scalarize_loop_ = true;
+      return NullOpt;
+    }
+    PrimExpr vec = this->VisitExpr(update);
+    if (need_scalarize_ || !vec.dtype().is_vector()) return NullOpt;
+    if (!enable_vector_reduce_) {
+      need_scalarize_ = true;
+      return GetRef<Stmt>(op);
+    }
+    PrimExpr acc = BufferLoad(op->buffer, indices);
+    PrimExpr reduced = Call(vec.dtype().element_of(), reduce, {vec});
+    return BufferStore(op->buffer, combine(acc, reduced), indices);
+  }
+
+  // Whether the load and the store of an accumulator update are the only accesses to the
+  // accumulated element in the loop. Any other access would observe the partial results
+  // of the scalar loop.
+  bool IsOnlyAccess(const BufferStoreNode* op) {
+    auto it = buffer_accesses_.find(op->buffer->data.get());
+    if (it == buffer_accesses_.end()) return false;
+    int same = 0;
+    for (const Optional<Array<PrimExpr>>& indices : it->second) {
+      if (!indices || indices.value().size() != op->indices.size()) return false;
+      bool equal = true, disjoint = false;
+      for (size_t i = 0; i < op->indices.size(); ++i) {
+        const PrimExpr& index = indices.value()[i];
+        equal = equal && deep_equal_(index, op->indices[i]);
+        disjoint = disjoint || (index.dtype() == op->indices[i].dtype() &&
+                                analyzer_.CanProve(index != op->indices[i]));
+      }
+      if (equal) {
+        ++same;
+      } else if (!disjoint) {
+        return false;
+      }
+    }
+    return same == 2;
+  }
+
   // scalarize the statment
   Stmt Scalarize(Stmt stmt) {
     Var idx(var_->name_hint + ".s", var_->dtype);
@@ -583,11 +754,147 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr ramp_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
+  // flag to mark that the whole loop has to stay serial.
+  bool scalarize_loop_{false};
+  // whether guarded bodies may be lowered to masked loads and stores.
+  bool enable_predication_;
+  // whether updates of a loop-invariant element may use vector_reduce_* builtins.
+  bool enable_vector_reduce_;
   // Let binding
   std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> let_binding_;
+  // the indices of the loads and stores of each buffer in the loop body, NullOpt for
+  // other uses of its data variable.
+  std::unordered_map<const VarNode*, std::vector<Optional<Array<PrimExpr>>>> buffer_accesses_;
   // vectorizable property
   OpAttrMap<TVectorizable> op_vectorizable_ = Op::GetAttrMap<TVectorizable>("TVectorizable");
 
+  // Split a condition into the conjuncts that stay scalar and the ones
+  // that become vectors after vectorization.  Returns false if any
+  // conjunct requires scalarization.
+  bool SplitCondition(PrimExpr cond, PrimExpr* scalar_cond, PrimExpr* vector_cond) {
+    if (const CallNode* call = cond.as<CallNode>()) {
+      if (call->op.same_as(builtin::likely())) cond = call->args[0];
+    }
+    if (const AndNode* op = cond.as<AndNode>()) {
+      return SplitCondition(op->a, scalar_cond, vector_cond) &&
+             SplitCondition(op->b, scalar_cond, vector_cond);
+    }
+    PrimExpr value = this->VisitExpr(cond);
+    if (need_scalarize_) return false;
+    PrimExpr* target = value.dtype().is_vector() ? vector_cond : scalar_cond;
+    *target = target->defined() ? (*target && value) : value;
+    return true;
+  }
+
+  // Lower an IfThenElse whose condition depends on the vectorized
+  // variable into masked stores.  The scalar part of the condition is
+  // kept as a branch.  `mask` is the predicate of the enclosing
+  // guards, if any.  Returns NullOpt if the body cannot be predicated.
+  Optional<Stmt> PredicateIfThenElse(const IfThenElseNode* op, Optional<PrimExpr> mask) {
+    PrimExpr scalar_cond, vector_cond;
+    if (!SplitCondition(op->condition, &scalar_cond, &vector_cond)) {
+      need_scalarize_ = false;
+      return NullOpt;
+    }
+    if (!vector_cond.defined()) {
+      ICHECK(mask.defined());
+      Optional<Stmt> then_case = PredicateStmt(op->then_case, mask.value());
+      Optional<Stmt> else_case = NullOpt;
+      if (op->else_case) {
+        else_case = PredicateStmt(op->else_case.value(), mask.value());
+        if (!else_case) return NullOpt;
+      }
+      if (!then_case) return NullOpt;
+      return IfThenElse(scalar_cond, then_case.value(), else_case);
+    }
+    if (vector_cond.dtype().lanes() != var_lanes_) return NullOpt;
+
+    PrimExpr then_mask = mask ? (mask.value() && vector_cond) : vector_cond;
+    Optional<Stmt> then_case = PredicateStmt(op->then_case, then_mask);
+    if (!then_case) return NullOpt;
+    Stmt body = then_case.value();
+    Optional<Stmt> else_case = NullOpt;
+    if (op->else_case) {
+      PrimExpr else_mask = mask ? (mask.value() && !vector_cond) : !vector_cond;
+      Optional<Stmt> masked_else = PredicateStmt(op->else_case.value(), else_mask);
+      if (!masked_else) return NullOpt;
+      body = SeqStmt({body, masked_else.value()});
+      if (scalar_cond.defined()) {
+        // All lanes take the else branch when the scalar part fails.
+        else_case = mask ? PredicateStmt(op->else_case.value(), mask.value())
+                         : Optional<Stmt>(this->VisitStmt(op->else_case.value()));
+        if (!else_case) return NullOpt;
+      }
+    }
+    if (scalar_cond.defined()) {
+      return IfThenElse(scalar_cond, body, else_case);
+    }
+    return body;
+  }
+
+  // Rewrite a statement executed under the vector predicate `mask`.
+  Optional<Stmt> PredicateStmt(const Stmt& stmt, const PrimExpr& mask) {
+    if (const SeqStmtNode* op = stmt.as<SeqStmtNode>()) {
+      Array<Stmt> seq;
+      for (const Stmt& s : op->seq) {
+        Optional<Stmt> ret = PredicateStmt(s, mask);
+        if (!ret) return NullOpt;
+        seq.push_back(ret.value());
+      }
+      return SeqStmt(seq);
+    } else if (const IfThenElseNode* op = stmt.as<IfThenElseNode>()) {
+      return PredicateIfThenElse(op, mask);
+    } else if (const BufferStoreNode* op = stmt.as<BufferStoreNode>()) {
+      Stmt ret = this->VisitStmt_(op);
+      if (need_scalarize_) {
+        need_scalarize_ = false;
+        return NullOpt;
+      }
+      const BufferStoreNode* store = ret.as<BufferStoreNode>();
+      int lanes = mask.dtype().lanes();
+      if (!store || store->value.dtype().lanes() != lanes ||
+          !MaskedLoadRewriter::IsMaskableAccess(store->buffer, store->indices, lanes)) {
+        return NullOpt;
+      }
+      MaskedLoadRewriter rewriter(mask);
+      Optional<PrimExpr> value = rewriter.Rewrite(store->value);
+      if (!value) return NullOpt;
+      // The indices of a scatter may themselves be loaded.
+      Array<PrimExpr> indices;
+      for (const PrimExpr& index : store->indices) {
+        Optional<PrimExpr> masked_index = rewriter.Rewrite(index);
+        if (!masked_index) return NullOpt;
+        indices.push_back(masked_index.value());
+      }
+      BufferLoad dst(store->buffer, indices);
+      PrimExpr addr = Call(DataType::Handle(), builtin::address_of(), {dst});
+      return Evaluate(Call(DataType::Void(), builtin::masked_store(), {addr, value.value(), mask}));
+    }
+    return NullOpt;
+  }
+
+  // Lower an if_then_else expression whose condition depends on the
+  // vectorized variable into a select over masked loads.
+  Optional<PrimExpr> PredicateIfThenElseExpr(const CallNode* op) {
+    PrimExpr scalar_cond, vector_cond;
+    if (!SplitCondition(op->args[0], &scalar_cond, &vector_cond)) return NullOpt;
+    PrimExpr t = this->VisitExpr(op->args[1]);
+    PrimExpr f = this->VisitExpr(op->args[2]);
+    if (need_scalarize_ || !vector_cond.defined()) return NullOpt;
+    int lanes = vector_cond.dtype().lanes();
+    if (t.dtype().lanes() > lanes || f.dtype().lanes() > lanes) return NullOpt;
+    t = BroadcastTo(t, lanes);
+    f = BroadcastTo(f, lanes);
+    Optional<PrimExpr> masked_t = MaskedLoadRewriter(vector_cond).Rewrite(t);
+    Optional<PrimExpr> masked_f = MaskedLoadRewriter(!vector_cond).Rewrite(f);
+    if (!masked_t || !masked_f) return NullOpt;
+    PrimExpr ret = Select(vector_cond, masked_t.value(), masked_f.value());
+    if (scalar_cond.defined()) {
+      ret = Call(ret.dtype(), builtin::if_then_else(), {scalar_cond, ret, f});
+    }
+    return ret;
+  }
+
   // mutate array, with given lane requirement
   // when finished, p_lane updates the lane requirement.
   Array<PrimExpr> MutateArray(Array<PrimExpr> arr, int* p_lanes) {
@@ -650,6 +957,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(bool enable_predication = false, bool enable_vector_reduce = false)
+      : enable_predication_(enable_predication), enable_vector_reduce_(enable_vector_reduce) {}
+
   Stmt VisitStmt_(const ForNode* op) final {
     if (op->kind == ForKind::kVectorized) {
       ICHECK(is_zero(op->min));
@@ -657,11 +967,17 @@ class LoopVectorizer : public StmtMutator {
       if (!extent_as_int || extent_as_int->value < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value))(op->body);
+      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value),
+                        enable_predication_, enable_vector_reduce_)
+          .Vectorize(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  bool enable_predication_;
+  bool enable_vector_reduce_;
 };
 
 Stmt VectorizeLoop(Stmt stmt) { return LoopVectorizer()(std::move(stmt)); }
@@ -683,12 +999,20 @@ Stmt SkipVectorize(Stmt stmt) { return VectorizeSkipper()(std::move(stmt)); }
 
 namespace transform {
 
+// Masked loads and stores and the vector reductions are only lowered by the
+// LLVM backend; other targets keep scalarizing guarded bodies and reductions.
+static bool IsLLVMFunc(const PrimFunc& f) {
+  Optional<Target> target = GetLoweringTarget(f);
+  return target && target.value()->kind->name == "llvm";
+}
+
 // TODO(tvm-team): Make it as a target property.
 Pass VectorizeLoop(bool enable_vectorize) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    bool is_llvm = IsLLVMFunc(f);
     auto* n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = LoopVectorizer()(std::move(n->body));
+      n->body = LoopVectorizer(is_llvm, is_llvm)(std::move(n->body));
     } else {
       n->body = VectorizeSkipper()(std::move(n->body));
     }
@@ -21,6 +21,8 @@
 #include <gtest/gtest.h>
 #include <tvm/runtime/ndarray.h>
 
+#include <vector>
+
 using namespace tvm;
 
 TEST(NDArrayTest, IsContiguous_ContiguousStride) {
@@ -71,3 +73,51 @@ TEST(NDArrayTest, IsContiguous_UncontiguousStride) {
   managed_tensor->dl_tensor.strides = nullptr;
   managed_tensor->deleter(managed_tensor);
 }
+
+TEST(NDArrayTest, CreateStridedView) {
+  auto array = runtime::NDArray::Empty({4, 6}, DataType::Float(32), {kDLCPU});
+  float* data = static_cast<float*>(array->data);
+  for (int i = 0; i < 24; ++i) data[i] = i;
+
+  // Rows 1 and 3, columns 1, 3 and 5.
+  auto view = array.CreateStridedView({2, 3}, {12, 2}, 7 * sizeof(float));
+  ICHECK_EQ(view->data, array->data);
+  ICHECK_EQ(view->byte_offset, 7 * sizeof(float));
+  ICHECK(!runtime::IsContiguous(*view.operator->()));
+
+  std::vector<float> out(6);
+  view.CopyToBytes(out.data(), out.size() * sizeof(float));
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      ICHECK_EQ(out[i * 3 + j], data[(1 + 2 * i) * 6 + 1 + 2 * j]);
+    }
+  }
+
+  // The strides survive the conversion to DLPack.
+  DLManagedTensor* managed_tensor = view.ToDLPack();
+  ICHECK_EQ(managed_tensor->dl_tensor.strides[0], 12);
+  ICHECK_EQ(managed_tensor->dl_tensor.strides[1], 2);
+  managed_tensor->deleter(managed_tensor);
+}
+
+TEST(NDArrayTest, CopyIntoStridedView) {
+  auto array = runtime::NDArray::Empty({3, 4}, DataType::Float(32), {kDLCPU});
+  float* data = static_cast<float*>(array->data);
+  for (int i = 0; i < 12; ++i) data[i] = 0;
+
+  // The transpose of the first two columns.
+  auto view = array.CreateStridedView({2, 3}, {1, 4});
+  std::vector<float> values = {1, 2, 3, 4, 5, 6};
+  view.CopyFromBytes(values.data(), values.size() * sizeof(float));
+  for (int i = 0; i < 3; ++i) {
+    ICHECK_EQ(data[i * 4], values[i]);
+    ICHECK_EQ(data[i * 4 + 1], values[3 + i]);
+    ICHECK_EQ(data[i * 4 + 2], 0);
+  }
+}
+
+TEST(NDArrayTest, CreateStridedView_OutOfRange) {
+  auto array = runtime::NDArray::Empty({4, 6}, DataType::Float(32), {kDLCPU});
+  EXPECT_THROW(array.CreateStridedView({4, 6}, {6, 1}, sizeof(float)), runtime::Error);
+  EXPECT_THROW(array.CreateStridedView({4, 6}, {6}), runtime::Error);
+}
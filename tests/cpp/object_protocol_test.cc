@@ -22,6 +22,9 @@
 #include <tvm/runtime/memory.h>
 #include <tvm/runtime/object.h>
 
+#include <thread>
+#include <vector>
+
 namespace tvm {
 namespace test {
 
@@ -59,10 +62,20 @@ class ObjAA : public ObjA {
   TVM_DECLARE_FINAL_OBJECT_INFO(ObjAA, ObjA);
 };
 
+class ObjPooled : public Object {
+ public:
+  int64_t values[4];
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "test.ObjPooled";
+  static constexpr bool _type_pooled_alloc = true;
+  TVM_DECLARE_FINAL_OBJECT_INFO(ObjPooled, Object);
+};
+
 TVM_REGISTER_OBJECT_TYPE(ObjBase);
 TVM_REGISTER_OBJECT_TYPE(ObjA);
 TVM_REGISTER_OBJECT_TYPE(ObjB);
 TVM_REGISTER_OBJECT_TYPE(ObjAA);
+TVM_REGISTER_OBJECT_TYPE(ObjPooled);
 
 }  // namespace test
 }  // namespace tvm
@@ -95,3 +108,36 @@ TEST(ObjectHierachy, Basic) {
   ICHECK(refB.as<ObjAA>() == nullptr);
   ICHECK(refB.as<ObjB>() != nullptr);
 }
+
+TEST(ObjectAllocator, Pooled) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+
+  ObjectRef ref(PooledObjAllocator().make_object<ObjPooled>());
+  ICHECK_EQ(ref->type_index(), ObjPooled::RuntimeTypeIndex());
+  ICHECK(ref.as<ObjPooled>() != nullptr);
+  // objects may be released by a different thread than the one that created them.
+  std::vector<std::vector<ObjectRef>> created(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < created.size(); ++t) {
+    threads.emplace_back([&created, t]() {
+      for (int i = 0; i < 10000; ++i) {
+        auto ptr = PooledObjAllocator().make_object<ObjPooled>();
+        ptr->values[0] = i;
+        created[t].push_back(ObjectRef(ptr));
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  threads.clear();
+  for (size_t t = 0; t < created.size(); ++t) {
+    threads.emplace_back([&created, t]() {
+      auto& refs = created[(t + 1) % created.size()];
+      for (size_t i = 0; i < refs.size(); ++i) {
+        ICHECK_EQ(refs[i].as<ObjPooled>()->values[0], static_cast<int64_t>(i));
+      }
+      refs.clear();
+    });
+  }
+  for (auto& t : threads) t.join();
+}
@@ -19,11 +19,17 @@
 
 #include <dmlc/logging.h>
 #include <gtest/gtest.h>
+#include <tvm/runtime/module.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/transform.h>
 
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 TEST(PackedFunc, Basic) {
   using namespace tvm;
   using namespace tvm::tir;
@@ -319,3 +325,77 @@ TEST(TypedPackedFunc, RValue) {
     tf(1, true);
   }
 }
+
+TEST(Registry, ConcurrentLookup) {
+  using namespace tvm::runtime;
+  const std::string prefix = "testing.registry_concurrent_lookup.";
+  Registry::Register(prefix + "0").set_body_typed([]() { return 0; });
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&]() {
+      while (!stop.load()) {
+        const PackedFunc* f = Registry::Get(prefix + "0");
+        ICHECK(f != nullptr);
+        ICHECK_EQ(static_cast<int>((*f)()), 0);
+      }
+    });
+  }
+  // registrations interleaved with the lookups are visible to the readers afterwards.
+  for (int i = 1; i < 64; ++i) {
+    Registry::Register(prefix + std::to_string(i)).set_body_typed([i]() { return i; });
+    const PackedFunc* f = Registry::Get(prefix + std::to_string(i));
+    ICHECK(f != nullptr);
+    ICHECK_EQ(static_cast<int>((*f)()), i);
+  }
+  stop = true;
+  for (auto& t : readers) t.join();
+  for (int i = 0; i < 64; ++i) {
+    ICHECK(Registry::Remove(prefix + std::to_string(i)));
+    ICHECK(Registry::Get(prefix + std::to_string(i)) == nullptr);
+  }
+}
+
+namespace {
+// Provides the functions f0 ... f{n-1}, returning their index.
+class IndexedFuncModuleNode : public tvm::runtime::ModuleNode {
+ public:
+  explicit IndexedFuncModuleNode(int n) : n_(n) {}
+  const char* type_key() const final { return "testing.indexed_func"; }
+  tvm::runtime::PackedFunc GetFunction(
+      const std::string& name, const tvm::runtime::ObjectPtr<tvm::runtime::Object>&) final {
+    if (name.size() < 2 || name[0] != 'f') return tvm::runtime::PackedFunc();
+    int index = std::stoi(name.substr(1));
+    if (index >= n_) return tvm::runtime::PackedFunc();
+    return tvm::runtime::TypedPackedFunc<int()>([index]() { return index; });
+  }
+
+ private:
+  int n_;
+};
+}  // namespace
+
+TEST(Module, GetFuncFromEnvConcurrent) {
+  using namespace tvm::runtime;
+  auto host = make_object<IndexedFuncModuleNode>(0);
+  host->Import(Module(make_object<IndexedFuncModuleNode>(512)));
+  std::vector<std::thread> callers;
+  for (int t = 0; t < 4; ++t) {
+    callers.emplace_back([&host, t]() {
+      for (int k = 0; k < 4096; ++k) {
+        int index = (k * 7 + t) % 400;
+        const PackedFunc* f = host->GetFuncFromEnv("f" + std::to_string(index));
+        ICHECK_EQ(static_cast<int>((*f)()), index);
+      }
+    });
+  }
+  for (auto& t : callers) t.join();
+
+  // Pointers handed out stay valid after the imports are cleared, and the functions of a module
+  // imported afterwards are found.
+  const PackedFunc* f3 = host->GetFuncFromEnv("f3");
+  host->ClearImports();
+  ICHECK_EQ(static_cast<int>((*f3)()), 3);
+  host->Import(Module(make_object<IndexedFuncModuleNode>(1024)));
+  ICHECK_EQ(static_cast<int>((*host->GetFuncFromEnv("f700"))()), 700);
+}
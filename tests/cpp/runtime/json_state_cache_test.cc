@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../../../src/runtime/contrib/json/json_state_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+namespace tvm {
+namespace runtime {
+namespace json {
+namespace {
+
+using Cache = ShapeStateCache<int64_t>;
+
+Cache::FBuild BuildBatch(int* num_builds) {
+  return [num_builds](const ShapeKey& key) {
+    ++*num_builds;
+    return std::make_shared<int64_t>(key[0][0]);
+  };
+}
+
+TEST(JSONStateCache, HitsAndEvictsLeastRecentlyUsed) {
+  Cache cache(2);
+  int num_builds = 0;
+  auto build = BuildBatch(&num_builds);
+  EXPECT_EQ(*cache.GetOrBuild({{1, 16}}, build), 1);
+  EXPECT_EQ(*cache.GetOrBuild({{2, 16}}, build), 2);
+  EXPECT_EQ(*cache.GetOrBuild({{1, 16}}, build), 1);
+  // Evicts batch 2, batch 1 was used more recently.
+  EXPECT_EQ(*cache.GetOrBuild({{3, 16}}, build), 3);
+  EXPECT_EQ(*cache.GetOrBuild({{1, 16}}, build), 1);
+  EXPECT_EQ(num_builds, 3);
+  EXPECT_EQ(*cache.GetOrBuild({{2, 16}}, build), 2);
+  EXPECT_EQ(num_builds, 4);
+
+  ShapeTuple stats = cache.Stats();
+  ASSERT_EQ(stats.size(), 5U);
+  EXPECT_EQ(stats[0], 6);  // lookups
+  EXPECT_EQ(stats[1], 2);  // hits
+  EXPECT_EQ(stats[2], 4);  // builds
+  EXPECT_EQ(stats[3], 2);  // evictions
+  EXPECT_EQ(stats[4], 2);  // size
+}
+
+TEST(JSONStateCache, BucketsSelectedAxes) {
+  EXPECT_EQ(DynamicAxes({{-1, 16}, {3}}), BucketAxes({{0}, {}}));
+  Cache cache(4, DynamicAxes({{-1, 16}, {3}}));
+  int num_builds = 0;
+  auto build = BuildBatch(&num_builds);
+  // Only the dynamic batch axis is rounded up.
+  EXPECT_EQ(cache.MakeKey({{5, 15}, {3}}), ShapeKey({{8, 15}, {3}}));
+  // Batch sizes 5 to 8 share the state built for the padded batch of 8.
+  for (int64_t batch = 5; batch <= 8; ++batch) {
+    EXPECT_EQ(*cache.GetOrBuild({{batch, 16}, {3}}, build), 8);
+  }
+  EXPECT_EQ(num_builds, 1);
+  EXPECT_EQ(cache.Stats()[1], 3);
+}
+
+TEST(JSONStateCache, BuildsOutsideTheLock) {
+  Cache cache(4);
+  std::promise<void> slow_started;
+  std::promise<void> other_built;
+  std::atomic<int> num_builds{0};
+  // The build of batch 1 only finishes after batch 2 was built meanwhile.
+  auto slow = std::async(std::launch::async, [&]() {
+    return *cache.GetOrBuild({{1}}, [&](const ShapeKey& key) {
+      ++num_builds;
+      slow_started.set_value();
+      auto status = other_built.get_future().wait_for(std::chrono::seconds(30));
+      EXPECT_EQ(status, std::future_status::ready);
+      return std::make_shared<int64_t>(key[0][0]);
+    });
+  });
+  slow_started.get_future().wait();
+  EXPECT_EQ(*cache.GetOrBuild({{2}}, [&](const ShapeKey& key) {
+    ++num_builds;
+    return std::make_shared<int64_t>(key[0][0]);
+  }),
+            2);
+  other_built.set_value();
+  EXPECT_EQ(slow.get(), 1);
+  // Batch 1 is built once and cached.
+  EXPECT_EQ(*cache.GetOrBuild({{1}}, [](const ShapeKey& key) -> Cache::StatePtr {
+    ADD_FAILURE() << "Rebuilt a cached state";
+    return nullptr;
+  }),
+            1);
+  EXPECT_EQ(num_builds, 2);
+}
+
+TEST(JSONStateCache, FailedBuildIsNotCached) {
+  Cache cache(4);
+  int num_builds = 0;
+  auto build = BuildBatch(&num_builds);
+  EXPECT_THROW(cache.GetOrBuild({{1}},
+                                [](const ShapeKey& key) -> Cache::StatePtr {
+                                  throw std::runtime_error("unsupported shape");
+                                }),
+               std::runtime_error);
+  EXPECT_EQ(cache.Stats()[4], 0);
+  EXPECT_EQ(*cache.GetOrBuild({{1}}, build), 1);
+  EXPECT_EQ(num_builds, 1);
+}
+
+TEST(JSONStateCache, EvictedStateOutlivesCache) {
+  Cache cache(1);
+  int num_builds = 0;
+  auto build = BuildBatch(&num_builds);
+  auto state = cache.GetOrBuild({{1}}, build);
+  cache.GetOrBuild({{2}}, build);
+  EXPECT_EQ(*state, 1);
+  cache.Clear();
+  EXPECT_EQ(cache.Stats()[4], 0);
+}
+
+}  // namespace
+}  // namespace json
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../../../src/runtime/workspace_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+/*! \brief A host memory device counting its allocations. */
+class CountingDeviceAPI : public DeviceAPI {
+ public:
+  void SetDevice(Device dev) final {}
+  void GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) final {}
+  void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
+    ++num_allocs;
+    return ::operator new(nbytes);
+  }
+  void FreeDataSpace(Device dev, void* ptr) final {
+    ++num_frees;
+    ::operator delete(ptr);
+  }
+  void StreamSync(Device dev, TVMStreamHandle stream) final {}
+
+  std::atomic<int> num_allocs{0};
+  std::atomic<int> num_frees{0};
+};
+
+// Every test uses its own device id, so that they do not share a backing pool.
+Device TestDevice(int device_id, DLDeviceType device_type = kDLExtDev) {
+  return Device{device_type, device_id};
+}
+
+TEST(WorkspacePool, ReuseSizeClass) {
+  CountingDeviceAPI api;
+  WorkspacePool pool(kDLExtDev, &api);
+  Device dev = TestDevice(0);
+
+  void* a = pool.AllocWorkspace(dev, 5000);
+  pool.FreeWorkspace(dev, a);
+  // A smaller request of the same size class reuses the entry.
+  void* b = pool.AllocWorkspace(dev, 4097);
+  EXPECT_EQ(a, b);
+  // A larger request does not free the cached entry.
+  void* c = pool.AllocWorkspace(dev, 1 << 20);
+  pool.FreeWorkspace(dev, c);
+  pool.FreeWorkspace(dev, b);
+  EXPECT_EQ(api.num_allocs, 2);
+  EXPECT_EQ(api.num_frees, 0);
+
+  WorkspacePoolStats stats = WorkspacePool::GetStats(dev);
+  EXPECT_EQ(stats.num_allocs, 3);
+  EXPECT_EQ(stats.num_thread_hits, 1);
+  EXPECT_EQ(stats.num_shared_hits, 0);
+  EXPECT_EQ(stats.reserved_bytes, 8192 + (1 << 20));
+  EXPECT_EQ(stats.peak_reserved_bytes, 8192 + (1 << 20));
+}
+
+TEST(WorkspacePool, FreeOutOfOrder) {
+  CountingDeviceAPI api;
+  WorkspacePool pool(kDLExtDev, &api);
+  Device dev = TestDevice(1);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 4; ++i) {
+    ptrs.push_back(pool.AllocWorkspace(dev, 4096));
+  }
+  for (int i : {1, 3, 0, 2}) {
+    pool.FreeWorkspace(dev, ptrs[i]);
+  }
+  for (int i = 0; i < 4; ++i) {
+    pool.AllocWorkspace(dev, 4096);
+  }
+  EXPECT_EQ(api.num_allocs, 4);
+  EXPECT_ANY_THROW(pool.FreeWorkspace(dev, &api));
+}
+
+TEST(WorkspacePool, ShareAcrossThreads) {
+  CountingDeviceAPI api;
+  // Far from the ids of the CPU devices the other runtime tests use.
+  Device dev = TestDevice(1002, kDLCPU);
+  // Entries of an exiting thread go to the shared pool, and are taken by the next thread.
+  for (int i = 0; i < 4; ++i) {
+    std::thread([&]() {
+      WorkspacePool pool(kDLCPU, &api);
+      void* a = pool.AllocWorkspace(dev, 64 << 10);
+      void* b = pool.AllocWorkspace(dev, 64 << 10);
+      pool.FreeWorkspace(dev, b);
+      pool.FreeWorkspace(dev, a);
+    }).join();
+  }
+  EXPECT_EQ(api.num_allocs, 2);
+
+  WorkspacePoolStats stats = WorkspacePool::GetStats(dev);
+  EXPECT_EQ(stats.num_allocs, 8);
+  EXPECT_EQ(stats.num_shared_hits, 6);
+  EXPECT_EQ(stats.peak_reserved_bytes, 2 * (64 << 10));
+}
+
+TEST(WorkspacePool, NoSharingOffCPU) {
+  CountingDeviceAPI api;
+  Device dev = TestDevice(3);
+  // Kernels may still use an entry on the stream of the thread that freed it, so entries
+  // of other devices are released when the thread exits rather than shared.
+  for (int i = 0; i < 4; ++i) {
+    std::thread([&]() {
+      WorkspacePool pool(kDLExtDev, &api);
+      void* a = pool.AllocWorkspace(dev, 64 << 10);
+      pool.FreeWorkspace(dev, a);
+    }).join();
+  }
+  EXPECT_EQ(api.num_allocs, 4);
+  EXPECT_EQ(api.num_frees, 4);
+
+  WorkspacePoolStats stats = WorkspacePool::GetStats(dev);
+  EXPECT_EQ(stats.num_shared_hits, 0);
+  EXPECT_EQ(stats.reserved_bytes, 0);
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
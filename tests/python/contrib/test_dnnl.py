@@ -831,6 +831,22 @@ def test_conv2d_bias_sum_relu(run_module, dtype="float32"):
     run_and_verify_func(config, run_module=run_module, dtype=dtype)
 
 
+def test_inter_op_parallel_branches(run_module, monkeypatch, dtype="float32"):
+    # Independent conv2d branches run concurrently on separate DNNL streams.
+    monkeypatch.setenv("TVM_DNNL_INTER_OP_STREAMS", "2")
+    x_shape = (1, 32, 8, 8)
+    k_shape = (16, 32, 3, 3)
+    x = relay.var("x", shape=x_shape, dtype=dtype)
+    kernel0 = relay.var("kernel0", shape=k_shape, dtype=dtype)
+    kernel1 = relay.var("kernel1", shape=k_shape, dtype=dtype)
+    branch0 = relay.nn.relu(relay.nn.conv2d(x, kernel0, kernel_size=(3, 3), channels=16))
+    branch1 = relay.nn.relu(relay.nn.conv2d(x, kernel1, kernel_size=(3, 3), channels=16))
+    out = relay.add(branch0, branch1)
+    dic = {"x": x_shape, "kernel0": k_shape, "kernel1": k_shape}
+    config = tvm.IRModule.from_expr(out), dic, ["kernel0", "kernel1"]
+    run_and_verify_func(config, run_module=run_module, dtype=dtype, test_bf16=False)
+
+
 def test_dense_bias_sum(run_module, dtype="float32"):
     x_shape = (4, 32)
     k_shape = (16, 32)
@@ -0,0 +1,130 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import os
+import sys
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.relax.distributed import ShardedExecutor
+from tvm.script.parser import ir as I
+from tvm.script.parser import relax as R
+from tvm.script.parser import tir as T
+
+pytestmark = pytest.mark.skipif(
+    not sys.platform.startswith("linux"), reason="shared memory collectives need POSIX shm"
+)
+
+
+@I.ir_module
+class ShardedMLP:
+    I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+    @T.prim_func
+    def matmul(var_A: T.handle, var_B: T.handle, var_C: T.handle):
+        m, k, n = T.int64(), T.int64(), T.int64()
+        A = T.match_buffer(var_A, (m, k), "float32")
+        B = T.match_buffer(var_B, (k, n), "float32")
+        C = T.match_buffer(var_C, (m, n), "float32")
+        for i, j, r in T.grid(m, n, k):
+            with T.block("matmul"):
+                vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                with T.init():
+                    C[vi, vj] = T.float32(0)
+                C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+    @R.function
+    def mlp(
+        x: R.DTensor((4, 8), "float32", "mesh[0]", "R"),
+        w1: R.DTensor((8, 16), "float32", "mesh[0]", "S[1]"),
+        w2: R.DTensor((16, 8), "float32", "mesh[0]", "S[0]"),
+    ) -> R.DTensor((4, 8), "float32", "mesh[0]", "R"):
+        cls = ShardedMLP
+        h = R.dist.call_tir(cls.matmul, (x, w1), R.DTensor((4, 16), "float32", "mesh[0]", "S[1]"))
+        partial = R.dist.call_tir(
+            cls.matmul, (h, w2), R.DTensor((4, 8), "float32", "mesh[0]", "R")
+        )
+        out = R.dist.allreduce(partial)
+        return out
+
+    @R.function
+    def column_parallel(
+        x: R.DTensor((4, 8), "float32", "mesh[0]", "R"),
+        w: R.DTensor((8, 16), "float32", "mesh[0]", "S[1]"),
+    ) -> R.Tuple(
+        R.DTensor((4, 16), "float32", "mesh[0]", "R"),
+        R.DTensor((4, 16), "float32", "mesh[0]", "S[1]"),
+    ):
+        cls = ShardedMLP
+        h = R.dist.call_tir(cls.matmul, (x, w), R.DTensor((4, 16), "float32", "mesh[0]", "S[1]"))
+        gathered = R.dist.redistribute(h, "mesh[0]", "R")
+        return (gathered, h)
+
+
+@tvm.testing.requires_llvm
+def test_sharded_executor():
+    x = np.random.rand(4, 8).astype("float32")
+    w1 = np.random.rand(8, 16).astype("float32")
+    w2 = np.random.rand(16, 8).astype("float32")
+    with ShardedExecutor(ShardedMLP, "llvm") as executor:
+        assert executor.num_workers == 2
+        out = executor["mlp"](x, w1, w2)
+        tvm.testing.assert_allclose(out, x @ w1 @ w2, rtol=1e-5, atol=1e-5)
+
+        gathered, sharded = executor["column_parallel"](x, w1)
+        tvm.testing.assert_allclose(gathered, x @ w1, rtol=1e-5, atol=1e-5)
+        tvm.testing.assert_allclose(sharded, x @ w1, rtol=1e-5, atol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_sharded_executor_worker_error():
+    x = np.random.rand(4, 8).astype("float32")
+    w1 = np.random.rand(8, 16).astype("float32")
+    executor = ShardedExecutor(ShardedMLP, "llvm")
+    # the shape mismatch is reported by the workers.
+    with pytest.raises(RuntimeError):
+        executor["column_parallel"](x[:, :4], w1)
+    executor.close()
+
+
+def test_collectives_on_offset_view():
+    name = "/tvm_ccl_test_%d" % os.getpid()
+    tvm.get_global_func("runtime.ccl.shm_create")(name, 1, 1024)
+    try:
+        tvm.get_global_func("runtime.ccl.shm_init")(name, 0, 1)
+        base = tvm.nd.array(np.arange(16, dtype="float32"))
+        # a compact view which starts half way into its allocation.
+        view = base._create_strided_view((2, 4), (4, 1), byte_offset=8 * 4)
+        expected = np.arange(8, 16, dtype="float32").reshape(2, 4)
+        outputs = [
+            tvm.get_global_func("vm.builtin.ccl.allreduce")(view),
+            tvm.get_global_func("vm.builtin.ccl.allgather")(view, 0),
+            tvm.get_global_func("vm.builtin.ccl.broadcast")(view, 0),
+            tvm.get_global_func("vm.builtin.ccl.scatter")(view, 0, 0),
+            tvm.get_global_func("vm.builtin.ccl.shard")(view, 0),
+        ]
+        for output in outputs:
+            np.testing.assert_equal(output.numpy(), expected)
+    finally:
+        tvm.get_global_func("runtime.ccl.shutdown")()
+        tvm.get_global_func("runtime.ccl.shm_unlink")(name)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,305 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.relax.distributed.transform import LowerDistIR
+from tvm.script.parser import ir as I
+from tvm.script.parser import relax as R
+from tvm.script.parser import tir as T
+
+
+def test_tensor_parallel_mlp():
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @T.prim_func
+        def matmul(var_A: T.handle, var_B: T.handle, var_C: T.handle):
+            m, k, n = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(var_A, (m, k), "float32")
+            B = T.match_buffer(var_B, (k, n), "float32")
+            C = T.match_buffer(var_C, (m, n), "float32")
+            for i, j, r in T.grid(m, n, k):
+                with T.block("matmul"):
+                    vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+        @R.function
+        def main(
+            x: R.DTensor((4, 8), "float32", "mesh[0]", "R"),
+            w1: R.DTensor((8, 16), "float32", "mesh[0]", "S[1]"),
+            w2: R.DTensor((16, 8), "float32", "mesh[0]", "S[0]"),
+        ) -> R.DTensor((4, 8), "float32", "mesh[0]", "R"):
+            cls = Before
+            h = R.dist.call_tir(
+                cls.matmul, (x, w1), R.DTensor((4, 16), "float32", "mesh[0]", "S[1]")
+            )
+            partial = R.dist.call_tir(
+                cls.matmul, (h, w2), R.DTensor((4, 8), "float32", "mesh[0]", "R")
+            )
+            out = R.dist.allreduce(partial)
+            return out
+
+    @I.ir_module
+    class Expected:
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @T.prim_func
+        def matmul(var_A: T.handle, var_B: T.handle, var_C: T.handle):
+            m, k, n = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(var_A, (m, k), "float32")
+            B = T.match_buffer(var_B, (k, n), "float32")
+            C = T.match_buffer(var_C, (m, n), "float32")
+            for i, j, r in T.grid(m, n, k):
+                with T.block("matmul"):
+                    vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+        @R.function
+        def main(
+            x: R.Tensor((4, 8), "float32"),
+            w1: R.Tensor((8, 8), "float32"),
+            w2: R.Tensor((8, 8), "float32"),
+        ) -> R.Tensor((4, 8), "float32"):
+            R.func_attr({"num_workers": 2, "dist_param_axes": [-1, 1, 0], "dist_ret_axes": [-1]})
+            cls = Expected
+            h = R.call_tir(cls.matmul, (x, w1), R.Tensor((4, 8), "float32"))
+            partial = R.call_tir(cls.matmul, (h, w2), R.Tensor((4, 8), "float32"))
+            out = R.call_packed(
+                "vm.builtin.ccl.allreduce", partial, sinfo_args=R.Tensor((4, 8), "float32")
+            )
+            return out
+
+    tvm.ir.assert_structural_equal(LowerDistIR()(Before), Expected)
+
+
+def test_static_shape_kernels():
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @T.prim_func
+        def matmul1(
+            A: T.Buffer((4, 8), "float32"),
+            B: T.Buffer((8, 16), "float32"),
+            C: T.Buffer((4, 16), "float32"),
+        ):
+            for i, j, r in T.grid(4, 16, 8):
+                with T.block("matmul"):
+                    vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+        @T.prim_func
+        def matmul2(
+            A: T.Buffer((4, 16), "float32"),
+            B: T.Buffer((16, 8), "float32"),
+            C: T.Buffer((4, 8), "float32"),
+        ):
+            for i, j, r in T.grid(4, 8, 16):
+                with T.block("matmul"):
+                    vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+        @R.function
+        def main(
+            x: R.DTensor((4, 8), "float32", "mesh[0]", "R"),
+            w1: R.DTensor((8, 16), "float32", "mesh[0]", "S[1]"),
+            w2: R.DTensor((16, 8), "float32", "mesh[0]", "S[0]"),
+        ) -> R.DTensor((4, 8), "float32", "mesh[0]", "R"):
+            cls = Before
+            h = R.dist.call_tir(
+                cls.matmul1, (x, w1), R.DTensor((4, 16), "float32", "mesh[0]", "S[1]")
+            )
+            partial = R.dist.call_tir(
+                cls.matmul2, (h, w2), R.DTensor((4, 8), "float32", "mesh[0]", "R")
+            )
+            out = R.dist.allreduce(partial)
+            return out
+
+    @I.ir_module
+    class Expected:
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @T.prim_func
+        def matmul1(
+            A: T.Buffer((4, 8), "float32"),
+            B: T.Buffer((8, 16), "float32"),
+            C: T.Buffer((4, 16), "float32"),
+        ):
+            for i, j, r in T.grid(4, 16, 8):
+                with T.block("matmul"):
+                    vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+        @T.prim_func
+        def matmul2(
+            A: T.Buffer((4, 16), "float32"),
+            B: T.Buffer((16, 8), "float32"),
+            C: T.Buffer((4, 8), "float32"),
+        ):
+            for i, j, r in T.grid(4, 8, 16):
+                with T.block("matmul"):
+                    vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+        @T.prim_func
+        def matmul1_shard(
+            A: T.Buffer((4, 8), "float32"),
+            B: T.Buffer((8, 8), "float32"),
+            C: T.Buffer((4, 8), "float32"),
+        ):
+            for i, j, r in T.grid(4, 8, 8):
+                with T.block("matmul"):
+                    vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+        @T.prim_func
+        def matmul2_shard(
+            A: T.Buffer((4, 8), "float32"),
+            B: T.Buffer((8, 8), "float32"),
+            C: T.Buffer((4, 8), "float32"),
+        ):
+            for i, j, r in T.grid(4, 8, 8):
+                with T.block("matmul"):
+                    vi, vj, vr = T.axis.remap("SSR", [i, j, r])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vr] * B[vr, vj]
+
+        @R.function
+        def main(
+            x: R.Tensor((4, 8), "float32"),
+            w1: R.Tensor((8, 8), "float32"),
+            w2: R.Tensor((8, 8), "float32"),
+        ) -> R.Tensor((4, 8), "float32"):
+            R.func_attr({"num_workers": 2, "dist_param_axes": [-1, 1, 0], "dist_ret_axes": [-1]})
+            cls = Expected
+            h = R.call_tir(cls.matmul1_shard, (x, w1), R.Tensor((4, 8), "float32"))
+            partial = R.call_tir(cls.matmul2_shard, (h, w2), R.Tensor((4, 8), "float32"))
+            out = R.call_packed(
+                "vm.builtin.ccl.allreduce", partial, sinfo_args=R.Tensor((4, 8), "float32")
+            )
+            return out
+
+    tvm.ir.assert_structural_equal(LowerDistIR()(Before), Expected)
+
+
+def test_static_shape_kernel_unsupported_index():
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @T.prim_func
+        def reverse(A: T.Buffer((8,), "float32"), B: T.Buffer((8,), "float32")):
+            for i in range(8):
+                with T.block("reverse"):
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[7 - vi]
+
+        @R.function
+        def main(
+            x: R.DTensor((8,), "float32", "mesh[0]", "S[0]"),
+        ) -> R.DTensor((8,), "float32", "mesh[0]", "S[0]"):
+            cls = Before
+            y = R.dist.call_tir(cls.reverse, (x,), R.DTensor((8,), "float32", "mesh[0]", "S[0]"))
+            return y
+
+    with pytest.raises(tvm.TVMError):
+        LowerDistIR()(Before)
+
+
+def test_redistribute():
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"mesh": [R.device_mesh((4,), I.Range(0, 4))]})
+
+        @R.function
+        def main(
+            x: R.DTensor((8, 4), "float32", "mesh[0]", "S[0]"),
+        ) -> R.Tuple(
+            R.DTensor((8, 4), "float32", "mesh[0]", "R"),
+            R.DTensor((8, 4), "float32", "mesh[0]", "S[1]"),
+        ):
+            replica = R.dist.redistribute(x, "mesh[0]", "R")
+            column = R.dist.redistribute(x, "mesh[0]", "S[1]")
+            return (replica, column)
+
+    @I.ir_module
+    class Expected:
+        I.module_global_infos({"mesh": [R.device_mesh((4,), I.Range(0, 4))]})
+
+        @R.function
+        def main(
+            x: R.Tensor((2, 4), "float32"),
+        ) -> R.Tuple(R.Tensor((8, 4), "float32"), R.Tensor((8, 1), "float32")):
+            R.func_attr({"num_workers": 4, "dist_param_axes": [0], "dist_ret_axes": [-1, 1]})
+            replica = R.call_packed(
+                "vm.builtin.ccl.allgather",
+                x,
+                R.prim_value(0),
+                sinfo_args=R.Tensor((8, 4), "float32"),
+            )
+            gathered = R.call_packed(
+                "vm.builtin.ccl.allgather",
+                x,
+                R.prim_value(0),
+                sinfo_args=R.Tensor((8, 4), "float32"),
+            )
+            column = R.call_packed(
+                "vm.builtin.ccl.shard",
+                gathered,
+                R.prim_value(1),
+                sinfo_args=R.Tensor((8, 1), "float32"),
+            )
+            return (replica, column)
+
+    tvm.ir.assert_structural_equal(LowerDistIR()(Before), Expected)
+
+
+def test_unsupported_mesh():
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"mesh": [R.device_mesh((2, 2), I.Range(0, 4))]})
+
+        @R.function
+        def main(
+            x: R.DTensor((8, 4), "float32", "mesh[0]", "S[0], R"),
+        ) -> R.DTensor((8, 4), "float32", "mesh[0]", "S[0], R"):
+            return x
+
+    with pytest.raises(tvm.TVMError):
+        LowerDistIR()(Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
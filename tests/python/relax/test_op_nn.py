@@ -1795,5 +1795,33 @@ def test_nll_loss_infer_struct_info_wrong_reduction():
         bb.normalize(relax.op.nn.nll_loss(x, y, w, reduction="foo"))
 
 
+
+def test_attention_attrs():
+    q = relax.Var("q", R.Tensor((2, 16, 4, 32), "float16"))
+    k = relax.Var("k", R.Tensor((2, 24, 4, 32), "float16"))
+    v = relax.Var("v", R.Tensor((2, 24, 4, 64), "float16"))
+    bias = relax.Var("bias", R.Tensor((2, 24), "float16"))
+
+    call = relax.op.nn.attention(q, k, v, scale=0.5, causal_mask="BottomRight")
+    assert call.op == Op.get("relax.nn.attention")
+    assert call.attrs.scale.value == 0.5
+    assert call.attrs.causal_mask == "BottomRight"
+
+    call = relax.op.nn.attention(q, k, v, bias)
+    assert call.op == Op.get("relax.nn.attention_bias")
+    assert call.attrs.scale is None
+    assert call.attrs.causal_mask is None
+
+    bb = relax.BlockBuilder()
+    _check_inference(
+        bb,
+        relax.op.nn.attention(q, k, v, bias, causal_mask="TopLeft"),
+        relax.TensorStructInfo((2, 16, 4, 64), "float16"),
+    )
+
+    with pytest.raises(TVMError):
+        relax.op.nn.attention(q, k, v, causal_mask="Diagonal")
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -19,7 +19,9 @@ import pytest
 import numpy as np
 
 from tvm.ir import assert_structural_equal
+from tvm import relax
 from tvm.relax.testing.runtime_builtin import MatchShapeCode, MakeShapeCode
+from tvm.script import relax as R
 
 
 def test_make_shape():
@@ -149,5 +151,130 @@ def test_tuple_getitem():
     assert tuple_getitem(t, 1) == y
 
 
+def test_paged_kv_cache():
+    fcreate = tvm.get_global_func("vm.builtin.paged_kv_cache_create")
+    fadd = tvm.get_global_func("vm.builtin.paged_kv_cache_add_sequence")
+    fappend = tvm.get_global_func("vm.builtin.paged_kv_cache_append")
+    fview = tvm.get_global_func("vm.builtin.paged_kv_cache_view")
+    fremove = tvm.get_global_func("vm.builtin.paged_kv_cache_remove_sequence")
+    fstats = tvm.get_global_func("vm.builtin.paged_kv_cache_stats")
+    fblock_table = tvm.get_global_func("vm.builtin.paged_kv_cache_block_table")
+    flengths = tvm.get_global_func("vm.builtin.paged_kv_cache_sequence_lengths")
+
+    cache = fcreate(tvm.runtime.ShapeTuple([2, 3]), "float32", tvm.cpu(), 8, 4)
+    fadd(cache, 0)
+    fadd(cache, 1)
+    data0 = np.random.rand(6, 2, 3).astype("float32")
+    data1 = np.random.rand(3, 2, 3).astype("float32")
+    # append across the block boundary.
+    fappend(cache, 0, tvm.nd.array(data0[:3]))
+    fappend(cache, 1, tvm.nd.array(data1))
+    fappend(cache, 0, tvm.nd.array(data0[3:]))
+    np.testing.assert_equal(fview(cache, 0).numpy(), data0)
+    np.testing.assert_equal(fview(cache, 1).numpy(), data1)
+
+    table = fblock_table(cache, tvm.runtime.ShapeTuple([0, 1])).numpy()
+    np.testing.assert_equal(table, [[0, 2], [1, -1]])
+    np.testing.assert_equal(flengths(cache, tvm.runtime.ShapeTuple([0, 1])).numpy(), [6, 3])
+    num_blocks, used_blocks, num_entries, block_size = fstats(cache)
+    assert (num_blocks, used_blocks, num_entries, block_size) == (8, 3, 9, 4)
+
+    fremove(cache, 0)
+    assert tuple(fstats(cache))[1:3] == (1, 3)
+    # blocks are recycled after removal.
+    fadd(cache, 2)
+    fappend(cache, 2, tvm.nd.array(data0))
+    np.testing.assert_equal(fview(cache, 2).numpy(), data0)
+
+    # running out of blocks.
+    fadd(cache, 3)
+    with pytest.raises(RuntimeError):
+        fappend(cache, 3, tvm.nd.array(np.zeros((32, 2, 3), "float32")))
+
+
+def test_paged_kv_cache_fork():
+    fcreate = tvm.get_global_func("vm.builtin.paged_kv_cache_create")
+    fadd = tvm.get_global_func("vm.builtin.paged_kv_cache_add_sequence")
+    ffork = tvm.get_global_func("vm.builtin.paged_kv_cache_fork_sequence")
+    fappend = tvm.get_global_func("vm.builtin.paged_kv_cache_append")
+    fpopn = tvm.get_global_func("vm.builtin.paged_kv_cache_popn")
+    fview = tvm.get_global_func("vm.builtin.paged_kv_cache_view")
+    fstats = tvm.get_global_func("vm.builtin.paged_kv_cache_stats")
+
+    cache = fcreate(tvm.runtime.ShapeTuple([4]), "float32", tvm.cpu(), 4, 4)
+    prefix = np.random.rand(6, 4).astype("float32")
+    fadd(cache, 0)
+    fappend(cache, 0, tvm.nd.array(prefix))
+    # beams share the prefix, the partially filled block is copied on write.
+    ffork(cache, 0, 1)
+    assert fstats(cache)[1] == 2
+    beam0 = np.random.rand(1, 4).astype("float32")
+    beam1 = np.random.rand(1, 4).astype("float32")
+    fappend(cache, 0, tvm.nd.array(beam0))
+    fappend(cache, 1, tvm.nd.array(beam1))
+    assert fstats(cache)[1] == 3
+    np.testing.assert_equal(fview(cache, 0).numpy(), np.concatenate([prefix, beam0]))
+    np.testing.assert_equal(fview(cache, 1).numpy(), np.concatenate([prefix, beam1]))
+
+    fpopn(cache, 1, 3)
+    np.testing.assert_equal(fview(cache, 1).numpy(), prefix[:4])
+    assert fstats(cache)[1] == 2
+
+
+def test_paged_kv_cache_append_out_of_blocks():
+    fcreate = tvm.get_global_func("vm.builtin.paged_kv_cache_create")
+    fadd = tvm.get_global_func("vm.builtin.paged_kv_cache_add_sequence")
+    ffork = tvm.get_global_func("vm.builtin.paged_kv_cache_fork_sequence")
+    fappend = tvm.get_global_func("vm.builtin.paged_kv_cache_append")
+    fview = tvm.get_global_func("vm.builtin.paged_kv_cache_view")
+    fstats = tvm.get_global_func("vm.builtin.paged_kv_cache_stats")
+
+    cache = fcreate(tvm.runtime.ShapeTuple([4]), "float32", tvm.cpu(), 3, 4)
+    prefix = np.random.rand(6, 4).astype("float32")
+    fadd(cache, 0)
+    fappend(cache, 0, tvm.nd.array(prefix))
+    ffork(cache, 0, 1)
+    fadd(cache, 2)
+    fappend(cache, 2, tvm.nd.array(prefix[:4]))
+    assert tuple(fstats(cache))[1:3] == (3, 10)
+
+    # a new block, a copy-on-write of the shared tail, or both.
+    for seq_id, num_entries in [(2, 1), (1, 1), (0, 3)]:
+        with pytest.raises(RuntimeError):
+            fappend(cache, seq_id, tvm.nd.array(np.zeros((num_entries, 4), "float32")))
+        assert tuple(fstats(cache))[1:3] == (3, 10)
+    np.testing.assert_equal(fview(cache, 0).numpy(), prefix)
+    np.testing.assert_equal(fview(cache, 1).numpy(), prefix)
+    np.testing.assert_equal(fview(cache, 2).numpy(), prefix[:4])
+
+
+def test_paged_kv_cache_call_packed():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def decode(cache: R.Object, x: R.Tensor((1, 2), "float32")):
+            cache1 = R.call_packed(
+                "vm.builtin.paged_kv_cache_append", cache, R.prim_value(0), x, sinfo_args=R.Object
+            )
+            y = R.call_packed(
+                "vm.builtin.paged_kv_cache_view",
+                cache1,
+                R.prim_value(0),
+                sinfo_args=R.Tensor(ndim=2, dtype="float32"),
+            )
+            return y
+
+    ex = relax.build(Module, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    cache = tvm.get_global_func("vm.builtin.paged_kv_cache_create")(
+        tvm.runtime.ShapeTuple([2]), "float32", tvm.cpu(), 4, 2
+    )
+    tvm.get_global_func("vm.builtin.paged_kv_cache_add_sequence")(cache, 0)
+    steps = [np.random.rand(1, 2).astype("float32") for _ in range(3)]
+    for i, step in enumerate(steps):
+        out = vm["decode"](cache, tvm.nd.array(step))
+        np.testing.assert_equal(out.numpy(), np.concatenate(steps[: i + 1]))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
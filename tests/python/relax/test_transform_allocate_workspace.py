@@ -0,0 +1,200 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import relax as R, tir as T
+
+
+@tvm.script.ir_module
+class Module:
+    @T.prim_func
+    def add_mul(a: T.handle, b: T.handle):
+        A = T.match_buffer(a, (T.int64(32), T.int64(32)), "float32")
+        B = T.match_buffer(b, (T.int64(32), T.int64(32)), "float32")
+        C = T.alloc_buffer((T.int64(32), T.int64(32)), "float32")
+        for i, j in T.grid(T.int64(32), T.int64(32)):
+            with T.block("C"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                C[vi, vj] = A[vi, vj] + T.float32(1)
+        for i, j in T.grid(T.int64(32), T.int64(32)):
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = C[vi, vj] * T.float32(2)
+
+    @T.prim_func
+    def add_small(a: T.handle, b: T.handle):
+        A = T.match_buffer(a, (T.int64(32), T.int64(32)), "float32")
+        B = T.match_buffer(b, (T.int64(32), T.int64(32)), "float32")
+        C = T.alloc_buffer((T.int64(4),), "float32")
+        for i, j in T.grid(T.int64(32), T.int64(32)):
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                C[T.int64(0)] = A[vi, vj]
+                B[vi, vj] = C[T.int64(0)] + T.float32(1)
+
+    @R.function
+    def main(x: R.Tensor((32, 32), "float32")) -> R.Tensor((32, 32), "float32"):
+        cls = Module
+        with R.dataflow():
+            y = R.call_tir(cls.add_mul, (x,), out_sinfo=R.Tensor((32, 32), "float32"))
+            z = R.call_tir(cls.add_small, (y,), out_sinfo=R.Tensor((32, 32), "float32"))
+            w = R.call_tir(cls.add_mul, (z,), out_sinfo=R.Tensor((32, 32), "float32"))
+            R.output(w)
+        return w
+
+
+def _call_tir_args(func):
+    calls = []
+
+    def fvisit(expr):
+        if isinstance(expr, relax.Call) and expr.op == tvm.ir.Op.get("relax.call_tir"):
+            calls.append((expr.args[0].name_hint, list(expr.args[1].fields)))
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return calls
+
+
+def test_workspace_argument():
+    mod = relax.transform.AllocateWorkspace()(Module)
+
+    add_mul = mod["add_mul"]
+    assert len(add_mul.params) == 3
+    assert add_mul.attrs["tir.workspace_param"] == 1
+    workspace = add_mul.buffer_map[add_mul.params[1]]
+    assert workspace.dtype == "uint8"
+    assert int(workspace.shape[0]) == 32 * 32 * 4
+
+    # Buffers small enough for the stack do not need a workspace.
+    assert len(mod["add_small"].params) == 2
+    assert "tir.workspace_param" not in (mod["add_small"].attrs or {})
+
+    main = mod["main"]
+    alloc = main.body.blocks[0].bindings[0]
+    assert alloc.value.op == tvm.ir.Op.get("relax.builtin.alloc_tensor")
+    calls = _call_tir_args(main)
+    assert [name for name, _ in calls] == ["add_mul", "add_small", "add_mul"]
+    for name, args in calls:
+        assert (args[-1].same_as(alloc.var)) == (name == "add_mul")
+
+
+def test_workspace_sized_by_largest_kernel():
+    @tvm.script.ir_module
+    class TwoKernels:
+        @T.prim_func
+        def small(a: T.handle, b: T.handle):
+            A = T.match_buffer(a, (T.int64(512),), "float32")
+            B = T.match_buffer(b, (T.int64(512),), "float32")
+            C = T.alloc_buffer((T.int64(512),), "float32")
+            for i in range(T.int64(512)):
+                with T.block("C"):
+                    vi = T.axis.spatial(T.int64(512), i)
+                    C[vi] = A[vi]
+            for i in range(T.int64(512)):
+                with T.block("B"):
+                    vi = T.axis.spatial(T.int64(512), i)
+                    B[vi] = C[vi]
+
+        @T.prim_func
+        def large(a: T.handle, b: T.handle):
+            A = T.match_buffer(a, (T.int64(512),), "float32")
+            B = T.match_buffer(b, (T.int64(512),), "float32")
+            C = T.alloc_buffer((T.int64(512),), "float32")
+            D = T.alloc_buffer((T.int64(512),), "float32")
+            for i in range(T.int64(512)):
+                with T.block("C"):
+                    vi = T.axis.spatial(T.int64(512), i)
+                    C[vi] = A[vi]
+            for i in range(T.int64(512)):
+                with T.block("D"):
+                    vi = T.axis.spatial(T.int64(512), i)
+                    D[vi] = C[vi]
+            for i in range(T.int64(512)):
+                with T.block("B"):
+                    vi = T.axis.spatial(T.int64(512), i)
+                    B[vi] = D[vi]
+
+        @R.function
+        def main(x: R.Tensor((512,), "float32")) -> R.Tensor((512,), "float32"):
+            cls = TwoKernels
+            with R.dataflow():
+                y = R.call_tir(cls.small, (x,), out_sinfo=R.Tensor((512,), "float32"))
+                z = R.call_tir(cls.large, (y,), out_sinfo=R.Tensor((512,), "float32"))
+                R.output(z)
+            return z
+
+    mod = relax.transform.AllocateWorkspace()(TwoKernels)
+    for name in ["small", "large"]:
+        func = mod[name]
+        workspace = func.buffer_map[func.params[func.attrs["tir.workspace_param"]]]
+        assert int(workspace.shape[0]) == 2 * 512 * 4
+
+
+def test_workspace_on_kernel_device():
+    @tvm.script.ir_module
+    class OnDevice:
+        @T.prim_func
+        def add_mul(a: T.handle, b: T.handle):
+            A = T.match_buffer(a, (T.int64(32), T.int64(32)), "float32")
+            B = T.match_buffer(b, (T.int64(32), T.int64(32)), "float32")
+            C = T.alloc_buffer((T.int64(32), T.int64(32)), "float32")
+            for i, j in T.grid(T.int64(32), T.int64(32)):
+                with T.block("C"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    C[vi, vj] = A[vi, vj] + T.float32(1)
+            for i, j in T.grid(T.int64(32), T.int64(32)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = C[vi, vj] * T.float32(2)
+
+        @R.function
+        def main(s: R.Shape((32, 32))) -> R.Tensor((32, 32), "float32"):
+            cls = OnDevice
+            x = R.builtin.alloc_tensor(R.shape([32, 32]), "float32", 1)
+            y = R.call_tir(cls.add_mul, (x,), out_sinfo=R.Tensor((32, 32), "float32"))
+            return y
+
+    mod = relax.transform.AllocateWorkspace()(OnDevice)
+    alloc = mod["main"].body.blocks[0].bindings[0]
+    assert alloc.value.op == tvm.ir.Op.get("relax.builtin.alloc_tensor")
+    assert alloc.value.args[2].value.value == 1
+    [(_, args)] = _call_tir_args(mod["main"])
+    assert args[-1].same_as(alloc.var)
+
+
+def test_build_and_run():
+    x_np = np.random.rand(32, 32).astype("float32")
+    ex = relax.build(Module, target="llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    out = vm["main"](tvm.nd.array(x_np)).numpy()
+    tvm.testing.assert_allclose(out, ((x_np + 1) * 2 + 1 + 1) * 2, rtol=1e-6)
+
+    # The intermediate buffer of the kernel is placed in the workspace.
+    lowered = tvm.lower(relax.transform.AllocateWorkspace()(Module)["add_mul"])
+    allocs = []
+    tvm.tir.stmt_functor.post_order_visit(
+        lowered["main"].body,
+        lambda stmt: allocs.append(stmt) if isinstance(stmt, tvm.tir.Allocate) else None,
+    )
+    assert not allocs
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
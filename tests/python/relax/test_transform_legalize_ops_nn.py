@@ -15,8 +15,10 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
 import pytest
 import tvm
+from tvm import relax
 from tvm.relax.transform import LegalizeOps
 from tvm.script import relax as R, tir as T, ir as I
 import tvm.testing
@@ -2452,5 +2454,54 @@ def test_nll_loss_symbolic():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+
+@pytest.mark.parametrize("impl", ["auto", "flash", "naive"])
+def test_attention(impl):
+    # fmt: off
+    @tvm.script.ir_module
+    class Attention:
+        @R.function
+        def main(q: R.Tensor((1, 40, 2, 16), "float32"), k: R.Tensor((1, 40, 2, 16), "float32"), v: R.Tensor((1, 40, 2, 8), "float32"), bias: R.Tensor((1, 40), "float32")):
+            gv: R.Tensor((1, 40, 2, 8), "float32") = R.nn.attention(q, k, v, bias, causal_mask="TopLeft")
+            return gv
+    # fmt: on
+
+    with tvm.transform.PassContext(config={"relax.LegalizeOps.attention_impl": impl}):
+        mod = LegalizeOps()(Attention)
+    expected_name = "naive_attention" if impl == "naive" else "flash_attention"
+    assert [gv.name_hint for gv in mod.get_global_vars() if gv.name_hint != "main"] == [
+        expected_name
+    ]
+
+    np_args = [
+        np.random.uniform(-1, 1, [int(d) for d in param.struct_info.shape]).astype("float32")
+        for param in Attention["main"].params
+    ]
+    with tvm.transform.PassContext(config={"relax.LegalizeOps.attention_impl": "naive"}):
+        ref_mod = LegalizeOps()(Attention)
+
+    def run(mod):
+        ex = relax.build(mod, "llvm")
+        vm = relax.VirtualMachine(ex, tvm.cpu())
+        return vm["main"](*[tvm.nd.array(arr) for arr in np_args]).numpy()
+
+    tvm.testing.assert_allclose(run(mod), run(ref_mod), rtol=1e-5, atol=1e-5)
+
+
+def test_attention_unknown_impl():
+    # fmt: off
+    @tvm.script.ir_module
+    class Attention:
+        @R.function
+        def main(q: R.Tensor((1, 8, 2, 16), "float32"), k: R.Tensor((1, 8, 2, 16), "float32"), v: R.Tensor((1, 8, 2, 16), "float32")):
+            gv: R.Tensor((1, 8, 2, 16), "float32") = R.nn.attention(q, k, v)
+            return gv
+    # fmt: on
+
+    with tvm.transform.PassContext(config={"relax.LegalizeOps.attention_impl": "cudnn"}):
+        with pytest.raises(ValueError):
+            LegalizeOps()(Attention)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
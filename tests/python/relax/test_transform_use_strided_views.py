@@ -0,0 +1,307 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import relax as R, tir as T
+
+
+def _run(mod, *args):
+    ex = relax.build(mod, target="llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    return vm["main"](*[tvm.nd.array(arg) for arg in args]).numpy()
+
+
+def test_permute_dims():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle):
+            s0, s1, offset = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(
+                a, (T.int64(4), T.int64(3)), "float32", strides=(s0, s1), elem_offset=offset
+            )
+            B = T.match_buffer(b, (T.int64(4), T.int64(3)), "float32")
+            for i, j in T.grid(T.int64(4), T.int64(3)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((3, 4), "float32")) -> R.Tensor((4, 3), "float32"):
+            cls = Module
+            with R.dataflow():
+                y = R.permute_dims(x)
+                z = R.call_tir(cls.add_one, (y,), out_sinfo=R.Tensor((4, 3), "float32"))
+                R.output(z)
+            return z
+
+    @tvm.script.ir_module
+    class Expected:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle):
+            s0, s1, offset = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(
+                a, (T.int64(4), T.int64(3)), "float32", strides=(s0, s1), elem_offset=offset
+            )
+            B = T.match_buffer(b, (T.int64(4), T.int64(3)), "float32")
+            for i, j in T.grid(T.int64(4), T.int64(3)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((3, 4), "float32")) -> R.Tensor((4, 3), "float32"):
+            cls = Expected
+            with R.dataflow():
+                y = R.call_packed(
+                    "vm.builtin.permute_dims_view",
+                    x,
+                    R.shape([1, 0]),
+                    sinfo_args=(R.Tensor((4, 3), "float32"),),
+                )
+                z = R.call_tir(cls.add_one, (y,), out_sinfo=R.Tensor((4, 3), "float32"))
+                R.output(z)
+            return z
+
+    mod = relax.transform.UseStridedViews()(Module)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+    x = np.random.rand(3, 4).astype("float32")
+    tvm.testing.assert_allclose(_run(mod, x), x.T + 1)
+
+
+def test_compact_consumer_unchanged():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def compact(
+            A: T.Buffer((T.int64(4), T.int64(3)), "float32"),
+            B: T.Buffer((T.int64(4), T.int64(3)), "float32"),
+        ):
+            for i, j in T.grid(T.int64(4), T.int64(3)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((3, 4), "float32")) -> R.Tensor((4, 3), "float32"):
+            cls = Module
+            with R.dataflow():
+                y = R.permute_dims(x)
+                z = R.call_tir(cls.compact, (y,), out_sinfo=R.Tensor((4, 3), "float32"))
+                R.output(z)
+            return z
+
+    mod = relax.transform.UseStridedViews()(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+def test_escaped_view_unchanged():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle):
+            s0, s1, offset = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(
+                a, (T.int64(4), T.int64(3)), "float32", strides=(s0, s1), elem_offset=offset
+            )
+            B = T.match_buffer(b, (T.int64(4), T.int64(3)), "float32")
+            for i, j in T.grid(T.int64(4), T.int64(3)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((3, 4), "float32")):
+            cls = Module
+            with R.dataflow():
+                y = R.permute_dims(x)
+                z = R.call_tir(cls.add_one, (y,), out_sinfo=R.Tensor((4, 3), "float32"))
+                R.output(y, z)
+            return (y, z)
+
+    mod = relax.transform.UseStridedViews()(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+def test_strided_slice():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle):
+            s0, s1, offset = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(
+                a, (T.int64(4), T.int64(3)), "float32", strides=(s0, s1), elem_offset=offset
+            )
+            B = T.match_buffer(b, (T.int64(4), T.int64(3)), "float32")
+            for i, j in T.grid(T.int64(4), T.int64(3)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((9, 7), "float32")) -> R.Tensor((4, 3), "float32"):
+            cls = Module
+            with R.dataflow():
+                y = R.strided_slice(x, axes=[0, 1], begin=[1, -6], end=[9, 7], strides=[2, 2])
+                z = R.call_tir(cls.add_one, (y,), out_sinfo=R.Tensor((4, 3), "float32"))
+                R.output(z)
+            return z
+
+    mod = relax.transform.UseStridedViews()(Module)
+    calls = [
+        binding.value.op.global_symbol
+        for binding in mod["main"].body.blocks[0].bindings
+        if isinstance(binding.value.op, relax.ExternFunc)
+    ]
+    assert calls == ["vm.builtin.strided_slice_view"]
+
+    x = np.random.rand(9, 7).astype("float32")
+    tvm.testing.assert_allclose(_run(mod, x), x[1:9:2, 1:7:2] + 1)
+
+
+def test_split():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle):
+            s0, s1, offset = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(
+                a, (T.int64(4), T.int64(3)), "float32", strides=(s0, s1), elem_offset=offset
+            )
+            B = T.match_buffer(b, (T.int64(4), T.int64(3)), "float32")
+            for i, j in T.grid(T.int64(4), T.int64(3)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((4, 9), "float32")):
+            cls = Module
+            with R.dataflow():
+                parts = R.split(x, indices_or_sections=3, axis=1)
+                a = parts[0]
+                b = parts[2]
+                y = R.call_tir(cls.add_one, (a,), out_sinfo=R.Tensor((4, 3), "float32"))
+                z = R.call_tir(cls.add_one, (b,), out_sinfo=R.Tensor((4, 3), "float32"))
+                R.output(y, z)
+            return (y, z)
+
+    mod = relax.transform.UseStridedViews()(Module)
+    calls = [
+        binding.value.op.global_symbol
+        for binding in mod["main"].body.blocks[0].bindings
+        if isinstance(binding.value, relax.Call) and isinstance(binding.value.op, relax.ExternFunc)
+    ]
+    assert calls == ["vm.builtin.strided_slice_view"] * 3
+
+    x = np.random.rand(4, 9).astype("float32")
+    ex = relax.build(mod, target="llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    y, z = vm["main"](tvm.nd.array(x))
+    tvm.testing.assert_allclose(y.numpy(), x[:, 0:3] + 1)
+    tvm.testing.assert_allclose(z.numpy(), x[:, 6:9] + 1)
+
+
+def test_split_with_compact_consumer_unchanged():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def strided(a: T.handle, b: T.handle):
+            s0, s1, offset = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(
+                a, (T.int64(4), T.int64(3)), "float32", strides=(s0, s1), elem_offset=offset
+            )
+            B = T.match_buffer(b, (T.int64(4), T.int64(3)), "float32")
+            for i, j in T.grid(T.int64(4), T.int64(3)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @T.prim_func
+        def compact(
+            A: T.Buffer((T.int64(4), T.int64(3)), "float32"),
+            B: T.Buffer((T.int64(4), T.int64(3)), "float32"),
+        ):
+            for i, j in T.grid(T.int64(4), T.int64(3)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((4, 6), "float32")):
+            cls = Module
+            with R.dataflow():
+                parts = R.split(x, indices_or_sections=2, axis=1)
+                a = parts[0]
+                b = parts[1]
+                y = R.call_tir(cls.strided, (a,), out_sinfo=R.Tensor((4, 3), "float32"))
+                z = R.call_tir(cls.compact, (b,), out_sinfo=R.Tensor((4, 3), "float32"))
+                R.output(y, z)
+            return (y, z)
+
+    mod = relax.transform.UseStridedViews()(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+def test_non_compact_input_unchanged():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle):
+            s0, s1, offset = T.int64(), T.int64(), T.int64()
+            A = T.match_buffer(
+                a, (T.int64(3), T.int64(4)), "float32", strides=(s0, s1), elem_offset=offset
+            )
+            B = T.match_buffer(b, (T.int64(3), T.int64(4)), "float32")
+            for i, j in T.grid(T.int64(3), T.int64(4)):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: R.Tensor((3, 4), "float32")) -> R.Tensor((3, 4), "float32"):
+            cls = Module
+            with R.dataflow():
+                y = R.call_packed(
+                    "vm.builtin.permute_dims_view",
+                    x,
+                    R.shape([1, 0]),
+                    sinfo_args=(R.Tensor((4, 3), "float32"),),
+                )
+                z = R.permute_dims(y)
+                w = R.call_tir(cls.add_one, (z,), out_sinfo=R.Tensor((3, 4), "float32"))
+                R.output(w)
+            return w
+
+    mod = relax.transform.UseStridedViews()(Module)
+    tvm.ir.assert_structural_equal(mod, Module)
+
+
+def test_strided_view_ndarray():
+    x = np.arange(24, dtype="float32").reshape(4, 6)
+    arr = tvm.nd.array(x)
+    view = arr._create_strided_view((2, 3), (12, 2), byte_offset=7 * 4)
+    tvm.testing.assert_allclose(view.numpy(), x[1::2, 1::2])
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
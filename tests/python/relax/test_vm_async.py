@@ -0,0 +1,136 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import concurrent.futures
+import threading
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+@I.ir_module
+class Model:
+    @R.function
+    def main(x: R.Tensor((32, 32), "float32"), w: R.Tensor((32, 32), "float32")):
+        with R.dataflow():
+            y = R.matmul(x, w)
+            z = R.nn.relu(y)
+            R.output(z)
+        return z
+
+
+def _make_vm():
+    ex = relax.build(Model, "llvm")
+    return relax.VirtualMachine(ex, tvm.cpu())
+
+
+def _inputs(seed):
+    rng = np.random.default_rng(seed)
+    x = rng.standard_normal((32, 32)).astype("float32")
+    w = rng.standard_normal((32, 32)).astype("float32")
+    return x, w
+
+
+def test_submit():
+    vm = _make_vm()
+    executor = relax.vm.AsyncVirtualMachine(vm, num_workers=4)
+    futures = []
+    for i in range(16):
+        x, w = _inputs(i)
+        futures.append((executor.submit("main", x, w), np.maximum(x @ w, 0)))
+    for future, expected in futures:
+        tvm.testing.assert_allclose(future.result().numpy(), expected, rtol=1e-5, atol=1e-5)
+        assert future.done()
+    executor.shutdown()
+
+
+def test_matches_sync_call():
+    vm = _make_vm()
+    executor = relax.vm.AsyncVirtualMachine(vm, num_workers=2)
+    x, w = _inputs(0)
+    expected = vm["main"](tvm.nd.array(x), tvm.nd.array(w)).numpy()
+    out = executor.submit("main", tvm.nd.array(x), tvm.nd.array(w)).result()
+    tvm.testing.assert_allclose(out.numpy(), expected)
+
+
+def test_done_callback():
+    vm = _make_vm()
+    executor = relax.vm.AsyncVirtualMachine(vm, num_workers=2)
+    done = threading.Event()
+    results = []
+
+    def callback(future):
+        results.append(future.result())
+        done.set()
+
+    future = executor.submit("main", *_inputs(0))
+    future.add_done_callback(callback)
+    assert done.wait(timeout=60)
+    assert len(results) == 1
+
+    # A callback added after completion runs immediately.
+    late = []
+    future.add_done_callback(late.append)
+    assert len(late) == 1
+
+
+def test_error():
+    vm = _make_vm()
+    executor = relax.vm.AsyncVirtualMachine(vm, num_workers=1)
+    future = executor.submit("main", np.zeros((4, 4), "float32"), np.zeros((4, 4), "float32"))
+    with pytest.raises(RuntimeError):
+        future.result()
+    assert future.done() and not future.cancelled()
+
+    future = executor.submit("unknown_function", *_inputs(0))
+    with pytest.raises(ValueError):
+        future.result()
+
+
+def test_cancel():
+    vm = _make_vm()
+    executor = relax.vm.AsyncVirtualMachine(vm, num_workers=1)
+    futures = [executor.submit("main", *_inputs(i)) for i in range(64)]
+    last = futures[-1]
+    if last.cancel():
+        assert last.cancelled()
+        with pytest.raises(concurrent.futures.CancelledError):
+            last.result()
+    for future in futures[:-1]:
+        future.result()
+    # A completed invocation cannot be cancelled.
+    assert not futures[0].cancel()
+
+
+def test_shutdown_cancels_queue():
+    vm = _make_vm()
+    executor = relax.vm.AsyncVirtualMachine(vm, num_workers=1)
+    futures = [executor.submit("main", *_inputs(i)) for i in range(64)]
+    executor.shutdown()
+    assert all(future.done() for future in futures)
+    assert executor.num_pending == 0
+    with pytest.raises(tvm.TVMError):
+        executor.submit("main", *_inputs(0))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,138 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I
+from tvm.script import relax as R
+from tvm.script import tir as T
+
+VOCAB_SIZE = 100
+
+
+@I.ir_module
+class CountingModel:
+    """The next token is the last token plus one, modulo VOCAB_SIZE."""
+
+    @T.prim_func
+    def prefill_next(var_ids: T.handle, var_indptr: T.handle, var_next: T.handle):
+        n, m, b = T.int64(), T.int64(), T.int64()
+        ids = T.match_buffer(var_ids, (n,), "int32")
+        indptr = T.match_buffer(var_indptr, (m,), "int32")
+        next_token = T.match_buffer(var_next, (b,), "int32")
+        for i in range(b):
+            with T.block("next"):
+                vi = T.axis.spatial(b, i)
+                next_token[vi] = T.floormod(ids[indptr[vi + 1] - 1] + 1, VOCAB_SIZE)
+
+    @T.prim_func
+    def decode_next(var_ids: T.handle, var_next: T.handle):
+        b = T.int64()
+        ids = T.match_buffer(var_ids, (b,), "int32")
+        next_token = T.match_buffer(var_next, (b,), "int32")
+        for i in range(b):
+            with T.block("next"):
+                vi = T.axis.spatial(b, i)
+                next_token[vi] = T.floormod(ids[vi] + 1, VOCAB_SIZE)
+
+    @R.function
+    def prefill(
+        input_ids: R.Tensor(("n",), "int32"),
+        indptr: R.Tensor(("m",), "int32"),
+        slots: R.Tensor(("b",), "int32"),
+    ):
+        b = T.int64()
+        cls = CountingModel
+        out = R.call_tir(cls.prefill_next, (input_ids, indptr), R.Tensor((b,), "int32"))
+        return out
+
+    @R.function
+    def decode(input_ids: R.Tensor(("b",), "int32"), slots: R.Tensor(("b",), "int32")):
+        b = T.int64()
+        cls = CountingModel
+        out = R.call_tir(cls.decode_next, (input_ids,), R.Tensor((b,), "int32"))
+        return out
+
+
+def _make_scheduler(max_batch_size, max_num_tokens):
+    ex = relax.build(CountingModel, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    return relax.vm.BatchScheduler(
+        vm, max_batch_size=max_batch_size, max_num_tokens=max_num_tokens
+    )
+
+
+def _expected(prompt, max_new_tokens, eos_token=-1):
+    out = []
+    token = prompt[-1]
+    while len(out) < max_new_tokens:
+        token = (token + 1) % VOCAB_SIZE
+        out.append(token)
+        if token == eos_token:
+            break
+    return out
+
+
+def test_batch_scheduler():
+    sched = _make_scheduler(max_batch_size=2, max_num_tokens=8)
+    requests = {
+        0: ([1, 2, 3], 3, -1),
+        1: ([10, 96], 10, 99),
+        2: ([5, 5, 5, 5, 5, 40], 2, -1),
+        3: ([7], 5, -1),
+        4: ([0, 1, 2, 3, 4, 5, 6, 70], 4, -1),
+    }
+    for request_id, (prompt, max_new_tokens, eos) in requests.items():
+        sched.add_request(request_id, prompt, max_new_tokens, eos)
+    assert sched.num_pending == len(requests)
+
+    outputs = sched.run()
+    assert sched.num_pending == 0
+    assert set(outputs) == set(requests)
+    for request_id, (prompt, max_new_tokens, eos) in requests.items():
+        assert outputs[request_id] == _expected(prompt, max_new_tokens, eos)
+
+    stats = sched.stats()
+    assert stats["finished"] == len(requests)
+    assert stats["prefill_tokens"] == sum(len(p) for p, _, _ in requests.values())
+    # the first token comes from prefill, the others from decode.
+    assert stats["decode_tokens"] == sum(len(o) - 1 for o in outputs.values())
+
+
+def test_batch_scheduler_join_running_batch():
+    sched = _make_scheduler(max_batch_size=4, max_num_tokens=16)
+    sched.add_request(0, [1], 4)
+    assert sched.step() == {}
+    # joins while request 0 is decoding, and finishes first.
+    sched.add_request(1, [50], 1)
+    assert sched.step() == {1: [51]}
+    assert sched.run() == {0: [2, 3, 4, 5]}
+
+
+def test_batch_scheduler_invalid_request():
+    sched = _make_scheduler(max_batch_size=2, max_num_tokens=4)
+    with pytest.raises(ValueError):
+        sched.add_request(0, [1, 2, 3, 4, 5], 1)
+    sched.add_request(0, [1], 1)
+    with pytest.raises(ValueError):
+        sched.add_request(0, [2], 1)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -286,6 +286,18 @@ def test_meta_ref():
         assert meta_op.attrs.node_index == 1337
 
 
+def test_meta_ref_before_metadata_section():
+    # Meta references are resolved before the parser reaches the metadata section at the end of
+    # the source, markers in comments ahead of it must not be mistaken for it.
+    x = relay.var("x", shape=(2, 3))
+    consts = [relay.const(np.random.rand(2, 3).astype("float32")) for _ in range(2)]
+    mod = tvm.IRModule.from_expr(relay.Function([x], x + consts[0] - consts[1]))
+    mod = relay.transform.InferType()(mod)
+    text = mod.astext(show_meta_data=True)
+    text = text.replace("def @main", "// #[metadata]\n/* #[metadata] */\ndef @main", 1)
+    assert_graph_equal(tvm.relay.parse(text), mod)
+
+
 def test_let():
     assert_parses_as("let %x = 1; ()", relay.Let(X, relay.const(1), UNIT))
 
@@ -143,6 +143,26 @@ def test_fixed_point_multiply():
     np.testing.assert_allclose(op_res.numpy(), ref_res, atol=1)
 
 
+@pytest.mark.parametrize("shift", [-1, -2, -5, -31])
+def test_fixed_point_multiply_matches_int64_reference(shift):
+    # Constant right shifts of 2 or more lower to a 32-bit multiply-high, which has to round
+    # exactly like the widened int64 computation.
+    multiplier = 1518500250
+    a = relay.var("a", relay.TensorType((4, 1024), "int32"))
+    y = relay.fixed_point_multiply(a, multiplier, shift)
+
+    np.random.seed(0)
+    data = np.random.randint(-(2**31), 2**31 - 1, size=(4, 1024), dtype="int64")
+    data[0, :4] = [-(2**31), 2**31 - 1, 0, -1]
+    data = data.astype("int32")
+    total_right_shift = 31 - shift
+    rounding = 1 << (total_right_shift - 1)
+    ref_res = (data.astype(object) * multiplier + rounding) >> total_right_shift
+    for target, dev in tvm.testing.enabled_targets():
+        op_res = relay.create_executor("graph", device=dev, target=target).evaluate(y)(data)
+        np.testing.assert_equal(op_res.numpy(), ref_res.astype("int32"))
+
+
 def test_reinterpret():
     a = relay.var("a", relay.TensorType((1000, 4), "float32"))
     y = relay.reinterpret(a, "int32")
@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import ctypes
+
 import numpy as np
 import pytest
 
@@ -166,6 +168,45 @@ def test_calibrate_memory_bound():
         relay.quantize.quantize(mod, params, dataset)
 
 
+def test_calibrate_histograms_non_finite():
+    from tvm.relay.quantize import _quantize
+
+    x = np.array([-1.0, np.nan, 0.5, 1.0, np.nan], "float32")
+    hists = tvm.nd.array(np.zeros((1, 11), "int64"))
+    thres = tvm.nd.array(np.array([1.0], "float32"))
+    # NaN values are skipped like numpy.histogram does.
+    _quantize.AccumulateHistograms([tvm.nd.array(x)], hists, thres)
+    hist, _ = np.histogram(x[~np.isnan(x)], bins=11, range=(-1.0, 1.0))
+    np.testing.assert_equal(hists.numpy()[0], hist)
+
+    with pytest.raises(tvm.TVMError):
+        _quantize.AccumulateHistograms(
+            [tvm.nd.array(x)], tvm.nd.array(np.zeros((1, 11), "int32")), thres
+        )
+    with pytest.raises(tvm.TVMError):
+        _quantize.AccumulateHistograms(
+            [tvm.nd.array(x)], hists, tvm.nd.array(np.array([np.inf], "float32"))
+        )
+
+    # An infinite activation has no histogram range.
+    mod, params = testing.synthetic.get_workload()
+    dataset = get_calibration_dataset(mod, "data")
+    dataset[0]["data"][:] = np.inf
+    with relay.quantize.qconfig(calibrate_mode="kl_divergence"):
+        with pytest.raises(ValueError):
+            relay.quantize.quantize(mod, params, dataset)
+
+
+def test_calibrate_kl_generator():
+    mod, params = testing.synthetic.get_workload()
+    dataset = get_calibration_dataset(mod, "data")
+    with relay.quantize.qconfig(calibrate_mode="kl_divergence"):
+        expected = relay.quantize.quantize(mod, params, dataset)
+        # A generator can be traversed only once.
+        actual = relay.quantize.quantize(mod, params, (batch for batch in dataset))
+    tvm.ir.assert_structural_equal(actual, expected)
+
+
 def test_calibrate_percentile():
     mod, params = testing.synthetic.get_workload()
     dataset = get_calibration_dataset(mod, "data")
@@ -173,6 +214,44 @@ def test_calibrate_percentile():
         relay.quantize.quantize(mod, params, dataset)
 
 
+def test_calibrate_histograms_match_numpy():
+    from tvm.relay.quantize import _quantize
+
+    num_bins = 8001
+    layers = [
+        np.random.normal(size=(4, 1000)).astype("float32"),
+        np.random.uniform(0, 3, size=(2, 777)).astype("float32"),
+    ]
+    min_max = np.empty((2, 2), "float32")
+    min_max[:, 0] = np.inf
+    min_max[:, 1] = -np.inf
+    min_max = tvm.nd.array(min_max)
+    hists = tvm.nd.array(np.zeros((2, num_bins), "int64"))
+    # Streaming over two batches gives the statistics of the whole data.
+    batches = [[tvm.nd.array(x[: len(x) // 2]) for x in layers]]
+    batches += [[tvm.nd.array(x[len(x) // 2 :]) for x in layers]]
+    for batch in batches:
+        _quantize.AccumulateMinMax(batch, min_max)
+    np.testing.assert_equal(min_max.numpy()[:, 0], [x.min() for x in layers])
+    np.testing.assert_equal(min_max.numpy()[:, 1], [x.max() for x in layers])
+    thres = np.abs(min_max.numpy()).max(axis=1)
+    thres_nd = tvm.nd.array(thres)
+    for batch in batches:
+        _quantize.AccumulateHistograms(batch, hists, thres_nd)
+
+    scales = _quantize.FindScalesByKLMinimization(hists, thres_nd, 255).numpy()
+    for j, x in enumerate(layers):
+        hist, _ = np.histogram(x, bins=num_bins, range=(-thres[j], thres[j]))
+        # Bin boundaries may differ by rounding for values right on an edge.
+        assert np.abs(hists.numpy()[j] - hist).sum() <= 2
+        hist = hists.numpy()[j].astype("int32")
+        edges = np.linspace(-thres[j], thres[j], num_bins + 1).astype("float32")
+        expected = _quantize.FindScaleByKLMinimization(
+            ctypes.c_void_p(hist.ctypes.data), ctypes.c_void_p(edges.ctypes.data), num_bins, 255
+        )
+        np.testing.assert_allclose(scales[j], expected, rtol=1e-5)
+
+
 ####################################
 # Quant/Dequant Partitioning Tests #
 ####################################
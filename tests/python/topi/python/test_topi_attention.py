@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test code for attention"""
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import te, topi
+from tvm.topi.utils import get_const_tuple
+
+
+implementation = tvm.testing.parameter("flash", "naive")
+causal_mask = tvm.testing.parameter(None, "TopLeft", "BottomRight")
+bias_ndim = tvm.testing.parameter(None, 2, 3, 4)
+seq_lens = tvm.testing.parameter((1, 1), (37, 37), (16, 100), (100, 16))
+
+
+def attention_python(q, k, v, bias, scale, causal_mask):
+    """Reference attention in numpy with BSNH layout."""
+    num_queries, num_keys = q.shape[1], k.shape[1]
+    score = np.einsum("bind,bjnd->bnij", q, k) * scale
+    if bias is not None:
+        if bias.ndim == 4:
+            score = score + bias
+        elif bias.ndim == 3:
+            score = score + bias[:, None, :, :]
+        else:
+            score = score + bias[:, None, None, :]
+    visible = np.ones((num_queries, num_keys), dtype=bool)
+    if causal_mask is not None:
+        offset = 0 if causal_mask == "TopLeft" else num_keys - num_queries
+        visible = np.arange(num_keys)[None, :] <= np.arange(num_queries)[:, None] + offset
+        score = np.where(visible, score, -np.inf)
+    score = score - np.max(np.where(visible, score, np.finfo("float32").min), -1, keepdims=True)
+    prob = np.exp(score)
+    denom = np.sum(prob, -1, keepdims=True)
+    prob = np.divide(prob, denom, out=np.zeros_like(prob), where=denom > 0)
+    return np.einsum("bnij,bjne->bine", prob, v).astype(q.dtype)
+
+
+@tvm.testing.parametrize_targets("llvm")
+def test_attention(target, dev, implementation, causal_mask, bias_ndim, seq_lens):
+    batch, num_heads, head_dim, head_dim_v = 2, 3, 16, 20
+    num_queries, num_keys = seq_lens
+    scale = 0.25
+
+    q = te.placeholder((batch, num_queries, num_heads, head_dim), name="q")
+    k = te.placeholder((batch, num_keys, num_heads, head_dim), name="k")
+    v = te.placeholder((batch, num_keys, num_heads, head_dim_v), name="v")
+    bias_shape = {
+        2: (batch, num_keys),
+        3: (batch, num_queries, num_keys),
+        4: (batch, num_heads, num_queries, num_keys),
+    }
+    bias = None if bias_ndim is None else te.placeholder(bias_shape[bias_ndim], name="bias")
+
+    te_func = topi.nn.flash_attention if implementation == "flash" else topi.nn.attention
+    out = te_func(q, k, v, bias, scale=scale, causal_mask=causal_mask)
+    args = [q, k, v] + ([bias] if bias is not None else []) + [out]
+    func = tvm.build(te.create_prim_func(args), target=target)
+
+    np_args = [np.random.uniform(-1, 1, get_const_tuple(t.shape)).astype("float32") for t in args]
+    bias_np = np_args[3] if bias is not None else None
+    ref = attention_python(np_args[0], np_args[1], np_args[2], bias_np, scale, causal_mask)
+    tvm_args = [tvm.nd.array(arr, dev) for arr in np_args]
+    func(*tvm_args)
+    tvm.testing.assert_allclose(tvm_args[-1].numpy(), ref, rtol=1e-4, atol=1e-5)
+
+
+@tvm.testing.parametrize_targets("llvm")
+def test_flash_attention_default_scale(target, dev):
+    q = te.placeholder((1, 70, 2, 64), name="q", dtype="float16")
+    k = te.placeholder((1, 70, 2, 64), name="k", dtype="float16")
+    v = te.placeholder((1, 70, 2, 64), name="v", dtype="float16")
+    out = topi.nn.flash_attention(q, k, v, causal_mask="TopLeft")
+    func = tvm.build(te.create_prim_func([q, k, v, out]), target=target)
+
+    np_args = [
+        np.random.uniform(-1, 1, get_const_tuple(t.shape)).astype("float16") for t in (q, k, v)
+    ]
+    ref = attention_python(*[arr.astype("float32") for arr in np_args], 1 / 8, "TopLeft")
+    tvm_args = [tvm.nd.array(arr, dev) for arr in np_args] + [
+        tvm.nd.empty(get_const_tuple(out.shape), "float16", dev)
+    ]
+    func(*tvm_args)
+    tvm.testing.assert_allclose(tvm_args[-1].numpy(), ref, rtol=1e-2, atol=1e-2)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
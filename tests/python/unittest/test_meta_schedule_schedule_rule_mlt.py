@@ -884,5 +884,31 @@ def test_max_pool_blocked():
     )
 
 
+def test_cpu_matmul_with_packing():
+    mod = te.create_prim_func(te_workload.matmul(512, 512, 512))
+    actual = generate_design_space(
+        kind="llvm",
+        mod=mod,
+        target=Target("llvm"),
+        types=None,
+        sch_rules=[
+            ms.schedule_rule.MultiLevelTilingWithPacking(
+                structure="SSRSRS",
+                max_innermost_factor=64,
+            )
+        ],
+    )
+    # One design space packs the operands in place, the other pipelines the packing.
+    assert len(actual) == 2
+    pipelined = []
+    for sch in actual:
+        insts = sch.trace.insts
+        cache_reads = [inst for inst in insts if inst.kind.name == "CacheRead"]
+        assert [inst.attrs[1] for inst in cache_reads] == ["global", "global"]
+        annotations = [inst.attrs[0] for inst in insts if inst.kind.name == "Annotate"]
+        pipelined.append("software_pipeline_stage" in annotations)
+    assert sorted(pipelined) == [False, True]
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,68 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the memory placement policy of the CPU device API."""
+import os
+import subprocess
+import sys
+
+import tvm.testing
+
+alloc_py = """
+import numpy as np
+import tvm
+
+for dev in [tvm.cpu(0), tvm.cpu(1)]:
+    # both below and above the huge page threshold
+    for n in [16, 4096, 1 << 20]:
+        x = np.random.uniform(size=n).astype("float32")
+        y = tvm.nd.array(x, dev)
+        z = tvm.nd.empty((n,), "float32", dev)
+        y.copyto(z)
+        np.testing.assert_equal(z.numpy(), x)
+        del y, z
+print("ok")
+"""
+
+
+def _run_with_env(env):
+    proc = subprocess.run(
+        [sys.executable, "-c", alloc_py],
+        env={**os.environ, **env},
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+    )
+    assert proc.returncode == 0, f"{env} exited with {proc.returncode}: {proc.stdout}"
+
+
+def test_numa_bind():
+    # Device ids beyond the available nodes fall back to unbound allocations.
+    _run_with_env({"TVM_CPU_NUMA_BIND": "1"})
+
+
+def test_huge_page():
+    for mode in ["transparent", "explicit"]:
+        _run_with_env(
+            {
+                "TVM_CPU_NUMA_BIND": "1",
+                "TVM_CPU_HUGE_PAGE": mode,
+                "TVM_CPU_HUGE_PAGE_MIN_BYTES": str(1 << 16),
+            }
+        )
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
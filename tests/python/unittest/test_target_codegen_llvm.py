@@ -28,6 +28,7 @@ import tvm.testing
 from tvm import te
 from tvm.contrib import clang, utils
 from tvm.relay.backend import Runtime
+from tvm.script import ir as I
 from tvm.script import tir as T
 from tvm.target.codegen import llvm_get_intrinsic_name, llvm_lookup_intrinsic_id
 
@@ -978,5 +979,216 @@ def test_llvm_target_attributes():
         assert n in functions_with_target
 
 
+@tvm.testing.requires_llvm
+def test_llvm_call_packed_same_module():
+    """Packed calls to a function of the same module are direct calls, without a handle lookup."""
+
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+            T.func_attr({"global_symbol": "add_one"})
+            for i in range(16):
+                B[i] = A[i] + T.float32(1)
+
+        @T.prim_func
+        def main(
+            A: T.Buffer((16,), "float32"),
+            B: T.Buffer((16,), "float32"),
+            C: T.Buffer((16,), "float32"),
+        ):
+            T.func_attr({"global_symbol": "main"})
+            T.evaluate(T.call_packed("add_one", A, B))
+            T.evaluate(T.call_packed("add_one", B, C))
+
+    module = tvm.build(Module, target="llvm")
+    llvm_ir = module.get_source("ll")
+    assert ".tvm_func.add_one" not in llvm_ir
+    assert re.search(r"call i32 @add_one\(", llvm_ir)
+
+    dev = tvm.cpu()
+    a = tvm.nd.array(np.random.rand(16).astype("float32"), dev)
+    b = tvm.nd.empty((16,), "float32", dev)
+    c = tvm.nd.empty((16,), "float32", dev)
+    module["main"](a, b, c)
+    tvm.testing.assert_allclose(c.numpy(), a.numpy() + 2, rtol=1e-6)
+
+
+def _build_predicated_tail(target):
+    @T.prim_func
+    def func(a: T.handle, b: T.handle, n: T.int32):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        A = T.match_buffer(a, (n,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i_0 in range((n + 7) // 8):
+            for i_1 in T.vectorized(8):
+                if i_0 * 8 + i_1 < n:
+                    B[i_0 * 8 + i_1] = A[i_0 * 8 + i_1] + T.float32(1)
+
+    # The target is only passed to the build, without entering its scope.
+    return tvm.build(func, target=target)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_predicated_tail():
+    """Bounds-guarded vectorized loops use masked loads and stores."""
+    module = _build_predicated_tail("llvm")
+    llvm_ir = module.get_source("ll")
+    assert "llvm.masked.load" in llvm_ir
+    assert "llvm.masked.store" in llvm_ir
+
+    dev = tvm.cpu()
+    for n in [1, 8, 37]:
+        a = tvm.nd.array(np.random.rand(n).astype("float32"), dev)
+        b = tvm.nd.empty((n,), "float32", dev)
+        module["main"](a, b, n)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1, rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+@tvm.testing.requires_x86_avx2
+def test_llvm_predicated_tail_avx2():
+    module = _build_predicated_tail("llvm -mcpu=core-avx2")
+    assert "vmaskmovps" in module.get_source("asm")
+
+    dev = tvm.cpu()
+    a = tvm.nd.array(np.random.rand(13).astype("float32"), dev)
+    b = tvm.nd.empty((13,), "float32", dev)
+    module["main"](a, b, 13)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1, rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+@tvm.testing.requires_skylake_avx512
+def test_llvm_predicated_tail_avx512():
+    module = _build_predicated_tail("llvm -mcpu=skylake-avx512")
+    assert re.search(r"\{%k[1-7]\}", module.get_source("asm"))
+
+    dev = tvm.cpu()
+    a = tvm.nd.array(np.random.rand(13).astype("float32"), dev)
+    b = tvm.nd.empty((13,), "float32", dev)
+    module["main"](a, b, 13)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1, rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_gather_scatter():
+    """Vector accesses through an index buffer or a stride use gather/scatter."""
+
+    @T.prim_func
+    def func(
+        A: T.Buffer((64,), "float32"),
+        idx: T.Buffer((16,), "int32"),
+        B: T.Buffer((16,), "float32"),
+        C: T.Buffer((48,), "float32"),
+    ):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i_0 in range(2):
+            for i_1 in T.vectorized(8):
+                B[i_0 * 8 + i_1] = A[idx[i_0 * 8 + i_1]]
+        for i_0 in range(2):
+            for i_1 in T.vectorized(8):
+                C[(i_0 * 8 + i_1) * 3] = A[(i_0 * 8 + i_1) * 2]
+
+    module = tvm.build(func, target="llvm")
+    llvm_ir = module.get_source("ll")
+    assert "llvm.masked.gather" in llvm_ir
+    assert "llvm.masked.scatter" in llvm_ir
+
+    dev = tvm.cpu()
+    a_np = np.random.rand(64).astype("float32")
+    idx_np = np.random.randint(0, 64, size=16).astype("int32")
+    a = tvm.nd.array(a_np, dev)
+    idx = tvm.nd.array(idx_np, dev)
+    b = tvm.nd.empty((16,), "float32", dev)
+    c = tvm.nd.array(np.zeros(48, "float32"), dev)
+    module["main"](a, idx, b, c)
+    tvm.testing.assert_allclose(b.numpy(), a_np[idx_np])
+    tvm.testing.assert_allclose(c.numpy()[::3], a_np[:32:2])
+
+
+@tvm.testing.requires_llvm
+def test_llvm_predicated_embedding_lookup():
+    """A bounds-guarded lookup vectorizes to a masked gather."""
+
+    @T.prim_func
+    def func(a: T.handle, i: T.handle, b: T.handle, n: T.int32):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        A = T.match_buffer(a, (1024,), "float32")
+        idx = T.match_buffer(i, (n,), "int32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i_0 in range((n + 7) // 8):
+            for i_1 in T.vectorized(8):
+                if i_0 * 8 + i_1 < n:
+                    B[i_0 * 8 + i_1] = A[idx[i_0 * 8 + i_1]]
+
+    with tvm.target.Target("llvm"):
+        module = tvm.build(func)
+    assert "llvm.masked.gather" in module.get_source("ll")
+
+    dev = tvm.cpu()
+    a_np = np.random.rand(1024).astype("float32")
+    idx_np = np.random.randint(0, 1024, size=21).astype("int32")
+    b = tvm.nd.empty((21,), "float32", dev)
+    module["main"](tvm.nd.array(a_np, dev), tvm.nd.array(idx_np, dev), b, 21)
+    tvm.testing.assert_allclose(b.numpy(), a_np[idx_np])
+
+
+@tvm.testing.requires_llvm
+def test_llvm_predicated_strided():
+    """A bounds-guarded strided access is masked through a gather and a scatter."""
+
+    @T.prim_func
+    def func(a: T.handle, b: T.handle, n: T.int32):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        A = T.match_buffer(a, (n * 3,), "float32")
+        B = T.match_buffer(b, (n * 2,), "float32")
+        for i_0 in range((n + 7) // 8):
+            for i_1 in T.vectorized(8):
+                if i_0 * 8 + i_1 < n:
+                    B[(i_0 * 8 + i_1) * 2] = A[(i_0 * 8 + i_1) * 3]
+
+    module = tvm.build(func, target="llvm")
+    llvm_ir = module.get_source("ll")
+    assert "llvm.masked.gather" in llvm_ir
+    assert "llvm.masked.scatter" in llvm_ir
+
+    dev = tvm.cpu()
+    n = 13
+    a_np = np.random.rand(n * 3).astype("float32")
+    b = tvm.nd.array(np.zeros(n * 2, "float32"), dev)
+    module["main"](tvm.nd.array(a_np, dev), b, n)
+    tvm.testing.assert_allclose(b.numpy()[::2], a_np[::3])
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("dtype", ["float32", "int32"])
+def test_llvm_vector_reduce(dtype):
+    """Vectorized accumulation into a single element uses llvm.vector.reduce."""
+
+    @T.prim_func
+    def func(A: T.Buffer((64,), dtype), B: T.Buffer((3,), dtype)):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        B[0] = T.Cast(dtype, 0)
+        B[1] = A[0]
+        B[2] = A[0]
+        for i_0 in range(8):
+            for i_1 in T.vectorized(8):
+                B[0] = B[0] + A[i_0 * 8 + i_1]
+                B[1] = T.max(B[1], A[i_0 * 8 + i_1])
+                B[2] = T.min(B[2], A[i_0 * 8 + i_1])
+
+    with tvm.target.Target("llvm"):
+        module = tvm.build(func)
+    assert "llvm.vector.reduce" in module.get_source("ll")
+
+    dev = tvm.cpu()
+    a_np = np.random.randint(-100, 100, size=64).astype(dtype)
+    b = tvm.nd.empty((3,), dtype, dev)
+    module["main"](tvm.nd.array(a_np, dev), b)
+    expected = np.array([a_np.sum(), a_np.max(), a_np.min()], dtype)
+    tvm.testing.assert_allclose(b.numpy(), expected, rtol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -1559,5 +1559,71 @@ def test_async_nested_pipeline_mma_gemm_ideal_annotation():
     build_and_run(sch)
 
 
+def _packed_gemm_schedule(annotations):
+    sch = tir.Schedule(te.create_prim_func(te_workload.matmul(64, 64, 64)))
+    block = sch.get_block("C")
+    i, j, k = sch.get_loops(block)
+    ko, ki = sch.split(k, [8, 8])
+    sch.reorder(ko, i, j, ki)
+    sch.decompose_reduction(block, ko)
+    for read_index in range(2):
+        pack = sch.cache_read(block, read_index, "global")
+        sch.compute_at(pack, ko)
+    for key, value in annotations.items():
+        sch.annotate(ko, key, value)
+    return sch
+
+
+def _check_packed_gemm(sch):
+    with tvm.target.Target("llvm"):
+        mod = tvm.lower(sch.mod)
+        f = tvm.build(sch.mod["main"])
+    dev = tvm.cpu()
+    a_np = np.random.uniform(size=(64, 64)).astype("float32")
+    b_np = np.random.uniform(size=(64, 64)).astype("float32")
+    a = tvm.nd.array(a_np, dev)
+    b = tvm.nd.array(b_np, dev)
+    c = tvm.nd.array(np.zeros((64, 64), dtype="float32"), dev)
+    f(a, b, c)
+    tvm.testing.assert_allclose(c.numpy(), np.dot(a_np, b_np), rtol=1e-5)
+    return mod
+
+
+@tvm.testing.requires_llvm
+def test_cpu_packed_gemm_pipeline():
+    sch = _packed_gemm_schedule(
+        {"software_pipeline_stage": [0, 0, 1], "software_pipeline_order": [0, 1, 2]}
+    )
+    mod = _check_packed_gemm(sch)
+    # Both packed panels are double buffered.
+    allocs = {}
+    tvm.tir.stmt_functor.post_order_visit(
+        mod["main"].body,
+        lambda x: allocs.update({x.buffer_var.name: x.extents})
+        if isinstance(x, tvm.tir.Allocate)
+        else None,
+    )
+    assert [int(e) for e in allocs["A_global"]] == [2 * 64 * 8]
+    assert [int(e) for e in allocs["B_global"]] == [2 * 8 * 64]
+
+
+@tvm.testing.requires_llvm
+def test_cpu_ignores_async_stages():
+    sch = _packed_gemm_schedule(
+        {
+            "software_pipeline_stage": [0, 0, 1],
+            "software_pipeline_order": [0, 1, 2],
+            "software_pipeline_async_stages": [0],
+        }
+    )
+    mod = _check_packed_gemm(sch)
+    attr_keys = set()
+    tvm.tir.stmt_functor.post_order_visit(
+        mod["main"].body,
+        lambda x: attr_keys.add(x.attr_key) if isinstance(x, tvm.tir.AttrStmt) else None,
+    )
+    assert not attr_keys & {"async_scope", "async_commit_queue_scope", "async_wait_queue_scope"}
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,120 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+@T.prim_func
+def transpose(A: T.Buffer((256, 256), "float32"), B: T.Buffer((256, 256), "float32")):
+    T.func_attr({"global_symbol": "main", "tir.noalias": True})
+    for i, j in T.grid(256, 256):
+        with T.block("B"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            B[vi, vj] = A[vj, vi]
+
+
+def _lower(func, target="llvm", config=None):
+    with tvm.transform.PassContext(config=config), tvm.target.Target(target):
+        return tvm.lower(func)
+
+
+def _prefetches(mod):
+    calls = []
+    tvm.tir.stmt_functor.post_order_visit(
+        mod["main"].body,
+        lambda x: calls.append(x)
+        if isinstance(x, tvm.tir.Call) and x.op.same_as(tvm.ir.Op.get("tir.prefetch"))
+        else None,
+    )
+    return calls
+
+
+def test_strided_read():
+    mod = _lower(transpose, config={"tir.InjectSoftwarePrefetch": {"distance": 8}})
+    calls = _prefetches(mod)
+    # Only the column-wise read of A is prefetched, the write of B is contiguous.
+    assert len(calls) == 1
+    load = calls[0].args[0].args[0]
+    assert load.buffer.name == "A"
+    # The address is clamped to the last iteration of the loop.
+    mins = []
+    tvm.tir.stmt_functor.post_order_visit(
+        load.indices[0], lambda x: mins.append(x) if isinstance(x, tvm.tir.Min) else None
+    )
+    assert len(mins) == 1
+
+
+def test_contiguous_read():
+    @T.prim_func
+    def copy(A: T.Buffer((256, 256), "float32"), B: T.Buffer((256, 256), "float32")):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        for i, j in T.grid(256, 256):
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[vi, vj]
+
+    mod = _lower(copy, config={"tir.InjectSoftwarePrefetch": {"distance": 8}})
+    assert not _prefetches(mod)
+
+
+def test_pragma_distance():
+    @T.prim_func
+    def func(A: T.Buffer((256, 256), "float32"), B: T.Buffer((256, 256), "float32")):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        with T.block("root"):
+            T.block_attr({"pragma_prefetch_distance": 4})
+            for i, j in T.grid(256, 256):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vj, vi]
+
+    mod = _lower(func)
+    assert len(_prefetches(mod)) == 1
+    attrs = []
+    tvm.tir.stmt_functor.post_order_visit(
+        mod["main"].body,
+        lambda x: attrs.append(x) if isinstance(x, tvm.tir.AttrStmt) else None,
+    )
+    assert all(attr.attr_key != "pragma_prefetch_distance" for attr in attrs)
+
+
+def test_disabled():
+    # No distance is set by default, and only LLVM lowers the prefetch intrinsic.
+    assert not _prefetches(_lower(transpose))
+    config = {"tir.InjectSoftwarePrefetch": {"distance": 8}}
+    assert not _prefetches(_lower(transpose, target="c", config=config))
+
+
+@tvm.testing.requires_llvm
+def test_run():
+    config = {"tir.InjectSoftwarePrefetch": {"distance": 8}}
+    # The target is only passed to the build, without entering its scope.
+    with tvm.transform.PassContext(config=config):
+        func = tvm.build(transpose, target="llvm")
+    assert "llvm.prefetch" in func.get_source("ll")
+    dev = tvm.cpu()
+    a = tvm.nd.array(np.random.rand(256, 256).astype("float32"), dev)
+    b = tvm.nd.empty((256, 256), "float32", dev)
+    func(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy().T)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
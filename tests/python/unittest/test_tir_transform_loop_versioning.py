@@ -0,0 +1,140 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+def _collect(stmt, node_type):
+    ret = []
+    tvm.tir.stmt_functor.post_order_visit(
+        stmt, lambda x: ret.append(x) if isinstance(x, node_type) else None
+    )
+    return ret
+
+
+@T.prim_func
+def guarded_add(a: T.handle, b: T.handle, n: T.int32):
+    T.func_attr({"global_symbol": "main", "tir.noalias": True})
+    A = T.match_buffer(a, (n,), "float32")
+    B = T.match_buffer(b, (n,), "float32")
+    for i_0 in T.serial((n + 7) // 8, annotations={"loop_versioning": 8}):
+        for i_1 in T.vectorized(8):
+            if i_0 * 8 + i_1 < n:
+                B[i_0 * 8 + i_1] = A[i_0 * 8 + i_1] + T.float32(1)
+
+
+def test_divisible_extent():
+    mod = tvm.IRModule.from_expr(guarded_add)
+    body = tvm.tir.transform.LoopVersioning()(mod)["main"].body
+
+    assert isinstance(body, tvm.tir.IfThenElse)
+    assert body.condition.op.same_as(tvm.ir.Op.get("tir.likely"))
+    assert isinstance(body.condition.args[0], tvm.tir.EQ)
+    assert isinstance(body.condition.args[0].a, tvm.tir.FloorMod)
+    # The fast version has its bound check folded, the fallback keeps it.
+    assert not _collect(body.then_case, tvm.tir.IfThenElse)
+    assert len(_collect(body.else_case, tvm.tir.IfThenElse)) == 1
+    for loop in _collect(body, tvm.tir.For):
+        assert "loop_versioning" not in loop.annotations
+
+
+def test_no_annotation():
+    @T.prim_func
+    def func(a: T.handle, b: T.handle, n: T.int32):
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        A = T.match_buffer(a, (n,), "float32")
+        B = T.match_buffer(b, (n,), "float32")
+        for i_0 in T.serial((n + 7) // 8):
+            for i_1 in T.vectorized(8):
+                if i_0 * 8 + i_1 < n:
+                    B[i_0 * 8 + i_1] = A[i_0 * 8 + i_1] + T.float32(1)
+
+    mod = tvm.IRModule.from_expr(func)
+    after = tvm.tir.transform.LoopVersioning()(mod)
+    tvm.ir.assert_structural_equal(after, mod)
+
+
+def test_non_aliasing():
+    @T.prim_func
+    def func(A: T.Buffer((64,), "float32"), B: T.Buffer((64,), "float32")):
+        T.func_attr({"global_symbol": "main"})
+        for i in T.serial(64, annotations={"loop_versioning": 1}):
+            B[i] = A[i] * T.float32(2)
+
+    mod = tvm.IRModule.from_expr(func)
+    body = tvm.tir.transform.LoopVersioning()(mod)["main"].body
+
+    assert isinstance(body, tvm.tir.IfThenElse)
+    assert isinstance(body.condition.args[0], tvm.tir.Or)
+    fast = body.then_case
+    noalias = []
+    while isinstance(fast, tvm.tir.AttrStmt):
+        assert fast.attr_key == "buffer_noalias"
+        noalias.append(fast.node.name)
+        fast = fast.body
+    assert sorted(noalias) == ["A", "B"]
+    assert isinstance(fast, tvm.tir.For)
+    assert isinstance(body.else_case, tvm.tir.For)
+
+
+@tvm.testing.requires_llvm
+def test_run_both_versions():
+    with tvm.target.Target("llvm"):
+        module = tvm.build(guarded_add)
+    dev = tvm.cpu()
+    # n = 16 takes the fast version, n = 13 the fallback.
+    for n in [16, 13]:
+        a = tvm.nd.array(np.random.rand(n).astype("float32"), dev)
+        b = tvm.nd.empty((n,), "float32", dev)
+        module["main"](a, b, n)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1, rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+def test_run_overlapping_buffers():
+    @T.prim_func
+    def shifted_add(a: T.handle, b: T.handle):
+        T.func_attr({"global_symbol": "main"})
+        A = T.match_buffer(a, (64,), "float32", offset_factor=1)
+        B = T.match_buffer(b, (64,), "float32", offset_factor=1)
+        for i in T.serial(64, annotations={"loop_versioning": 1}):
+            B[i] = A[i] + T.float32(1)
+
+    module = tvm.build(shifted_add, target="llvm")
+    dev = tvm.cpu()
+
+    # Disjoint buffers take the noalias version.
+    a_np = np.random.rand(64).astype("float32")
+    b = tvm.nd.empty((64,), "float32", dev)
+    module["main"](tvm.nd.array(a_np, dev), b)
+    tvm.testing.assert_allclose(b.numpy(), a_np + 1, rtol=1e-6)
+
+    # B starts one element after A, so every iteration reads the element written by the
+    # previous one. Only the original loop, taken when the overlap check fails, computes
+    # this recurrence; the noalias version may load A before the earlier stores.
+    base = tvm.nd.array(np.zeros(65, "float32"), dev)
+    a = base._create_strided_view((64,), (1,), byte_offset=0)
+    b = base._create_strided_view((64,), (1,), byte_offset=4)
+    module["main"](a, b)
+    tvm.testing.assert_allclose(base.numpy(), np.arange(65, dtype="float32"))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -119,6 +119,35 @@ def test_lower_floormod():
         check_value(res, x, y, [(a, b) for a, b in data if b == 8], lambda a, b: a % b)
 
 
+@tvm.testing.requires_llvm
+def test_lower_q_multiply_shift_vector():
+    lanes = 8
+    x = tvm.tir.Var("x", "int32x%d" % lanes)
+    y = tvm.tir.Broadcast(tvm.tir.const(1518500250, "int32"), lanes)
+    for q in [tvm.tir.const(31, "int32"), tvm.tir.Broadcast(tvm.tir.const(31, "int32"), lanes)]:
+        s = tvm.tir.Broadcast(tvm.tir.const(-3, "int32"), lanes)
+        expr = tvm.tir.call_intrin(x.dtype, "tir.q_multiply_shift", x, y, q, s)
+        res = lower_intrin([x], expr)
+
+        # Constant shifts only widen for the multiply-high, the rounding shift stays in int32.
+        shifts = []
+
+        def visit(node):
+            if isinstance(node, tvm.tir.Call) and node.op.same_as(tvm.ir.Op.get("tir.shift_right")):
+                shifts.append(node)
+
+        tvm.tir.stmt_functor.post_order_visit(tvm.tir.Evaluate(res), visit)
+        assert shifts
+        for shift in shifts:
+            if shift.dtype.startswith("int64"):
+                amount = shift.args[1]
+                amount = amount.value if isinstance(amount, tvm.tir.Broadcast) else amount
+                assert isinstance(amount, tvm.tir.IntImm) and amount.value == 32, res
+            else:
+                assert shift.dtype == "int32x%d" % lanes, res
+
+
 if __name__ == "__main__":
     test_lower_floordiv()
     test_lower_floormod()
+    test_lower_q_multiply_shift_vector()
@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import json
+
 import tvm
 import tvm.testing
 from tvm import te
@@ -336,5 +338,63 @@ def test6():
     tvm.ir.assert_structural_equal(mod["main"], test6_expected_output)
 
 
+@T.prim_func
+def loop_count_input(A: T.Buffer((64, 4), "float32"), B: T.Buffer((64, 4), "float32")):
+    T.func_attr({"global_symbol": "main"})
+    for i in T.serial(64):
+        for j in T.serial(4):
+            if i < 63:
+                B[i, j] = A[i, j] * T.float32(2)
+            else:
+                B[i, j] = A[i, j]
+
+
+def _extern_calls(stmt):
+    calls = []
+
+    def _visit(node):
+        if isinstance(node, tvm.tir.Call) and node.op.same_as(tvm.ir.Op.get("tir.call_extern")):
+            calls.append((node.args[0].value, node.args[2].value))
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, _visit)
+    return calls
+
+
+# test7: The loop count mode records every loop entry and every branch evaluation.
+def test7():
+    mod = tvm.IRModule({"main": loop_count_input})
+    mod = tvm.tir.transform.InstrumentLoopCounts()(mod)
+    calls = _extern_calls(mod["main"].body)
+    assert sorted(calls) == [
+        ("TVMBackendProfileBranch", 0),
+        ("TVMBackendProfileLoop", 0),
+        ("TVMBackendProfileLoop", 1),
+    ]
+
+
+# test8: A recorded profile unrolls the hot inner loop and marks the biased branch as likely.
+@tvm.testing.requires_llvm
+def test8(tmp_path):
+    mod = tvm.IRModule({"main": loop_count_input})
+    with tvm.transform.PassContext(config={"tir.instrument_loop_counts": True}):
+        f = tvm.build(mod, target="llvm")
+    a = tvm.nd.array(numpy.ones((64, 4), "float32"))
+    b = tvm.nd.empty((64, 4), "float32")
+    tvm.runtime.profiling.reset_loop_profile()
+    f["main"](a, b)
+    profile_path = str(tmp_path / "loops.json")
+    profile = json.loads(tvm.runtime.profiling.dump_loop_profile(profile_path))
+    assert profile["main"]["loops"] == [[0, 1, 64], [1, 64, 256]]
+    assert profile["main"]["branches"] == [[0, 256, 252]]
+
+    with tvm.transform.PassContext(config={"tir.ApplyLoopProfile": {"profile": profile_path}}):
+        mod = tvm.tir.transform.ApplyLoopProfile()(mod)
+    outer = mod["main"].body
+    inner = outer.body
+    assert outer.kind == tvm.tir.ForKind.SERIAL
+    assert inner.kind == tvm.tir.ForKind.UNROLLED
+    assert inner.body.condition.op.same_as(tvm.ir.Op.get("tir.likely"))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -673,6 +673,38 @@ def test_access_in_let_value():
     tvm.ir.assert_structural_equal(mod["main"], func_rewritten)
 
 
+def test_allocate_in_workspace():
+    @T.prim_func
+    def func(A: T.Buffer((512,), "float32"), W: T.Buffer((4096,), "uint8")):
+        T.func_attr({"tir.workspace_param": 1})
+        B_data = T.allocate((512,), "float32", "global")
+        B = T.Buffer(shape=[512], dtype="float32", data=B_data)
+        C_data = T.allocate((512,), "float32", "global")
+        C = T.Buffer(shape=[512], dtype="float32", data=C_data)
+        D_data = T.allocate((4,), "float32", "global")
+        D = T.Buffer(shape=[4], dtype="float32", data=D_data)
+        for i in range(512):
+            B[i] = A[i]
+        for i in range(512):
+            C[i] = B[i] + A[i]
+        for i in range(512):
+            D[i % 4] = C[i]
+            A[i] = C[i] + B[i] + D[i % 4]
+
+    mod = tvm.tir.transform.StorageRewrite()(tvm.IRModule.from_expr(func))
+    body = mod["main"].body
+    offsets = []
+    while isinstance(body, (tvm.tir.LetStmt, tvm.tir.Allocate, tvm.tir.DeclBuffer)):
+        if isinstance(body, tvm.tir.LetStmt):
+            assert body.value.op.same_as(tvm.ir.Op.get("tir.address_of"))
+            offsets.append(body.value.args[0].indices[0].value)
+        else:
+            # Buffers small enough for the stack are left alone.
+            assert not isinstance(body, tvm.tir.Allocate) or body.extents[0].value == 4
+        body = body.body
+    assert sorted(offsets) == [0, 2048]
+
+
 class BaseCompare(tvm.testing.CompareBeforeAfter):
     transform = tvm.tir.transform.StorageRewrite()
 
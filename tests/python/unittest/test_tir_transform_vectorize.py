@@ -171,6 +171,171 @@ def test_vectorize_if_then_else():
     assert isinstance(stmt.body.value.args[2], tvm.tir.Broadcast)
 
 
+def _vectorize_for_llvm(stmt, *params):
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc(list(params), stmt))
+    with tvm.target.Target("llvm"):
+        return tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+
+def test_vectorize_predicated_store():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            B[i] = A[i] + 1
+    stmt = _vectorize_for_llvm(ib.get(), A, B, n)
+
+    assert isinstance(stmt, tvm.tir.Evaluate)
+    store = stmt.value
+    assert store.op.same_as(tvm.ir.Op.get("tir.masked_store"))
+    assert isinstance(store.args[0].args[0].indices[0], tvm.tir.Ramp)
+    assert store.args[1].dtype == "float32x4"
+    assert store.args[2].dtype == "boolx4"
+    load = store.args[1].a
+    assert load.op.same_as(tvm.ir.Op.get("tir.masked_load"))
+    assert load.args[1].same_as(store.args[2])
+
+
+def test_vectorize_predicated_store_scalar_cond():
+    n = te.var("n")
+    x = te.var("x")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(tvm.tir.all(x < n, i < n)):
+            A[i] = 1.0
+        with ib.else_scope():
+            A[i] = 2.0
+    stmt = _vectorize_for_llvm(ib.get(), A, n, x)
+
+    # The scalar part of the condition stays a branch, the vector part
+    # becomes the mask of both stores.
+    assert isinstance(stmt, tvm.tir.IfThenElse)
+    assert stmt.condition.dtype == "bool"
+    assert isinstance(stmt.then_case, tvm.tir.SeqStmt)
+    masks = [s.value.args[2] for s in stmt.then_case]
+    assert isinstance(masks[1], tvm.tir.Not)
+    assert masks[1].a.same_as(masks[0])
+    assert isinstance(stmt.else_case, tvm.tir.BufferStore)
+    assert stmt.else_case.value.dtype == "float32x4"
+
+
+def test_vectorize_predicated_if_then_else_expr():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n) as k:
+        with ib.for_range(0, 4, kind="vectorize") as i:
+            B[k * 4 + i] = tvm.tir.call_intrin(
+                "float32", "tir.if_then_else", k * 4 + i < n, A[k * 4 + i], 0.0
+            )
+    stmt = _vectorize_for_llvm(ib.get(), A, B, n)
+
+    assert isinstance(stmt.body, tvm.tir.BufferStore)
+    value = stmt.body.value
+    assert isinstance(value, tvm.tir.Select)
+    assert value.true_value.op.same_as(tvm.ir.Op.get("tir.masked_load"))
+    assert isinstance(value.false_value, tvm.tir.Broadcast)
+
+
+def test_vectorize_predicated_gather():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            B[i] = A[i * 2]
+    stmt = _vectorize_for_llvm(ib.get(), A, B, n)
+
+    # The strided load becomes a masked gather.
+    assert isinstance(stmt, tvm.tir.Evaluate)
+    load = stmt.value.args[1]
+    assert load.op.same_as(tvm.ir.Op.get("tir.masked_load"))
+    index = load.args[0].args[0].indices[0]
+    assert isinstance(index, tvm.tir.Ramp)
+    assert index.stride.value == 2
+
+
+def test_vectorize_predicated_scatter():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    idx = ib.pointer("int32", name="idx")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            B[idx[i]] = A[i]
+    stmt = _vectorize_for_llvm(ib.get(), A, B, idx, n)
+
+    assert isinstance(stmt, tvm.tir.Evaluate)
+    store = stmt.value
+    assert store.op.same_as(tvm.ir.Op.get("tir.masked_store"))
+    # The index vector itself is loaded under the mask.
+    index = store.args[0].args[0].indices[0]
+    assert index.op.same_as(tvm.ir.Op.get("tir.masked_load"))
+
+
+def test_vectorize_reduction():
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        B[0] = B[0] + A[i]
+        B[1] = tvm.te.max(B[1], A[i])
+        B[2] = tvm.te.min(B[2], A[i])
+    stmt = _vectorize_for_llvm(ib.get(), A, B)
+
+    assert isinstance(stmt, tvm.tir.SeqStmt)
+    for store, name in zip(stmt, ["sum", "max", "min"]):
+        assert isinstance(store, tvm.tir.BufferStore)
+        assert store.indices[0].dtype == "int32"
+        reduce = store.value.b
+        assert reduce.op.same_as(tvm.ir.Op.get("tir.vector_reduce_" + name))
+        assert reduce.args[0].dtype == "float32x4"
+
+
+def test_vectorize_reduction_with_other_access():
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    C = ib.pointer("float32", name="C")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        B[0] = B[0] + A[i]
+        C[i] = B[0]
+    stmt = _vectorize_for_llvm(ib.get(), A, B, C)
+
+    # The running sums stored to C require the serial update.
+    reduces = []
+    tvm.tir.stmt_functor.post_order_visit(
+        stmt,
+        lambda x: reduces.append(x)
+        if isinstance(x, tvm.tir.Call) and x.op.name.startswith("tir.vector_reduce")
+        else None,
+    )
+    assert not reduces
+    assert isinstance(stmt, tvm.tir.For)
+    assert stmt.kind == tvm.tir.ForKind.SERIAL
+
+
+def test_vectorize_reduction_scalarized():
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        B[0] = B[0] + A[i]
+    stmt = ib.get()
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, B], stmt))
+    stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    # Without an LLVM target the update is kept as a serial loop.
+    assert isinstance(stmt, tvm.tir.For)
+    assert stmt.kind == tvm.tir.ForKind.SERIAL
+
+
 def test_vectorize_while_fail():
     """A while loop inside a vectorized loop should fail."""
 
@@ -234,5 +399,13 @@ if __name__ == "__main__":
     test_vectorize_with_le_cond()
     test_vectorize_with_ge_cond()
     test_vectorize_let()
+    test_vectorize_predicated_store()
+    test_vectorize_predicated_store_scalar_cond()
+    test_vectorize_predicated_if_then_else_expr()
+    test_vectorize_predicated_gather()
+    test_vectorize_predicated_scatter()
+    test_vectorize_reduction()
+    test_vectorize_reduction_with_other_access()
+    test_vectorize_reduction_scalarized()
     test_vectorize_while_fail()
     test_vectorize_dtype_mismatch()
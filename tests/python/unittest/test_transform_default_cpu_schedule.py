@@ -0,0 +1,154 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name,,missing-function-docstring
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+from tvm.tir.transform import DefaultCPUSchedule
+
+
+# pylint: disable=no-self-argument,missing-class-docstring
+@tvm.script.ir_module
+class Module:
+    @T.prim_func
+    def matmul(
+        A: T.Buffer((T.int64(256), T.int64(256)), "float32"),
+        B: T.Buffer((T.int64(256), T.int64(256)), "float32"),
+        C: T.Buffer((T.int64(256), T.int64(256)), "float32"),
+    ):
+        T.func_attr({"tir.noalias": True})
+        for i, j, k in T.grid(T.int64(256), T.int64(256), T.int64(256)):
+            with T.block("matmul"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                with T.init():
+                    C[vi, vj] = T.float32(0)
+                C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
+    @T.prim_func
+    def add(
+        A: T.Buffer((T.int64(512), T.int64(512)), "float32"),
+        B: T.Buffer((T.int64(512), T.int64(512)), "float32"),
+    ):
+        T.func_attr({"tir.noalias": True})
+        for i, j in T.grid(T.int64(512), T.int64(512)):
+            with T.block("add"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[vi, vj] + T.float32(1)
+
+    @T.prim_func
+    def add_small(
+        A: T.Buffer((T.int64(4), T.int64(8)), "float32"),
+        B: T.Buffer((T.int64(4), T.int64(8)), "float32"),
+    ):
+        T.func_attr({"tir.noalias": True})
+        for i, j in T.grid(T.int64(4), T.int64(8)):
+            with T.block("add"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[vi, vj] + T.float32(1)
+
+    @T.prim_func
+    def row_sum(
+        A: T.Buffer((T.int64(512), T.int64(512)), "float32"),
+        B: T.Buffer((T.int64(512),), "float32"),
+    ):
+        T.func_attr({"tir.noalias": True})
+        for i, k in T.grid(T.int64(512), T.int64(512)):
+            with T.block("sum"):
+                vi, vk = T.axis.remap("SR", [i, k])
+                with T.init():
+                    B[vi] = T.float32(0)
+                B[vi] = B[vi] + A[vi, vk]
+
+
+# pylint: enable=no-self-argument,missing-class-docstring
+
+
+def _loop_kinds(func):
+    kinds = []
+    tvm.tir.stmt_functor.post_order_visit(
+        func.body, lambda n: kinds.append(n.kind) if isinstance(n, tvm.tir.For) else None
+    )
+    return kinds
+
+
+def _schedule(mod, target="llvm"):
+    with tvm.target.Target(target), tvm.transform.PassContext(opt_level=3):
+        return DefaultCPUSchedule()(mod)
+
+
+def test_matmul():
+    mod = _schedule(Module)
+    func = mod["matmul"]
+    assert func.attrs["tir.is_scheduled"] == 1
+    kinds = _loop_kinds(func)
+    assert kinds.count(tvm.tir.ForKind.PARALLEL) == 1
+    assert kinds.count(tvm.tir.ForKind.VECTORIZED) == 1
+    # The initialization is split out of the tiled reduction.
+    block_names = []
+    tvm.tir.stmt_functor.post_order_visit(
+        func.body,
+        lambda n: block_names.append(n.name_hint) if isinstance(n, tvm.tir.Block) else None,
+    )
+    assert "matmul_init" in block_names
+
+
+def test_elementwise():
+    mod = _schedule(Module)
+    kinds = _loop_kinds(mod["add"])
+    assert kinds.count(tvm.tir.ForKind.PARALLEL) == 1
+    assert kinds.count(tvm.tir.ForKind.VECTORIZED) == 1
+    # Too little work to be worth parallelizing.
+    kinds = _loop_kinds(mod["add_small"])
+    assert tvm.tir.ForKind.PARALLEL not in kinds
+    assert kinds.count(tvm.tir.ForKind.VECTORIZED) == 1
+
+
+def test_reduction_innermost():
+    kinds = _loop_kinds(_schedule(Module)["row_sum"])
+    assert kinds.count(tvm.tir.ForKind.PARALLEL) == 1
+    assert tvm.tir.ForKind.VECTORIZED not in kinds
+
+
+def test_skip_scheduled_and_non_cpu():
+    scheduled = Module["add"].with_attr("tir.is_scheduled", 1)
+    mod = tvm.IRModule({"add": scheduled})
+    tvm.ir.assert_structural_equal(_schedule(mod), mod)
+    tvm.ir.assert_structural_equal(_schedule(Module, target="cuda"), Module)
+
+
+@tvm.testing.requires_llvm
+def test_build_and_run():
+    mod = _schedule(Module)
+    dev = tvm.cpu()
+    a_np = np.random.uniform(size=(256, 256)).astype("float32")
+    b_np = np.random.uniform(size=(256, 256)).astype("float32")
+    func = tvm.build(mod["matmul"], target="llvm")
+    c = tvm.nd.empty((256, 256), "float32", dev)
+    func(tvm.nd.array(a_np, dev), tvm.nd.array(b_np, dev), c)
+    tvm.testing.assert_allclose(c.numpy(), a_np @ b_np, rtol=1e-4)
+
+    x_np = np.random.uniform(size=(512, 512)).astype("float32")
+    func = tvm.build(mod["row_sum"], target="llvm")
+    y = tvm.nd.empty((512,), "float32", dev)
+    func(tvm.nd.array(x_np, dev), y)
+    tvm.testing.assert_allclose(y.numpy(), x_np.sum(axis=1), rtol=1e-4)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()